@@ -36,6 +36,8 @@ check_function_exists( pthread_timedjoin_np HAVE_TIMEDJOIN)
 check_function_exists( pthread_yield_np HAVE_YIELD_NP)
 check_function_exists( pthread_yield HAVE_YIELD)
 check_function_exists( fseeko HAVE_FSEEKO )
+check_function_exists( mmap HAVE_MMAP )
+check_function_exists( pread HAVE_PREAD )
 check_function_exists( timegm HAVE_TIMEGM )
 
 check_function_exists( _mkdir HAVE_WINDOWS_MKDIR)
@@ -59,6 +61,9 @@ include(CheckSymbolExists)
 check_symbol_exists(_tzname time.h HAVE_WINDOWS_TZNAME)
 check_symbol_exists( tzname time.h HAVE_TZNAME)
 
+include(CheckStructHasMember)
+check_struct_has_member( "struct stat" st_mtim sys/stat.h HAVE_STAT_MTIM )
+
 find_path( HAVE_EXECINFO execinfo.h /usr/include )
 
 try_compile( HAVE_VA_COPY ${CMAKE_BINARY_DIR} ${PROJECT_SOURCE_DIR}/cmake/Tests/test_va_copy.c )
@@ -17,7 +17,9 @@
 */
 
 #include <stdlib.h>
+#include <string.h>
 
+#include <ert/util/ert_api_config.h>
 #include <ert/util/util.h>
 #include <ert/util/stringlist.h>
 #include <ert/util/msg.h>
@@ -25,11 +27,49 @@
 #include <ert/ecl/ecl_file.h>
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_endian_flip.h>   
+#include <ert/ecl/ecl_pack.h>
 
+#ifdef ERT_HAVE_UNISTD
+#include <unistd.h>
+#endif
 
 
+static int num_cpu( void ) {
+#ifdef ERT_HAVE_UNISTD
+  long num = sysconf( _SC_NPROCESSORS_ONLN );
+  if (num > 0)
+    return num;
+#endif
+  return 1;
+}
+
+
+static void pack_kw( ecl_kw_type * ecl_kw , fortio_type * target , ecl_pack_writer_type * writer ) {
+  if (writer)
+    ecl_pack_writer_add_kw( writer , ecl_kw );
+  else
+    ecl_kw_fwrite( ecl_kw , target );
+}
+
+
+/*
+  With the -z option the files are packed into a compressed file,
+  which can be opened directly with ecl_file_open(); the compressed
+  file gets the name of the unformatted unified file with the suffix
+  ECL_PACKED_FILE_SUFFIX appended, i.e. CASE.UNRST.z.
+*/
+
 int main(int argc, char ** argv) {
-  int num_files = argc - 1;
+  bool compress = false;
+  int num_files;
+
+  if ((argc > 1) && (strcmp( argv[1] , "-z") == 0)) {
+    compress = true;
+    argv++;
+    argc--;
+  }
+
+  num_files = argc - 1;
   if (num_files >= 1) {
     /* File type and formatted / unformatted is determined from the first argument on the command line. */
     char * ecl_base;
@@ -60,10 +100,22 @@ int main(int argc, char ** argv) {
     {
       msg_type * msg;
       int i , report_step , prev_report_step;
-      char *  target_file_name   = ecl_util_alloc_filename( NULL , ecl_base , target_type , fmt_file , -1);
+      char *  target_file_name   = ecl_util_alloc_filename( NULL , ecl_base , target_type , fmt_file && !compress , -1);
       stringlist_type * filelist = stringlist_alloc_argv_copy( (const char **) &argv[1] , num_files );
       ecl_kw_type * seqnum_kw    = NULL;
-      fortio_type * target       = fortio_open_writer( target_file_name , fmt_file , ECL_ENDIAN_FLIP);
+      fortio_type * target       = NULL;
+      ecl_pack_writer_type * writer = NULL;
+
+      if (compress) {
+        char * packed_file_name = ecl_util_alloc_packed_filename( target_file_name );
+        free( target_file_name );
+        target_file_name = packed_file_name;
+
+        writer = ecl_pack_writer_alloc( target_file_name , num_cpu() );
+        if (!writer)
+          util_exit("Failed to create compressed file:%s - zlib support is required.\n" , target_file_name);
+      } else
+        target = fortio_open_writer( target_file_name , fmt_file , ECL_ENDIAN_FLIP);
 
       if (target_type == ECL_UNIFIED_RESTART_FILE) {
         int dummy;
@@ -96,15 +148,25 @@ int main(int argc, char ** argv) {
             if (target_type == ECL_UNIFIED_RESTART_FILE) {
               /* Must insert the SEQNUM keyword first. */
               ecl_kw_iset_int(seqnum_kw , 0 , report_step);
-              ecl_kw_fwrite( seqnum_kw , target );
+              pack_kw( seqnum_kw , target , writer );
             }
-            ecl_file_fwrite_fortio( src_file , target , 0);
+
+            if (writer) {
+              int ikw;
+              for (ikw = 0; ikw < ecl_file_get_size( src_file ); ikw++)
+                pack_kw( ecl_file_iget_kw( src_file , ikw ) , target , writer );
+            } else
+              ecl_file_fwrite_fortio( src_file , target , 0);
             ecl_file_close( src_file );
           }
         }  /* Else skipping file of incorrect type. */
       }
       msg_free(msg , false);
-      fortio_fclose( target );
+      if (writer) {
+        if (!ecl_pack_writer_close( writer ))
+          util_exit("Failed to write compressed file:%s \n" , target_file_name);
+      } else
+        fortio_fclose( target );
       free(target_file_name);
       stringlist_free( filelist );
       if (seqnum_kw != NULL) ecl_kw_free(seqnum_kw);
@@ -29,6 +29,7 @@
 #include <ert/util/time_t_vector.h>
 #include <ert/util/statistics.h>
 #include <ert/util/vector.h>
+#include <ert/util/stringlist.h>
 #include <ert/util/arg_pack.h>
 #include <ert/util/thread_pool.h>
 
@@ -89,6 +90,7 @@ typedef struct {
   time_t                start_time;
   time_t                end_time;
   const ecl_sum_type  * refcase;     /* Pointer to an arbitrary ecl_sum instance in the ensemble - to have access to indexing functions. */
+  stringlist_type     * key_filter;  /* The (wildcard) summary keys used in the OUTPUT statements; only these are loaded. */
   pthread_rwlock_t      rwlock;
 } ensemble_type;
 
@@ -121,10 +123,10 @@ static void quant_key_free__( void * qkey ) {
 
 /*****************************************************************/
 
-sum_case_type * sum_case_fread_alloc( const char * data_file , const time_t_vector_type * interp_time ) {
+sum_case_type * sum_case_fread_alloc( const char * data_file , const time_t_vector_type * interp_time , const stringlist_type * key_filter) {
   sum_case_type * sum_case = util_malloc( sizeof * sum_case );
 
-  sum_case->ecl_sum     = ecl_sum_fread_alloc_case( data_file , SUMMARY_JOIN );
+  sum_case->ecl_sum     = ecl_sum_fread_alloc_case_filtered( data_file , SUMMARY_JOIN , true , key_filter );
   sum_case->interp_data = double_vector_alloc(0 , 0);
   sum_case->interp_time = interp_time;
   sum_case->start_time  = ecl_sum_get_start_time( sum_case->ecl_sum );
@@ -149,7 +151,7 @@ void sum_case_free__( void * sum_case) {
 
 
 void ensemble_add_case( ensemble_type * ensemble , const char * data_file ) {
-  sum_case_type * sum_case = sum_case_fread_alloc( data_file , ensemble->interp_time );
+  sum_case_type * sum_case = sum_case_fread_alloc( data_file , ensemble->interp_time , ensemble->key_filter );
 
   pthread_rwlock_wrlock( &ensemble->rwlock );
   {
@@ -213,14 +215,45 @@ ensemble_type * ensemble_alloc( ) {
   ensemble->end_time    = -1;
   ensemble->data        = vector_alloc_new();
   ensemble->interp_time = time_t_vector_alloc( 0 , -1 );
+  ensemble->key_filter  = stringlist_alloc_new();
   pthread_rwlock_init( &ensemble->rwlock , NULL );
   return ensemble;
 }
 
 
+/**
+   Collects the summary keys from all the OUTPUT statements, i.e. the
+   'WOPR:B*' part of 'WOPR:B*:0.75', so that only the summary vectors
+   which are actually used are loaded from the ensemble cases. Malformed
+   keys are reported later by output_add_key().
+*/
+
+static void ensemble_init_key_filter( ensemble_type * ensemble , const config_content_type * config) {
+  int i,j;
+  if (config_content_has_item( config , "OUTPUT")) {
+    const config_content_item_type * output_item = config_content_get_item( config , "OUTPUT");
+    for (i = 0; i < config_content_item_get_size( output_item ); i++) {
+      const config_content_node_type * output_node = config_content_item_iget_node( output_item , i );
+
+      for (j = 2; j < config_content_node_get_size( output_node ); j++) {
+        int tokens;
+        char ** tmp;
+
+        util_split_string( config_content_node_iget( output_node , j) , SUMMARY_JOIN , &tokens , &tmp);
+        if (tokens > 1)
+          stringlist_append_owned_ref( ensemble->key_filter , util_alloc_joined_string( (const char **) tmp , tokens - 1 , SUMMARY_JOIN));
+        util_free_stringlist( tmp, tokens );
+      }
+    }
+  }
+}
+
+
 void ensemble_init( ensemble_type * ensemble , config_content_type * config) {
 
   /*1 : Loading ensembles and settings from the config instance */
+  ensemble_init_key_filter( ensemble , config );
+
   /*1a: Loading the eclipse summary cases. */
   {
     thread_pool_type * tp = thread_pool_alloc( LOAD_THREADS , true );
@@ -266,6 +299,7 @@ const ecl_sum_type * ensemble_get_refcase( const ensemble_type * ensemble ) {
 void ensemble_free( ensemble_type * ensemble ) {
   vector_free( ensemble->data );
   time_t_vector_free( ensemble->interp_time );
+  stringlist_free( ensemble->key_filter );
   free( ensemble );
 }
 
@@ -17,6 +17,7 @@
 */
 
 #include <stdbool.h>
+#include <string.h>
 
 #include <ert/util/util.h>
 #include <ert/util/msg.h>
@@ -51,7 +52,13 @@ void unpack_file(const char * filename) {
     char * path; 
     char * base;
     msg_type * msg;
-    util_alloc_file_components( filename , &path , &base , NULL);
+    if (ecl_util_packed_file( filename )) {
+      /* CASE.UNRST.z => CASE */
+      char * plain_file = util_alloc_substring_copy( filename , 0 , strlen( filename ) - strlen( ECL_PACKED_FILE_SUFFIX ));
+      util_alloc_file_components( plain_file , &path , &base , NULL);
+      free( plain_file );
+    } else
+      util_alloc_file_components( filename , &path , &base , NULL);
     {
       char * label  = util_alloc_sprintf("Unpacking %s => ", filename);
       msg = msg_alloc( label , false);
@@ -26,6 +26,7 @@ extern "C" {
 #include <stdbool.h>
 #include <time.h>
 
+#include <ert/util/stringlist.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file_kw.h>
@@ -37,8 +38,11 @@ extern "C" {
 
 #define ECL_FILE_FLAGS_ENUM_DEFS \
   {.value =   1 , .name="ECL_FILE_CLOSE_STREAM"}, \
-  {.value =   2 , .name="ECL_FILE_WRITABLE"}
-#define ECL_FILE_FLAGS_ENUM_SIZE 2
+  {.value =   2 , .name="ECL_FILE_WRITABLE"}, \
+  {.value =   4 , .name="ECL_FILE_MMAP"}, \
+  {.value =   8 , .name="ECL_FILE_INDEX"}, \
+  {.value =  16 , .name="ECL_FILE_THREAD_SAFE"}
+#define ECL_FILE_FLAGS_ENUM_SIZE 5
 
 
 
@@ -48,6 +52,16 @@ extern "C" {
   ecl_file_type  * ecl_file_open( const char * filename , int flags);
   void             ecl_file_close( ecl_file_type * ecl_file );
   void             ecl_file_fortio_detach( ecl_file_type * ecl_file );
+  bool             ecl_file_enable_prefetch( ecl_file_type * ecl_file , int num_blocks , const stringlist_type * kw_list , size_t max_bytes );
+  void             ecl_file_disable_prefetch( ecl_file_type * ecl_file );
+  bool             ecl_file_set_max_kw_bytes( ecl_file_type * ecl_file , size_t max_bytes );
+  size_t           ecl_file_get_max_kw_bytes( const ecl_file_type * ecl_file );
+  size_t           ecl_file_get_loaded_kw_bytes( const ecl_file_type * ecl_file );
+  void             ecl_file_pin_kw( ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw );
+  void             ecl_file_unpin_kw( ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw );
+  void             ecl_file_release_kw( ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw );
+  char           * ecl_file_alloc_index_filename( const char * filename );
+  bool             ecl_file_write_index( const ecl_file_type * ecl_file , const char * index_filename );
   void             ecl_file_free__(void * arg);
   ecl_kw_type    * ecl_file_icopy_named_kw( const ecl_file_type * ecl_file , const char * kw, int ith);
   ecl_kw_type    * ecl_file_icopy_kw( const ecl_file_type * ecl_file , int index);
@@ -80,6 +94,7 @@ extern "C" {
   int                ecl_file_iget_size( const ecl_file_type * file , int global_index);
   const char       * ecl_file_iget_header( const ecl_file_type * file , int global_index);
   ecl_kw_type      * ecl_file_iget_named_kw( const ecl_file_type * file , const char * kw, int ith);
+  ecl_kw_type      * ecl_file_iget_named_kw_pinned( const ecl_file_type * file , const char * kw, int ith);
   ecl_type_enum      ecl_file_iget_named_type( const ecl_file_type * file , const char * kw , int ith);
   int                ecl_file_iget_named_size( const ecl_file_type * file , const char * kw , int ith);
   void               ecl_file_indexed_read(const ecl_file_type * file , const char * kw, int index, const int_vector_type * index_map, char* buffer);
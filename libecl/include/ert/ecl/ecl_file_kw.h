@@ -24,24 +24,40 @@ extern "C" {
 #endif
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <ert/util/util.h>
+#include <ert/util/buffer.h>
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/fortio.h>
 
+/* Size of one ecl_file_kw record in a keyword index file: header, type, size and offset. */
+#define ECL_FILE_KW_INDEX_SIZE (ECL_STRING8_LENGTH + 2 * sizeof(int) + sizeof(int64_t))
+
 typedef struct ecl_file_kw_struct ecl_file_kw_type;
 typedef struct inv_map_struct inv_map_type;
 
   inv_map_type     * inv_map_alloc(void);
   ecl_file_kw_type * inv_map_get_file_kw( inv_map_type * inv_map , const ecl_kw_type * ecl_kw );
   void               inv_map_free( inv_map_type * map );
+  void               inv_map_set_max_bytes( inv_map_type * map , size_t max_bytes );
+  size_t             inv_map_get_max_bytes( const inv_map_type * map );
+  size_t             inv_map_get_used_bytes( inv_map_type * map );
+  void               inv_map_pin_kw( inv_map_type * map , const ecl_kw_type * ecl_kw );
+  void               inv_map_unpin_kw( inv_map_type * map , const ecl_kw_type * ecl_kw );
+  void               inv_map_release_kw( inv_map_type * map , const ecl_kw_type * ecl_kw );
+  bool               inv_map_enable_locking( inv_map_type * map );
+  bool               inv_map_is_thread_safe( const inv_map_type * map );
 
   ecl_file_kw_type * ecl_file_kw_alloc( const ecl_kw_type * ecl_kw , offset_type offset);
   void               ecl_file_kw_free( ecl_file_kw_type * file_kw );
   void               ecl_file_kw_free__( void * arg );
   ecl_kw_type      * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * fortio, inv_map_type * inv_map);
+  ecl_kw_type      * ecl_file_kw_get_kw_pinned( ecl_file_kw_type * file_kw , fortio_type * fortio, inv_map_type * inv_map);
   ecl_kw_type      * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map );
+  void               ecl_file_kw_set_kw( ecl_file_kw_type * file_kw , ecl_kw_type * ecl_kw , inv_map_type * inv_map );
+  bool               ecl_file_kw_is_loaded( const ecl_file_kw_type * file_kw );
   ecl_file_kw_type * ecl_file_kw_alloc_copy( const ecl_file_kw_type * src );
   const char       * ecl_file_kw_get_header( const ecl_file_kw_type * file_kw );
   int                ecl_file_kw_get_size( const ecl_file_kw_type * file_kw );
@@ -51,6 +67,8 @@ typedef struct inv_map_struct inv_map_type;
   void               ecl_file_kw_replace_kw( ecl_file_kw_type * file_kw , fortio_type * target , ecl_kw_type * new_kw );
   bool               ecl_file_kw_fskip_data( const ecl_file_kw_type * file_kw , fortio_type * fortio);
   void               ecl_file_kw_inplace_fwrite( ecl_file_kw_type * file_kw , fortio_type * fortio);
+  void               ecl_file_kw_buffer_store( const ecl_file_kw_type * file_kw , buffer_type * buffer);
+  ecl_file_kw_type * ecl_file_kw_buffer_alloc( buffer_type * buffer );
  
 #ifdef __cplusplus
 }
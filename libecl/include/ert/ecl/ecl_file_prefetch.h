@@ -0,0 +1,50 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_prefetch.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_FILE_PREFETCH_H
+#define ERT_ECL_FILE_PREFETCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include <ert/util/stringlist.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file_kw.h>
+
+typedef struct ecl_file_prefetch_struct ecl_file_prefetch_type;
+
+  ecl_file_prefetch_type * ecl_file_prefetch_alloc( const char * filename , int num_blocks , const stringlist_type * kw_list , size_t max_bytes );
+  void                     ecl_file_prefetch_free( ecl_file_prefetch_type * prefetch );
+  int                      ecl_file_prefetch_get_num_blocks( const ecl_file_prefetch_type * prefetch );
+  bool                     ecl_file_prefetch_add( ecl_file_prefetch_type * prefetch , const ecl_file_kw_type * file_kw );
+  void                     ecl_file_prefetch_drop_before( ecl_file_prefetch_type * prefetch , offset_type offset );
+  ecl_kw_type            * ecl_file_prefetch_take( ecl_file_prefetch_type * prefetch , const ecl_file_kw_type * file_kw );
+  size_t                   ecl_file_prefetch_get_used_bytes( ecl_file_prefetch_type * prefetch );
+
+  UTIL_IS_INSTANCE_HEADER( ecl_file_prefetch );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -25,6 +25,8 @@
 
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_prefetch.h>
+#include <ert/ecl/ecl_pack.h>
 
 
 #ifdef __cplusplus
@@ -37,12 +39,43 @@ typedef enum {
                                     mainly to save filedescriptors in cases where many ecl_file instances are open at
                                     the same time. */
   //
-  ECL_FILE_WRITABLE      =  2    /*
+  ECL_FILE_WRITABLE      =  2 ,  /*
                                     This flag opens the file in a mode where it can be updated and modified, but it
                                     must still exist and be readable. I.e. this should not compared with the normal:
                                     fopen(filename , "w") where an existing file is truncated to zero upon successfull
                                     open.
                                  */
+  //
+  ECL_FILE_MMAP          =  4 ,  /*
+                                    This flag will map the complete file into memory, and keywords are then instantiated
+                                    directly from the mapped memory instead of being read through the FILE object. When
+                                    possible the keywords will reference the mapped memory directly, without any copying.
+                                    That is only possible when the byte order of the file is the native byte order; the
+                                    ECLIPSE files are big endian, so on little endian hosts like x86 the data of a keyword
+                                    is still copied from the mapping and byte swapped - in one pass, when the keyword is
+                                    loaded, and not lazily on element access. The flag is ignored for formatted files, for
+                                    files opened with ECL_FILE_WRITABLE and on platforms without mmap().
+                                 */
+  //
+  ECL_FILE_INDEX         =  8 ,  /*
+                                    With this flag the keyword index is loaded from the sidecar file created by
+                                    ecl_file_write_index() instead of scanning through the complete file. If the index
+                                    file is missing or out of date the file is scanned as usual, and a new index file is
+                                    written if possible. See ecl_file_alloc_index_filename().
+                                 */
+  //
+  ECL_FILE_THREAD_SAFE   = 16    /*
+                                    With this flag several threads can load keywords from the same ecl_file instance
+                                    concurrently, i.e. call ecl_file_iget_kw() and ecl_file_iget_named_kw(). Binary
+                                    files are read with pread(), so loads of different keywords proceed in parallel.
+                                    Selecting blocks and creating or modifying views is still not thread safe. The
+                                    ECL_FILE_CLOSE_STREAM flag is ignored, prefetching is not available, and the flag
+                                    is ignored for files opened with ECL_FILE_WRITABLE and on platforms without
+                                    pthreads or pread(). When a memory budget is set with ecl_file_set_max_kw_bytes() a keyword
+                                    released by one thread can be evicted while another thread still uses it; threads
+                                    sharing keywords should then use ecl_file_iget_named_kw_pinned() and
+                                    ecl_file_unpin_kw(), which pin the keyword atomically with the lookup.
+                                 */
 } ecl_file_flag_type;
 
 
@@ -52,6 +85,8 @@ typedef struct ecl_file_view_struct ecl_file_view_type;
   bool ecl_file_view_check_flags( int state_flags , int query_flags);
 
   ecl_file_view_type * ecl_file_view_alloc( fortio_type * fortio , int * flags , inv_map_type * inv_map , bool owner );
+  void ecl_file_view_set_prefetch_ref( ecl_file_view_type * ecl_file_view , ecl_file_prefetch_type ** prefetch );
+  void ecl_file_view_set_pack( ecl_file_view_type * ecl_file_view , const ecl_pack_type * pack );
   int ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , const char * kw , int ith);
   void ecl_file_view_make_index( ecl_file_view_type * ecl_file_view );
   bool ecl_file_view_has_kw( const ecl_file_view_type * ecl_file_view, const char * kw);
@@ -67,11 +102,14 @@ typedef struct ecl_file_view_struct ecl_file_view_type;
   int ecl_file_view_iget_size( const ecl_file_view_type * ecl_file_view , int index);
   const char * ecl_file_view_iget_header( const ecl_file_view_type * ecl_file_view , int index);
   ecl_kw_type * ecl_file_view_iget_named_kw( const ecl_file_view_type * ecl_file_view , const char * kw, int ith);
+  ecl_kw_type * ecl_file_view_iget_named_kw_pinned( const ecl_file_view_type * ecl_file_view , const char * kw, int ith);
   ecl_type_enum ecl_file_view_iget_named_type( const ecl_file_view_type * ecl_file_view , const char * kw , int ith);
   int ecl_file_view_iget_named_size( const ecl_file_view_type * ecl_file_view , const char * kw , int ith);
   void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type * old_kw , ecl_kw_type * new_kw , bool insert_copy);
   bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view );
   void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw);
+  void ecl_file_view_buffer_store( const ecl_file_view_type * ecl_file_view , buffer_type * buffer );
+  bool ecl_file_view_buffer_load( ecl_file_view_type * ecl_file_view , buffer_type * buffer );
   void ecl_file_view_free( ecl_file_view_type * ecl_file_view );
   void ecl_file_view_free__( void * arg );
   int ecl_file_view_get_num_named_kw(const ecl_file_view_type * ecl_file_view , const char * kw);
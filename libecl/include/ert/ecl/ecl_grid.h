@@ -38,6 +38,30 @@ extern "C" {
 #define ECL_GRID_GLOBAL_GRID   "Global"  // used as key in hash tables over grids.
 #define  ECL_GRID_MAINGRID_LGR_NR 0
 
+/*
+  Cell properties which can be calculated for all cells in one call
+  with ecl_grid_init_geometry_data().
+*/
+typedef enum { ECL_GRID_VOLUME   = 0,
+               ECL_GRID_CENTER_X = 1,
+               ECL_GRID_CENTER_Y = 2,
+               ECL_GRID_DEPTH    = 3,    /* The z coordinate of the cell center. */
+               ECL_GRID_DX       = 4,
+               ECL_GRID_DY       = 5,
+               ECL_GRID_DZ       = 6} ecl_grid_geometry_enum;
+
+/*
+  Statistics of the values blocked into a cell with the blocking
+  accumulators, see ecl_grid_alloc_blocking_accumulators().
+*/
+typedef enum { ECL_GRID_BLOCK_COUNT    = 0,
+               ECL_GRID_BLOCK_SUM      = 1,
+               ECL_GRID_BLOCK_MEAN     = 2,
+               ECL_GRID_BLOCK_VARIANCE = 3,
+               ECL_GRID_BLOCK_STD      = 4,
+               ECL_GRID_BLOCK_MIN      = 5,
+               ECL_GRID_BLOCK_MAX      = 6} ecl_grid_block_stat_enum;
+
   typedef double (block_function_ftype) ( const double_vector_type *);
   typedef struct ecl_grid_struct ecl_grid_type;
 
@@ -80,6 +104,8 @@ extern "C" {
   double          ecl_grid_get_cdepth1(const ecl_grid_type * grid , int global_index);
   double          ecl_grid_get_cdepth3(const ecl_grid_type * grid , int i, int j , int k);
   int             ecl_grid_get_global_index_from_xy( const ecl_grid_type * ecl_grid , int k , bool lower_layer , double x , double y);
+  void            ecl_grid_get_global_index_from_xy_batch( const ecl_grid_type * ecl_grid , int k , bool lower_layer , int num_points , const double * x , const double * y , int * global_index);
+  void            ecl_grid_free_xy_index( ecl_grid_type * grid );
   bool            ecl_grid_cell_contains_xyz1( const ecl_grid_type * ecl_grid , int global_index , double x , double y , double z);
   bool            ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i , int j , int k, double x , double y , double z );
   double          ecl_grid_get_cell_volume1( const ecl_grid_type * ecl_grid, int global_index );
@@ -89,8 +115,12 @@ extern "C" {
   bool            ecl_grid_cell_contains1(const ecl_grid_type * grid , int global_index , double x , double y , double z);
   bool            ecl_grid_cell_contains3(const ecl_grid_type * grid , int i , int j ,int k , double x , double y , double z);
   int             ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index);
+  void            ecl_grid_get_global_index_from_xyz_batch(ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , const int * start_index , int * global_index);
+  void            ecl_grid_init_xyz_index( ecl_grid_type * grid );
+  void            ecl_grid_free_xyz_index( ecl_grid_type * grid );
   bool            ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k );
   bool            ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j);
+  void            ecl_grid_get_ij_from_xy_batch( const ecl_grid_type * grid , int k , int num_points , const double * x , const double * y , int * i , int * j);
   const  char   * ecl_grid_get_name( const ecl_grid_type * );
   int             ecl_grid_get_active_index3(const ecl_grid_type * ecl_grid , int i , int j , int k);
   int             ecl_grid_get_active_index1(const ecl_grid_type * ecl_grid , int global_index);
@@ -105,6 +135,7 @@ extern "C" {
 
   const nnc_info_type * ecl_grid_get_cell_nnc_info3( const ecl_grid_type * grid , int i , int j , int k);
   const nnc_info_type * ecl_grid_get_cell_nnc_info1( const ecl_grid_type * grid , int global_index);
+  int                   ecl_grid_get_cell_nnc_row( const ecl_grid_type * grid , int global_index , const int ** lgr_nr , const int ** global_index2 , const int ** nnc_index);
   void                  ecl_grid_add_self_nnc( ecl_grid_type * grid1, int g1, int g2, int nnc_index);
   void                  ecl_grid_add_self_nnc_list( ecl_grid_type * grid, const int * g1_list , const int * g2_list , int num_nnc );
 
@@ -112,8 +143,13 @@ extern "C" {
   ecl_grid_type * ecl_grid_alloc_GRDECL_data(int , int , int , const float *  , const float *  , const int * , bool apply_mapaxes , const float * mapaxes);
   ecl_grid_type * ecl_grid_alloc_GRID_data(int num_coords , int nx, int ny , int nz , int coords_size , int ** coords , float ** corners , bool apply_mapaxes, const float * mapaxes);
   ecl_grid_type * ecl_grid_alloc(const char * );
+  ecl_grid_type * ecl_grid_alloc_lazy(const char * grid_file );
   ecl_grid_type * ecl_grid_load_case( const char * case_input );
   ecl_grid_type * ecl_grid_load_case__( const char * case_input , bool apply_mapaxes);
+  bool            ecl_grid_fwrite_cache( const ecl_grid_type * grid , const char * grid_file , bool apply_mapaxes , const char * cache_file );
+  ecl_grid_type * ecl_grid_fread_cache( const char * grid_file , bool apply_mapaxes , const char * cache_file );
+  char          * ecl_grid_alloc_cache_filename( const char * grid_file );
+  ecl_grid_type * ecl_grid_load_case_cached( const char * case_input );
   ecl_grid_type * ecl_grid_alloc_rectangular( int nx , int ny , int nz , double dx , double dy , double dz , const int * actnum);
   ecl_grid_type * ecl_grid_alloc_regular( int nx, int ny , int nz , const double * ivec, const double * jvec , const double * kvec , const int * actnum);
   ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv( int nx, int ny , int nz , const double * dxv , const double * dyv , const double * dzv , const int * actnum);
@@ -163,6 +199,11 @@ extern "C" {
   double          ecl_grid_block_eval3d(ecl_grid_type * grid , int i, int j , int k ,block_function_ftype * blockf );
   int             ecl_grid_get_block_count3d(const ecl_grid_type * ecl_grid , int i , int j, int k);
   bool            ecl_grid_block_value_3d(ecl_grid_type * , double  , double  ,double , double);
+  void            ecl_grid_alloc_blocking_accumulators(ecl_grid_type * grid);
+  int             ecl_grid_block_values_3d(ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , const double * value);
+  double          ecl_grid_get_block_stat1(const ecl_grid_type * grid , int global_index , ecl_grid_block_stat_enum stat);
+  double          ecl_grid_get_block_stat3(const ecl_grid_type * grid , int i , int j , int k , ecl_grid_block_stat_enum stat);
+  void            ecl_grid_init_block_stat_data(const ecl_grid_type * grid , ecl_grid_block_stat_enum stat , double * data);
 
   bool            ecl_grid_cell_invalid1(const ecl_grid_type * ecl_grid , int global_index);
   bool            ecl_grid_cell_invalid3(const ecl_grid_type * ecl_grid , int i , int j , int k);
@@ -248,6 +289,9 @@ extern "C" {
   int  ecl_grid_get_coord_size( const ecl_grid_type * ecl_grid);
 
   void ecl_grid_init_actnum_data( const ecl_grid_type * grid , int * actnum );
+  void ecl_grid_init_geometry_data( const ecl_grid_type * grid , ecl_grid_geometry_enum property , bool active_only , double * data);
+  void ecl_grid_init_geometry_data_float( const ecl_grid_type * grid , ecl_grid_geometry_enum property , bool active_only , float * data);
+  ecl_kw_type * ecl_grid_alloc_geometry_kw( const ecl_grid_type * grid , ecl_grid_geometry_enum property , const char * kw_name , bool active_only);
   bool ecl_grid_use_mapaxes( const ecl_grid_type * grid );
   void ecl_grid_init_mapaxes_data_double( const ecl_grid_type * grid , double * mapaxes);
   void ecl_grid_reset_actnum( ecl_grid_type * grid , const int * actnum );
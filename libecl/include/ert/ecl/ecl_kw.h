@@ -57,9 +57,10 @@ extern "C" {
 
   int            ecl_kw_first_different( const ecl_kw_type * kw1 , const ecl_kw_type * kw2 , int offset, double abs_epsilon , double rel_epsilon);
   size_t         ecl_kw_fortio_size( const ecl_kw_type * ecl_kw );
+  size_t         ecl_kw_fortio_size__( ecl_type_enum ecl_type , int size );
   void *         ecl_kw_get_ptr(const ecl_kw_type *ecl_kw);
   void           ecl_kw_set_data_ptr(ecl_kw_type * ecl_kw , void * data);
-  void           ecl_kw_fwrite_data(const ecl_kw_type *_ecl_kw , fortio_type *fortio);
+  void           ecl_kw_fwrite_data(const ecl_kw_type *ecl_kw , fortio_type *fortio);
   bool           ecl_kw_fread_realloc_data(ecl_kw_type *ecl_kw, fortio_type *fortio);
   ecl_type_enum  ecl_kw_get_type(const ecl_kw_type *);
   const char   * ecl_kw_get_header8(const ecl_kw_type *);
@@ -77,6 +78,9 @@ extern "C" {
   bool           ecl_kw_fread_realloc(ecl_kw_type *, fortio_type *);
   void           ecl_kw_fread(ecl_kw_type * , fortio_type * );
   ecl_kw_type *  ecl_kw_fread_alloc(fortio_type *);
+  ecl_kw_type *  ecl_kw_alloc_mmap( char * kw_ptr , offset_type avail );
+  ecl_kw_type *  ecl_kw_alloc_memory_copy( const char * kw_ptr , offset_type avail );
+  void           ecl_kw_write_memory_image( const ecl_kw_type * ecl_kw , char * buffer );
   void           ecl_kw_free_data(ecl_kw_type *);
   void           ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ecl_type_enum ecl_type, int element_count, const int_vector_type* index_map, char* buffer);
   void           ecl_kw_free(ecl_kw_type *);
@@ -106,6 +110,7 @@ extern "C" {
   ecl_kw_type *  ecl_kw_alloc( const char * header , int size , ecl_type_enum ecl_type );
   ecl_kw_type *  ecl_kw_alloc_new(const char * ,  int , ecl_type_enum , const void * );
   ecl_kw_type *  ecl_kw_alloc_new_shared(const char * ,  int , ecl_type_enum , void * );
+  bool           ecl_kw_data_is_shared( const ecl_kw_type * ecl_kw );
   void           ecl_kw_fwrite_param(const char * , bool  , const char * ,  ecl_type_enum , int , void * );
   void           ecl_kw_fwrite_param_fortio(fortio_type *, const char * ,  ecl_type_enum , int , void * );
   void           ecl_kw_summarize(const ecl_kw_type * ecl_kw);
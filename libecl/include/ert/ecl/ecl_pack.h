@@ -0,0 +1,52 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_pack.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_PACK_H
+#define ERT_ECL_PACK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+#include <ert/util/buffer.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_kw.h>
+
+typedef struct ecl_pack_struct        ecl_pack_type;
+typedef struct ecl_pack_writer_struct ecl_pack_writer_type;
+
+  bool                   ecl_pack_is_packed_file( const char * filename );
+  ecl_pack_type        * ecl_pack_open( const char * filename );
+  void                   ecl_pack_free( ecl_pack_type * pack );
+  int                    ecl_pack_get_size( const ecl_pack_type * pack );
+  buffer_type          * ecl_pack_alloc_kw_index( const ecl_pack_type * pack );
+  ecl_kw_type          * ecl_pack_alloc_kw( const ecl_pack_type * pack , offset_type offset );
+
+  ecl_pack_writer_type * ecl_pack_writer_alloc( const char * filename , int num_threads );
+  void                   ecl_pack_writer_add_kw( ecl_pack_writer_type * writer , const ecl_kw_type * ecl_kw );
+  bool                   ecl_pack_writer_close( ecl_pack_writer_type * writer );
+
+  UTIL_IS_INSTANCE_HEADER( ecl_pack );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -65,6 +65,8 @@ typedef struct ecl_region_struct ecl_region_type;
   const int_vector_type * ecl_region_get_active_list( ecl_region_type * region );
   const int_vector_type * ecl_region_get_global_list( ecl_region_type * region );
   const int_vector_type * ecl_region_get_global_active_list( ecl_region_type * region );
+  int                     ecl_region_get_global_size( const ecl_region_type * region );
+  int                     ecl_region_get_active_size( ecl_region_type * region );
 
   bool            ecl_region_contains_ijk( const ecl_region_type * ecl_region , int i , int j , int k);
   bool            ecl_region_contains_global( const ecl_region_type * ecl_region , int global_index);
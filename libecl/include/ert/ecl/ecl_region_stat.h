@@ -0,0 +1,55 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_region_stat.h' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#ifndef ERT_ECL_REGION_STAT_H
+#define ERT_ECL_REGION_STAT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_grid.h>
+
+  typedef struct ecl_region_stat_struct ecl_region_stat_type;
+
+  ecl_region_stat_type * ecl_region_stat_alloc( const ecl_grid_type * grid , const ecl_kw_type * region_kw , int num_values , const ecl_kw_type ** value_kw , const ecl_kw_type * weight_kw);
+  void                   ecl_region_stat_free( ecl_region_stat_type * region_stat );
+
+  int                    ecl_region_stat_get_num_values( const ecl_region_stat_type * region_stat );
+  int                    ecl_region_stat_get_min_region( const ecl_region_stat_type * region_stat );
+  int                    ecl_region_stat_get_max_region( const ecl_region_stat_type * region_stat );
+  int                    ecl_region_stat_get_num_regions( const ecl_region_stat_type * region_stat );
+  int                    ecl_region_stat_iget_region( const ecl_region_stat_type * region_stat , int index );
+
+  int                    ecl_region_stat_get_count( const ecl_region_stat_type * region_stat , int region_value );
+  double                 ecl_region_stat_get_weight( const ecl_region_stat_type * region_stat , int region_value );
+  double                 ecl_region_stat_iget_sum( const ecl_region_stat_type * region_stat , int value_nr , int region_value );
+  double                 ecl_region_stat_iget_mean( const ecl_region_stat_type * region_stat , int value_nr , int region_value );
+  double                 ecl_region_stat_iget_min( const ecl_region_stat_type * region_stat , int value_nr , int region_value );
+  double                 ecl_region_stat_iget_max( const ecl_region_stat_type * region_stat , int value_nr , int region_value );
+
+UTIL_IS_INSTANCE_HEADER( ecl_region_stat );
+UTIL_SAFE_CAST_HEADER( ecl_region_stat );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -58,6 +58,9 @@ typedef struct ecl_smspec_struct ecl_smspec_type;
   void                ecl_smspec_fwrite( const ecl_smspec_type * smspec , const char * ecl_case , bool fmt_file );
 
   ecl_smspec_type *        ecl_smspec_fread_alloc(const char *header_file, const char * key_join_string , bool include_restart);
+  ecl_smspec_type *        ecl_smspec_fread_alloc_filtered(const char *header_file, const char * key_join_string , bool include_restart , const stringlist_type * key_filter);
+  const int_vector_type  * ecl_smspec_get_file_index( const ecl_smspec_type * smspec );
+  int                      ecl_smspec_get_file_params_size( const ecl_smspec_type * smspec );
   void                     ecl_smspec_free( ecl_smspec_type *);
 
   int                      ecl_smspec_get_date_day_index( const ecl_smspec_type * smspec );
@@ -92,8 +92,10 @@ typedef struct ecl_sum_struct       ecl_sum_type;
   void             ecl_sum_free__(void * );
   void             ecl_sum_free(ecl_sum_type * );
   ecl_sum_type   * ecl_sum_fread_alloc(const char * , const stringlist_type * data_files, const char * key_join_string);
+  ecl_sum_type   * ecl_sum_fread_alloc_filtered(const char * header_file , const stringlist_type * data_files, const char * key_join_string , const stringlist_type * key_filter);
   ecl_sum_type   * ecl_sum_fread_alloc_case(const char *  , const char * key_join_string);
   ecl_sum_type   * ecl_sum_fread_alloc_case__(const char *  , const char * key_join_string , bool include_restart);
+  ecl_sum_type   * ecl_sum_fread_alloc_case_filtered(const char * input_file , const char * key_join_string , bool include_restart , const stringlist_type * key_filter);
   bool             ecl_sum_case_exists( const char * input_file );
 
   /* Accessor functions : */
@@ -44,6 +44,8 @@ typedef struct ecl_sum_data_struct ecl_sum_data_type ;
   void                     ecl_sum_data_fread_restart( ecl_sum_data_type * data , const stringlist_type * filelist);
   ecl_sum_data_type      * ecl_sum_data_alloc_writer( ecl_smspec_type * smspec );
   ecl_sum_data_type      * ecl_sum_data_alloc( ecl_smspec_type * smspec);
+  void                     ecl_sum_data_set_columnar( ecl_sum_data_type * data , bool columnar );
+  bool                     ecl_sum_data_is_columnar( const ecl_sum_data_type * data );
   double                   ecl_sum_data_time2days( const ecl_sum_data_type * data , time_t sim_time);
   int                      ecl_sum_data_get_report_step_from_time(const ecl_sum_data_type * data , time_t sim_time);
   int                      ecl_sum_data_get_report_step_from_days(const ecl_sum_data_type * data , double days);
@@ -27,6 +27,7 @@ extern "C" {
 
 #include <ert/ecl/ecl_smspec.h>
 #include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file_view.h>
 
 typedef struct ecl_sum_tstep_struct ecl_sum_tstep_type;
 
@@ -40,6 +41,12 @@ typedef struct ecl_sum_tstep_struct ecl_sum_tstep_type;
                                                      const char * src_file ,
                                                      const ecl_smspec_type * smspec);
 
+  ecl_sum_tstep_type * ecl_sum_tstep_alloc_from_file_index( int report_step ,
+                                                            int ministep_nr ,
+                                                            const ecl_file_view_type * summary_view ,
+                                                            int params_nr ,
+                                                            const ecl_smspec_type * smspec);
+
   ecl_sum_tstep_type * ecl_sum_tstep_alloc_new( int report_step , int ministep , float sim_seconds , const ecl_smspec_type * smspec );
 
   double ecl_sum_tstep_iget(const ecl_sum_tstep_type * ministep , int index);
@@ -68,6 +75,11 @@ typedef struct ecl_sum_tstep_struct ecl_sum_tstep_type;
 
   bool ecl_sum_tstep_sim_time_equal( const ecl_sum_tstep_type * tstep1 , const ecl_sum_tstep_type * tstep2 );
 
+  const float * ecl_sum_tstep_get_data_ptr( const ecl_sum_tstep_type * tstep );
+  size_t ecl_sum_tstep_get_data_stride( const ecl_sum_tstep_type * tstep );
+  void ecl_sum_tstep_set_data_view( ecl_sum_tstep_type * tstep , float * data , size_t stride );
+  void ecl_sum_tstep_detach_data( ecl_sum_tstep_type * tstep );
+
   UTIL_SAFE_CAST_HEADER( ecl_sum_tstep );
   UTIL_SAFE_CAST_HEADER_CONST( ecl_sum_tstep );
 
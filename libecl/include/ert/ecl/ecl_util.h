@@ -172,6 +172,7 @@ typedef enum {
 #define ECL_COMMENT_STRING       "--"
 #define ECL_COMMENT_CHAR         '-'   // Need to consecutive to make an ECLIPSE comment
 #define ECL_DATA_TERMINATION      "/"
+#define ECL_PACKED_FILE_SUFFIX    ".z"  // Suffix of files packed with ecl_pack_writer, e.g. CASE.UNRST.z
 
 int              ecl_util_get_sizeof_ctype_fortio(ecl_type_enum ecl_type);
 int              ecl_util_get_sizeof_ctype(ecl_type_enum );
@@ -180,6 +181,8 @@ const char     * ecl_util_get_type_name( ecl_type_enum ecl_type );
 
 /*****************************************************************/
 bool            ecl_util_unified_file(const char *filename);
+bool            ecl_util_packed_file(const char *filename);
+char          * ecl_util_alloc_packed_filename(const char * filename);
 const char    * ecl_util_file_type_name( ecl_file_enum file_type );
 char          * ecl_util_alloc_base_guess(const char *);
 int             ecl_util_filename_report_nr(const char *);
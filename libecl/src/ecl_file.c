@@ -21,12 +21,14 @@
 #include <math.h>
 #include <errno.h>
 #include <time.h>
+#include <stdint.h>
 
 #include <ert/util/hash.h>
 #include <ert/util/util.h>
 #include <ert/util/vector.h>
 #include <ert/util/int_vector.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/buffer.h>
 
 #include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_kw.h>
@@ -36,6 +38,7 @@
 #include <ert/ecl/ecl_kw_magic.h>
 #include <ert/ecl/ecl_rsthead.h>
 #include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_pack.h>
 
 /**
    This file implements functionality to load an ECLIPSE file in
@@ -137,6 +140,8 @@ struct ecl_file_struct {
   int             flags;
   vector_type   * map_stack;
   inv_map_type  * inv_view;
+  ecl_file_prefetch_type * prefetch;   /* NULL unless ecl_file_enable_prefetch() has been called. */
+  ecl_pack_type * pack;                /* NULL unless the file has been created by ecl_pack_writer. */
 };
 
 
@@ -182,6 +187,8 @@ ecl_file_type * ecl_file_alloc_empty( int flags ) {
   ecl_file->map_stack = vector_alloc_new();
   ecl_file->inv_view  = inv_map_alloc( );
   ecl_file->flags     = flags;
+  ecl_file->prefetch  = NULL;
+  ecl_file->pack      = NULL;
   return ecl_file;
 }
 
@@ -442,6 +449,20 @@ ecl_kw_type * ecl_file_iget_named_kw( const ecl_file_type * file , const char *
   return ecl_file_view_iget_named_kw( file->active_view , kw , ith);
 }
 
+
+/*
+  As ecl_file_iget_named_kw(), but the keyword is pinned so that it
+  is not dropped because of the limit set with
+  ecl_file_set_max_kw_bytes(); the call must be balanced with
+  ecl_file_unpin_kw(). For files opened with ECL_FILE_THREAD_SAFE the
+  keyword is pinned atomically with the lookup, so that it can not be
+  evicted by another thread before it is pinned.
+*/
+
+ecl_kw_type * ecl_file_iget_named_kw_pinned( const ecl_file_type * file , const char * kw, int ith) {
+  return ecl_file_view_iget_named_kw_pinned( file->active_view , kw , ith);
+}
+
 void ecl_file_indexed_read(const ecl_file_type * file , const char * kw, int index, const int_vector_type * index_map, char* buffer) {
     ecl_file_view_index_fload_kw(file->active_view, kw, index, index_map, buffer);
 }
@@ -557,12 +578,176 @@ static bool ecl_file_scan( ecl_file_type * ecl_file ) {
 }
 
 
+/*
+  The keyword index of a file can be stored in a separate index file
+  with ecl_file_write_index(), and later be loaded by ecl_file_open()
+  when the ECL_FILE_INDEX flag is set; for large files, in particular
+  on network storage, this is much faster than ecl_file_scan(). The
+  index file is written in native byte order and has the layout:
+
+     ECL_FILE_INDEX_ID       : int
+     ECL_FILE_INDEX_VERSION  : int
+     size of the data file   : int64_t
+     mtime of the data file  : int64_t
+     number of keywords      : int
+     keywords                : num_kw * ECL_FILE_KW_INDEX_SIZE bytes
+
+  The index file is only used when the size and modification time of
+  the data file are equal to the values stored in the index; i.e. an
+  index file is automatically invalidated when e.g. new report steps
+  are appended to a restart file.
+*/
+
+#define ECL_FILE_INDEX_ID      660517
+#define ECL_FILE_INDEX_VERSION 1
+
+
+char * ecl_file_alloc_index_filename( const char * filename ) {
+  return util_alloc_sprintf("%s.index" , filename );
+}
+
+
+static void ecl_file_index_buffer_store_header( const char * filename , buffer_type * buffer ) {
+  int64_t file_size = util_file_size( filename );
+  int64_t mtime     = util_file_mtime( filename );
+
+  buffer_fwrite_int( buffer , ECL_FILE_INDEX_ID );
+  buffer_fwrite_int( buffer , ECL_FILE_INDEX_VERSION );
+  buffer_fwrite( buffer , &file_size , sizeof file_size , 1 );
+  buffer_fwrite( buffer , &mtime , sizeof mtime , 1 );
+}
+
+
+/**
+   Will write the keyword index of @ecl_file to the file
+   @index_filename; returns false if the index file could not be
+   written. Observe that the index describes the complete file,
+   irrespective of the currently active view.
+
+   The index is written to a temporary file in the same directory
+   which is renamed to @index_filename, so a process opening the data
+   file concurrently sees either the old index or the complete new
+   one, never a partially written file. The directory is not created;
+   if it does not exist false is returned.
+*/
+
+bool ecl_file_write_index( const ecl_file_type * ecl_file , const char * index_filename ) {
+  bool write_ok = false;
+  char * path;
+  char * basename;
+  char * tmp_file = NULL;
+  FILE * stream = NULL;
+
+  util_alloc_file_components( index_filename , &path , &basename , NULL );
+  if (util_is_directory( path ? path : "." )) {
+    tmp_file = util_alloc_tmp_file( path ? path : "." , basename , true );
+    stream = fopen( tmp_file , "w");
+  }
+
+  if (stream) {
+    buffer_type * buffer = buffer_alloc( 1024 );
+
+    ecl_file_index_buffer_store_header( ecl_file_get_src_file( ecl_file ) , buffer );
+    ecl_file_view_buffer_store( ecl_file->global_view , buffer );
+    write_ok = (buffer_stream_fwrite_n( buffer , 0 , buffer_get_size( buffer ) , stream ) == buffer_get_size( buffer ));
+    write_ok = (fclose( stream ) == 0) && write_ok;
+    buffer_free( buffer );
+
+    if (write_ok)
+      write_ok = (rename( tmp_file , index_filename ) == 0);
+
+    if (!write_ok)
+      remove( tmp_file );
+  }
+  free( tmp_file );
+  free( basename );
+  free( path );
+  return write_ok;
+}
+
+
+/*
+  Will load the global view from the index file; the complete index
+  file is read in one operation. Returns false if the index file is
+  not present, is not consistent, or does not describe the current
+  content of the data file.
+*/
+
+static bool ecl_file_load_index( ecl_file_type * ecl_file , const char * index_filename ) {
+  bool load_ok = false;
+  if (util_file_readable( index_filename )) {
+    buffer_type * buffer = buffer_fread_alloc( index_filename );
+    buffer_type * header = buffer_alloc( 32 );
+
+    ecl_file_index_buffer_store_header( ecl_file_get_src_file( ecl_file ) , header );
+    if (buffer_get_size( buffer ) >= buffer_get_size( header )) {
+      if (memcmp( buffer_get_data( buffer ) , buffer_get_data( header ) , buffer_get_size( header )) == 0) {
+        buffer_fseek( buffer , buffer_get_size( header ) , SEEK_SET );
+        load_ok = ecl_file_view_buffer_load( ecl_file->global_view , buffer );
+      }
+    }
+
+    buffer_free( header );
+    buffer_free( buffer );
+  }
+  return load_ok;
+}
+
+
 void ecl_file_select_global( ecl_file_type * ecl_file ) {
   ecl_file->active_view = ecl_file->global_view;
 }
 
 
 
+/*
+  Files created with the ecl_pack_writer are recognized from the
+  ECL_PACKED_FILE_SUFFIX suffix of the name, or from the magic
+  number for packed files with other names. They are opened from the
+  keyword index stored in the file, and the keywords are uncompressed when
+  they are loaded. Packed files can not be opened with
+  ECL_FILE_WRITABLE, and the ECL_FILE_MMAP, ECL_FILE_INDEX and
+  ECL_FILE_THREAD_SAFE flags are ignored. The fortio instance is only
+  retained for the filename.
+*/
+
+static ecl_file_type * ecl_file_open_packed( const char * filename , int flags ) {
+  ecl_file_type * ecl_file = NULL;
+
+  if (ecl_file_view_check_flags( flags , ECL_FILE_WRITABLE ))
+    return NULL;
+
+  {
+    ecl_pack_type * pack = ecl_pack_open( filename );
+    if (pack) {
+      buffer_type * buffer = ecl_pack_alloc_kw_index( pack );
+      bool open_ok = false;
+
+      flags &= ~(ECL_FILE_MMAP + ECL_FILE_INDEX + ECL_FILE_THREAD_SAFE + ECL_FILE_CLOSE_STREAM);
+      ecl_file = ecl_file_alloc_empty( flags );
+      ecl_file->pack = pack;
+      ecl_file->fortio = fortio_open_reader( filename , false , ECL_ENDIAN_FLIP );
+      ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
+      ecl_file_view_set_pack( ecl_file->global_view , pack );
+
+      if (buffer) {
+        open_ok = ecl_file_view_buffer_load( ecl_file->global_view , buffer );
+        buffer_free( buffer );
+      }
+
+      if (open_ok && ecl_file->fortio) {
+        ecl_file_select_global( ecl_file );
+        fortio_fclose_stream( ecl_file->fortio );
+      } else {
+        ecl_file_close( ecl_file );
+        ecl_file = NULL;
+      }
+    }
+  }
+  return ecl_file;
+}
+
+
 /**
    The fundamental open file function; all alternative open()
    functions start by calling this one. This function will read
@@ -579,6 +764,9 @@ ecl_file_type * ecl_file_open( const char * filename , int flags) {
   fortio_type * fortio;
   bool          fmt_file;
 
+  if (ecl_util_packed_file( filename ) || ecl_pack_is_packed_file( filename ))
+    return ecl_file_open_packed( filename , flags );
+
   ecl_util_fmt_file( filename , &fmt_file);
 
   if (ecl_file_view_check_flags(flags , ECL_FILE_WRITABLE))
@@ -588,12 +776,39 @@ ecl_file_type * ecl_file_open( const char * filename , int flags) {
 
   if (fortio) {
     ecl_file_type * ecl_file = ecl_file_alloc_empty( flags );
+    bool open_ok;
+
+    if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_THREAD_SAFE)) {
+      if (!ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_WRITABLE) && inv_map_enable_locking( ecl_file->inv_view ))
+        ecl_file->flags &= ~ECL_FILE_CLOSE_STREAM;
+      else
+        ecl_file->flags &= ~ECL_FILE_THREAD_SAFE;
+    }
+
     ecl_file->fortio = fortio;
     ecl_file->global_view = ecl_file_view_alloc( ecl_file->fortio , &ecl_file->flags , ecl_file->inv_view , true );
+    ecl_file_view_set_prefetch_ref( ecl_file->global_view , &ecl_file->prefetch );
+
+    if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_INDEX)) {
+      char * index_filename = ecl_file_alloc_index_filename( filename );
+      open_ok = ecl_file_load_index( ecl_file , index_filename );
+      if (!open_ok) {
+        open_ok = ecl_file_scan( ecl_file );
+        if (open_ok)
+          ecl_file_write_index( ecl_file , index_filename );
+      }
+      free( index_filename );
+    } else
+      open_ok = ecl_file_scan( ecl_file );
 
-    if (ecl_file_scan( ecl_file )) {
+    if (open_ok) {
       ecl_file_select_global( ecl_file );
 
+      if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_MMAP)) {
+        if (!fmt_file && !ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_WRITABLE))
+          fortio_mmap( ecl_file->fortio );
+      }
+
       if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_CLOSE_STREAM))
         fortio_fclose_stream( ecl_file->fortio );
 
@@ -639,12 +854,15 @@ bool ecl_file_writable( const ecl_file_type * ecl_file ) {
 */
 
 void ecl_file_close(ecl_file_type * ecl_file) {
+  ecl_file_disable_prefetch( ecl_file );
   if (ecl_file->fortio != NULL)
     fortio_fclose( ecl_file->fortio  );
 
   ecl_file_view_free( ecl_file->global_view );
   inv_map_free( ecl_file->inv_view );
   vector_free( ecl_file->map_stack );
+  if (ecl_file->pack)
+    ecl_pack_free( ecl_file->pack );
   free( ecl_file );
 }
 
@@ -663,12 +881,153 @@ void ecl_file_close_fortio_stream(ecl_file_type * ecl_file) {
    already, but if you try on-demand loading of a keyword you will get
    crash-and-burn. To ensure that all keywords are in memory you can
    call ecl_file_load_all() prior to the detach call.
+
+   If the file has been opened with ECL_FILE_MMAP the loaded keywords
+   might reference the mapped memory directly; in that case only the
+   FILE stream is closed, and the memory image is retained until
+   ecl_file_close() is called.
 */
 
 
 void ecl_file_fortio_detach( ecl_file_type * ecl_file ) {
-  fortio_fclose( ecl_file->fortio );
-  ecl_file->fortio = NULL;
+  ecl_file_disable_prefetch( ecl_file );
+  if (fortio_is_mapped( ecl_file->fortio ))
+    fortio_fclose_stream( ecl_file->fortio );
+  else {
+    fortio_fclose( ecl_file->fortio );
+    ecl_file->fortio = NULL;
+  }
+}
+
+
+/**
+   Will start a worker thread which reads restart keywords ahead of
+   time. Each time a restart block is selected with
+   ecl_file_get_restart_view(), the keywords in that block and in the
+   following @num_blocks blocks are queued for loading by the worker
+   thread, and when the keywords are accessed they are taken from the
+   worker instead of being read from the file. If @kw_list is
+   different from NULL only the keywords in @kw_list are
+   prefetched. The memory used by prefetched keywords which have not
+   yet been accessed is limited to @max_bytes; prefetched keywords
+   which are skipped by the reader are dropped when a keyword after
+   them in the file is accessed.
+
+   Prefetching is only supported for binary files which are not
+   opened with ECL_FILE_WRITABLE, ECL_FILE_MMAP or ECL_FILE_THREAD_SAFE, which are not
+   packed with ecl_pack_writer, and only on
+   platforms with pthreads; the function will return false if the
+   prefetching could not be started.
+*/
+
+bool ecl_file_enable_prefetch( ecl_file_type * ecl_file , int num_blocks , const stringlist_type * kw_list , size_t max_bytes ) {
+  ecl_file_disable_prefetch( ecl_file );
+
+  if ((ecl_file->fortio == NULL) || (ecl_file->pack != NULL))
+    return false;
+
+  if (fortio_fmt_file( ecl_file->fortio ) || fortio_is_mapped( ecl_file->fortio ))
+    return false;
+
+  if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_WRITABLE ) ||
+      ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_THREAD_SAFE ))
+    return false;
+
+  ecl_file->prefetch = ecl_file_prefetch_alloc( fortio_filename_ref( ecl_file->fortio ) , num_blocks , kw_list , max_bytes );
+  return (ecl_file->prefetch != NULL);
+}
+
+
+void ecl_file_disable_prefetch( ecl_file_type * ecl_file ) {
+  if (ecl_file->prefetch) {
+    ecl_file_prefetch_free( ecl_file->prefetch );
+    ecl_file->prefetch = NULL;
+  }
+}
+
+
+/**
+   Will limit the memory used by the keywords loaded from the file to
+   @max_bytes; when the limit is exceeded the least recently released
+   keywords are dropped from memory, and reloaded from the file if
+   they are accessed again. A @max_bytes value of zero removes the
+   limit.
+
+   Only keywords which have been released with ecl_file_release_kw()
+   are dropped; an ecl_kw pointer returned by e.g. ecl_file_iget_kw()
+   stays valid until it is released, so the limit is exceeded if the
+   keywords which have not been released use more memory than
+   @max_bytes. To scan through a large restart file with bounded
+   memory the keywords of each report step should be released when
+   the step has been processed:
+
+      ecl_file_set_max_kw_bytes( restart_file , 1000000000 );
+      for (int step = 0; step < num_steps; step++) {
+         ecl_kw_type * pressure = ecl_file_iget_named_kw( restart_file , "PRESSURE" , step );
+         ...
+         ecl_file_release_kw( restart_file , pressure );
+      }
+
+   Keywords which use the memory of a file opened with ECL_FILE_MMAP
+   directly, without a copy, are not counted and never dropped; the
+   operating system pages the mapped memory in and out on its own.
+   On little endian hosts the big endian data of ECLIPSE files is
+   always copied, and then counts like any other loaded keyword.
+
+   The loaded keywords of a file opened with ECL_FILE_WRITABLE might
+   have been modified in memory, and can therefor not be dropped; the
+   function will return false for such files.
+*/
+
+bool ecl_file_set_max_kw_bytes( ecl_file_type * ecl_file , size_t max_bytes ) {
+  if (ecl_file_view_check_flags( ecl_file->flags , ECL_FILE_WRITABLE ))
+    return false;
+
+  inv_map_set_max_bytes( ecl_file->inv_view , max_bytes );
+  return true;
+}
+
+
+size_t ecl_file_get_max_kw_bytes( const ecl_file_type * ecl_file ) {
+  return inv_map_get_max_bytes( ecl_file->inv_view );
+}
+
+
+size_t ecl_file_get_loaded_kw_bytes( const ecl_file_type * ecl_file ) {
+  return inv_map_get_used_bytes( ecl_file->inv_view );
+}
+
+
+/*
+  A pinned keyword is never dropped because of the limit set with
+  ecl_file_set_max_kw_bytes(), even if it has been released. The
+  calls to ecl_file_pin_kw() and ecl_file_unpin_kw() must be
+  balanced. For files opened with ECL_FILE_THREAD_SAFE another thread
+  might evict the keyword between the lookup and the call to
+  ecl_file_pin_kw(); use ecl_file_iget_named_kw_pinned() instead.
+*/
+
+void ecl_file_pin_kw( ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw ) {
+  inv_map_pin_kw( ecl_file->inv_view , ecl_kw );
+}
+
+
+void ecl_file_unpin_kw( ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw ) {
+  inv_map_unpin_kw( ecl_file->inv_view , ecl_kw );
+}
+
+
+/*
+  Tells the ecl_file that the caller is done with @ecl_kw, which can
+  then be dropped because of the limit set with
+  ecl_file_set_max_kw_bytes(); the @ecl_kw pointer must not be used
+  after the call. If the keyword is accessed again it is retained
+  until it is released again - or reloaded from the file if it has
+  already been dropped.
+*/
+
+void ecl_file_release_kw( ecl_file_type * ecl_file , const ecl_kw_type * ecl_kw ) {
+  inv_map_release_kw( ecl_file->inv_view , ecl_kw );
 }
 
 
@@ -20,15 +20,27 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 
+#include <ert/util/build_config.h>
 #include <ert/util/size_t_vector.h>
 #include <ert/util/util.h>
+#include <ert/util/buffer.h>
 
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_file_kw.h>
 #include <ert/ecl/fortio.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#ifdef HAVE_PREAD
+#include <unistd.h>
+#endif
+
 /*
   This file implements the datatype ecl_file_kw which is used to hold
   header-information about an ecl_kw instance on file. When a
@@ -39,19 +51,58 @@
   If and when the keyword is actually queried for at a later stage the
   ecl_file_kw_get_kw() method will seek to the keyword position in an
   open fortio instance and call ecl_kw_fread_alloc() to instantiate
-  the keyword itself.
+  the keyword itself. If the fortio instance has been memory mapped
+  with fortio_mmap() the keyword is instead created directly from the
+  mapped memory with ecl_kw_alloc_mmap().
 
   The ecl_file_kw datatype is mainly used by the ecl_file datatype;
   whose index tables consists of ecl_file_kw instances.
+
+  When locking has been enabled with inv_map_enable_locking() all
+  access to the loaded keywords goes through the mutex of the inv_map,
+  which is shared by all the file_kw instances of one file. The mutex
+  is only held while the bookkeeping is updated; the keyword data is
+  read with pread() - or from the mapped memory - without holding the
+  lock, so several threads can load different keywords concurrently.
+  A file_kw which is being loaded is flagged, and other threads asking
+  for the same keyword wait for the load to complete. Formatted files
+  must be read through the shared FILE position, and the lock is then
+  held for the duration of the load. Locking is not available on
+  platforms without pread(); then all binary loads would go through
+  the FILE position as well, and so would the indexed reads of
+  ecl_kw_fread_indexed_data(), which do not take the lock.
 */
 
 
 #define ECL_FILE_KW_TYPE_ID 646107
 
+/*
+  When the inv_map has a memory budget only the keywords which have
+  been released with inv_map_release_kw() can be evicted; the code
+  loading keywords - e.g. the grid, restart header and well loaders -
+  can hold on to any number of keyword pointers without pinning them.
+  The released keywords are kept in a list in least recently released
+  order, and accessing a released keyword removes it from the list
+  again.
+
+  Only the data owned by the keywords counts against the budget; a
+  keyword which uses the memory of a file mapped with ECL_FILE_MMAP
+  directly costs nothing to keep, and is never evicted.
+*/
+
 struct inv_map_struct {
   size_t_vector_type * file_kw_ptr;
   size_t_vector_type * ecl_kw_ptr;
   bool                 sorted;
+  size_t               max_bytes;    /* Memory budget for the loaded keywords; 0 means no limit. */
+  size_t               used_bytes;   /* The sum of data_bytes of the loaded keywords. */
+  ecl_file_kw_type   * lru_head;     /* The most recently released keyword. */
+  ecl_file_kw_type   * lru_tail;     /* The least recently released keyword - the first to be evicted. */
+  bool                 thread_safe;  /* Set by inv_map_enable_locking(). */
+#ifdef HAVE_PTHREAD
+  pthread_mutex_t      mutex;
+  pthread_cond_t       load_cond;    /* Broadcast when a keyword load has completed. */
+#endif
 };
 
 struct ecl_file_kw_struct {
@@ -61,6 +112,12 @@ struct ecl_file_kw_struct {
   int              kw_size;
   char           * header;
   ecl_kw_type    * kw;
+  size_t           data_bytes;       /* The heap memory of kw counted by the inv_map; 0 when the data is shared with a mapped file. */
+  int              pin_count;
+  bool             released;         /* The keyword is in the lru list of the inv_map, and can be evicted. */
+  ecl_file_kw_type * lru_prev;
+  ecl_file_kw_type * lru_next;
+  bool             loading;          /* The keyword is being loaded by another thread. */
 };
 
 
@@ -72,16 +129,68 @@ inv_map_type * inv_map_alloc() {
   map->file_kw_ptr = size_t_vector_alloc( 0 , 0 );
   map->ecl_kw_ptr  = size_t_vector_alloc( 0 , 0 );
   map->sorted = false;
+  map->max_bytes  = 0;
+  map->used_bytes = 0;
+  map->lru_head   = NULL;
+  map->lru_tail   = NULL;
+  map->thread_safe = false;
   return map;
 }
 
 void inv_map_free( inv_map_type * map ) {
+#ifdef HAVE_PTHREAD
+  if (map->thread_safe) {
+    pthread_mutex_destroy( &map->mutex );
+    pthread_cond_destroy( &map->load_cond );
+  }
+#endif
   size_t_vector_free( map->file_kw_ptr );
   size_t_vector_free( map->ecl_kw_ptr );
   free( map );
 }
 
 
+/*
+  Will make the keyword access through this inv_map thread safe; see
+  the comment at the top of the file. Returns false on platforms
+  without pthreads or pread().
+*/
+
+bool inv_map_enable_locking( inv_map_type * map ) {
+#if defined(HAVE_PTHREAD) && defined(HAVE_PREAD)
+  if (!map->thread_safe) {
+    pthread_mutex_init( &map->mutex , NULL );
+    pthread_cond_init( &map->load_cond , NULL );
+    map->thread_safe = true;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+bool inv_map_is_thread_safe( const inv_map_type * map ) {
+  return map->thread_safe;
+}
+
+
+static void inv_map_lock( inv_map_type * map ) {
+#ifdef HAVE_PTHREAD
+  if (map->thread_safe)
+    pthread_mutex_lock( &map->mutex );
+#endif
+}
+
+
+static void inv_map_unlock( inv_map_type * map ) {
+#ifdef HAVE_PTHREAD
+  if (map->thread_safe)
+    pthread_mutex_unlock( &map->mutex );
+#endif
+}
+
+
 static void inv_map_assert_sort( inv_map_type * map ) {
   if (!map->sorted) {
     perm_vector_type * perm = size_t_vector_alloc_sort_perm( map->ecl_kw_ptr );
@@ -90,32 +199,83 @@ static void inv_map_assert_sort( inv_map_type * map ) {
     size_t_vector_permute( map->file_kw_ptr , perm );
     map->sorted = true;
 
-    free( perm );
+    perm_vector_free( perm );
   }
 }
 
-static void inv_map_drop_kw( inv_map_type * map , const ecl_kw_type * ecl_kw) {
+
+static void inv_map_lru_unlink( inv_map_type * map , ecl_file_kw_type * file_kw ) {
+  if (file_kw->lru_prev)
+    file_kw->lru_prev->lru_next = file_kw->lru_next;
+  else
+    map->lru_head = file_kw->lru_next;
+
+  if (file_kw->lru_next)
+    file_kw->lru_next->lru_prev = file_kw->lru_prev;
+  else
+    map->lru_tail = file_kw->lru_prev;
+
+  file_kw->lru_prev = NULL;
+  file_kw->lru_next = NULL;
+  file_kw->released = false;
+}
+
+
+static void inv_map_lru_push( inv_map_type * map , ecl_file_kw_type * file_kw ) {
+  file_kw->lru_prev = NULL;
+  file_kw->lru_next = map->lru_head;
+  if (map->lru_head)
+    map->lru_head->lru_prev = file_kw;
+  else
+    map->lru_tail = file_kw;
+  map->lru_head = file_kw;
+  file_kw->released = true;
+}
+
+
+/*
+  Called when a loaded keyword is accessed; a released keyword is
+  taken out of the lru list, and will not be evicted until it is
+  released again.
+*/
+
+static void inv_map_hold_kw( inv_map_type * map , ecl_file_kw_type * file_kw ) {
+  if (file_kw->released)
+    inv_map_lru_unlink( map , file_kw );
+}
+
+
+static void inv_map_drop_kw( inv_map_type * map , ecl_file_kw_type * file_kw , const ecl_kw_type * ecl_kw) {
+  inv_map_hold_kw( map , file_kw );
+  map->used_bytes -= file_kw->data_bytes;
+  file_kw->data_bytes = 0;
   inv_map_assert_sort( map );
   {
     int index = size_t_vector_index_sorted( map->ecl_kw_ptr , (size_t) ecl_kw );
     if (index == -1)
       util_abort("%s: trying to drop non-existent kw \n",__func__);
 
+    /* Removing an element does not change the ordering of the remaining elements. */
     size_t_vector_idel( map->ecl_kw_ptr  , index );
     size_t_vector_idel( map->file_kw_ptr , index );
-    map->sorted = false;
   }
 }
 
 
-static void inv_map_add_kw( inv_map_type * map , const ecl_file_kw_type * file_kw , const ecl_kw_type * ecl_kw) {
+static void inv_map_add_kw( inv_map_type * map , ecl_file_kw_type * file_kw , const ecl_kw_type * ecl_kw) {
   size_t_vector_append( map->file_kw_ptr , (size_t) file_kw );
   size_t_vector_append( map->ecl_kw_ptr  , (size_t) ecl_kw );
   map->sorted = false;
+
+  if (ecl_kw_data_is_shared( ecl_kw ))
+    file_kw->data_bytes = 0;
+  else
+    file_kw->data_bytes = (size_t) file_kw->kw_size * ecl_util_get_sizeof_ctype( file_kw->ecl_type );
+  map->used_bytes += file_kw->data_bytes;
 }
 
 
-ecl_file_kw_type * inv_map_get_file_kw( inv_map_type * inv_map , const ecl_kw_type * ecl_kw ) {
+static ecl_file_kw_type * inv_map_get_file_kw__( inv_map_type * inv_map , const ecl_kw_type * ecl_kw ) {
   inv_map_assert_sort( inv_map );
   {
     int index = size_t_vector_index_sorted( inv_map->ecl_kw_ptr , (size_t) ecl_kw );
@@ -128,6 +288,17 @@ ecl_file_kw_type * inv_map_get_file_kw( inv_map_type * inv_map , const ecl_kw_ty
 }
 
 
+ecl_file_kw_type * inv_map_get_file_kw( inv_map_type * inv_map , const ecl_kw_type * ecl_kw ) {
+  ecl_file_kw_type * file_kw;
+
+  inv_map_lock( inv_map );
+  file_kw = inv_map_get_file_kw__( inv_map , ecl_kw );
+  inv_map_unlock( inv_map );
+
+  return file_kw;
+}
+
+
 /*****************************************************************/
 
 static UTIL_SAFE_CAST_FUNCTION( ecl_file_kw , ECL_FILE_KW_TYPE_ID )
@@ -144,6 +315,12 @@ static ecl_file_kw_type * ecl_file_kw_alloc__( const char * header , ecl_type_en
   file_kw->ecl_type = ecl_type;
   file_kw->file_offset = offset;
   file_kw->kw = NULL;
+  file_kw->data_bytes = 0;
+  file_kw->pin_count = 0;
+  file_kw->released = false;
+  file_kw->lru_prev = NULL;
+  file_kw->lru_next = NULL;
+  file_kw->loading = false;
 
   return file_kw;
 }
@@ -206,30 +383,227 @@ static void ecl_file_kw_assert_kw( const ecl_file_kw_type * file_kw ) {
 
 static void ecl_file_kw_drop_kw( ecl_file_kw_type * file_kw , inv_map_type * inv_map ) {
   if (file_kw->kw != NULL) {
-    inv_map_drop_kw( inv_map , file_kw->kw );
+    inv_map_drop_kw( inv_map , file_kw , file_kw->kw );
     ecl_kw_free( file_kw->kw );
     file_kw->kw = NULL;
   }
 }
 
 
-static void ecl_file_kw_load_kw( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map) {
+/*
+  Will drop the least recently released keywords until the total size
+  of the loaded keywords is within the budget of the inv_map; pinned
+  keywords are retained even if they have been released. Keywords
+  which have not been released are never dropped, so the budget is
+  exceeded when they alone use more memory than the budget. Keywords
+  sharing the data of a mapped file would not free anything, and are
+  retained.
+*/
+
+static void inv_map_evict( inv_map_type * map ) {
+  ecl_file_kw_type * file_kw = map->lru_tail;
+
+  while ((map->max_bytes > 0) && (map->used_bytes > map->max_bytes) && file_kw) {
+    ecl_file_kw_type * prev = file_kw->lru_prev;
+    if ((file_kw->pin_count == 0) && (file_kw->data_bytes > 0))
+      ecl_file_kw_drop_kw( file_kw , map );
+
+    file_kw = prev;
+  }
+}
+
+
+/*
+  Sets the memory budget for the keywords loaded through this inv_map;
+  when the budget is exceeded the least recently released keywords
+  will be dropped, and subsequently reloaded from file if they are
+  accessed again. A @max_bytes value of zero means no limit.
+*/
+
+void inv_map_set_max_bytes( inv_map_type * map , size_t max_bytes ) {
+  inv_map_lock( map );
+  map->max_bytes = max_bytes;
+  inv_map_evict( map );
+  inv_map_unlock( map );
+}
+
+
+size_t inv_map_get_max_bytes( const inv_map_type * map ) {
+  return map->max_bytes;
+}
+
+
+size_t inv_map_get_used_bytes( inv_map_type * map ) {
+  size_t used_bytes;
+
+  inv_map_lock( map );
+  used_bytes = map->used_bytes;
+  inv_map_unlock( map );
+
+  return used_bytes;
+}
+
+
+/*
+  A pinned keyword is never dropped because of the memory budget of
+  the inv_map; the calls to inv_map_pin_kw() and inv_map_unpin_kw()
+  must be balanced. Will fail hard if @ecl_kw has not been loaded
+  through this inv_map.
+*/
+
+static ecl_file_kw_type * inv_map_get_loaded_file_kw( inv_map_type * map , const ecl_kw_type * ecl_kw ) {
+  ecl_file_kw_type * file_kw = inv_map_get_file_kw__( map , ecl_kw );
+  if (file_kw == NULL)
+    util_abort("%s: keyword:%s has not been loaded from this file \n",__func__ , ecl_kw_get_header( ecl_kw ));
+  return file_kw;
+}
+
+
+void inv_map_pin_kw( inv_map_type * map , const ecl_kw_type * ecl_kw ) {
+  inv_map_lock( map );
+  inv_map_get_loaded_file_kw( map , ecl_kw )->pin_count++;
+  inv_map_unlock( map );
+}
+
+
+void inv_map_unpin_kw( inv_map_type * map , const ecl_kw_type * ecl_kw ) {
+  inv_map_lock( map );
+  {
+    ecl_file_kw_type * file_kw = inv_map_get_loaded_file_kw( map , ecl_kw );
+    if (file_kw->pin_count == 0)
+      util_abort("%s: keyword:%s is not pinned \n",__func__ , file_kw->header);
+    file_kw->pin_count--;
+  }
+  inv_map_evict( map );
+  inv_map_unlock( map );
+}
+
+
+/*
+  Tells the inv_map that the caller is done with @ecl_kw; the keyword
+  can then be dropped because of the memory budget, and the @ecl_kw
+  pointer must not be used after this call. The keyword is retained
+  again if it is accessed before it has been dropped. Will fail hard
+  if @ecl_kw has not been loaded through this inv_map.
+*/
+
+void inv_map_release_kw( inv_map_type * map , const ecl_kw_type * ecl_kw ) {
+  inv_map_lock( map );
+  {
+    ecl_file_kw_type * file_kw = inv_map_get_loaded_file_kw( map , ecl_kw );
+    inv_map_hold_kw( map , file_kw );
+    inv_map_lru_push( map , file_kw );
+  }
+  inv_map_evict( map );
+  inv_map_unlock( map );
+}
+
+
+#ifdef HAVE_PREAD
+static ecl_kw_type * ecl_file_kw_pread_alloc_kw( const ecl_file_kw_type * file_kw , fortio_type * fortio ) {
+  size_t kw_size = ecl_kw_fortio_size__( file_kw->ecl_type , file_kw->kw_size );
+  char * buffer = util_malloc( kw_size );
+  int fd = fortio_fileno( fortio );
+  ecl_kw_type * ecl_kw = NULL;
+  size_t bytes_read = 0;
+
+  while (bytes_read < kw_size) {
+    ssize_t count = pread( fd , &buffer[bytes_read] , kw_size - bytes_read , file_kw->file_offset + bytes_read );
+    if (count <= 0)
+      break;
+    bytes_read += count;
+  }
+
+  if (bytes_read == kw_size)
+    ecl_kw = ecl_kw_alloc_memory_copy( buffer , kw_size );
+
+  free( buffer );
+  return ecl_kw;
+}
+#endif
+
+
+/*
+  Returns true if the keyword can be instantiated without using the
+  FILE position of @fortio, i.e. from the mapped memory or with
+  pread(). A keyword beyond the end of the mapping, e.g. appended
+  after the file was mapped, must be read with pread().
+*/
+
+static bool ecl_file_kw_positional_load( const ecl_file_kw_type * file_kw , fortio_type * fortio ) {
+  if (fortio == NULL)
+    return false;
+
+  if (fortio_mmap_ptr( fortio , file_kw->file_offset ))
+    return true;
+
+#ifdef HAVE_PREAD
+  return !fortio_fmt_file( fortio );
+#else
+  return false;
+#endif
+}
+
+
+/*
+  Will instantiate the keyword from @fortio; the file_kw and the
+  inv_map are not updated. When @positional is true the FILE position
+  of @fortio is not used, see ecl_file_kw_positional_load().
+*/
+
+static ecl_kw_type * ecl_file_kw_fread_alloc_kw( const ecl_file_kw_type * file_kw , fortio_type * fortio , bool positional) {
+  ecl_kw_type * ecl_kw;
+
   if (fortio == NULL)
     util_abort("%s: trying to load a keyword after the backing file has been detached.\n",__func__);
 
+  {
+    char * mmap_ptr = fortio_mmap_ptr( fortio , file_kw->file_offset );
+    if (mmap_ptr)
+      ecl_kw = ecl_kw_alloc_mmap( mmap_ptr , fortio_mmap_size( fortio ) - file_kw->file_offset );
+#ifdef HAVE_PREAD
+    else if (positional)
+      ecl_kw = ecl_file_kw_pread_alloc_kw( file_kw , fortio );
+#endif
+    else {
+      fortio_fseek( fortio , file_kw->file_offset , SEEK_SET );
+      ecl_kw = ecl_kw_fread_alloc( fortio );
+    }
+  }
+
+  if (ecl_kw == NULL)
+    util_abort("%s: failed to load keyword:%s from:%s \n",__func__ , file_kw->header , fortio_filename_ref( fortio ));
+
+  return ecl_kw;
+}
+
+
+static void ecl_file_kw_install_kw( ecl_file_kw_type * file_kw , ecl_kw_type * ecl_kw , inv_map_type * inv_map ) {
   if (file_kw->kw != NULL)
     ecl_file_kw_drop_kw( file_kw , inv_map );
 
-  {
-    fortio_fseek( fortio , file_kw->file_offset , SEEK_SET );
-    file_kw->kw = ecl_kw_fread_alloc( fortio );
-    ecl_file_kw_assert_kw( file_kw );
-    inv_map_add_kw( inv_map , file_kw , file_kw->kw );
-  }
+  file_kw->kw = ecl_kw;
+  ecl_file_kw_assert_kw( file_kw );
+  inv_map_add_kw( inv_map , file_kw , file_kw->kw );
+  inv_map_evict( inv_map );
 }
 
+
 ecl_kw_type * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map ) {
-  return file_kw->kw;
+  ecl_kw_type * ecl_kw;
+
+  inv_map_lock( inv_map );
+  ecl_kw = file_kw->kw;
+  if (ecl_kw != NULL)
+    inv_map_hold_kw( inv_map , file_kw );
+  inv_map_unlock( inv_map );
+
+  return ecl_kw;
+}
+
+
+bool ecl_file_kw_is_loaded( const ecl_file_kw_type * file_kw ) {
+  return (file_kw->kw != NULL);
 }
 
 /*
@@ -247,11 +621,70 @@ ecl_kw_type * ecl_file_kw_get_kw_ptr( ecl_file_kw_type * file_kw , fortio_type *
 */
 
 
-ecl_kw_type * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map ) {
+static ecl_kw_type * ecl_file_kw_get_kw__( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map , bool pin) {
+  ecl_kw_type * ecl_kw;
+  inv_map_lock( inv_map );
+
+#ifdef HAVE_PTHREAD
+  if (inv_map->thread_safe) {
+    while (file_kw->loading)
+      pthread_cond_wait( &inv_map->load_cond , &inv_map->mutex );
+
+    if ((file_kw->kw == NULL) && ecl_file_kw_positional_load( file_kw , fortio )) {
+      file_kw->loading = true;
+      inv_map_unlock( inv_map );
+
+      ecl_kw = ecl_file_kw_fread_alloc_kw( file_kw , fortio , true );
+
+      inv_map_lock( inv_map );
+      file_kw->loading = false;
+      ecl_file_kw_install_kw( file_kw , ecl_kw , inv_map );
+      pthread_cond_broadcast( &inv_map->load_cond );
+    }
+  }
+#endif
+
   if (file_kw->kw == NULL)
-    ecl_file_kw_load_kw( file_kw , fortio , inv_map);
+    ecl_file_kw_install_kw( file_kw , ecl_file_kw_fread_alloc_kw( file_kw , fortio , false ) , inv_map );
+  else
+    inv_map_hold_kw( inv_map , file_kw );
+
+  if (pin)
+    file_kw->pin_count++;
+
+  ecl_kw = file_kw->kw;
+  inv_map_unlock( inv_map );
+  return ecl_kw;
+}
+
 
-  return file_kw->kw;
+ecl_kw_type * ecl_file_kw_get_kw( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map ) {
+  return ecl_file_kw_get_kw__( file_kw , fortio , inv_map , false );
+}
+
+
+/*
+  As ecl_file_kw_get_kw(), but the keyword is also pinned while the
+  lock of the inv_map is held, so that it can not be evicted by
+  another thread before the caller has pinned it. Must be balanced
+  with a call to inv_map_unpin_kw().
+*/
+
+ecl_kw_type * ecl_file_kw_get_kw_pinned( ecl_file_kw_type * file_kw , fortio_type * fortio , inv_map_type * inv_map ) {
+  return ecl_file_kw_get_kw__( file_kw , fortio , inv_map , true );
+}
+
+
+/*
+  Will install @ecl_kw, which has been loaded by other means than
+  ecl_file_kw_get_kw() - e.g. by the ecl_file_prefetch thread - as the
+  keyword of this file_kw. The file_kw takes ownership of @ecl_kw.
+*/
+
+void ecl_file_kw_set_kw( ecl_file_kw_type * file_kw , ecl_kw_type * ecl_kw , inv_map_type * inv_map ) {
+  inv_map_lock( inv_map );
+  ecl_file_kw_install_kw( file_kw , ecl_kw , inv_map );
+  inv_map_unlock( inv_map );
 }
 
 
@@ -302,6 +735,52 @@ bool ecl_file_kw_fskip_data( const ecl_file_kw_type * file_kw , fortio_type * fo
 }
 
 
+/*
+  The functions ecl_file_kw_buffer_store() and ecl_file_kw_buffer_alloc()
+  are used to save and restore the header information of an
+  ecl_file_kw instance from a keyword index file, see
+  ecl_file_write_index(). All records have the same size of
+  ECL_FILE_KW_INDEX_SIZE bytes:
+
+     header   : 8 bytes, padded with '\0'
+     type     : int
+     size     : int
+     offset   : int64_t
+*/
+
+void ecl_file_kw_buffer_store( const ecl_file_kw_type * file_kw , buffer_type * buffer) {
+  char header[ECL_STRING8_LENGTH];
+  int64_t offset = file_kw->file_offset;
+
+  memset( header , 0 , ECL_STRING8_LENGTH );
+  memcpy( header , file_kw->header , util_int_min( strlen( file_kw->header ) , ECL_STRING8_LENGTH ));
+
+  buffer_fwrite( buffer , header , sizeof header , 1 );
+  buffer_fwrite_int( buffer , file_kw->ecl_type );
+  buffer_fwrite_int( buffer , file_kw->kw_size );
+  buffer_fwrite( buffer , &offset , sizeof offset , 1 );
+}
+
+
+ecl_file_kw_type * ecl_file_kw_buffer_alloc( buffer_type * buffer ) {
+  char header[ECL_STRING8_LENGTH + 1];
+  int64_t offset;
+  ecl_type_enum ecl_type;
+  int size;
+
+  buffer_fread( buffer , header , ECL_STRING8_LENGTH , 1 );
+  header[ECL_STRING8_LENGTH] = '\0';
+  ecl_type = buffer_fread_int( buffer );
+  size = buffer_fread_int( buffer );
+  buffer_fread( buffer , &offset , sizeof offset , 1 );
+
+  if ((ecl_type < ECL_CHAR_TYPE) || (ecl_type > ECL_MESS_TYPE) || (size < 0) || (offset < 0))
+    return NULL;
+
+  return ecl_file_kw_alloc__( header , ecl_type , size , offset );
+}
+
+
 /**
    This function will replace the file content of the keyword pointed
    to by @file_kw, with the new content given by @ecl_kw. The new
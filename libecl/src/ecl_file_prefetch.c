@@ -0,0 +1,441 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_prefetch.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/build_config.h>
+#include <ert/util/util.h>
+#include <ert/util/vector.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_file_prefetch.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+/*
+  The ecl_file_prefetch datatype implements a worker thread which
+  reads keywords from a binary ECLIPSE file ahead of time. The
+  ecl_file layer registers the keywords it expects to need soon with
+  ecl_file_prefetch_add(), and when a keyword is actually needed it
+  is claimed with ecl_file_prefetch_take():
+
+   o If the worker has completed loading the keyword it is returned
+     immediately.
+
+   o If the worker is currently loading the keyword the calling
+     thread waits for it to complete.
+
+   o If the worker has not yet started on the keyword the request is
+     cancelled, and NULL is returned; the caller must then load the
+     keyword itself.
+
+  The worker thread has its own FILE instance, it is therefor
+  independent of the file position, and of opening and closing, of
+  the main fortio instance. The total size of the keywords which have
+  been loaded by the worker, but not yet claimed, is limited by
+  max_bytes; when the budget is exhausted the worker waits until
+  keywords are claimed or dropped with ecl_file_prefetch_drop_before().
+
+  The reader is assumed to move forward through the file; when a
+  keyword is claimed the unclaimed keywords before it have fallen
+  behind the reader, and are dropped to release their part of the
+  budget. The nodes are kept sorted on file offset, and are located
+  with binary search.
+
+  Without pthread support ecl_file_prefetch_alloc() returns NULL.
+*/
+
+
+#define ECL_FILE_PREFETCH_TYPE_ID 661307
+
+typedef enum {
+  PREFETCH_QUEUED  = 1,
+  PREFETCH_LOADING = 2,
+  PREFETCH_READY   = 3,
+  PREFETCH_FAILED  = 4
+} prefetch_state_enum;
+
+
+typedef struct {
+  offset_type          offset;
+  ecl_type_enum        ecl_type;
+  int                  size;
+  size_t               fortio_size;     /* The number of bytes on disk. */
+  size_t               data_size;       /* The number of bytes in memory; this is charged to the budget. */
+  prefetch_state_enum  state;
+  ecl_kw_type        * ecl_kw;
+} prefetch_node_type;
+
+
+struct ecl_file_prefetch_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int                  num_blocks;
+  stringlist_type    * kw_list;
+  size_t               max_bytes;
+  size_t               used_bytes;
+  vector_type        * node_list;       /* Sorted on file offset. */
+  FILE               * stream;
+  bool                 stop;
+#ifdef HAVE_PTHREAD
+  pthread_t            thread;
+  pthread_mutex_t      mutex;
+  pthread_cond_t       work_cond;       /* Signalled when the worker might have something to do. */
+  pthread_cond_t       done_cond;       /* Signalled when the worker has completed a keyword. */
+#endif
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_file_prefetch , ECL_FILE_PREFETCH_TYPE_ID )
+
+
+#ifdef HAVE_PTHREAD
+
+static void prefetch_node_free( prefetch_node_type * node ) {
+  if (node->ecl_kw)
+    ecl_kw_free( node->ecl_kw );
+  free( node );
+}
+
+
+static void prefetch_node_free__( void * arg ) {
+  prefetch_node_free( (prefetch_node_type *) arg );
+}
+
+
+/*
+  The budget is charged when the worker starts loading a keyword, and
+  released when the keyword is claimed or dropped.
+*/
+
+static bool prefetch_node_charged( const prefetch_node_type * node ) {
+  return (node->state != PREFETCH_QUEUED);
+}
+
+
+/*
+  Returns the index of the first node with file offset >= @offset, or
+  the number of nodes if there is no such node.
+*/
+
+static int ecl_file_prefetch_lower_bound( const ecl_file_prefetch_type * prefetch , offset_type offset ) {
+  int lower = 0;
+  int upper = vector_get_size( prefetch->node_list );
+
+  while (lower < upper) {
+    int mid = lower + (upper - lower) / 2;
+    const prefetch_node_type * node = vector_iget_const( prefetch->node_list , mid );
+    if (node->offset < offset)
+      lower = mid + 1;
+    else
+      upper = mid;
+  }
+  return lower;
+}
+
+
+static int ecl_file_prefetch_find_node( const ecl_file_prefetch_type * prefetch , offset_type offset ) {
+  int index = ecl_file_prefetch_lower_bound( prefetch , offset );
+  if (index < vector_get_size( prefetch->node_list )) {
+    const prefetch_node_type * node = vector_iget_const( prefetch->node_list , index );
+    if (node->offset == offset)
+      return index;
+  }
+  return -1;
+}
+
+
+static void ecl_file_prefetch_del_node( ecl_file_prefetch_type * prefetch , int index ) {
+  prefetch_node_type * node = vector_iget( prefetch->node_list , index );
+  if (prefetch_node_charged( node ))
+    prefetch->used_bytes -= node->data_size;
+  vector_idel( prefetch->node_list , index );
+  pthread_cond_signal( &prefetch->work_cond );
+}
+
+
+/*
+  Deletes the nodes before @offset, except the node the worker is
+  currently loading; must be called with the mutex held.
+*/
+
+static void ecl_file_prefetch_del_before( ecl_file_prefetch_type * prefetch , offset_type offset ) {
+  int index = 0;
+  while (index < vector_get_size( prefetch->node_list )) {
+    prefetch_node_type * node = vector_iget( prefetch->node_list , index );
+    if (node->offset >= offset)
+      break;
+
+    if (node->state == PREFETCH_LOADING)
+      index++;
+    else
+      ecl_file_prefetch_del_node( prefetch , index );
+  }
+}
+
+
+/*
+  Returns the first queued node, provided it fits in the budget. A
+  keyword which is larger than the complete budget is loaded when
+  nothing else is held.
+*/
+static prefetch_node_type * ecl_file_prefetch_next_node( ecl_file_prefetch_type * prefetch ) {
+  int index;
+  for (index = 0; index < vector_get_size( prefetch->node_list ); index++) {
+    prefetch_node_type * node = vector_iget( prefetch->node_list , index );
+    if (node->state == PREFETCH_QUEUED) {
+      if ((prefetch->used_bytes == 0) || (prefetch->used_bytes + node->data_size <= prefetch->max_bytes))
+        return node;
+      else
+        return NULL;
+    }
+  }
+  return NULL;
+}
+
+
+static ecl_kw_type * ecl_file_prefetch_load( FILE * stream , const prefetch_node_type * node ) {
+  ecl_kw_type * ecl_kw = NULL;
+  char * buffer = malloc( node->fortio_size );
+
+  if (buffer) {
+    if (util_fseek( stream , node->offset , SEEK_SET ) == 0) {
+      if (fread( buffer , 1 , node->fortio_size , stream ) == node->fortio_size)
+        ecl_kw = ecl_kw_alloc_memory_copy( buffer , node->fortio_size );
+    }
+    free( buffer );
+  }
+  return ecl_kw;
+}
+
+
+static void * ecl_file_prefetch_main( void * arg ) {
+  ecl_file_prefetch_type * prefetch = (ecl_file_prefetch_type *) arg;
+
+  pthread_mutex_lock( &prefetch->mutex );
+  while (!prefetch->stop) {
+    prefetch_node_type * node = ecl_file_prefetch_next_node( prefetch );
+    if (node) {
+      ecl_kw_type * ecl_kw;
+
+      node->state = PREFETCH_LOADING;
+      prefetch->used_bytes += node->data_size;
+      pthread_mutex_unlock( &prefetch->mutex );
+
+      /* The node can not be removed by the other threads while it is in the LOADING state. */
+      ecl_kw = ecl_file_prefetch_load( prefetch->stream , node );
+
+      pthread_mutex_lock( &prefetch->mutex );
+      node->ecl_kw = ecl_kw;
+      node->state = ecl_kw ? PREFETCH_READY : PREFETCH_FAILED;
+      pthread_cond_broadcast( &prefetch->done_cond );
+    } else
+      pthread_cond_wait( &prefetch->work_cond , &prefetch->mutex );
+  }
+  pthread_mutex_unlock( &prefetch->mutex );
+  return NULL;
+}
+
+#endif
+
+
+/**
+   Will create a prefetch instance for the binary file @filename and
+   start the worker thread. The @num_blocks and @kw_list settings are
+   used by the ecl_file_view layer when selecting which keywords to
+   prefetch; if @kw_list is NULL all keywords are prefetched. The
+   @max_bytes argument is the maximum size of the keywords which have
+   been loaded, but not yet claimed.
+
+   Will return NULL if the file can not be opened, or if the platform
+   does not support threads.
+*/
+
+ecl_file_prefetch_type * ecl_file_prefetch_alloc( const char * filename , int num_blocks , const stringlist_type * kw_list , size_t max_bytes ) {
+#ifdef HAVE_PTHREAD
+  FILE * stream = fopen( filename , "rb" );
+  if (stream) {
+    ecl_file_prefetch_type * prefetch = util_malloc( sizeof * prefetch );
+    UTIL_TYPE_ID_INIT( prefetch , ECL_FILE_PREFETCH_TYPE_ID );
+    prefetch->num_blocks = num_blocks;
+    prefetch->kw_list    = kw_list ? stringlist_alloc_deep_copy( kw_list ) : NULL;
+    prefetch->max_bytes  = max_bytes;
+    prefetch->used_bytes = 0;
+    prefetch->node_list  = vector_alloc_new();
+    prefetch->stream     = stream;
+    prefetch->stop       = false;
+
+    pthread_mutex_init( &prefetch->mutex , NULL );
+    pthread_cond_init( &prefetch->work_cond , NULL );
+    pthread_cond_init( &prefetch->done_cond , NULL );
+    if (pthread_create( &prefetch->thread , NULL , ecl_file_prefetch_main , prefetch ) == 0)
+      return prefetch;
+
+    pthread_cond_destroy( &prefetch->done_cond );
+    pthread_cond_destroy( &prefetch->work_cond );
+    pthread_mutex_destroy( &prefetch->mutex );
+    vector_free( prefetch->node_list );
+    if (prefetch->kw_list)
+      stringlist_free( prefetch->kw_list );
+    free( prefetch );
+    fclose( stream );
+  }
+#endif
+  return NULL;
+}
+
+
+/*
+  Will stop the worker thread and discard all keywords which have not
+  been claimed.
+*/
+
+void ecl_file_prefetch_free( ecl_file_prefetch_type * prefetch ) {
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock( &prefetch->mutex );
+  prefetch->stop = true;
+  pthread_cond_signal( &prefetch->work_cond );
+  pthread_mutex_unlock( &prefetch->mutex );
+  pthread_join( prefetch->thread , NULL );
+
+  pthread_cond_destroy( &prefetch->done_cond );
+  pthread_cond_destroy( &prefetch->work_cond );
+  pthread_mutex_destroy( &prefetch->mutex );
+#endif
+  vector_free( prefetch->node_list );
+  if (prefetch->kw_list)
+    stringlist_free( prefetch->kw_list );
+  fclose( prefetch->stream );
+  free( prefetch );
+}
+
+
+int ecl_file_prefetch_get_num_blocks( const ecl_file_prefetch_type * prefetch ) {
+  return prefetch->num_blocks;
+}
+
+
+/*
+  Will register @file_kw for loading by the worker thread. Returns
+  false if the keyword is not in the keyword list of the prefetch
+  instance, or if it has already been registered.
+*/
+
+bool ecl_file_prefetch_add( ecl_file_prefetch_type * prefetch , const ecl_file_kw_type * file_kw ) {
+  bool added = false;
+#ifdef HAVE_PTHREAD
+  if (prefetch->kw_list && !stringlist_contains( prefetch->kw_list , ecl_file_kw_get_header( file_kw )))
+    return false;
+
+  pthread_mutex_lock( &prefetch->mutex );
+  {
+    offset_type offset = ecl_file_kw_get_offset( file_kw );
+    if (ecl_file_prefetch_find_node( prefetch , offset ) < 0) {
+      prefetch_node_type * node = util_malloc( sizeof * node );
+      int index = ecl_file_prefetch_lower_bound( prefetch , offset );
+
+      node->offset      = offset;
+      node->ecl_type    = ecl_file_kw_get_type( file_kw );
+      node->size        = ecl_file_kw_get_size( file_kw );
+      node->fortio_size = ecl_kw_fortio_size__( node->ecl_type , node->size );
+      node->data_size   = (size_t) node->size * ecl_util_get_sizeof_ctype( node->ecl_type );
+      node->state       = PREFETCH_QUEUED;
+      node->ecl_kw      = NULL;
+
+      /* Keep the list sorted on offset so the worker reads the file sequentially. */
+      vector_insert_owned_ref( prefetch->node_list , index , node , prefetch_node_free__ );
+      pthread_cond_signal( &prefetch->work_cond );
+      added = true;
+    }
+  }
+  pthread_mutex_unlock( &prefetch->mutex );
+#endif
+  return added;
+}
+
+
+/*
+  Will discard all keywords located before @offset in the file, both
+  the keywords which have been loaded and those which are still
+  queued. This is used when a caller has moved on to a later part of
+  the file, so the keywords before that point will presumably not be
+  claimed.
+*/
+
+void ecl_file_prefetch_drop_before( ecl_file_prefetch_type * prefetch , offset_type offset ) {
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock( &prefetch->mutex );
+  ecl_file_prefetch_del_before( prefetch , offset );
+  pthread_mutex_unlock( &prefetch->mutex );
+#endif
+}
+
+
+/*
+  Will return the prefetched keyword corresponding to @file_kw, and
+  the calling scope takes ownership. Returns NULL if the keyword has
+  not been prefetched. When @file_kw has been registered the keywords
+  before it which have not been claimed are dropped; a caller reading
+  keywords out of file order will load the skipped keywords the
+  ordinary way.
+*/
+
+ecl_kw_type * ecl_file_prefetch_take( ecl_file_prefetch_type * prefetch , const ecl_file_kw_type * file_kw ) {
+  ecl_kw_type * ecl_kw = NULL;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock( &prefetch->mutex );
+  {
+    offset_type offset = ecl_file_kw_get_offset( file_kw );
+    int index = ecl_file_prefetch_find_node( prefetch , offset );
+    while (index >= 0) {
+      prefetch_node_type * node = vector_iget( prefetch->node_list , index );
+      if (node->state != PREFETCH_LOADING) {
+        ecl_kw = node->ecl_kw;
+        node->ecl_kw = NULL;
+        ecl_file_prefetch_del_node( prefetch , index );
+        ecl_file_prefetch_del_before( prefetch , offset );
+        break;
+      }
+
+      pthread_cond_wait( &prefetch->done_cond , &prefetch->mutex );
+      /* The node list might have been modified while waiting. */
+      index = ecl_file_prefetch_find_node( prefetch , offset );
+    }
+  }
+  pthread_mutex_unlock( &prefetch->mutex );
+#endif
+  return ecl_kw;
+}
+
+
+size_t ecl_file_prefetch_get_used_bytes( ecl_file_prefetch_type * prefetch ) {
+  size_t used_bytes = 0;
+#ifdef HAVE_PTHREAD
+  pthread_mutex_lock( &prefetch->mutex );
+  used_bytes = prefetch->used_bytes;
+  pthread_mutex_unlock( &prefetch->mutex );
+#endif
+  return used_bytes;
+}
@@ -17,9 +17,12 @@
 */
 
 
+#include <string.h>
+
 #include <ert/util/vector.h>
 #include <ert/util/hash.h>
 #include <ert/util/stringlist.h>
+#include <ert/util/buffer.h>
 
 #include <ert/ecl/fortio.h>
 #include <ert/ecl/ecl_kw.h>
@@ -27,6 +30,7 @@
 #include <ert/ecl/ecl_file_kw.h>
 #include <ert/ecl/ecl_file_view.h>
 #include <ert/ecl/ecl_rsthead.h>
+#include <ert/ecl/ecl_pack.h>
 
 
 struct ecl_file_view_struct {
@@ -38,6 +42,8 @@ struct ecl_file_view_struct {
   inv_map_type      * inv_map;      /* Shared reference owned by the ecl_file structure. */
   vector_type       * child_list;
   int               * flags;
+  ecl_file_prefetch_type ** prefetch;  /* Shared reference to the prefetch pointer in the ecl_file structure; can be NULL. */
+  const ecl_pack_type * pack;          /* Shared reference owned by the ecl_file structure; NULL unless the file is packed. */
 };
 
 
@@ -75,9 +81,73 @@ ecl_file_view_type * ecl_file_view_alloc( fortio_type * fortio , int * flags , i
   ecl_file_view->fortio               = fortio;
   ecl_file_view->inv_map              = inv_map;
   ecl_file_view->flags                = flags;
+  ecl_file_view->prefetch             = NULL;
+  ecl_file_view->pack                 = NULL;
   return ecl_file_view;
 }
 
+
+/*
+  The prefetch reference is inherited by all views created from this
+  view; it should be set on the global view before any other views
+  are created.
+*/
+
+void ecl_file_view_set_prefetch_ref( ecl_file_view_type * ecl_file_view , ecl_file_prefetch_type ** prefetch ) {
+  ecl_file_view->prefetch = prefetch;
+}
+
+
+/*
+  For packed files the keywords are loaded from the ecl_pack instance
+  instead of the fortio instance. Like the prefetch reference the pack
+  reference is inherited by all views created from this view.
+*/
+
+void ecl_file_view_set_pack( ecl_file_view_type * ecl_file_view , const ecl_pack_type * pack ) {
+  ecl_file_view->pack = pack;
+}
+
+
+static ecl_kw_type * ecl_file_view_get_packed_kw( const ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw ) {
+  ecl_kw_type * ecl_kw = ecl_file_kw_get_kw_ptr( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map );
+  if (!ecl_kw) {
+    ecl_kw = ecl_pack_alloc_kw( ecl_file_view->pack , ecl_file_kw_get_offset( file_kw ));
+    if (!ecl_kw)
+      util_abort("%s: failed to load keyword:%s from packed file:%s \n",__func__ , ecl_file_kw_get_header( file_kw ) , fortio_filename_ref( ecl_file_view->fortio ));
+
+    ecl_file_kw_set_kw( file_kw , ecl_kw , ecl_file_view->inv_map );
+  }
+  return ecl_kw;
+}
+
+
+static ecl_file_prefetch_type * ecl_file_view_get_prefetch( const ecl_file_view_type * ecl_file_view ) {
+  if (ecl_file_view->prefetch)
+    return *ecl_file_view->prefetch;
+  else
+    return NULL;
+}
+
+
+/*
+  Will claim the keyword from the prefetch thread, if it has been
+  prefetched; returns NULL if the keyword must be loaded the ordinary
+  way.
+*/
+
+static ecl_kw_type * ecl_file_view_take_prefetched_kw( const ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw ) {
+  ecl_file_prefetch_type * prefetch = ecl_file_view_get_prefetch( ecl_file_view );
+  ecl_kw_type * ecl_kw = NULL;
+
+  if (prefetch) {
+    ecl_kw = ecl_file_prefetch_take( prefetch , file_kw );
+    if (ecl_kw)
+      ecl_file_kw_set_kw( file_kw , ecl_kw , ecl_file_view->inv_map );
+  }
+  return ecl_kw;
+}
+
 int ecl_file_view_get_global_index( const ecl_file_view_type * ecl_file_view , const char * kw , int ith) {
   const int_vector_type * index_vector = hash_get(ecl_file_view->kw_index , kw);
   int global_index = int_vector_iget( index_vector , ith);
@@ -146,11 +216,25 @@ void ecl_file_view_add_flag( ecl_file_view_type * file_view , int flag)  {
 }
 
 
-ecl_kw_type * ecl_file_view_iget_kw( const ecl_file_view_type * ecl_file_view , int index) {
-  ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_view , index );
-  ecl_kw_type * ecl_kw = ecl_file_kw_get_kw_ptr( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map);
+static ecl_kw_type * ecl_file_view_get_kw( const ecl_file_view_type * ecl_file_view , ecl_file_kw_type * file_kw ) {
+  ecl_kw_type * ecl_kw;
+
+  if (ecl_file_view->pack)
+    return ecl_file_view_get_packed_kw( ecl_file_view , file_kw );
+
+  if (ecl_file_view_flags_set( ecl_file_view , ECL_FILE_THREAD_SAFE))
+    /* The stream is never closed in thread safe mode, and ecl_file_kw_get_kw() does the locking. */
+    return ecl_file_kw_get_kw( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map );
+
+  ecl_kw = ecl_file_kw_get_kw_ptr( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map);
+  if (!ecl_kw)
+    ecl_kw = ecl_file_view_take_prefetched_kw( ecl_file_view , file_kw );
+
   if (!ecl_kw) {
-    if (fortio_assert_stream_open( ecl_file_view->fortio )) {
+    if (fortio_is_mapped( ecl_file_view->fortio ))
+      /* The keyword is instantiated from the memory image; no need for the FILE stream. */
+      ecl_kw = ecl_file_kw_get_kw( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map);
+    else if (fortio_assert_stream_open( ecl_file_view->fortio )) {
 
       ecl_kw = ecl_file_kw_get_kw( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map);
 
@@ -161,10 +245,30 @@ ecl_kw_type * ecl_file_view_iget_kw( const ecl_file_view_type * ecl_file_view ,
   return ecl_kw;
 }
 
+
+ecl_kw_type * ecl_file_view_iget_kw( const ecl_file_view_type * ecl_file_view , int index) {
+  ecl_file_kw_type * file_kw = ecl_file_view_iget_file_kw( ecl_file_view , index );
+  return ecl_file_view_get_kw( ecl_file_view , file_kw );
+}
+
 void ecl_file_view_index_fload_kw(const ecl_file_view_type * ecl_file_view, const char* kw, int index, const int_vector_type * index_map, char* buffer) {
     ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw( ecl_file_view , kw , index);
 
-    if (fortio_assert_stream_open( ecl_file_view->fortio )) {
+    if (ecl_file_view->pack) {
+        const ecl_kw_type * ecl_kw = ecl_file_view_get_packed_kw( ecl_file_view , file_kw );
+        ecl_type_enum ecl_type = ecl_kw_get_type( ecl_kw );
+        int element_size = ecl_util_get_sizeof_ctype( ecl_type );
+        int i;
+
+        if (ecl_type == ECL_CHAR_TYPE || ecl_type == ECL_MESS_TYPE)
+            element_size = ECL_STRING8_LENGTH;
+
+        for (i = 0; i < int_vector_size( index_map ); i++)
+            memcpy( &buffer[i * element_size] , ecl_kw_iget_ptr( ecl_kw , int_vector_iget( index_map , i )) , element_size );
+        return;
+    }
+
+    if (fortio_is_mapped( ecl_file_view->fortio ) || fortio_assert_stream_open( ecl_file_view->fortio )) {
         offset_type offset = ecl_file_kw_get_offset(file_kw);
         ecl_type_enum ecl_type = ecl_file_kw_get_type(file_kw);
         int element_count = ecl_file_kw_get_size(file_kw);
@@ -222,16 +326,28 @@ const char * ecl_file_view_iget_header( const ecl_file_view_type * ecl_file_view
 
 ecl_kw_type * ecl_file_view_iget_named_kw( const ecl_file_view_type * ecl_file_view , const char * kw, int ith) {
   ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw( ecl_file_view , kw , ith);
-  ecl_kw_type * ecl_kw = ecl_file_kw_get_kw_ptr( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map );
-  if (!ecl_kw) {
-    if (fortio_assert_stream_open( ecl_file_view->fortio )) {
+  return ecl_file_view_get_kw( ecl_file_view , file_kw );
+}
 
-      ecl_kw = ecl_file_kw_get_kw( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map);
 
-      if (ecl_file_view_flags_set( ecl_file_view , ECL_FILE_CLOSE_STREAM))
-        fortio_fclose_stream( ecl_file_view->fortio );
-    }
-  }
+/*
+  Will return the ith occurence of @kw, pinned so that it is not
+  dropped because of the memory budget of the file; the keyword must
+  be unpinned with inv_map_unpin_kw() when the caller is done with
+  it. In thread safe mode the keyword is pinned atomically with the
+  lookup.
+*/
+
+ecl_kw_type * ecl_file_view_iget_named_kw_pinned( const ecl_file_view_type * ecl_file_view , const char * kw, int ith) {
+  ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw( ecl_file_view , kw , ith);
+  ecl_kw_type * ecl_kw;
+
+  if (!ecl_file_view->pack && ecl_file_view_flags_set( ecl_file_view , ECL_FILE_THREAD_SAFE))
+    return ecl_file_kw_get_kw_pinned( file_kw , ecl_file_view->fortio , ecl_file_view->inv_map );
+
+  /* Without locking there are no other threads which can evict the keyword in between. */
+  ecl_kw = ecl_file_view_get_kw( ecl_file_view , file_kw );
+  inv_map_pin_kw( ecl_file_view->inv_map , ecl_kw );
   return ecl_kw;
 }
 
@@ -273,6 +389,13 @@ void ecl_file_view_replace_kw( ecl_file_view_type * ecl_file_view , ecl_kw_type
 bool ecl_file_view_load_all( ecl_file_view_type * ecl_file_view ) {
   bool loadOK = false;
 
+  if (ecl_file_view->pack) {
+    int index;
+    for (index = 0; index < vector_get_size( ecl_file_view->kw_list); index++)
+      ecl_file_view_get_packed_kw( ecl_file_view , vector_iget( ecl_file_view->kw_list , index ));
+    return true;
+  }
+
   if (fortio_assert_stream_open( ecl_file_view->fortio )) {
     int index;
     for (index = 0; index < vector_get_size( ecl_file_view->kw_list); index++) {
@@ -300,6 +423,55 @@ void ecl_file_view_add_kw( ecl_file_view_type * ecl_file_view , ecl_file_kw_type
     vector_append_ref( ecl_file_view->kw_list , file_kw);
 }
 
+/**
+   Will store the header information of all the keywords in the view
+   in the buffer; this is the payload of the keyword index files
+   created by ecl_file_write_index().
+*/
+
+void ecl_file_view_buffer_store( const ecl_file_view_type * ecl_file_view , buffer_type * buffer ) {
+  int i;
+  buffer_fwrite_int( buffer , vector_get_size( ecl_file_view->kw_list ));
+  for (i=0; i < vector_get_size( ecl_file_view->kw_list ); i++)
+    ecl_file_kw_buffer_store( vector_iget_const( ecl_file_view->kw_list , i ) , buffer );
+}
+
+
+/**
+   Will populate an empty view with the ecl_file_kw instances stored
+   with ecl_file_view_buffer_store(), and build the index. The buffer
+   must be positioned at the start of the keyword list, and the list
+   must extend exactly to the end of the buffer. If the buffer content
+   is not consistent the function will return false and the view is
+   left empty.
+*/
+
+bool ecl_file_view_buffer_load( ecl_file_view_type * ecl_file_view , buffer_type * buffer ) {
+  if (buffer_get_remaining_size( buffer ) < sizeof(int))
+    return false;
+
+  {
+    int num_kw = buffer_fread_int( buffer );
+    if ((num_kw < 0) || (buffer_get_remaining_size( buffer ) != num_kw * ECL_FILE_KW_INDEX_SIZE))
+      return false;
+
+    {
+      int i;
+      for (i=0; i < num_kw; i++) {
+        ecl_file_kw_type * file_kw = ecl_file_kw_buffer_alloc( buffer );
+        if (file_kw == NULL) {
+          vector_clear( ecl_file_view->kw_list );
+          return false;
+        }
+        ecl_file_view_add_kw( ecl_file_view , file_kw );
+      }
+    }
+  }
+  ecl_file_view_make_index( ecl_file_view );
+  return true;
+}
+
+
 void ecl_file_view_free( ecl_file_view_type * ecl_file_view ) {
   vector_free( ecl_file_view->child_list );
   hash_free( ecl_file_view->kw_index );
@@ -371,6 +543,8 @@ ecl_file_view_type * ecl_file_view_alloc_blockview2(const ecl_file_view_type * e
 
 
   ecl_file_view_type * block_map = ecl_file_view_alloc( ecl_file_view->fortio , ecl_file_view->flags , ecl_file_view->inv_map , false);
+  block_map->prefetch = ecl_file_view->prefetch;
+  block_map->pack = ecl_file_view->pack;
   int kw_index = 0;
   if (start_kw)
     kw_index = ecl_file_view_get_global_index( ecl_file_view , start_kw , occurence );
@@ -738,6 +912,45 @@ int ecl_file_view_seqnum_index_from_sim_days( ecl_file_view_type * file_view , d
 
 
 
+/*
+  When prefetching is enabled, the keywords of restart block
+  @seqnum_index and the following num_blocks blocks are registered
+  with the prefetch thread, and the keywords before the block are
+  dropped from the prefetch thread.
+*/
+
+static void ecl_file_view_prefetch_restart( const ecl_file_view_type * file_view , int seqnum_index ) {
+  ecl_file_prefetch_type * prefetch = ecl_file_view_get_prefetch( file_view );
+  if (prefetch && ecl_file_view_has_kw( file_view , SEQNUM_KW )) {
+    const int_vector_type * seqnum_list = hash_get( file_view->kw_index , SEQNUM_KW );
+    const int num_seqnum = int_vector_size( seqnum_list );
+
+    if (seqnum_index < num_seqnum) {
+      int last_block = util_int_min( seqnum_index + ecl_file_prefetch_get_num_blocks( prefetch ) + 1 , num_seqnum );
+      int start_index = int_vector_iget( seqnum_list , seqnum_index );
+      int end_index;
+      int index;
+
+      if (last_block < num_seqnum)
+        end_index = int_vector_iget( seqnum_list , last_block );
+      else
+        end_index = vector_get_size( file_view->kw_list );
+
+      {
+        const ecl_file_kw_type * start_kw = vector_iget_const( file_view->kw_list , start_index );
+        ecl_file_prefetch_drop_before( prefetch , ecl_file_kw_get_offset( start_kw ));
+      }
+
+      for (index = start_index; index < end_index; index++) {
+        ecl_file_kw_type * file_kw = vector_iget( file_view->kw_list , index );
+        if (!ecl_file_kw_is_loaded( file_kw ))
+          ecl_file_prefetch_add( prefetch , file_kw );
+      }
+    }
+  }
+}
+
+
 /*
   Will mulitplex on the four input arguments.
 */
@@ -757,8 +970,10 @@ ecl_file_view_type * ecl_file_view_add_restart_view( ecl_file_view_type * file_v
     seqnum_index = ecl_file_view_seqnum_index_from_sim_days( file_view , sim_days );
 
 
-  if (seqnum_index >= 0)
+  if (seqnum_index >= 0) {
+    ecl_file_view_prefetch_restart( file_view , seqnum_index );
     child = ecl_file_view_add_blockview( file_view , SEQNUM_KW , seqnum_index );
+  }
 
   return child;
 }
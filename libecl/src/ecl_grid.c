@@ -20,8 +20,10 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <math.h>
 
+#include <ert/util/build_config.h>
 #include <ert/util/util.h>
 #include <ert/util/double_vector.h>
 #include <ert/util/int_vector.h>
@@ -30,7 +32,6 @@
 #include <ert/util/stringlist.h>
 
 #include <ert/geometry/geo_util.h>
-#include <ert/geometry/geo_polygon.h>
 
 #include <ert/ecl/ecl_util.h>
 #include <ert/ecl/ecl_kw.h>
@@ -42,6 +43,14 @@
 #include <ert/ecl/grid_dims.h>
 #include <ert/ecl/nnc_info.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
 
 /**
   this function implements functionality to load eclispe grid files,
@@ -406,6 +415,20 @@
      }
 
 
+  The preferred accessor is ecl_grid_get_cell_nnc_row(), which will
+  return the connections of a cell directly from the underlying
+  arrays; the nnc_info instances are views of the same connections
+  which are created the first time they are requested for a cell:
+
+     const int * lgr_nr;
+     const int * global_index;
+     const int * nnc_index;
+     int num_nnc = ecl_grid_get_cell_nnc_row( grid , cell_index , &lgr_nr , &global_index , &nnc_index );
+
+     for (int j=0; j < num_nnc; j++)
+        printf("Cell[%d] -> %d  in lgr:%d \n", cell_index , global_index[j] , lgr_nr[j]);
+
+
   Dual porosity and nnc: In ECLIPSE the connection between the matrix
   properties and the fracture properties in a cell is implemented as a
   nnc where the fracture cell has global index in the range [nx*ny*nz,
@@ -675,17 +698,10 @@ static void point_copy_values(point_type * p , const point_type * src) {
   point_set(p , src->x , src->y , src->z);
 }
 
-/*
-  Indices used in the cell->active_index[] array.
-*/
-#define MATRIX_INDEX   0
-#define FRACTURE_INDEX 1
-
 #define COARSE_GROUP_NONE  -1
 #define HOST_CELL_NONE     -1
 
 #define CELL_FLAG_VALID    1     /* In the case of GRID files not necessarily all cells geometry values set - in that case this will be left as false. */
-#define CELL_FLAG_CENTER   2     /* Has the center value been calculated - this is by default not done to speed up loading a tiny bit. */
 #define CELL_FLAG_TAINTED  4     /* lazy fucking stupid reservoir engineers make invalid grid
                                     cells - for kicks??  must try to keep those cells out of
                                     real-world calculations with some hysteric heuristics.*/
@@ -698,18 +714,23 @@ typedef struct ecl_cell_struct           ecl_cell_type;
 #define METER_TO_FEET_SCALE_FACTOR   3.28084
 #define METER_TO_CM_SCALE_FACTOR   100.0
 
+/*
+  The cell only holds the properties which are set for every cell;
+  the lgr, host_cell and coarse_group properties are only set for a
+  small minority of the cells and are stored in the side tables
+  cell_lgr, host_cell and coarse_group of the grid, which are only
+  allocated when the first non-default value is set. The nnc are
+  stored in compressed rows in the grid. The center of the cell is recalculated from the corners when
+  needed. The active status of the cells is stored in the cell_active
+  array of the grid, and the active indices in the index maps, so
+  that the topology of a grid is available without the cells.
+*/
+
 struct ecl_cell_struct {
-  point_type center;
   point_type corner_list[8];
 
   double                 volume;             /* Cache volume - whether it is initialized or not is handled by a cell_flags. */
-  int                    active;
-  int                    active_index[2];    /* [0]: The active matrix index; [1]: the active fracture index */
-  const ecl_grid_type   *lgr;                /* if this cell is part of an lgr; this will point to a grid instance for that lgr; NULL if not part of lgr. */
-  int                    host_cell;          /* the global index of the host cell for an lgr cell, set to -1 for normal cells. */
-  int                    coarse_group;       /* The index of the coarse group holding this cell -1 for non-coarsened cells. */
   int                    cell_flags;
-  nnc_info_type        * nnc_info;           /* Non-neighbour connection info*/
 };
 
 
@@ -720,6 +741,12 @@ static const float * ecl_grid_get_mapaxes( const ecl_grid_type * grid );
 
 #define ECL_GRID_ID       991010
 
+/* Number of points searched as one unit in ecl_grid_get_global_index_from_xyz_batch(). */
+#define ECL_GRID_XYZ_CHUNK_SIZE 1024
+
+typedef struct ecl_grid_xyz_index_struct ecl_grid_xyz_index_type;
+typedef struct ecl_grid_xy_index_struct ecl_grid_xy_index_type;
+
 struct ecl_grid_struct {
   UTIL_TYPE_ID_DECLARATION;
   int                   lgr_nr;        /* EGRID files: corresponds to item 4 in gridhead - 0 for the main grid.
@@ -729,14 +756,26 @@ struct ecl_grid_struct {
   int                   size;          /* == nx*ny*nz */
   int                   total_active;
   int                   total_active_fracture;
-  bool                * visited;                /* internal helper struct used when searching for index - can be NULL. */
+  ecl_grid_xyz_index_type * xyz_index;          /* spatial index used when searching for index - created on demand, can be NULL. */
+  vector_type         * xy_index_list;          /* spatial indices of column footprints used for map view lookup - created on demand, can be NULL. */
   int                 * index_map;              /* this a list of nx*ny*nz elements, where value -1 means inactive cell .*/
   int                 * inv_index_map;          /* this is list of total_active elements - which point back to the index_map. */
 
   int                 * fracture_index_map;     /* For fractures: this a list of nx*ny*nz elements, where value -1 means inactive cell .*/
   int                 * inv_fracture_index_map; /* For fractures: this is list of total_active elements - which point back to the index_map. */
 
-  ecl_cell_type      *  cells;
+  int                 * cell_active;    /* for each cell the active status; CELL_NOT_ACTIVE, CELL_ACTIVE_MATRIX and/or CELL_ACTIVE_FRACTURE. */
+  ecl_cell_type      *  cells;          /* NULL for grids with compact geometry, see ecl_grid_compute_cell(). */
+  size_t                cells_map_size; /* > 0 if the cells are a private mapping of a grid cache file, see ecl_grid_fread_cache(). */
+  const ecl_grid_type ** cell_lgr;      /* for each cell the lgr grid instance for this cell, NULL if no LGR is installed in this grid. */
+  int                 * host_cell;      /* for each cell the global index of the host cell, NULL for grids which are not LGRs. */
+  int                 * coarse_group;   /* for each cell the coarse group holding this cell, NULL for grids without coarsening. */
+  int                 * nnc_offset;       /* the nnc of cell g are in [nnc_offset[g], nnc_offset[g+1]) of the arrays below, NULL for grids without nnc. */
+  int                 * nnc_lgr_nr;       /* for each nnc the lgr_nr of the grid holding the second cell. */
+  int                 * nnc_global_index; /* for each nnc the global index of the second cell. */
+  int                 * nnc_input_index;  /* for each nnc the nnc_index, i.e. the ordering of the nnc on file. */
+  int_vector_type     * nnc_pending;      /* nnc which have been added, but not yet merged into the arrays above; NULL if none. */
+  nnc_info_type      ** cell_nnc;         /* nnc_info views of the rows, created on demand by ecl_grid_get_cell_nnc_info1(); NULL until the first view is created. */
 
   char                * parent_name;   /* the name of the parent for a nested lgr - for the main grid, and also a
                                           lgr descending directly from the main grid this will be NULL. */
@@ -768,33 +807,359 @@ struct ecl_grid_struct {
   int                    block_size;
   int                    last_block_index;
   double_vector_type  ** values;
+  int                  * block_count;   /* Accumulator blocking: number of values in each cell, NULL when not in use. */
+  double               * block_mean;
+  double               * block_m2;      /* Sum of squared deviations from block_mean. */
+  double               * block_min;
+  double               * block_max;
   ecl_kw_type          * coord_kw;   /* Retained for writing the grid to file.
                                         In principal it should be possible to
                                         recalculate this from the cell coordinates,
                                         but in cases with skewed cells this has proved
                                         numerically challenging. */
+  double               * pillars;           /* Compact geometry: the top point and direction of each of the (nx+1)*(ny+1) pillars; NULL for grids which store the cells. */
+  float                * zcorn;             /* Compact geometry: the ZCORN values. */
+  size_t                 zcorn_map_size;    /* > 0 if zcorn is a private mapping of a grid cache file. */
+  unsigned char        * tainted;           /* Compact geometry: bitset of the cells marked by ecl_cell_taint_cell(). */
+  bool                 * lazy_jslice_init;  /* For a grid with lazy geometry: have the tainted bits of j slice been initialized? NULL when all slices have been initialized. */
+  int                    lazy_jslice_count; /* The number of j slices with uninitialized tainted bits. */
 
   ert_ecl_unit_enum     unit_system;
   int                   eclipse_version;
 };
 
-static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2,  bool include_nnc , bool * equal) {
+
+/*
+  Accessors for the sparse cell properties; the get functions return
+  the default value when the corresponding table has not been
+  allocated.
+*/
+
+static const ecl_grid_type * ecl_grid_get_cell_lgr__( const ecl_grid_type * grid , int global_index ) {
+  if (grid->cell_lgr)
+    return grid->cell_lgr[global_index];
+  else
+    return NULL;
+}
+
+
+static void ecl_grid_set_cell_lgr__( ecl_grid_type * grid , int global_index , const ecl_grid_type * lgr ) {
+  if (!grid->cell_lgr) {
+    int i;
+    grid->cell_lgr = util_calloc( grid->size , sizeof * grid->cell_lgr );
+    for (i=0; i < grid->size; i++)
+      grid->cell_lgr[i] = NULL;
+  }
+  grid->cell_lgr[global_index] = lgr;
+}
+
+
+static int ecl_grid_get_host_cell__( const ecl_grid_type * grid , int global_index ) {
+  if (grid->host_cell)
+    return grid->host_cell[global_index];
+  else
+    return HOST_CELL_NONE;
+}
+
+
+static void ecl_grid_set_host_cell__( ecl_grid_type * grid , int global_index , int host_cell ) {
+  if (!grid->host_cell) {
+    if (host_cell == HOST_CELL_NONE)
+      return;
+
+    grid->host_cell = util_calloc( grid->size , sizeof * grid->host_cell );
+    {
+      int i;
+      for (i=0; i < grid->size; i++)
+        grid->host_cell[i] = HOST_CELL_NONE;
+    }
+  }
+  grid->host_cell[global_index] = host_cell;
+}
+
+
+static int ecl_grid_get_coarse_group__( const ecl_grid_type * grid , int global_index ) {
+  if (grid->coarse_group)
+    return grid->coarse_group[global_index];
+  else
+    return COARSE_GROUP_NONE;
+}
+
+
+static void ecl_grid_alloc_coarse_group( ecl_grid_type * grid ) {
+  if (!grid->coarse_group) {
+    int i;
+    grid->coarse_group = util_calloc( grid->size , sizeof * grid->coarse_group );
+    for (i=0; i < grid->size; i++)
+      grid->coarse_group[i] = COARSE_GROUP_NONE;
+  }
+}
+
+
+static void ecl_grid_set_coarse_group__( ecl_grid_type * grid , int global_index , int coarse_group ) {
+  if (!grid->coarse_group) {
+    if (coarse_group == COARSE_GROUP_NONE)
+      return;
+
+    ecl_grid_alloc_coarse_group( grid );
+  }
+  grid->coarse_group[global_index] = coarse_group;
+}
+
+
+/*
+  Non neighbour connections: the nnc of a grid are stored in
+  compressed sparse row form, i.e. the nnc starting in cell g are
+  found in the range [nnc_offset[g], nnc_offset[g+1]) of the
+  nnc_lgr_nr, nnc_global_index and nnc_input_index arrays, in the
+  order they were added.
+
+  New connections are appended to the nnc_pending list with
+  ecl_grid_add_nnc__(), and merged into the rows in one pass by
+  ecl_grid_merge_nnc(); that way the millions of nnc in a model with
+  many faults are sorted into the rows with a counting sort instead of
+  being added one by one. The pending connections are merged before
+  the grid is returned from the loaders; connections added later with
+  ecl_grid_add_self_nnc() are merged by ecl_grid_assert_nnc() the
+  first time the nnc of the grid are read, so adding nnc one at a time
+  is O(1) per connection.
+
+  The nnc_info instances returned by ecl_grid_get_cell_nnc_info1() are
+  views of the rows which are created the first time they are
+  requested for a cell, and discarded for the cells getting new
+  connections when the nnc are merged.
+
+  Merging the pending nnc and creating the views modifies the grid;
+  the nnc can only be read concurrently with
+  ecl_grid_get_cell_nnc_row() when there are no pending nnc, i.e. for
+  a grid which has not been modified since it was loaded or since the
+  nnc were last read.
+*/
+
+static void ecl_grid_add_nnc__( ecl_grid_type * grid , int global_index1 , int lgr_nr2 , int global_index2 , int nnc_index ) {
+  if ((global_index1 < 0) || (global_index1 >= grid->size))
+    util_abort("%s: invalid global index:%d - grid size:%d \n",__func__ , global_index1 , grid->size);
+
+  if (!grid->nnc_pending)
+    grid->nnc_pending = int_vector_alloc( 0 , 0 );
+
+  int_vector_append( grid->nnc_pending , global_index1 );
+  int_vector_append( grid->nnc_pending , lgr_nr2 );
+  int_vector_append( grid->nnc_pending , global_index2 );
+  int_vector_append( grid->nnc_pending , nnc_index );
+}
+
+
+static void ecl_grid_free_nnc_views( ecl_grid_type * grid ) {
+  if (grid->cell_nnc) {
+    int i;
+    for (i=0; i < grid->size; i++) {
+      if (grid->cell_nnc[i])
+        nnc_info_free( grid->cell_nnc[i] );
+    }
+    free( grid->cell_nnc );
+    grid->cell_nnc = NULL;
+  }
+}
+
+
+static void ecl_grid_free_nnc_rows( ecl_grid_type * grid ) {
+  util_safe_free( grid->nnc_offset );
+  util_safe_free( grid->nnc_lgr_nr );
+  util_safe_free( grid->nnc_global_index );
+  util_safe_free( grid->nnc_input_index );
+
+  grid->nnc_offset = NULL;
+  grid->nnc_lgr_nr = NULL;
+  grid->nnc_global_index = NULL;
+  grid->nnc_input_index = NULL;
+}
+
+
+static void ecl_grid_free_nnc( ecl_grid_type * grid ) {
+  ecl_grid_free_nnc_views( grid );
+  ecl_grid_free_nnc_rows( grid );
+  if (grid->nnc_pending)
+    int_vector_free( grid->nnc_pending );
+  grid->nnc_pending = NULL;
+}
+
+
+static int ecl_grid_get_cell_num_nnc__( const ecl_grid_type * grid , int global_index ) {
+  if (grid->nnc_offset)
+    return grid->nnc_offset[global_index + 1] - grid->nnc_offset[global_index];
+  else
+    return 0;
+}
+
+
+/*
+  Merges the pending nnc into the rows. The existing rows are copied
+  to their new position, and the pending connections are then
+  scattered to the end of their row in the order they were added.
+  The nnc_info views of the cells which got new connections are
+  discarded.
+*/
+
+static void ecl_grid_merge_nnc( ecl_grid_type * ecl_grid ) {
+  if (ecl_grid->nnc_pending) {
+    const int size = ecl_grid->size;
+    const int * pending = int_vector_get_const_ptr( ecl_grid->nnc_pending );
+    const int num_pending = int_vector_size( ecl_grid->nnc_pending ) / 4;
+    int * offset = util_calloc( size + 1 , sizeof * offset );
+    int * cursor = util_calloc( size , sizeof * cursor );
+    int * lgr_nr;
+    int * global_index;
+    int * input_index;
+    int num_nnc;
+    int g , i;
+
+#pragma omp parallel for
+    for (g = 0; g < size; g++)
+      offset[g + 1] = ecl_grid_get_cell_num_nnc__( ecl_grid , g );
+    offset[0] = 0;
+
+    for (i = 0; i < num_pending; i++)
+      offset[pending[4*i] + 1]++;
+
+    for (g = 0; g < size; g++)
+      offset[g + 1] += offset[g];
+
+    num_nnc = offset[size];
+    lgr_nr       = util_calloc( num_nnc , sizeof * lgr_nr );
+    global_index = util_calloc( num_nnc , sizeof * global_index );
+    input_index  = util_calloc( num_nnc , sizeof * input_index );
+
+#pragma omp parallel for
+    for (g = 0; g < size; g++) {
+      int row_size = ecl_grid_get_cell_num_nnc__( ecl_grid , g );
+      if (row_size > 0) {
+        int src = ecl_grid->nnc_offset[g];
+        memcpy( &lgr_nr[offset[g]]       , &ecl_grid->nnc_lgr_nr[src]       , row_size * sizeof * lgr_nr );
+        memcpy( &global_index[offset[g]] , &ecl_grid->nnc_global_index[src] , row_size * sizeof * global_index );
+        memcpy( &input_index[offset[g]]  , &ecl_grid->nnc_input_index[src]  , row_size * sizeof * input_index );
+      }
+      cursor[g] = offset[g] + row_size;
+    }
+
+    for (i = 0; i < num_pending; i++) {
+      const int * nnc = &pending[4*i];
+      int dst = cursor[nnc[0]]++;
+      lgr_nr[dst]       = nnc[1];
+      global_index[dst] = nnc[2];
+      input_index[dst]  = nnc[3];
+
+      if (ecl_grid->cell_nnc && ecl_grid->cell_nnc[nnc[0]]) {
+        nnc_info_free( ecl_grid->cell_nnc[nnc[0]] );
+        ecl_grid->cell_nnc[nnc[0]] = NULL;
+      }
+    }
+
+    ecl_grid_free_nnc_rows( ecl_grid );
+    int_vector_free( ecl_grid->nnc_pending );
+    ecl_grid->nnc_pending      = NULL;
+    ecl_grid->nnc_offset       = offset;
+    ecl_grid->nnc_lgr_nr       = lgr_nr;
+    ecl_grid->nnc_global_index = global_index;
+    ecl_grid->nnc_input_index  = input_index;
+    free( cursor );
+  }
+}
+
+
+static void ecl_grid_assert_nnc( const ecl_grid_type * grid ) {
+  if (grid->nnc_pending)
+    ecl_grid_merge_nnc( (ecl_grid_type *) grid );
+}
+
+
+/*
+  Returns the nnc_info view of the nnc in cell global_index, or NULL
+  if the cell does not have any nnc. The view is created the first
+  time it is requested.
+*/
+
+static const nnc_info_type * ecl_grid_get_cell_nnc__( const ecl_grid_type * grid , int global_index ) {
+  ecl_grid_type * ecl_grid = (ecl_grid_type *) grid;
+
+  ecl_grid_assert_nnc( grid );
+  if (ecl_grid_get_cell_num_nnc__( grid , global_index ) == 0)
+    return NULL;
+
+  if (!ecl_grid->cell_nnc) {
+    int g;
+    ecl_grid->cell_nnc = util_calloc( grid->size , sizeof * ecl_grid->cell_nnc );
+    for (g=0; g < grid->size; g++)
+      ecl_grid->cell_nnc[g] = NULL;
+  }
+
+  if (!ecl_grid->cell_nnc[global_index]) {
+    nnc_info_type * nnc_info = nnc_info_alloc( grid->lgr_nr );
+    int i;
+    for (i = grid->nnc_offset[global_index]; i < grid->nnc_offset[global_index + 1]; i++)
+      nnc_info_add_nnc( nnc_info , grid->nnc_lgr_nr[i] , grid->nnc_global_index[i] , grid->nnc_input_index[i] );
+    ecl_grid->cell_nnc[global_index] = nnc_info;
+  }
+  return ecl_grid->cell_nnc[global_index];
+}
+
+
+/*
+  Two cells have equal nnc if the rows are identical; if the rows
+  differ the comparison falls back to nnc_info_equal(), which only
+  considers the order of the connections to the same grid.
+*/
+
+static bool ecl_grid_cell_nnc_equal( const ecl_grid_type * g1 , const ecl_grid_type * g2 , int global_index ) {
+  int row_size;
+
+  ecl_grid_assert_nnc( g1 );
+  ecl_grid_assert_nnc( g2 );
+  row_size = ecl_grid_get_cell_num_nnc__( g1 , global_index );
+  if (row_size != ecl_grid_get_cell_num_nnc__( g2 , global_index ))
+    return false;
+
+  if (row_size == 0)
+    return true;
+
+  if (g1->lgr_nr == g2->lgr_nr) {
+    int offset1 = g1->nnc_offset[global_index];
+    int offset2 = g2->nnc_offset[global_index];
+    if ((memcmp( &g1->nnc_lgr_nr[offset1]       , &g2->nnc_lgr_nr[offset2]       , row_size * sizeof(int)) == 0) &&
+        (memcmp( &g1->nnc_global_index[offset1] , &g2->nnc_global_index[offset2] , row_size * sizeof(int)) == 0) &&
+        (memcmp( &g1->nnc_input_index[offset1]  , &g2->nnc_input_index[offset2]  , row_size * sizeof(int)) == 0))
+      return true;
+  }
+
+  return nnc_info_equal( ecl_grid_get_cell_nnc__( g1 , global_index ) , ecl_grid_get_cell_nnc__( g2 , global_index ));
+}
+
+
+static int ecl_grid_get_active_fracture_index__( const ecl_grid_type * grid , int global_index ) {
+  if (grid->fracture_index_map)
+    return grid->fracture_index_map[global_index];
+  else
+    return -1;
+}
+
+
+static void ecl_cell_compare(const ecl_grid_type * g1 , const ecl_grid_type * g2 , const ecl_cell_type * c1 , const ecl_cell_type * c2, int global_index , bool include_nnc , bool * equal) {
   int i;
 
-  if (c1->active != c2->active)
+  if (g1->cell_active[global_index] != g2->cell_active[global_index])
     *equal = false;
 
 
-  if (c1->active_index[0] != c2->active_index[0])
+  if (g1->index_map[global_index] != g2->index_map[global_index])
     *equal = false;
 
-  if (c1->active_index[1] != c2->active_index[1])
+  if (ecl_grid_get_active_fracture_index__( g1 , global_index ) != ecl_grid_get_active_fracture_index__( g2 , global_index ))
     *equal = false;
 
-  if (c1->coarse_group != c2->coarse_group)
+  if (ecl_grid_get_coarse_group__( g1 , global_index ) != ecl_grid_get_coarse_group__( g2 , global_index ))
     *equal = false;
 
-  if (c1->host_cell != c2->host_cell)
+  if (ecl_grid_get_host_cell__( g1 , global_index ) != ecl_grid_get_host_cell__( g2 , global_index ))
     *equal = false;
 
   if (*equal) {
@@ -805,7 +1170,7 @@ static void ecl_cell_compare(const ecl_cell_type * c1 , const ecl_cell_type * c2
 
   if (include_nnc) {
     if (*equal)
-      *equal = nnc_info_equal( c1->nnc_info , c2->nnc_info );
+      *equal = ecl_grid_cell_nnc_equal( g1 , g2 , global_index );
   }
 
 }
@@ -818,15 +1183,21 @@ static void ecl_cell_dump( const ecl_cell_type * cell , FILE * stream) {
 }
 
 
-static void ecl_cell_assert_center( ecl_cell_type * cell);
+static void ecl_cell_compute_center( const ecl_cell_type * cell , point_type * center);
 
-static void ecl_cell_dump_ascii( ecl_cell_type * cell , int i , int j , int k , FILE * stream , const double * offset) {
-  fprintf(stream , "Cell: i:%3d  j:%3d    k:%3d   host_cell:%d  CoarseGroup:%4d active_nr:%6d  active:%d \nCorners:\n",i,j,k,cell->host_cell, cell->coarse_group , cell->active_index[MATRIX_INDEX], cell->active);
+static void ecl_cell_dump_ascii( const ecl_grid_type * grid , const ecl_cell_type * cell , int global_index , int i , int j , int k , FILE * stream , const double * offset) {
+  fprintf(stream , "Cell: i:%3d  j:%3d    k:%3d   host_cell:%d  CoarseGroup:%4d active_nr:%6d  active:%d \nCorners:\n",i,j,k,
+          ecl_grid_get_host_cell__( grid , global_index ) ,
+          ecl_grid_get_coarse_group__( grid , global_index ) ,
+          grid->index_map[global_index], grid->cell_active[global_index]);
 
-  ecl_cell_assert_center( cell );
-  fprintf(stream , "Center   : ");
-  point_dump_ascii( &cell->center , stream , offset);
-  fprintf(stream , "\n");
+  {
+    point_type center;
+    ecl_cell_compute_center( cell , &center );
+    fprintf(stream , "Center   : ");
+    point_dump_ascii( &center , stream , offset);
+    fprintf(stream , "\n");
+  }
 
   {
     int l;
@@ -848,16 +1219,16 @@ static void ecl_cell_fwrite_GRID( const ecl_grid_type * grid , const ecl_cell_ty
 
   ecl_kw_iset_int( coords_kw , 4 , 0);
   if (fracture_cell) {
-    if (cell->active & CELL_ACTIVE_FRACTURE)
+    if (grid->cell_active[global_index] & CELL_ACTIVE_FRACTURE)
       ecl_kw_iset_int( coords_kw , 4 , 1);
   } else {
-    if (cell->active & CELL_ACTIVE_MATRIX)
+    if (grid->cell_active[global_index] & CELL_ACTIVE_MATRIX)
       ecl_kw_iset_int( coords_kw , 4 , 1);
   }
 
   if (coords_size == 7) {
-    ecl_kw_iset_int( coords_kw , 5 , cell->host_cell + 1);
-    ecl_kw_iset_int( coords_kw , 6 , cell->coarse_group + 1);
+    ecl_kw_iset_int( coords_kw , 5 , ecl_grid_get_host_cell__( grid , global_index ) + 1);
+    ecl_kw_iset_int( coords_kw , 6 , ecl_grid_get_coarse_group__( grid , global_index ) + 1);
   }
 
   ecl_kw_fwrite( coords_kw , fortio );
@@ -1024,7 +1395,7 @@ static double ecl_cell_max_y( const ecl_cell_type * cell ) {
  */
 
 
-static void ecl_cell_taint_cell( ecl_cell_type * cell ) {
+static void ecl_cell_taint_cell( ecl_cell_type * cell , int active ) {
   int c;
   for (c = 0; c < 8; c++) {
     const point_type p = cell->corner_list[c];
@@ -1037,7 +1408,7 @@ static void ecl_cell_taint_cell( ecl_cell_type * cell ) {
   /*
     Second heuristic to invalidate cells.
   */
-  if (cell->active == CELL_NOT_ACTIVE) {
+  if (active == CELL_NOT_ACTIVE) {
     if (!GET_CELL_FLAG(cell , CELL_FLAG_TAINTED)) {
       const point_type p0 = cell->corner_list[0];
       int cell_index = 1;
@@ -1088,17 +1459,9 @@ static int ecl_cell_get_twist( const ecl_cell_type * cell ) {
 */
 
 static void ecl_cell_init( ecl_cell_type * cell , bool init_valid) {
-  cell->active                = CELL_NOT_ACTIVE;
-  cell->lgr                   = NULL;
-  cell->host_cell             = HOST_CELL_NONE;
-  cell->coarse_group          = COARSE_GROUP_NONE;
   cell->cell_flags            = 0;
-  cell->active_index[MATRIX_INDEX]   = -1;
-  cell->active_index[FRACTURE_INDEX] = -1;
   if (init_valid)
     cell->cell_flags = CELL_FLAG_VALID;
-
-  cell->nnc_info = NULL;
 }
 
 
@@ -1110,35 +1473,21 @@ static int ecl_cell_get_tetrahedron_method( int i , int j , int k) {
 #undef mod
 */
 
-static void ecl_cell_set_center( ecl_cell_type * cell) {
-  point_set(&cell->center , 0 , 0 , 0);
+static void ecl_cell_compute_center( const ecl_cell_type * cell , point_type * center) {
+  point_set(center , 0 , 0 , 0);
   {
     int c;
     for (c = 0; c < 8; c++)
-      point_inplace_add(&cell->center , &cell->corner_list[c]);
+      point_inplace_add(center , &cell->corner_list[c]);
   }
-  point_inplace_scale(&cell->center , 1.0 / 8.0);
-
-  SET_CELL_FLAG( cell , CELL_FLAG_CENTER );
-}
-
-
-
-static void ecl_cell_assert_center( ecl_cell_type * cell) {
-  if (!GET_CELL_FLAG(cell , CELL_FLAG_CENTER))
-    ecl_cell_set_center( cell );
+  point_inplace_scale(center , 1.0 / 8.0);
 }
 
 
-
 static void ecl_cell_memcpy( ecl_cell_type * target_cell , const ecl_cell_type * src_cell ) {
   memcpy( target_cell , src_cell , sizeof * target_cell );
 }
 
-static void ecl_cell_install_lgr( ecl_cell_type * cell , const ecl_grid_type * lgr_grid) {
-  cell->lgr       = lgr_grid;
-}
-
 static double C(double *r,int f1,int f2,int f3){
   if (f1 == 0) {
     if (f2 == 0) {
@@ -1249,17 +1598,15 @@ static inline double tetrahedron_volume6( tetrahedron_type tet ) {
  * when used in opm-parser and has been optimised significantly. This means
  * inlining several operations, e.g. vector operations, and other tricks.
  */
-static double ecl_cell_get_signed_volume( ecl_cell_type * cell) {
-  if (GET_CELL_FLAG(cell , CELL_FLAG_VOLUME))
-    return cell->volume;
+static double ecl_cell_compute_signed_volume( const ecl_cell_type * cell) {
+  point_type center;
 
-  ecl_cell_assert_center( cell );
+  ecl_cell_compute_center( cell , &center );
   {
     /*
      * We make an activation record local copy of the cell's corners for less
      * jumping in memory and better cache performance.
      */
-    point_type center = cell->center;
     point_type corners[ 8 ];
     memcpy( corners, cell->corner_list, sizeof( point_type ) * 8 );
 
@@ -1305,13 +1652,33 @@ static double ecl_cell_get_signed_volume( ecl_cell_type * cell) {
      * reverted.
      */
 
-    cell->volume = volume * 0.5;
+    return volume * 0.5;
+  }
+}
+
+
+static double ecl_cell_get_signed_volume( ecl_cell_type * cell) {
+  if (!GET_CELL_FLAG(cell , CELL_FLAG_VOLUME)) {
+    cell->volume = ecl_cell_compute_signed_volume( cell );
     SET_CELL_FLAG( cell , CELL_FLAG_VOLUME );
   }
   return cell->volume;
 }
 
 
+/*
+  Will not modify the cell; used when several threads search the
+  same grid.
+*/
+
+static double ecl_cell_peek_signed_volume( const ecl_cell_type * cell) {
+  if (GET_CELL_FLAG(cell , CELL_FLAG_VOLUME))
+    return cell->volume;
+  else
+    return ecl_cell_compute_signed_volume( cell );
+}
+
+
 static double ecl_cell_get_volume( ecl_cell_type * cell ) {
   return fabs( ecl_cell_get_signed_volume(cell));
 }
@@ -1402,7 +1769,7 @@ static bool ecl_cell_layer_contains_xy( const ecl_cell_type * cell , bool lower_
          |   |           |   |
          0---1           4---5
 */
-static void ecl_cell_init_regular( ecl_cell_type * cell , const double * offset , int i , int j , int k , int global_index , const double * ivec , const double * jvec , const double * kvec , const int * actnum ) {
+static void ecl_cell_init_regular( ecl_cell_type * cell , const double * offset , const double * ivec , const double * jvec , const double * kvec ) {
   point_set(&cell->corner_list[0] , offset[0] , offset[1] , offset[2] ); // Point 0
 
   cell->corner_list[1] = cell->corner_list[0];                       // Point 1
@@ -1421,11 +1788,6 @@ static void ecl_cell_init_regular( ecl_cell_type * cell , const double * offset
       point_shift(&cell->corner_list[i+4] , kvec[0] , kvec[1] , kvec[2]);
     }
   }
-
-  if (actnum != NULL)
-    cell->active = actnum[global_index];
-  else
-    cell->active = CELL_ACTIVE;
 }
 
 /* end of cell implementation                                    */
@@ -1441,11 +1803,67 @@ UTIL_IS_INSTANCE_FUNCTION( ecl_grid , ECL_GRID_ID);
 
 
 
+/*
+  Returns the stored cell; can only be used for grids which store the
+  cells, i.e. grids from GRID files and the rectangular grids - see
+  ecl_grid_get_cell_geometry().
+*/
+
 static ecl_cell_type * ecl_grid_get_cell(const ecl_grid_type * grid , int global_index) {
   return &grid->cells[global_index];
 }
 
 
+#define ECL_GRID_TAINTED_BYTE(g) ((g) >> 3)
+#define ECL_GRID_TAINTED_BIT(g)  (1 << ((g) & 7))
+
+static void ecl_grid_compute_cell( const ecl_grid_type * grid , int i , int j , int k , ecl_cell_type * cell );
+static void ecl_grid_init_lazy_jslice( const ecl_grid_type * grid , int j );
+
+static void ecl_grid_assert_lazy_jslice( const ecl_grid_type * grid , int j ) {
+  if (grid->lazy_jslice_init && !grid->lazy_jslice_init[j])
+    ecl_grid_init_lazy_jslice( grid , j );
+}
+
+
+/*
+  Returns the cell with global index global_index. For grids with
+  compact geometry the cell is calculated into cell_buffer, which is
+  returned; updates of the cell, i.e. the cached volume, are then
+  lost when the buffer goes out of scope.
+*/
+
+static ecl_cell_type * ecl_grid_get_cell_geometry(const ecl_grid_type * grid , int global_index , ecl_cell_type * cell_buffer) {
+  if (grid->pillars) {
+    int i = global_index % grid->nx;
+    int j = (global_index / grid->nx) % grid->ny;
+    int k = global_index / (grid->nx * grid->ny);
+
+    ecl_grid_assert_lazy_jslice( grid , j );
+    ecl_grid_compute_cell( grid , i , j , k , cell_buffer );
+    return cell_buffer;
+  }
+  return ecl_grid_get_cell( grid , global_index );
+}
+
+
+/*
+  Returns the cell_flags of the cell without calculating the geometry
+  of a compact cell.
+*/
+
+static int ecl_grid_get_cell_flags(const ecl_grid_type * grid , int global_index) {
+  if (grid->pillars) {
+    ecl_grid_assert_lazy_jslice( grid , (global_index / grid->nx) % grid->ny );
+    if (grid->tainted[ECL_GRID_TAINTED_BYTE( global_index )] & ECL_GRID_TAINTED_BIT( global_index ))
+      return CELL_FLAG_VALID | CELL_FLAG_TAINTED;
+    else
+      return CELL_FLAG_VALID;
+  }
+  return ecl_grid_get_cell( grid , global_index )->cell_flags;
+}
+
+
 /**
    this function uses heuristics (ahhh - i hate it) in an attempt to
    mark cells with fucked geometry - see further comments in the
@@ -1453,24 +1871,50 @@ static ecl_cell_type * ecl_grid_get_cell(const ecl_grid_type * grid , int global
 */
 
 static void ecl_grid_taint_cells( ecl_grid_type * ecl_grid ) {
+  const int size = ecl_grid->size;
   int index;
-  for (index = 0; index < ecl_grid->size; index++) {
+#pragma omp parallel for
+  for (index = 0; index < size; index++) {
     ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , index );
-    ecl_cell_taint_cell( cell );
+    ecl_cell_taint_cell( cell , ecl_grid->cell_active[index] );
   }
 }
 
 
+static void ecl_grid_free_compact_geometry( ecl_grid_type * grid ) {
+  util_safe_free( grid->pillars );
+#ifdef HAVE_MMAP
+  if (grid->zcorn_map_size > 0)
+    munmap( grid->zcorn , grid->zcorn_map_size );
+  else
+#endif
+    util_safe_free( grid->zcorn );
+  util_safe_free( grid->tainted );
+  util_safe_free( grid->lazy_jslice_init );
+  grid->pillars = NULL;
+  grid->zcorn = NULL;
+  grid->zcorn_map_size = 0;
+  grid->tainted = NULL;
+  grid->lazy_jslice_init = NULL;
+  grid->lazy_jslice_count = 0;
+}
+
+
 static void ecl_grid_free_cells( ecl_grid_type * grid ) {
+  ecl_grid_free_compact_geometry( grid );
+  ecl_grid_free_nnc( grid );
+  util_safe_free( grid->cell_lgr );
+  util_safe_free( grid->host_cell );
+  util_safe_free( grid->coarse_group );
   if (!grid->cells)
     return;
 
-  for (int i=0; i < grid->size; i++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , i );
-    if (cell->nnc_info)
-      nnc_info_free(cell->nnc_info);
-  }
-  free( grid->cells );
+#ifdef HAVE_MMAP
+  if (grid->cells_map_size > 0)
+    munmap( grid->cells , grid->cells_map_size );
+  else
+#endif
+    free( grid->cells );
 
 }
 
@@ -1498,10 +1942,12 @@ static bool ecl_grid_alloc_cells( ecl_grid_type * grid , bool init_valid) {
    is != NULL the newly created grid instance will copy the mapaxes
    transformations; and set the global_grid pointer of the new grid
    instance. apart from that no further lgr-relationsip initialisation
-   is performed.
+   is performed. All cells are initially inactive. If alloc_cells is
+   false the cells are left at NULL, and must be installed by the
+   caller.
 */
 
-static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int dualp_flag , int nx , int ny , int nz, int lgr_nr, bool init_valid) {
+static ecl_grid_type * ecl_grid_alloc_empty__(ecl_grid_type * global_grid , int dualp_flag , int nx , int ny , int nz, int lgr_nr, bool init_valid , bool alloc_cells) {
   ecl_grid_type * grid = util_malloc(sizeof * grid );
   UTIL_TYPE_ID_INIT(grid , ECL_GRID_ID);
   grid->total_active   = 0;
@@ -1517,7 +1963,26 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int du
 
   grid->dualp_flag            = dualp_flag;
   grid->coord_kw              = NULL;
-  grid->visited               = NULL;
+  grid->pillars               = NULL;
+  grid->zcorn                 = NULL;
+  grid->zcorn_map_size        = 0;
+  grid->tainted               = NULL;
+  grid->lazy_jslice_init      = NULL;
+  grid->lazy_jslice_count     = 0;
+  grid->xyz_index             = NULL;
+  grid->xy_index_list         = NULL;
+  grid->cell_active           = NULL;
+  grid->cells                 = NULL;
+  grid->cells_map_size        = 0;
+  grid->cell_lgr              = NULL;
+  grid->host_cell             = NULL;
+  grid->coarse_group          = NULL;
+  grid->nnc_offset            = NULL;
+  grid->nnc_lgr_nr            = NULL;
+  grid->nnc_global_index      = NULL;
+  grid->nnc_input_index       = NULL;
+  grid->nnc_pending           = NULL;
+  grid->cell_nnc              = NULL;
   grid->inv_index_map         = NULL;
   grid->index_map             = NULL;
   grid->fracture_index_map    = NULL;
@@ -1551,6 +2016,11 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int du
 
   grid->block_dim       = 0;
   grid->values          = NULL;
+  grid->block_count     = NULL;
+  grid->block_mean      = NULL;
+  grid->block_m2        = NULL;
+  grid->block_min       = NULL;
+  grid->block_max       = NULL;
   if (ECL_GRID_MAINGRID_LGR_NR == lgr_nr) {  /* this is the main grid */
     grid->LGR_list      = vector_alloc_new();
     grid->lgr_index_map = int_vector_alloc(0,0);
@@ -1567,8 +2037,9 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int du
   grid->coarse_cells    = vector_alloc_new();
   grid->eclipse_version = 0;
 
-  /* This is the large allocation - which can potentially fail. */
-  if (!ecl_grid_alloc_cells( grid , init_valid )) {
+  /* These are the large allocations - which can potentially fail. */
+  grid->cell_active = calloc( grid->size , sizeof * grid->cell_active );
+  if (!grid->cell_active || (alloc_cells && !ecl_grid_alloc_cells( grid , init_valid ))) {
     ecl_grid_free( grid );
     grid = NULL;
   }
@@ -1576,6 +2047,11 @@ static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int du
 }
 
 
+static ecl_grid_type * ecl_grid_alloc_empty(ecl_grid_type * global_grid , int dualp_flag , int nx , int ny , int nz, int lgr_nr, bool init_valid) {
+  return ecl_grid_alloc_empty__( global_grid , dualp_flag , nx , ny , nz , lgr_nr , init_valid , true );
+}
+
+
 
 
 static  int ecl_grid_get_global_index__(const ecl_grid_type * ecl_grid , int i , int j , int k) {
@@ -1583,40 +2059,24 @@ static  int ecl_grid_get_global_index__(const ecl_grid_type * ecl_grid , int i ,
 }
 
 
-static void ecl_grid_set_cell_EGRID(ecl_grid_type * ecl_grid , int i, int j , int k ,
-                                    double x[4][2] , double y[4][2] , double z[4][2] ,
-                                    const int * actnum, const int * corsnum) {
+/*
+  If actnum == NULL that is taken to mean active.
 
-  const int global_index   = ecl_grid_get_global_index__(ecl_grid , i , j  , k );
-  ecl_cell_type * cell     = ecl_grid_get_cell( ecl_grid , global_index );
-  int ip , iz;
+  for normal runs actnum will be 1 for active cells,
+  for dual porosity models it can also be 2 and 3.
+*/
 
-  for (iz = 0; iz < 2; iz++) {
-    for (ip = 0; ip < 4; ip++) {
-      int c = ip + iz * 4;
-      point_set(&cell->corner_list[c] , x[ip][iz] , y[ip][iz] , z[ip][iz]);
+static void ecl_grid_init_actnum__( ecl_grid_type * ecl_grid , const int * actnum ) {
+  const int size = ecl_grid->size;
+  int global_index;
 
-      if (ecl_grid->use_mapaxes)
-        point_mapaxes_transform( &cell->corner_list[c] , ecl_grid->origo , ecl_grid->unit_x , ecl_grid->unit_y );
-    }
+#pragma omp parallel for
+  for (global_index = 0; global_index < size; global_index++) {
+    if (actnum == NULL)
+      ecl_grid->cell_active[global_index] = CELL_ACTIVE;
+    else
+      ecl_grid->cell_active[global_index] = actnum[global_index];
   }
-
-
-
-
-  /*
-    If actnum == NULL that is taken to mean active.
-
-    for normal runs actnum will be 1 for active cells,
-    for dual porosity models it can also be 2 and 3.
-  */
-  if (actnum == NULL)
-    cell->active = CELL_ACTIVE;
-  else
-    cell->active = actnum[global_index];
-
-  if (corsnum != NULL)
-    cell->coarse_group = corsnum[ global_index ] - 1;
 }
 
 
@@ -1683,16 +2143,16 @@ static void ecl_grid_set_cell_GRID(ecl_grid_type * ecl_grid , int coords_size ,
 
     switch(coords_size) {
     case 4:                /* all cells active */
-      cell->active += active_value;
+      ecl_grid->cell_active[global_index] += active_value;
       break;
     case 5:                /* only spesific cells active - no lgr */
-      cell->active  += coords[4] * active_value;
+      ecl_grid->cell_active[global_index] += coords[4] * active_value;
       break;
     case 7:
-      cell->active      += coords[4] * active_value;
-      cell->host_cell    = coords[5] - 1;
-      cell->coarse_group = coords[6] - 1;
-      if (cell->coarse_group >= 0)
+      ecl_grid->cell_active[global_index] += coords[4] * active_value;
+      ecl_grid_set_host_cell__( ecl_grid , global_index , coords[5] - 1 );
+      ecl_grid_set_coarse_group__( ecl_grid , global_index , coords[6] - 1 );
+      if (coords[6] > 0)
         ecl_grid->coarsening_active = true;
       break;
     default:
@@ -1714,154 +2174,178 @@ static void ecl_grid_set_cell_GRID(ecl_grid_type * ecl_grid , int coords_size ,
 
 
 /**
-   The function ecl_grid_set_active_index() must be called immediately
-   prior to calling this function, to ensure that
-   ecl_grid->total_active is correct.
+   Will initialize the inverse index map from the index map; the
+   function ecl_grid_set_active_index() must be called immediately
+   prior to calling this function. In the case of coarse cells with
+   more than one active cell in the main grid, the inverse active ->
+   global mapping will map to the first active cell in the coarse
+   cell.
 */
 
-static void ecl_grid_init_index_map__( ecl_grid_type * ecl_grid , int * index_map , int * inv_index_map , int active_mask, int type_index) {
+static void ecl_grid_init_inv_index_map__( ecl_grid_type * ecl_grid , const int * index_map , int * inv_index_map , int active_mask) {
+  const int size = ecl_grid->size;
   int global_index;
 
-  for (global_index = 0; global_index < ecl_grid->size; global_index++) {
-    const ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index);
-    if (cell->active & active_mask) {
-      index_map[global_index] = cell->active_index[type_index];
-
-      if (cell->coarse_group == COARSE_GROUP_NONE)
-        inv_index_map[cell->active_index[type_index]] = global_index;
-      //else: In the case of coarse groups the inv_index_map is set below.
-    } else
-      index_map[global_index] = -1;
-  }
-
-}
-
-
-static void ecl_grid_realloc_index_map(ecl_grid_type * ecl_grid) {
-  /* Creating the inverse mapping for the matrix cells. */
-  {
-    ecl_grid->index_map     = util_realloc(ecl_grid->index_map     , ecl_grid->size                * sizeof * ecl_grid->index_map     );
-    ecl_grid->inv_index_map = util_realloc(ecl_grid->inv_index_map , ecl_grid->total_active * sizeof * ecl_grid->inv_index_map );
-    ecl_grid_init_index_map__( ecl_grid , ecl_grid->index_map , ecl_grid->inv_index_map , CELL_ACTIVE_MATRIX , MATRIX_INDEX);
-  }
-
-  /* Create the inverse mapping for the fractures. */
-  if (ecl_grid->dualp_flag != FILEHEAD_SINGLE_POROSITY) {
-    ecl_grid->fracture_index_map     = util_realloc(ecl_grid->fracture_index_map     , ecl_grid->size                  * sizeof * ecl_grid->fracture_index_map     );
-    ecl_grid->inv_fracture_index_map = util_realloc(ecl_grid->inv_fracture_index_map , ecl_grid->total_active_fracture * sizeof * ecl_grid->inv_fracture_index_map );
-    ecl_grid_init_index_map__( ecl_grid , ecl_grid->fracture_index_map , ecl_grid->inv_fracture_index_map , CELL_ACTIVE_FRACTURE , FRACTURE_INDEX);
+#pragma omp parallel for
+  for (global_index = 0; global_index < size; global_index++) {
+    if ((index_map[global_index] >= 0) && (ecl_grid_get_coarse_group__( ecl_grid , global_index ) == COARSE_GROUP_NONE))
+      inv_index_map[index_map[global_index]] = global_index;
+    //else: In the case of coarse groups the inv_index_map is set below.
   }
 
-
-  /* Update the inverse map in the case of coarse cells. Observe that
-     in the case of coarse cells with more than one active cell in the
-     main grid, the inverse active -> global mapping will map to the
-     first active cell in the coarse cell. */
   {
     int coarse_group;
     for (coarse_group = 0; coarse_group < ecl_grid_get_num_coarse_groups( ecl_grid ); coarse_group++) {
       ecl_coarse_cell_type * coarse_cell = ecl_grid_iget_coarse_group( ecl_grid , coarse_group );
       if (ecl_coarse_cell_get_num_active( coarse_cell ) > 0) {
-        int global_index          = ecl_coarse_cell_iget_active_cell_index( coarse_cell , 0 );
-        int active_value          = ecl_coarse_cell_iget_active_value( coarse_cell , 0 );
-        int active_index          = ecl_coarse_cell_get_active_index( coarse_cell );
-        int active_fracture_index = ecl_coarse_cell_get_active_fracture_index( coarse_cell );
+        int global_index = ecl_coarse_cell_iget_active_cell_index( coarse_cell , 0 );
+        int active_value = ecl_coarse_cell_iget_active_value( coarse_cell , 0 );
 
-        if (active_value & CELL_ACTIVE_MATRIX)
-          ecl_grid->inv_index_map[ active_index ] = global_index;    // The active -> global mapping point to one "random" cell in the coarse group
-
-        if (active_value & CELL_ACTIVE_FRACTURE)
-          ecl_grid->inv_fracture_index_map[ active_fracture_index ] = global_index;
+        if (active_value & active_mask)
+          inv_index_map[ index_map[ global_index ] ] = global_index;    // The active -> global mapping point to one "random" cell in the coarse group
+      } // else the coarse cell does not have any active cells.
+    }
+  }
+}
 
-        {
-          int coarse_size = ecl_coarse_cell_get_size( coarse_cell );
-          const int_vector_type * global_index_list = ecl_coarse_cell_get_index_vector( coarse_cell );
-          int ic;
-          for (ic =0; ic < coarse_size; ic++) {
-            int gi = int_vector_iget( global_index_list , ic );
 
-            if (active_value & CELL_ACTIVE_MATRIX)
-              ecl_grid->index_map[ gi ] = active_index;        // All the cells in the coarse group point to the same active index.
+static void ecl_grid_realloc_inv_index_map(ecl_grid_type * ecl_grid) {
+  /* Creating the inverse mapping for the matrix cells. */
+  ecl_grid->inv_index_map = util_realloc(ecl_grid->inv_index_map , ecl_grid->total_active * sizeof * ecl_grid->inv_index_map );
+  ecl_grid_init_inv_index_map__( ecl_grid , ecl_grid->index_map , ecl_grid->inv_index_map , CELL_ACTIVE_MATRIX );
 
-            if (active_value & CELL_ACTIVE_FRACTURE)
-              ecl_grid->fracture_index_map[ gi ] = active_fracture_index;
-          }
-        }
-      } // else the coarse cell does not have any active cells.
-    }
+  /* Create the inverse mapping for the fractures. */
+  if (ecl_grid->dualp_flag != FILEHEAD_SINGLE_POROSITY) {
+    ecl_grid->inv_fracture_index_map = util_realloc(ecl_grid->inv_fracture_index_map , ecl_grid->total_active_fracture * sizeof * ecl_grid->inv_fracture_index_map );
+    ecl_grid_init_inv_index_map__( ecl_grid , ecl_grid->fracture_index_map , ecl_grid->inv_fracture_index_map , CELL_ACTIVE_FRACTURE );
   }
 }
 
 
 
 /*
-  This function goes through the entire grid and sets the active_index
-  of all the cells. The functione ecl_grid_realloc_index_map()
-  subsequently reads this to create and initialize the index map.
+  Numbers the cells with (cell_active & active_mask) consecutively in
+  global index order into index_map, the remaining cells get -1, and
+  returns the number of such cells. The grid is numbered one k layer
+  at a time: first the active cells in each layer are counted, then
+  each layer is numbered starting from the sum of the counts in the
+  layers above; both passes run in parallel over the layers.
+*/
+
+static int ecl_grid_set_active_index__(ecl_grid_type * ecl_grid , int * index_map , int active_mask) {
+  const int layer_size = ecl_grid->nx * ecl_grid->ny;
+  const int nz = ecl_grid->nz;
+  const int * cell_active = ecl_grid->cell_active;
+  int * layer_offset = util_calloc( nz + 1 , sizeof * layer_offset );
+  int k;
+
+#pragma omp parallel for
+  for (k = 0; k < nz; k++) {
+    int count = 0;
+    int global_index;
+    for (global_index = k * layer_size; global_index < (k + 1) * layer_size; global_index++) {
+      if (cell_active[global_index] & active_mask)
+        count++;
+    }
+    layer_offset[k + 1] = count;
+  }
+
+  layer_offset[0] = 0;
+  for (k = 0; k < nz; k++)
+    layer_offset[k + 1] += layer_offset[k];
+
+#pragma omp parallel for
+  for (k = 0; k < nz; k++) {
+    int active_index = layer_offset[k];
+    int global_index;
+    for (global_index = k * layer_size; global_index < (k + 1) * layer_size; global_index++) {
+      if (cell_active[global_index] & active_mask) {
+        index_map[global_index] = active_index;
+        active_index++;
+      } else
+        index_map[global_index] = -1;
+    }
+  }
+
+  {
+    int num_active = layer_offset[nz];
+    free( layer_offset );
+    return num_active;
+  }
+}
+
+
+/*
+  This function goes through the entire grid and sets the index_map,
+  and for dual porosity grids the fracture_index_map, from the active
+  status of the cells. The function ecl_grid_realloc_inv_index_map()
+  subsequently reads this to create and initialize the inverse index
+  maps.
 */
 
 static void ecl_grid_set_active_index(ecl_grid_type * ecl_grid) {
   int global_index;
   int active_index = 0;
   int active_fracture_index = 0;
+  int * index_map;
+  int * fracture_index_map = NULL;
+
+  ecl_grid->index_map = util_realloc(ecl_grid->index_map , ecl_grid->size * sizeof * ecl_grid->index_map );
+  index_map = ecl_grid->index_map;
+  if (ecl_grid->dualp_flag != FILEHEAD_SINGLE_POROSITY) {
+    ecl_grid->fracture_index_map = util_realloc(ecl_grid->fracture_index_map , ecl_grid->size * sizeof * ecl_grid->fracture_index_map );
+    fracture_index_map = ecl_grid->fracture_index_map;
+  }
 
   if (!ecl_grid_have_coarse_cells( ecl_grid )) {
     /* Keeping a fast path for the 99% most common case of no coarse
        groups and single porosity. */
-    {
-      for (global_index = 0; global_index < ecl_grid->size; global_index++) {
-        ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index);
-
-        if (cell->active & CELL_ACTIVE_MATRIX) {
-          cell->active_index[MATRIX_INDEX] = active_index;
-          active_index++;
-        }
-      }
-    }
+    active_index = ecl_grid_set_active_index__( ecl_grid , index_map , CELL_ACTIVE_MATRIX );
 
-    if (ecl_grid->dualp_flag != FILEHEAD_SINGLE_POROSITY) {
-      for (global_index = 0; global_index < ecl_grid->size; global_index++) {
-        ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index);
-        if (cell->active & CELL_ACTIVE_FRACTURE) {
-          cell->active_index[FRACTURE_INDEX] = active_fracture_index;
-          active_fracture_index++;
-        }
-      }
-    }
+    if (fracture_index_map)
+      active_fracture_index = ecl_grid_set_active_index__( ecl_grid , fracture_index_map , CELL_ACTIVE_FRACTURE );
   } else {
     /* --- More involved path in the case of coarsening groups. --- */
 
+    for (global_index = 0; global_index < ecl_grid->size; global_index++) {
+      index_map[global_index] = -1;
+      if (fracture_index_map)
+        fracture_index_map[global_index] = -1;
+    }
+
     /* 1: Go through all the cells and set the active index. In the
           case of coarse cells we only set the common active index of
           the entire coarse cell.
     */
     for (global_index = 0; global_index < ecl_grid->size; global_index++) {
-      ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index);
-      if (cell->active != CELL_NOT_ACTIVE) {
-        if (cell->coarse_group == COARSE_GROUP_NONE) {
+      int active = ecl_grid->cell_active[global_index];
+      if (active != CELL_NOT_ACTIVE) {
+        int coarse_group = ecl_grid_get_coarse_group__( ecl_grid , global_index );
+        if (coarse_group == COARSE_GROUP_NONE) {
 
-          if (cell->active & CELL_ACTIVE_MATRIX) {
-            cell->active_index[MATRIX_INDEX] = active_index;
+          if (active & CELL_ACTIVE_MATRIX) {
+            index_map[global_index] = active_index;
             active_index++;
           }
 
-          if (cell->active & CELL_ACTIVE_FRACTURE) {
-            cell->active_index[FRACTURE_INDEX] = active_fracture_index;
+          if (active & CELL_ACTIVE_FRACTURE) {
+            if (fracture_index_map)
+              fracture_index_map[global_index] = active_fracture_index;
             active_fracture_index++;
           }
 
         } else {
-          ecl_coarse_cell_type * coarse_cell = ecl_grid_iget_coarse_group( ecl_grid , cell->coarse_group );
-          ecl_coarse_cell_update_index( coarse_cell , global_index , &active_index , &active_fracture_index , cell->active);
+          ecl_coarse_cell_type * coarse_cell = ecl_grid_iget_coarse_group( ecl_grid , coarse_group );
+          ecl_coarse_cell_update_index( coarse_cell , global_index , &active_index , &active_fracture_index , active);
         }
       }
     }
 
 
     /*
-      2: Go through all the coarse cells and set the active index and
-         active value of all the cells in the coarse cell to the
-         common value for the coarse cell.
+      2: Go through all the coarse cells and set the active index of
+         all the cells in the coarse cell to the common value for the
+         coarse cell.
     */
     {
       int coarse_group;
@@ -1876,18 +2360,13 @@ static void ecl_grid_set_active_index(ecl_grid_type * ecl_grid) {
 
           for (i=0; i < group_size; i++) {
             global_index = coarse_cell_list[i];
-            {
-              ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
 
-              if (cell_active_value & CELL_ACTIVE_MATRIX)
-                cell->active_index[MATRIX_INDEX] = cell_active_index;
+            if (cell_active_value & CELL_ACTIVE_MATRIX)
+              index_map[global_index] = cell_active_index;
 
-              /* Coarse cell and dual porosity - that is probably close to zero measure. */
-              if (cell_active_value & CELL_ACTIVE_FRACTURE) {
-                int cell_active_fracture_index = ecl_coarse_cell_get_active_fracture_index( coarse_cell );
-                cell->active_index[FRACTURE_INDEX] = cell_active_fracture_index;
-              }
-            }
+            /* Coarse cell and dual porosity - that is probably close to zero measure. */
+            if ((cell_active_value & CELL_ACTIVE_FRACTURE) && fracture_index_map)
+              fracture_index_map[global_index] = ecl_coarse_cell_get_active_fracture_index( coarse_cell );
           }
 
         }
@@ -1901,7 +2380,7 @@ static void ecl_grid_set_active_index(ecl_grid_type * ecl_grid) {
 
 static void ecl_grid_update_index( ecl_grid_type * ecl_grid) {
   ecl_grid_set_active_index(ecl_grid);
-  ecl_grid_realloc_index_map(ecl_grid);
+  ecl_grid_realloc_inv_index_map(ecl_grid);
 }
 
 
@@ -1920,9 +2399,9 @@ static void ecl_grid_init_coarse_cells( ecl_grid_type * ecl_grid ) {
   if (ecl_grid->coarsening_active) {
     int global_index;
     for (global_index = 0; global_index < ecl_grid->size; global_index++) {
-      ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
-      if (cell->coarse_group != COARSE_GROUP_NONE) {
-        ecl_coarse_cell_type * coarse_cell = ecl_grid_get_or_create_coarse_cell( ecl_grid , cell->coarse_group);
+      int coarse_group = ecl_grid_get_coarse_group__( ecl_grid , global_index );
+      if (coarse_group != COARSE_GROUP_NONE) {
+        ecl_coarse_cell_type * coarse_cell = ecl_grid_get_or_create_coarse_cell( ecl_grid , coarse_group);
         int i,j,k;
         ecl_grid_get_ijk1( ecl_grid , global_index , &i , &j , &k);
         ecl_coarse_cell_update( coarse_cell , i , j , k , global_index );
@@ -1938,11 +2417,11 @@ ecl_coarse_cell_type * ecl_grid_iget_coarse_group( const ecl_grid_type * ecl_gri
 
 
 ecl_coarse_cell_type * ecl_grid_get_cell_coarse_group1( const ecl_grid_type * ecl_grid , int global_index) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
-  if (cell->coarse_group == COARSE_GROUP_NONE)
+  int coarse_group = ecl_grid_get_coarse_group__( ecl_grid , global_index );
+  if (coarse_group == COARSE_GROUP_NONE)
     return NULL;
   else
-    return ecl_grid_iget_coarse_group( ecl_grid , cell->coarse_group );
+    return ecl_grid_iget_coarse_group( ecl_grid , coarse_group );
 }
 
 
@@ -1953,8 +2432,7 @@ ecl_coarse_cell_type * ecl_grid_get_cell_coarse_group3( const ecl_grid_type * ec
 
 
 bool ecl_grid_cell_in_coarse_group1( const ecl_grid_type * main_grid , int global_index ) {
-  ecl_cell_type * cell = ecl_grid_get_cell( main_grid , global_index );
-  if (cell->coarse_group == COARSE_GROUP_NONE )
+  if (ecl_grid_get_coarse_group__( main_grid , global_index ) == COARSE_GROUP_NONE )
     return false;
   else
     return true;
@@ -2084,11 +2562,9 @@ static void ecl_grid_install_lgr_EGRID(ecl_grid_type * host_grid , ecl_grid_type
 
   for (global_lgr_index = 0; global_lgr_index < lgr_grid->size; global_lgr_index++) {
     int host_index = hostnum[ global_lgr_index ] - 1;
-    ecl_cell_type * lgr_cell  = ecl_grid_get_cell( lgr_grid , global_lgr_index);
-    ecl_cell_type * host_cell = ecl_grid_get_cell( host_grid ,  host_index );
 
-    ecl_cell_install_lgr( host_cell , lgr_grid );
-    lgr_cell->host_cell = host_index;
+    ecl_grid_set_cell_lgr__( host_grid , host_index , lgr_grid );
+    ecl_grid_set_host_cell__( lgr_grid , global_lgr_index , host_index );
   }
   ecl_grid_install_lgr_common( host_grid , lgr_grid );
 }
@@ -2100,11 +2576,9 @@ static void ecl_grid_install_lgr_EGRID(ecl_grid_type * host_grid , ecl_grid_type
 static void ecl_grid_install_lgr_GRID(ecl_grid_type * host_grid , ecl_grid_type * lgr_grid) {
   int global_lgr_index;
 
-  for (global_lgr_index = 0; global_lgr_index < lgr_grid->size; global_lgr_index++) {
-    ecl_cell_type * lgr_cell = ecl_grid_get_cell( lgr_grid , global_lgr_index);
-    ecl_cell_type * host_cell = ecl_grid_get_cell( host_grid , lgr_cell->host_cell );
-    ecl_cell_install_lgr( host_cell , lgr_grid );
-  }
+  for (global_lgr_index = 0; global_lgr_index < lgr_grid->size; global_lgr_index++)
+    ecl_grid_set_cell_lgr__( host_grid , ecl_grid_get_host_cell__( lgr_grid , global_lgr_index ) , lgr_grid );
+
   ecl_grid_install_lgr_common( host_grid , lgr_grid );
 }
 
@@ -2189,82 +2663,209 @@ int ecl_grid_zcorn_index(const ecl_grid_type * grid , int i, int j , int k , int
 }
 
 
-static void ecl_grid_init_GRDECL_data_jslice(ecl_grid_type * ecl_grid ,  const float * zcorn , const float * coord , const int * actnum, const int * corsnum , int j) {
-  const int nx = ecl_grid->nx;
-  const int ny = ecl_grid->ny;
-  const int nz = ecl_grid->nz;
-  int i;
+static void ecl_grid_init_corsnum__( ecl_grid_type * ecl_grid , const int * corsnum ) {
+  if (corsnum != NULL) {
+    const int size = ecl_grid->size;
+    int global_index;
+    ecl_grid_alloc_coarse_group( ecl_grid );
+#pragma omp parallel for
+    for (global_index = 0; global_index < size; global_index++)
+      ecl_grid->coarse_group[global_index] = corsnum[ global_index ] - 1;
+  }
+}
 
 
-  for (i=0; i < nx; i++) {
-    point_type pillars[4][2];
-    int pillar_index[4];
-    pillar_index[0] = 6 * ( j      * (nx + 1) + i    );
-    pillar_index[1] = 6 * ( j      * (nx + 1) + i + 1);
-    pillar_index[2] = 6 * ((j + 1) * (nx + 1) + i    );
-    pillar_index[3] = 6 * ((j + 1) * (nx + 1) + i + 1);
+/*
+  Compact geometry: the grids loaded from EGRID files and GRDECL
+  keywords do not store the cells. Instead the grid stores the top
+  point and direction of each pillar, calculated from COORD, a copy of
+  ZCORN and a bitset of the tainted cells. The corners of a cell are
+  calculated with ecl_grid_compute_cell() every time the cell is
+  accessed through ecl_grid_get_cell_geometry(); this uses exactly the
+  same arithmetic as was used when the cells were stored, so the
+  corners are bitwise identical. Observe that the volume and center of
+  a compact cell are not cached, they are recalculated on every call.
+*/
 
-    {
-      int ip;
-      for (ip = 0; ip < 4; ip++) {
-        int index = pillar_index[ip];
-        point_set(&pillars[ip][0] , coord[index] , coord[index + 1] , coord[index + 2]);
+static void ecl_grid_init_pillars( ecl_grid_type * ecl_grid , const float * coord ) {
+  const int num_pillars = (ecl_grid->nx + 1) * (ecl_grid->ny + 1);
+  int ip;
 
-        index += 3;
-        point_set(&pillars[ip][1] , coord[index] , coord[index + 1] , coord[index + 2]);
-      }
+  ecl_grid->pillars = util_calloc( 6 * num_pillars , sizeof * ecl_grid->pillars );
+  for (ip = 0; ip < num_pillars; ip++) {
+    const float * pillar_coord = &coord[6 * ip];
+    double * pillar = &ecl_grid->pillars[6 * ip];
+    point_type p0 , p1;
+
+    point_set( &p0 , pillar_coord[0] , pillar_coord[1] , pillar_coord[2] );
+    point_set( &p1 , pillar_coord[3] , pillar_coord[4] , pillar_coord[5] );
+
+    pillar[0] = p0.x;
+    pillar[1] = p0.y;
+    pillar[2] = p0.z;
+    pillar[3] = p1.x - p0.x;
+    pillar[4] = p1.y - p0.y;
+    pillar[5] = p1.z - p0.z;
+  }
+}
+
+
+static void ecl_grid_compute_cell( const ecl_grid_type * grid , int i , int j , int k , ecl_cell_type * cell ) {
+  const int nx = grid->nx;
+  const int ny = grid->ny;
+  const float * zcorn = grid->zcorn;
+  const int global_index = i + j * nx + k * nx * ny;
+  int pillar_index[4];
+  double z[4][2];
+  int ip;
+
+  pillar_index[0] = 6 * ( j      * (nx + 1) + i    );
+  pillar_index[1] = 6 * ( j      * (nx + 1) + i + 1);
+  pillar_index[2] = 6 * ((j + 1) * (nx + 1) + i    );
+  pillar_index[3] = 6 * ((j + 1) * (nx + 1) + i + 1);
+
+  {
+    int c;
+    for (c = 0; c < 2; c++) {
+      z[0][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i            + c*4*nx*ny];
+      z[1][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i  +  1      + c*4*nx*ny];
+      z[2][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i     + c*4*nx*ny];
+      z[3][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i + 1 + c*4*nx*ny];
     }
+  }
 
-    {
-      double ex[4];
-      double ey[4];
-      double ez[4];
-      int k;
+  ecl_cell_init( cell , true );
+  for (ip = 0; ip < 4; ip++) {
+    const double * pillar = &grid->pillars[pillar_index[ip]];
+    point_type p0;
+    double x[2];
+    double y[2];
+    int iz;
 
-      {
-        int ip;
-        for (ip = 0; ip <  4; ip++) {
-          ex[ip] = pillars[ip][1].x - pillars[ip][0].x;
-          ey[ip] = pillars[ip][1].y - pillars[ip][0].y;
-          ez[ip] = pillars[ip][1].z - pillars[ip][0].z;
-        }
-      }
+    point_set( &p0 , pillar[0] , pillar[1] , pillar[2] );
+    ecl_grid_pillar_cross_planes( &p0 , pillar[3] , pillar[4] , pillar[5] , z[ip] , x , y );
+    for (iz = 0; iz < 2; iz++) {
+      int c = ip + iz * 4;
+      point_set(&cell->corner_list[c] , x[iz] , y[iz] , z[ip][iz]);
 
+      if (grid->use_mapaxes)
+        point_mapaxes_transform( &cell->corner_list[c] , grid->origo , grid->unit_x , grid->unit_y );
+    }
+  }
 
-      for (k=0; k < nz; k++) {
-        double x[4][2];
-        double y[4][2];
-        double z[4][2];
+  if (grid->tainted[ECL_GRID_TAINTED_BYTE( global_index )] & ECL_GRID_TAINTED_BIT( global_index ))
+    SET_CELL_FLAG(cell , CELL_FLAG_TAINTED);
+}
 
-        {
-          int c;
-          for (c = 0; c < 2; c++) {
-            z[0][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i            + c*4*nx*ny];
-            z[1][c] = zcorn[k*8*nx*ny + j*4*nx + 2*i  +  1      + c*4*nx*ny];
-            z[2][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i     + c*4*nx*ny];
-            z[3][c] = zcorn[k*8*nx*ny + j*4*nx + 2*nx + 2*i + 1 + c*4*nx*ny];
-          }
-        }
 
-        {
-          int ip;
-          for (ip = 0; ip <  4; ip++)
-            ecl_grid_pillar_cross_planes(&pillars[ip][0] , ex[ip], ey[ip] , ez[ip] , z[ip] , x[ip] , y[ip]);
-        }
+static void ecl_grid_taint_compact_cell( ecl_grid_type * ecl_grid , int global_index ) {
+  ecl_cell_type cell;
+  int i = global_index % ecl_grid->nx;
+  int j = (global_index / ecl_grid->nx) % ecl_grid->ny;
+  int k = global_index / (ecl_grid->nx * ecl_grid->ny);
+
+  ecl_grid_compute_cell( ecl_grid , i , j , k , &cell );
+  ecl_cell_taint_cell( &cell , ecl_grid->cell_active[global_index] );
+  if (GET_CELL_FLAG( (&cell) , CELL_FLAG_TAINTED ))
+    ecl_grid->tainted[ECL_GRID_TAINTED_BYTE( global_index )] |= ECL_GRID_TAINTED_BIT( global_index );
+}
+
+
+/*
+  Will taint all the cells which have not been tainted already; the
+  loop runs over the bytes of the bitset to avoid updating the same
+  byte from several threads.
+*/
 
-        ecl_grid_set_cell_EGRID(ecl_grid , i , j , k , x , y , z , actnum , corsnum);
+static void ecl_grid_taint_compact_cells( ecl_grid_type * ecl_grid ) {
+  const int size = ecl_grid->size;
+  const int num_bytes = (size + 7) / 8;
+  int byte_index;
+
+#pragma omp parallel for
+  for (byte_index = 0; byte_index < num_bytes; byte_index++) {
+    int global_index;
+    for (global_index = 8 * byte_index; global_index < util_int_min( 8 * byte_index + 8 , size); global_index++) {
+      if (ecl_grid->lazy_jslice_init) {
+        int j = (global_index / ecl_grid->nx) % ecl_grid->ny;
+        if (ecl_grid->lazy_jslice_init[j])
+          continue;
       }
+      ecl_grid_taint_compact_cell( ecl_grid , global_index );
     }
   }
 }
 
 
 void ecl_grid_init_GRDECL_data(ecl_grid_type * ecl_grid ,  const float * zcorn , const float * coord , const int * actnum, const int * corsnum) {
+  const size_t tainted_size = (ecl_grid->size + 7) / 8;
+
+  ecl_grid_init_corsnum__( ecl_grid , corsnum );
+  ecl_grid_init_actnum__( ecl_grid , actnum );
+
+  ecl_grid_init_pillars( ecl_grid , coord );
+  ecl_grid->zcorn = util_alloc_copy( zcorn , ecl_grid_get_zcorn_size( ecl_grid ) * sizeof * zcorn );
+  ecl_grid->tainted = util_calloc( tainted_size , sizeof * ecl_grid->tainted );
+  if (tainted_size > 0)
+    memset( ecl_grid->tainted , 0 , tainted_size * sizeof * ecl_grid->tainted );
+}
+
+
+/*
+  Lazy geometry: when a grid is loaded with lazy geometry the tainting
+  heuristics are not applied when the grid is loaded; instead they are
+  applied to all the cells in one j slice the first time the geometry
+  of a cell in that slice is accessed. A user which only needs the
+  topology of the grid will never calculate the corners of a cell.
+
+  Initializing the lazy geometry modifies the grid, concurrent access
+  is only safe after ecl_grid_assert_geometry() has been called.
+*/
+
+static void ecl_grid_free_lazy_geometry( ecl_grid_type * ecl_grid ) {
+  free( ecl_grid->lazy_jslice_init );
+  ecl_grid->lazy_jslice_init = NULL;
+  ecl_grid->lazy_jslice_count = 0;
+}
+
+
+static void ecl_grid_init_lazy_jslice( const ecl_grid_type * grid , int j ) {
+  ecl_grid_type * ecl_grid = (ecl_grid_type *) grid;
+  const int nx = ecl_grid->nx;
   const int ny = ecl_grid->ny;
+  int i,k;
+
+  for (k=0; k < ecl_grid->nz; k++)
+    for (i=0; i < nx; i++)
+      ecl_grid_taint_compact_cell( ecl_grid , i + j*nx + k*nx*ny );
+
+  ecl_grid->lazy_jslice_init[j] = true;
+  ecl_grid->lazy_jslice_count--;
+  if (ecl_grid->lazy_jslice_count == 0)
+    ecl_grid_free_lazy_geometry( ecl_grid );
+}
+
+
+/*
+  Will taint all the cells in a grid with lazy geometry. For a grid
+  without lazy geometry this is a noop.
+*/
+
+static void ecl_grid_assert_geometry( const ecl_grid_type * grid ) {
+  if (grid->lazy_jslice_init) {
+    ecl_grid_type * ecl_grid = (ecl_grid_type *) grid;
+    ecl_grid_taint_compact_cells( ecl_grid );
+    ecl_grid_free_lazy_geometry( ecl_grid );
+  }
+}
+
+
+static void ecl_grid_init_lazy_geometry( ecl_grid_type * ecl_grid ) {
   int j;
-#pragma omp parallel for
-  for ( j=0; j < ny; j++)
-    ecl_grid_init_GRDECL_data_jslice( ecl_grid , zcorn, coord , actnum , corsnum , j );
+  ecl_grid->lazy_jslice_init = util_calloc( ecl_grid->ny , sizeof * ecl_grid->lazy_jslice_init );
+  for (j=0; j < ecl_grid->ny; j++)
+    ecl_grid->lazy_jslice_init[j] = false;
+  ecl_grid->lazy_jslice_count = ecl_grid->ny;
 }
 
 
@@ -2278,9 +2879,15 @@ void ecl_grid_init_GRDECL_data(ecl_grid_type * ecl_grid ,  const float * zcorn ,
 static ecl_grid_type * ecl_grid_alloc_GRDECL_data__(ecl_grid_type * global_grid ,
                                                     int dualp_flag , bool apply_mapaxes, int nx , int ny , int nz ,
                                                     const float * zcorn , const float * coord , const int * actnum, const float * mapaxes, const int * corsnum,
-                                                    int lgr_nr) {
+                                                    int lgr_nr , bool lazy_geometry) {
+
+  ecl_grid_type * ecl_grid;
 
-  ecl_grid_type * ecl_grid = ecl_grid_alloc_empty(global_grid , dualp_flag , nx,ny,nz,lgr_nr,true);
+  /* A grid without cells is loaded normally. */
+  if (nx*ny*nz == 0)
+    lazy_geometry = false;
+
+  ecl_grid = ecl_grid_alloc_empty__(global_grid , dualp_flag , nx,ny,nz,lgr_nr,true , false);
   if (ecl_grid) {
     if (mapaxes != NULL)
       ecl_grid_init_mapaxes( ecl_grid , apply_mapaxes, mapaxes );
@@ -2293,7 +2900,10 @@ static ecl_grid_type * ecl_grid_alloc_GRDECL_data__(ecl_grid_type * global_grid
 
     ecl_grid_init_coarse_cells( ecl_grid );
     ecl_grid_update_index( ecl_grid );
-    ecl_grid_taint_cells( ecl_grid );
+    if (lazy_geometry)
+      ecl_grid_init_lazy_geometry( ecl_grid );
+    else
+      ecl_grid_taint_compact_cells( ecl_grid );
   }
   return ecl_grid;
 }
@@ -2314,15 +2924,36 @@ static void ecl_grid_copy_mapaxes( ecl_grid_type * target_grid , const ecl_grid_
 }
 
 
+static void ecl_grid_copy_compact_geometry( ecl_grid_type * target_grid , const ecl_grid_type * src_grid ) {
+  ecl_grid_assert_geometry( src_grid );
+  target_grid->pillars = util_alloc_copy( src_grid->pillars , ecl_grid_get_coord_size( src_grid ) * sizeof * src_grid->pillars );
+  target_grid->zcorn   = util_alloc_copy( src_grid->zcorn , ecl_grid_get_zcorn_size( src_grid ) * sizeof * src_grid->zcorn );
+  target_grid->tainted = util_alloc_copy( src_grid->tainted , (src_grid->size + 7) / 8 * sizeof * src_grid->tainted );
+}
+
+
 static void ecl_grid_copy_content( ecl_grid_type * target_grid , const ecl_grid_type * src_grid ) {
   int global_index;
+  if (src_grid->pillars)
+    ecl_grid_copy_compact_geometry( target_grid , src_grid );
+
   for (global_index = 0; global_index  < src_grid->size; global_index++) {
-    ecl_cell_type * target_cell = ecl_grid_get_cell( target_grid , global_index);
-    const ecl_cell_type * src_cell = ecl_grid_get_cell( src_grid , global_index );
+    if (!src_grid->pillars)
+      ecl_cell_memcpy( ecl_grid_get_cell( target_grid , global_index) , ecl_grid_get_cell( src_grid , global_index ));
+
+    target_grid->cell_active[global_index] = src_grid->cell_active[global_index];
+    ecl_grid_set_host_cell__( target_grid , global_index , ecl_grid_get_host_cell__( src_grid , global_index ));
+    ecl_grid_set_coarse_group__( target_grid , global_index , ecl_grid_get_coarse_group__( src_grid , global_index ));
+  }
 
-    ecl_cell_memcpy( target_cell , src_cell );
-    if (src_cell->nnc_info)
-      target_cell->nnc_info = nnc_info_alloc_copy( src_cell->nnc_info );
+  ecl_grid_assert_nnc( src_grid );
+  if (src_grid->nnc_offset) {
+    int num_nnc = src_grid->nnc_offset[src_grid->size];
+    ecl_grid_free_nnc( target_grid );
+    target_grid->nnc_offset       = util_alloc_copy( src_grid->nnc_offset , (src_grid->size + 1) * sizeof * src_grid->nnc_offset );
+    target_grid->nnc_lgr_nr       = util_alloc_copy( src_grid->nnc_lgr_nr , num_nnc * sizeof * src_grid->nnc_lgr_nr );
+    target_grid->nnc_global_index = util_alloc_copy( src_grid->nnc_global_index , num_nnc * sizeof * src_grid->nnc_global_index );
+    target_grid->nnc_input_index  = util_alloc_copy( src_grid->nnc_input_index , num_nnc * sizeof * src_grid->nnc_input_index );
   }
   ecl_grid_copy_mapaxes( target_grid , src_grid );
 
@@ -2334,13 +2965,14 @@ static void ecl_grid_copy_content( ecl_grid_type * target_grid , const ecl_grid_
 }
 
 static ecl_grid_type * ecl_grid_alloc_copy__( const ecl_grid_type * src_grid,  ecl_grid_type * main_grid ) {
-  ecl_grid_type * copy_grid = ecl_grid_alloc_empty( main_grid ,
-                                                    src_grid->dualp_flag ,
-                                                    ecl_grid_get_nx( src_grid ) ,
-                                                    ecl_grid_get_ny( src_grid ) ,
-                                                    ecl_grid_get_nz( src_grid ) ,
-                                                    0 ,
-                                                    false );
+  ecl_grid_type * copy_grid = ecl_grid_alloc_empty__( main_grid ,
+                                                      src_grid->dualp_flag ,
+                                                      ecl_grid_get_nx( src_grid ) ,
+                                                      ecl_grid_get_ny( src_grid ) ,
+                                                      ecl_grid_get_nz( src_grid ) ,
+                                                      0 ,
+                                                      false ,
+                                                      src_grid->pillars == NULL );
   if (copy_grid) {
     ecl_grid_copy_content( copy_grid , src_grid );  // This will handle everything except LGR relationships which is established in the calling routine
     ecl_grid_update_index( copy_grid );
@@ -2370,12 +3002,9 @@ ecl_grid_type * ecl_grid_alloc_copy( const ecl_grid_type * src_grid ) {
       {
         int global_lgr_index;
 
-        for (global_lgr_index = 0; global_lgr_index < copy_lgr->size; global_lgr_index++) {
-          ecl_cell_type * lgr_cell  = ecl_grid_get_cell( copy_lgr , global_lgr_index);
-          ecl_cell_type * host_cell = ecl_grid_get_cell( host_grid , lgr_cell->host_cell );
+        for (global_lgr_index = 0; global_lgr_index < copy_lgr->size; global_lgr_index++)
+          ecl_grid_set_cell_lgr__( host_grid , ecl_grid_get_host_cell__( copy_lgr , global_lgr_index ) , copy_lgr );
 
-          ecl_cell_install_lgr( host_cell , copy_lgr );
-        }
         ecl_grid_install_lgr_common( host_grid , copy_lgr );
 
       }
@@ -2432,7 +3061,7 @@ ecl_grid_type * ecl_grid_alloc_processed_copy( const ecl_grid_type * src_grid ,
 */
 
 ecl_grid_type * ecl_grid_alloc_GRDECL_data(int nx , int ny , int nz , const float * zcorn , const float * coord , const int * actnum, bool apply_mapaxes , const float * mapaxes) {
-  return ecl_grid_alloc_GRDECL_data__(NULL , FILEHEAD_SINGLE_POROSITY , apply_mapaxes , nx , ny , nz , zcorn , coord , actnum , mapaxes , NULL , 0);
+  return ecl_grid_alloc_GRDECL_data__(NULL , FILEHEAD_SINGLE_POROSITY , apply_mapaxes , nx , ny , nz , zcorn , coord , actnum , mapaxes , NULL , 0 , false);
 }
 
 
@@ -2461,7 +3090,8 @@ static ecl_grid_type * ecl_grid_alloc_GRDECL_kw__(ecl_grid_type * global_grid ,
                                                   const ecl_kw_type * coord_kw ,
                                                   const ecl_kw_type * actnum_kw ,    /* Can be NULL */
                                                   const ecl_kw_type * mapaxes_kw ,   /* Can be NULL */
-                                                  const ecl_kw_type * corsnum_kw) {   /* Can be NULL */
+                                                  const ecl_kw_type * corsnum_kw ,   /* Can be NULL */
+                                                  bool lazy_geometry) {
    int gtype, nx,ny,nz, lgr_nr;
 
   gtype   = ecl_kw_iget_int(gridhead_kw , GRIDHEAD_TYPE_INDEX);
@@ -2505,7 +3135,8 @@ static ecl_grid_type * ecl_grid_alloc_GRDECL_kw__(ecl_grid_type * global_grid ,
                                         actnum_data,
                                         mapaxes_data,
                                         corsnum_data,
-                                        lgr_nr);
+                                        lgr_nr ,
+                                        lazy_geometry);
   }
 }
 
@@ -2525,7 +3156,7 @@ ecl_grid_type * ecl_grid_alloc_GRDECL_kw( int nx, int ny , int nz ,
 
   bool apply_mapaxes = true;
   ecl_kw_type * gridhead_kw = ecl_grid_alloc_gridhead_kw( nx , ny , nz , 0);
-  ecl_grid_type * ecl_grid = ecl_grid_alloc_GRDECL_kw__(NULL , FILEHEAD_SINGLE_POROSITY , apply_mapaxes , gridhead_kw , zcorn_kw , coord_kw , actnum_kw , mapaxes_kw , NULL);
+  ecl_grid_type * ecl_grid = ecl_grid_alloc_GRDECL_kw__(NULL , FILEHEAD_SINGLE_POROSITY , apply_mapaxes , gridhead_kw , zcorn_kw , coord_kw , actnum_kw , mapaxes_kw , NULL , false);
   ecl_kw_free( gridhead_kw );
   return ecl_grid;
 
@@ -2536,12 +3167,6 @@ ecl_grid_type * ecl_grid_alloc_GRDECL_kw( int nx, int ny , int nz ,
 
 
 
-static void ecl_grid_init_cell_nnc_info(ecl_grid_type * ecl_grid, int global_index) {
-  ecl_cell_type * grid_cell = ecl_grid_get_cell(ecl_grid, global_index);
-
-  if (!grid_cell->nnc_info)
-    grid_cell->nnc_info = nnc_info_alloc(ecl_grid->lgr_nr);
-}
 
 /*
   The function ecl_grid_add_self_nnc() will add a NNC connection
@@ -2587,21 +3212,21 @@ static void ecl_grid_init_cell_nnc_info(ecl_grid_type * ecl_grid, int global_ind
 */
 
 void ecl_grid_add_self_nnc( ecl_grid_type * grid, int cell_index1, int cell_index2, int nnc_index) {
-  ecl_cell_type * grid_cell = ecl_grid_get_cell(grid, cell_index1);
-  ecl_grid_init_cell_nnc_info(grid, cell_index1);
-  nnc_info_add_nnc(grid_cell->nnc_info, grid->lgr_nr, cell_index2, nnc_index);
+  ecl_grid_add_nnc__( grid , cell_index1 , grid->lgr_nr , cell_index2 , nnc_index );
 }
 
 /*
   This function will add all the nnc connections given by the g1_list
   and g2_list arrays. The ncc connections will be added with
-  consecutively running nnc_index = [0,num_nnc).
+  consecutively running nnc_index = [0,num_nnc). Like
+  ecl_grid_add_self_nnc() the connections are merged into the grid
+  the first time the nnc are read.
 */
 
 void ecl_grid_add_self_nnc_list( ecl_grid_type * grid, const int * g1_list , const int * g2_list , int num_nnc ) {
   int i;
   for (i = 0; i < num_nnc; i++)
-    ecl_grid_add_self_nnc( grid , g1_list[i] , g2_list[i] , i );
+    ecl_grid_add_nnc__( grid , g1_list[i] , grid->lgr_nr , g2_list[i] , i );
 }
 
 /*
@@ -2650,11 +3275,7 @@ static void ecl_grid_init_nnc_cells( ecl_grid_type * grid1, ecl_grid_type * grid
 
 
 
-    {
-      ecl_cell_type * grid1_cell = ecl_grid_get_cell(grid1, grid1_cell_index);
-      ecl_grid_init_cell_nnc_info(grid1, grid1_cell_index);
-      nnc_info_add_nnc(grid1_cell->nnc_info, grid2->lgr_nr, grid2_cell_index , nnc_index);
-    }
+    ecl_grid_add_nnc__( grid1 , grid1_cell_index , grid2->lgr_nr , grid2_cell_index , nnc_index );
   }
 }
 
@@ -2741,7 +3362,7 @@ static void ecl_grid_init_nnc_amalgamated(ecl_grid_type * main_grid, ecl_file_ty
 */
 
 
-static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const ecl_file_type * ecl_file , int grid_nr, bool apply_mapaxes) {
+static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const ecl_file_type * ecl_file , int grid_nr, bool apply_mapaxes , bool lazy_geometry) {
   ecl_kw_type * gridhead_kw  = ecl_file_iget_named_kw( ecl_file , GRIDHEAD_KW  , grid_nr);
   ecl_kw_type * zcorn_kw     = ecl_file_iget_named_kw( ecl_file , ZCORN_KW     , grid_nr);
   ecl_kw_type * coord_kw     = ecl_file_iget_named_kw( ecl_file , COORD_KW     , grid_nr);
@@ -2784,7 +3405,8 @@ static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const
                                                            coord_kw ,
                                                            actnum_kw ,
                                                            mapaxes_kw ,
-                                                           corsnum_kw );
+                                                           corsnum_kw ,
+                                                           lazy_geometry);
 
     if (ECL_GRID_MAINGRID_LGR_NR != grid_nr) ecl_grid_set_lgr_name_EGRID(ecl_grid , ecl_file , grid_nr);
     ecl_grid->eclipse_version = eclipse_version;
@@ -2794,7 +3416,7 @@ static ecl_grid_type * ecl_grid_alloc_EGRID__( ecl_grid_type * main_grid , const
 
 
 
-ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes) {
+static ecl_grid_type * ecl_grid_alloc_EGRID_file(const char * grid_file, bool apply_mapaxes , bool lazy_geometry) {
   ecl_file_enum   file_type;
   file_type = ecl_util_get_file_type(grid_file , NULL , NULL);
   if (file_type != ECL_EGRID_FILE)
@@ -2803,11 +3425,11 @@ ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes)
     ecl_file_type * ecl_file   = ecl_file_open( grid_file , 0);
     if (ecl_file) {
       int num_grid               = ecl_file_get_num_named_kw( ecl_file , GRIDHEAD_KW );
-      ecl_grid_type * main_grid  = ecl_grid_alloc_EGRID__( NULL , ecl_file , 0 , apply_mapaxes);
+      ecl_grid_type * main_grid  = ecl_grid_alloc_EGRID__( NULL , ecl_file , 0 , apply_mapaxes , lazy_geometry);
       int grid_nr;
 
       for ( grid_nr = 1; grid_nr < num_grid; grid_nr++) {
-        ecl_grid_type * lgr_grid = ecl_grid_alloc_EGRID__( main_grid , ecl_file , grid_nr , false);  /* The apply_mapaxes argument is ignored for LGR - it inherits from parent anyway. */
+        ecl_grid_type * lgr_grid = ecl_grid_alloc_EGRID__( main_grid , ecl_file , grid_nr , false , lazy_geometry);  /* The apply_mapaxes argument is ignored for LGR - it inherits from parent anyway. */
         ecl_grid_add_lgr( main_grid , lgr_grid );
         {
           ecl_grid_type * host_grid;
@@ -2823,6 +3445,12 @@ ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes)
       main_grid->name = util_alloc_string_copy( grid_file );
       ecl_grid_init_nnc(main_grid, ecl_file);
       ecl_grid_init_nnc_amalgamated(main_grid, ecl_file);
+      {
+        int grid_nr;
+        ecl_grid_merge_nnc( main_grid );
+        for (grid_nr = 0; grid_nr < vector_get_size( main_grid->LGR_list ); grid_nr++)
+          ecl_grid_merge_nnc( vector_iget( main_grid->LGR_list , grid_nr ));
+      }
 
       ecl_file_close( ecl_file );
       return main_grid;
@@ -2832,6 +3460,11 @@ ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes)
 }
 
 
+ecl_grid_type * ecl_grid_alloc_EGRID(const char * grid_file, bool apply_mapaxes) {
+  return ecl_grid_alloc_EGRID_file( grid_file , apply_mapaxes , false );
+}
+
+
 
 
 
@@ -3094,10 +3727,11 @@ ecl_grid_type * ecl_grid_alloc_regular( int nx, int ny , int nz , const double *
           };
 
           ecl_cell_type * cell = ecl_grid_get_cell(grid , global_index );
-          ecl_cell_init_regular( cell , offset , i,j,k,global_index , ivec , jvec , kvec , actnum );
+          ecl_cell_init_regular( cell , offset , ivec , jvec , kvec );
         }
       }
     }
+    ecl_grid_init_actnum__( grid , actnum );
     ecl_grid_update_index( grid );
   }
 
@@ -3160,15 +3794,14 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv( int nx, int ny , int nz , const doub
             ivec[0] = dxv[i];
 
             ecl_cell_init_regular(cell, offset,
-                                  i,j,k,global_index,
-                                  ivec,jvec,kvec,
-                                  actnum);
+                                  ivec,jvec,kvec);
             offset[0] += dxv[i];
           }
           offset[1] += dyv[j];
         }
         offset[2] += dzv[k];
       }
+      ecl_grid_init_actnum__( grid , actnum );
       ecl_grid_update_index(grid);
     }
 
@@ -3239,22 +3872,8 @@ ecl_grid_type * ecl_grid_alloc_dxv_dyv_dzv_depthz( int nx, int ny , int nz , con
       }
     }
 
-    if (grid) {
-      int i,j,k;
-      for (k=0; k < nz; k++) {
-        for (j=0; j <ny; j++) {
-          for (i=0; i < nx; i++) {
-            int global_index = i + j*nx + k*nx*ny;
-            ecl_cell_type* cell = ecl_grid_get_cell(grid, global_index);
-
-            if (actnum)
-              cell->active = actnum[global_index];
-            else
-              cell->active = CELL_ACTIVE;
-          }
-        }
-      }
-    }
+    if (grid)
+      ecl_grid_init_actnum__( grid , actnum );
 
     if (grid)
       ecl_grid_update_index(grid);
@@ -3313,15 +3932,11 @@ ecl_grid_type * ecl_grid_alloc_dx_dy_dz_tops( int nx, int ny , int nz , const do
 
           x0    += dx[g];
           y0[i] += dy[g];
-
-          if (actnum != NULL)
-            cell->active = actnum[g];
-          else
-            cell->active = CELL_ACTIVE;
         }
       }
     }
     free( y0 );
+    ecl_grid_init_actnum__( grid , actnum );
 
     ecl_grid_update_index(grid);
   }
@@ -3362,6 +3977,27 @@ ecl_grid_type * ecl_grid_alloc(const char * grid_file ) {
 }
 
 
+/**
+   Will load the grid with lazy geometry, see the comment above
+   ecl_grid_init_lazy_jslice(). Like all EGRID grids the cell corners
+   are calculated from the pillars and ZCORN when they are needed; in
+   addition the tainting heuristics are deferred, and applied to one j
+   slice the first time a cell in that slice is accessed. The grid can
+   be used exactly like a grid from ecl_grid_alloc(). This is only
+   supported for EGRID files, a GRID file is loaded normally.
+*/
+
+ecl_grid_type * ecl_grid_alloc_lazy(const char * grid_file ) {
+  bool apply_mapaxes = true;
+  ecl_file_enum file_type = ecl_util_get_file_type(grid_file , NULL ,  NULL);
+
+  if (file_type == ECL_EGRID_FILE)
+    return ecl_grid_alloc_EGRID_file( grid_file , apply_mapaxes , true );
+  else
+    return ecl_grid_alloc__( grid_file , apply_mapaxes );
+}
+
+
 static void ecl_grid_file_nactive_dims( fortio_type * data_fortio , int * dims) {
   if (data_fortio) {
     if (ecl_kw_fseek_kw( INTEHEAD_KW , false , false , data_fortio )) {
@@ -3546,116 +4182,738 @@ char * ecl_grid_alloc_case_filename( const char * case_input ) {
   }
 }
 
-ecl_grid_type * ecl_grid_load_case__( const char * case_input , bool apply_mapaxes) {
-  ecl_grid_type * ecl_grid = NULL;
-  char * grid_file = ecl_grid_alloc_case_filename( case_input );
-  if (grid_file != NULL) {
-
-    if (util_file_exists( grid_file ))
-      ecl_grid = ecl_grid_alloc__( grid_file , apply_mapaxes);
+/*****************************************************************/
+/* Grid cache */
 
-    free( grid_file );
-  }
-  return ecl_grid;
-}
+/*
+  The grid cache is a binary image of a fully processed grid, i.e. the
+  cells with corners and flags - or for grids with compact geometry
+  the pillars, ZCORN and the tainted bitset - the active status, the
+  lgr grids and the host, coarsening and nnc information. The arrays
+  are stored raw in native byte order, i.e. the cache can only be read
+  by the same version of the library on the same architecture; that
+  is checked with the version number and the size of ecl_cell_type in
+  the header.
+
+  The cache is keyed on the size, modification time and inode of the
+  grid file, and on the apply_mapaxes setting; when one of these does
+  not match the cache is ignored. A hash of the content of the grid
+  file is also stored in the cache, and if the environment variable
+  ECL_GRID_CACHE_VERIFY is set the hash is checked as well; that
+  costs a full read of the grid file, but catches a grid file which
+  has been rewritten with the same size within the resolution of the
+  file system timestamps.
+
+  Large cell and ZCORN arrays are stored at an offset aligned to
+  ECL_GRID_CACHE_ALIGN in the cache file, and are mapped into memory
+  instead of being read. The mapping is private, so the cells cache
+  their volume in copy-on-write pages and the cache file itself is
+  never modified. The cache is written to a temporary file which is
+  renamed in place, so that several processes can create and read the
+  same cache concurrently, and a cache file which is in use is never
+  truncated.
+*/
 
-ecl_grid_type * ecl_grid_load_case( const char * case_input ) {
-  bool apply_mapaxes = true;
-  return ecl_grid_load_case__( case_input , apply_mapaxes );
-}
+#define ECL_GRID_CACHE_MAGIC       0x45474331
+#define ECL_GRID_CACHE_VERSION     5
+#define ECL_GRID_CACHE_EXT         "grid_cache"
+#define ECL_GRID_CACHE_DIR_ENV     "ECL_GRID_CACHE_DIR"
+#define ECL_GRID_NO_CACHE_ENV      "ECL_GRID_NO_CACHE"
+#define ECL_GRID_CACHE_VERIFY_ENV  "ECL_GRID_CACHE_VERIFY"
+#define ECL_GRID_CACHE_HASH_BLOCK  (1 << 20)
+#define ECL_GRID_CACHE_ALIGN       65536     /* Multiple of the page size on all supported platforms. */
+#define ECL_GRID_CACHE_MMAP_MIN    (1 << 20) /* Cell arrays smaller than this are read, and not padded for alignment. */
+#define ECL_GRID_CACHE_KEY_SIZE    4         /* file size, mtime seconds, mtime nanoseconds, inode */
 
 
+static uint64_t ecl_grid_cache_hash( uint64_t hash , const char * data , size_t size ) {
+  size_t offset = 0;
+  while (offset + sizeof(uint64_t) <= size) {
+    uint64_t word;
+    memcpy( &word , &data[offset] , sizeof word );
+    hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+    offset += sizeof word;
+  }
 
-bool ecl_grid_exists( const char * case_input ) {
-  bool exists = false;
-  char * grid_file = ecl_grid_alloc_case_filename( case_input );
-  if (grid_file != NULL) {
-    exists = true;
-    free( grid_file );
+  while (offset < size) {
+    hash = (hash ^ (unsigned char) data[offset]) * 0x100000001B3ULL;
+    offset++;
   }
-  return exists;
+  return hash;
 }
 
 
-static bool ecl_grid_compare_coarse_cells(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool verbose) {
-  if (vector_get_size( g1->coarse_cells ) == vector_get_size( g2->coarse_cells )) {
-    bool equal = true;
-    int c;
-
-    for (c = 0; c < vector_get_size( g1->coarse_cells ); c++) {
-      const ecl_coarse_cell_type * coarse_cell1 = vector_iget_const( g1->coarse_cells , c);
-      const ecl_coarse_cell_type * coarse_cell2 = vector_iget_const( g2->coarse_cells , c);
+static bool ecl_grid_cache_file_hash( const char * filename , int64_t * file_size , uint64_t * hash) {
+  FILE * stream = fopen( filename , "r" );
+  if (stream) {
+    char * block = util_malloc( ECL_GRID_CACHE_HASH_BLOCK );
+    size_t bytes;
+    *file_size = 0;
+    *hash = 0xCBF29CE484222325ULL;
 
-      equal = ecl_coarse_cell_equal( coarse_cell1 , coarse_cell2 );
-      if (!equal)
-        if (verbose) fprintf(stderr,"Difference in coarse cell:%d \n",c );
+    do {
+      bytes = fread( block , 1 , ECL_GRID_CACHE_HASH_BLOCK , stream );
+      *hash = ecl_grid_cache_hash( *hash , block , bytes );
+      *file_size += bytes;
+    } while (bytes == ECL_GRID_CACHE_HASH_BLOCK);
 
+    {
+      bool ok = !ferror( stream );
+      free( block );
+      fclose( stream );
+      return ok;
     }
-    return equal;
   } else
     return false;
 }
 
 
-static bool ecl_grid_compare_cells(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool include_nnc , bool verbose) {
-  int g;
-  bool equal = true;
-  for (g = 0; g < g1->size; g++) {
-    bool this_equal = true;
-    ecl_cell_type *c1 = ecl_grid_get_cell( g1 , g );
-    ecl_cell_type *c2 = ecl_grid_get_cell( g2 , g );
-    ecl_cell_compare(c1 , c2 ,  include_nnc , &this_equal);
+/*
+  The key identifying the version of the grid file the cache was
+  created from; the nanosecond part of the modification time is only
+  available on platforms where struct stat has the st_mtim field.
+*/
 
-    if (!this_equal) {
-      if (verbose) {
-        int i,j,k;
-        ecl_grid_get_ijk1( g1 , g , &i , &j , &k);
+static bool ecl_grid_cache_file_key( const char * filename , int64_t * key ) {
+  stat_type stat_buffer;
 
-        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , nnc_info_equal( c1->nnc_info , c2->nnc_info) , ecl_cell_get_volume( c1 ));
-        printf("-----------------------------------------------------------------\n");
-        ecl_cell_dump_ascii( c1 , i , j , k , stdout , NULL);
-        printf("-----------------------------------------------------------------\n");
-        ecl_cell_dump_ascii( c2 , i , j , k , stdout , NULL );
-        printf("-----------------------------------------------------------------\n");
+  if (util_stat( filename , &stat_buffer ) != 0)
+    return false;
 
-      }
-      equal = false;
-      break;
-    }
-  }
-  return equal;
+  key[0] = (int64_t) stat_buffer.st_size;
+  key[1] = (int64_t) stat_buffer.st_mtime;
+#ifdef HAVE_STAT_MTIM
+  key[2] = (int64_t) stat_buffer.st_mtim.tv_nsec;
+#else
+  key[2] = 0;
+#endif
+  key[3] = (int64_t) stat_buffer.st_ino;
+  return true;
 }
 
-static bool ecl_grid_compare_index(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool verbose) {
-  bool equal = true;
 
-  if (g1->total_active != g2->total_active) {
-    if (verbose)
-      fprintf(stderr,"Difference in total active:%d / %d\n",g1->total_active , g2->total_active);
-    equal = false;
-  }
+static void ecl_grid_cache_fwrite_string( const char * string , FILE * stream ) {
+  int length = string ? strlen( string ) : -1;
+  fwrite( &length , sizeof length , 1 , stream );
+  if (length > 0)
+    fwrite( string , 1 , length , stream );
+}
 
-  if (equal) {
-    if (memcmp( g1->index_map , g2->index_map , g1->size * sizeof * g1->index_map ) != 0) {
-      equal = false;
-      if (verbose)
-        fprintf(stderr,"Difference in index map \n");
-    }
-  }
 
-  if (equal) {
-    if (memcmp( g1->inv_index_map , g2->inv_index_map , g1->total_active * sizeof * g1->inv_index_map ) != 0) {
-      equal = false;
-      if (verbose)
-        fprintf(stderr,"Difference in inverse index map \n");
+static bool ecl_grid_cache_fread( void * ptr , size_t size , size_t count , FILE * stream ) {
+  return (fread( ptr , size , count , stream ) == count);
+}
+
+
+static bool ecl_grid_cache_fread_string( char ** string , FILE * stream ) {
+  int length;
+  *string = NULL;
+  if (!ecl_grid_cache_fread( &length , sizeof length , 1 , stream ))
+    return false;
+
+  if (length >= 0) {
+    *string = util_calloc( length + 1 , sizeof ** string );
+    (*string)[length] = '\0';
+    if (!ecl_grid_cache_fread( *string , 1 , length , stream )) {
+      free( *string );
+      *string = NULL;
+      return false;
     }
   }
+  return true;
+}
 
-  if (equal && (g1->dualp_flag != FILEHEAD_SINGLE_POROSITY)) {
-    if (g1->total_active_fracture != g2->total_active_fracture) {
-      if (verbose)
-        fprintf(stderr,"Difference in toal_active_fracture %d / %d \n",g1->total_active_fracture , g2->total_active_fracture);
-      equal = false;
+
+static void ecl_grid_cache_fwrite_int_table( const int * table , int size , FILE * stream ) {
+  int present = table ? 1 : 0;
+  fwrite( &present , sizeof present , 1 , stream );
+  if (table)
+    fwrite( table , sizeof * table , size , stream );
+}
+
+
+static bool ecl_grid_cache_fread_int_table( int ** table , int size , FILE * stream ) {
+  int present;
+  if (!ecl_grid_cache_fread( &present , sizeof present , 1 , stream ))
+    return false;
+
+  if (present) {
+    *table = util_calloc( size , sizeof ** table );
+    return ecl_grid_cache_fread( *table , sizeof ** table , size , stream );
+  }
+  return true;
+}
+
+
+/*
+  The cell and ZCORN arrays are preceded by the number of padding
+  bytes written to align large arrays to ECL_GRID_CACHE_ALIGN.
+*/
+
+static void ecl_grid_cache_fwrite_array( const void * data , size_t data_size , FILE * stream ) {
+  int padding = 0;
+
+  if (data_size >= ECL_GRID_CACHE_MMAP_MIN) {
+    offset_type offset = util_ftell( stream ) + sizeof padding;
+    padding = (ECL_GRID_CACHE_ALIGN - offset % ECL_GRID_CACHE_ALIGN) % ECL_GRID_CACHE_ALIGN;
+  }
+
+  fwrite( &padding , sizeof padding , 1 , stream );
+  {
+    int i;
+    for (i = 0; i < padding; i++)
+      fputc( 0 , stream );
+  }
+  fwrite( data , 1 , data_size , stream );
+}
+
+
+/*
+  Will read an array written with ecl_grid_cache_fwrite_array();
+  aligned arrays are mapped and *map_size is set to the size of the
+  mapping, other arrays are read into newly allocated memory.
+*/
+
+static bool ecl_grid_cache_fread_array( void ** data , size_t * map_size , size_t data_size , FILE * stream ) {
+  int padding;
+
+  if (!ecl_grid_cache_fread( &padding , sizeof padding , 1 , stream ))
+    return false;
+
+  if ((padding < 0) || (padding >= ECL_GRID_CACHE_ALIGN))
+    return false;
+
+  if ((padding > 0) && (util_fseek( stream , padding , SEEK_CUR ) != 0))
+    return false;
+
+  if (data_size == 0)
+    return true;
+
+#ifdef HAVE_MMAP
+  {
+    offset_type offset = util_ftell( stream );
+    if ((data_size >= ECL_GRID_CACHE_MMAP_MIN) && ((offset % ECL_GRID_CACHE_ALIGN) == 0) &&
+        (offset + data_size <= util_fd_size( fileno( stream )))) {
+      void * map = mmap( NULL , data_size , PROT_READ | PROT_WRITE , MAP_PRIVATE , fileno( stream ) , offset );
+      if (map != MAP_FAILED) {
+        *data = map;
+        *map_size = data_size;
+        return (util_fseek( stream , offset + data_size , SEEK_SET ) == 0);
+      }
+    }
+  }
+#endif
+
+  *data = malloc( data_size );
+  if (!*data)
+    return false;
+  return ecl_grid_cache_fread( *data , 1 , data_size , stream );
+}
+
+
+static void ecl_grid_fwrite_cache__( const ecl_grid_type * grid , FILE * stream ) {
+  {
+    int header[10] = { grid->lgr_nr , grid->nx , grid->ny , grid->nz , grid->dualp_flag ,
+                       grid->eclipse_version , grid->unit_system , grid->use_mapaxes , grid->coarsening_active ,
+                       grid->pillars ? 1 : 0 };
+    fwrite( header , sizeof header[0] , 10 , stream );
+    fwrite( grid->unit_x , sizeof grid->unit_x[0] , 2 , stream );
+    fwrite( grid->unit_y , sizeof grid->unit_y[0] , 2 , stream );
+    fwrite( grid->origo  , sizeof grid->origo[0]  , 2 , stream );
+  }
+  ecl_grid_cache_fwrite_string( grid->name , stream );
+  ecl_grid_cache_fwrite_string( grid->parent_name , stream );
+
+  {
+    int mapaxes_size = grid->mapaxes ? 6 : 0;
+    fwrite( &mapaxes_size , sizeof mapaxes_size , 1 , stream );
+    fwrite( grid->mapaxes , sizeof * grid->mapaxes , mapaxes_size , stream );
+  }
+
+  {
+    int coord_size = grid->coord_kw ? ecl_kw_get_size( grid->coord_kw ) : 0;
+    fwrite( &coord_size , sizeof coord_size , 1 , stream );
+    if (coord_size > 0)
+      fwrite( ecl_kw_get_float_ptr( grid->coord_kw ) , sizeof(float) , coord_size , stream );
+  }
+
+  if (grid->pillars) {
+    ecl_grid_assert_geometry( grid );
+    fwrite( grid->pillars , sizeof * grid->pillars , ecl_grid_get_coord_size( grid ) , stream );
+    ecl_grid_cache_fwrite_array( grid->zcorn , ecl_grid_get_zcorn_size( grid ) * sizeof * grid->zcorn , stream );
+    fwrite( grid->tainted , sizeof * grid->tainted , (grid->size + 7) / 8 , stream );
+  } else
+    ecl_grid_cache_fwrite_array( grid->cells , grid->size * sizeof * grid->cells , stream );
+  fwrite( grid->cell_active , sizeof * grid->cell_active , grid->size , stream );
+  ecl_grid_cache_fwrite_int_table( grid->host_cell , grid->size , stream );
+  ecl_grid_cache_fwrite_int_table( grid->coarse_group , grid->size , stream );
+
+  {
+    int num_nnc;
+
+    ecl_grid_assert_nnc( grid );
+    num_nnc = grid->nnc_offset ? grid->nnc_offset[grid->size] : 0;
+    fwrite( &num_nnc , sizeof num_nnc , 1 , stream );
+    if (num_nnc > 0) {
+      fwrite( grid->nnc_offset , sizeof * grid->nnc_offset , grid->size + 1 , stream );
+      fwrite( grid->nnc_lgr_nr , sizeof * grid->nnc_lgr_nr , num_nnc , stream );
+      fwrite( grid->nnc_global_index , sizeof * grid->nnc_global_index , num_nnc , stream );
+      fwrite( grid->nnc_input_index , sizeof * grid->nnc_input_index , num_nnc , stream );
+    }
+  }
+}
+
+
+static ecl_grid_type * ecl_grid_fread_cache__( ecl_grid_type * main_grid , FILE * stream ) {
+  int header[10];
+  double unit_x[2] , unit_y[2] , origo[2];
+  ecl_grid_type * grid;
+  bool ok;
+
+  if (!ecl_grid_cache_fread( header , sizeof header[0] , 10 , stream ))
+    return NULL;
+
+  if (!(ecl_grid_cache_fread( unit_x , sizeof unit_x[0] , 2 , stream ) &&
+        ecl_grid_cache_fread( unit_y , sizeof unit_y[0] , 2 , stream ) &&
+        ecl_grid_cache_fread( origo  , sizeof origo[0]  , 2 , stream )))
+    return NULL;
+
+  if ((header[1] < 0) || (header[2] < 0) || (header[3] < 0))
+    return NULL;
+
+  grid = ecl_grid_alloc_empty__( main_grid , header[4] , header[1] , header[2] , header[3] , header[0] , false , false );
+  if (!grid)
+    return NULL;
+
+  grid->eclipse_version   = header[5];
+  grid->unit_system       = header[6];
+  grid->use_mapaxes       = header[7];
+  grid->coarsening_active = header[8];
+  for (int i=0; i < 2; i++) {
+    grid->unit_x[i] = unit_x[i];
+    grid->unit_y[i] = unit_y[i];
+    grid->origo[i]  = origo[i];
+  }
+
+  ok = ecl_grid_cache_fread_string( &grid->name , stream ) &&
+       ecl_grid_cache_fread_string( &grid->parent_name , stream );
+
+  if (ok) {
+    int mapaxes_size;
+    ok = ecl_grid_cache_fread( &mapaxes_size , sizeof mapaxes_size , 1 , stream ) && (mapaxes_size == 0 || mapaxes_size == 6);
+    if (ok && mapaxes_size > 0) {
+      grid->mapaxes = util_malloc( mapaxes_size * sizeof * grid->mapaxes );
+      ok = ecl_grid_cache_fread( grid->mapaxes , sizeof * grid->mapaxes , mapaxes_size , stream );
+    }
+  }
+
+  if (ok) {
+    int coord_size;
+    ok = ecl_grid_cache_fread( &coord_size , sizeof coord_size , 1 , stream ) && (coord_size >= 0);
+    if (ok && coord_size > 0) {
+      grid->coord_kw = ecl_kw_alloc( COORD_KW , coord_size , ECL_FLOAT_TYPE );
+      ok = ecl_grid_cache_fread( ecl_kw_get_ptr( grid->coord_kw ) , sizeof(float) , coord_size , stream );
+    }
+  }
+
+  if (ok) {
+    if (header[9]) {
+      size_t tainted_size = (grid->size + 7) / 8;
+      grid->pillars = util_calloc( ecl_grid_get_coord_size( grid ) , sizeof * grid->pillars );
+      grid->tainted = util_calloc( tainted_size , sizeof * grid->tainted );
+      ok = ecl_grid_cache_fread( grid->pillars , sizeof * grid->pillars , ecl_grid_get_coord_size( grid ) , stream ) &&
+           ecl_grid_cache_fread_array( (void **) &grid->zcorn , &grid->zcorn_map_size , ecl_grid_get_zcorn_size( grid ) * sizeof * grid->zcorn , stream ) &&
+           ecl_grid_cache_fread( grid->tainted , sizeof * grid->tainted , tainted_size , stream );
+    } else
+      ok = ecl_grid_cache_fread_array( (void **) &grid->cells , &grid->cells_map_size , grid->size * sizeof * grid->cells , stream );
+  }
+
+  ok = ok &&
+    ecl_grid_cache_fread( grid->cell_active , sizeof * grid->cell_active , grid->size , stream ) &&
+    ecl_grid_cache_fread_int_table( &grid->host_cell , grid->size , stream ) &&
+    ecl_grid_cache_fread_int_table( &grid->coarse_group , grid->size , stream );
+
+  if (ok) {
+    int num_nnc;
+    ok = ecl_grid_cache_fread( &num_nnc , sizeof num_nnc , 1 , stream ) && (num_nnc >= 0);
+    if (ok && num_nnc > 0) {
+      grid->nnc_offset       = util_calloc( grid->size + 1 , sizeof * grid->nnc_offset );
+      grid->nnc_lgr_nr       = util_calloc( num_nnc , sizeof * grid->nnc_lgr_nr );
+      grid->nnc_global_index = util_calloc( num_nnc , sizeof * grid->nnc_global_index );
+      grid->nnc_input_index  = util_calloc( num_nnc , sizeof * grid->nnc_input_index );
+
+      ok = ecl_grid_cache_fread( grid->nnc_offset , sizeof * grid->nnc_offset , grid->size + 1 , stream ) &&
+           ecl_grid_cache_fread( grid->nnc_lgr_nr , sizeof * grid->nnc_lgr_nr , num_nnc , stream ) &&
+           ecl_grid_cache_fread( grid->nnc_global_index , sizeof * grid->nnc_global_index , num_nnc , stream ) &&
+           ecl_grid_cache_fread( grid->nnc_input_index , sizeof * grid->nnc_input_index , num_nnc , stream );
+
+      if (ok) {
+        int g;
+        ok = (grid->nnc_offset[0] == 0) && (grid->nnc_offset[grid->size] == num_nnc);
+        for (g = 0; ok && (g < grid->size); g++)
+          ok = (grid->nnc_offset[g] <= grid->nnc_offset[g + 1]);
+      }
+    }
+  }
+
+  if (!ok) {
+    ecl_grid_free( grid );
+    return NULL;
+  }
+
+  ecl_grid_init_coarse_cells( grid );
+  ecl_grid_update_index( grid );
+  return grid;
+}
+
+
+/**
+   Will write a cache of the grid, which should have been loaded from
+   the file grid_file with the apply_mapaxes setting, to
+   cache_file. Returns false if the cache could not be written.
+*/
+
+bool ecl_grid_fwrite_cache( const ecl_grid_type * grid , const char * grid_file , bool apply_mapaxes , const char * cache_file ) {
+  int64_t file_key[ECL_GRID_CACHE_KEY_SIZE];
+  int64_t file_size;
+  uint64_t file_hash;
+  bool ok = false;
+
+  if (!ecl_grid_cache_file_key( grid_file , file_key ))
+    return false;
+
+  if (!ecl_grid_cache_file_hash( grid_file , &file_size , &file_hash ) || (file_size != file_key[0]))
+    return false;
+
+  ecl_grid_assert_geometry( grid );
+  {
+    int grid_nr;
+    for (grid_nr = 0; grid_nr < vector_get_size( grid->LGR_list ); grid_nr++)
+      ecl_grid_assert_geometry( vector_iget_const( grid->LGR_list , grid_nr ));
+  }
+
+  {
+    char * path;
+    char * basename;
+    char * tmp_file;
+    FILE * stream;
+
+    util_alloc_file_components( cache_file , &path , &basename , NULL );
+    tmp_file = util_alloc_tmp_file( path ? path : "." , basename , true );
+    stream = fopen( tmp_file , "w" );
+    if (stream) {
+      int header[5] = { ECL_GRID_CACHE_MAGIC , ECL_GRID_CACHE_VERSION , sizeof(ecl_cell_type) , apply_mapaxes , 1 + vector_get_size( grid->LGR_list ) };
+      int trailer   = ECL_GRID_CACHE_MAGIC;
+      int grid_nr;
+
+      fwrite( header , sizeof header[0] , 5 , stream );
+      fwrite( file_key , sizeof file_key[0] , ECL_GRID_CACHE_KEY_SIZE , stream );
+      fwrite( &file_hash , sizeof file_hash , 1 , stream );
+
+      ecl_grid_fwrite_cache__( grid , stream );
+      for (grid_nr = 0; grid_nr < vector_get_size( grid->LGR_list ); grid_nr++)
+        ecl_grid_fwrite_cache__( vector_iget_const( grid->LGR_list , grid_nr ) , stream );
+      fwrite( &trailer , sizeof trailer , 1 , stream );
+
+      ok = !ferror( stream );
+      if (fclose( stream ) != 0)
+        ok = false;
+
+      if (ok)
+        ok = (rename( tmp_file , cache_file ) == 0);
+
+      if (!ok)
+        remove( tmp_file );
+    }
+    free( tmp_file );
+    free( basename );
+    free( path );
+  }
+  return ok;
+}
+
+
+/**
+   Will load a grid from the cache_file written by
+   ecl_grid_fwrite_cache(). Returns NULL if the cache does not exist,
+   is invalid or does not match the size, modification time and inode
+   of grid_file and the apply_mapaxes setting. If the environment
+   variable ECL_GRID_CACHE_VERIFY is set the content of grid_file is
+   also checked against the hash stored in the cache.
+
+   The cells of large grids are mapped from the cache file; they stay
+   valid if the cache file is replaced or removed while the grid is in
+   use.
+*/
+
+ecl_grid_type * ecl_grid_fread_cache( const char * grid_file , bool apply_mapaxes , const char * cache_file ) {
+  ecl_grid_type * main_grid = NULL;
+  FILE * stream = fopen( cache_file , "r" );
+
+  if (stream) {
+    int header[5];
+    int64_t cache_file_key[ECL_GRID_CACHE_KEY_SIZE];
+    int64_t file_key[ECL_GRID_CACHE_KEY_SIZE];
+    uint64_t cache_file_hash;
+    bool ok = ecl_grid_cache_fread( header , sizeof header[0] , 5 , stream ) &&
+              ecl_grid_cache_fread( cache_file_key , sizeof cache_file_key[0] , ECL_GRID_CACHE_KEY_SIZE , stream ) &&
+              ecl_grid_cache_fread( &cache_file_hash , sizeof cache_file_hash , 1 , stream );
+
+    ok = ok &&
+      (header[0] == ECL_GRID_CACHE_MAGIC) &&
+      (header[1] == ECL_GRID_CACHE_VERSION) &&
+      (header[2] == sizeof(ecl_cell_type)) &&
+      (header[3] == (apply_mapaxes ? 1 : 0)) &&
+      (header[4] >= 1) &&
+      ecl_grid_cache_file_key( grid_file , file_key ) &&
+      (memcmp( file_key , cache_file_key , sizeof file_key ) == 0);
+
+    if (ok && getenv( ECL_GRID_CACHE_VERIFY_ENV )) {
+      int64_t file_size;
+      uint64_t file_hash;
+      ok = ecl_grid_cache_file_hash( grid_file , &file_size , &file_hash ) &&
+           (file_size == cache_file_key[0]) &&
+           (file_hash == cache_file_hash);
+    }
+
+    if (ok) {
+      main_grid = ecl_grid_fread_cache__( NULL , stream );
+      ok = (main_grid != NULL);
+    }
+
+    if (ok) {
+      int grid_nr;
+      for (grid_nr = 1; grid_nr < header[4]; grid_nr++) {
+        ecl_grid_type * lgr_grid = ecl_grid_fread_cache__( main_grid , stream );
+        ecl_grid_type * host_grid;
+
+        if (!lgr_grid || !lgr_grid->name || !lgr_grid->host_cell) {
+          if (lgr_grid)
+            ecl_grid_free( lgr_grid );
+          ok = false;
+          break;
+        }
+
+        ecl_grid_add_lgr( main_grid , lgr_grid );
+        if (lgr_grid->parent_name == NULL)
+          host_grid = main_grid;
+        else if (ecl_grid_has_lgr( main_grid , lgr_grid->parent_name ))
+          host_grid = ecl_grid_get_lgr( main_grid , lgr_grid->parent_name );
+        else {
+          ok = false;
+          break;
+        }
+
+        {
+          int global_lgr_index;
+          for (global_lgr_index = 0; global_lgr_index < lgr_grid->size; global_lgr_index++) {
+            int host_index = ecl_grid_get_host_cell__( lgr_grid , global_lgr_index );
+            if ((host_index < 0) || (host_index >= host_grid->size)) {
+              ok = false;
+              break;
+            }
+            ecl_grid_set_cell_lgr__( host_grid , host_index , lgr_grid );
+          }
+        }
+        if (!ok)
+          break;
+        ecl_grid_install_lgr_common( host_grid , lgr_grid );
+      }
+    }
+
+    if (ok) {
+      int trailer;
+      ok = ecl_grid_cache_fread( &trailer , sizeof trailer , 1 , stream ) && (trailer == ECL_GRID_CACHE_MAGIC);
+    }
+
+    if (!ok && main_grid) {
+      ecl_grid_free( main_grid );
+      main_grid = NULL;
+    }
+    fclose( stream );
+  }
+
+  if (main_grid) {
+    free( main_grid->name );
+    main_grid->name = util_alloc_string_copy( grid_file );
+  }
+  return main_grid;
+}
+
+
+/**
+   Returns the name of the cache file used for grid_file, or NULL if
+   caching has been disabled by setting the environment variable
+   ECL_GRID_NO_CACHE. If the environment variable ECL_GRID_CACHE_DIR
+   is set the cache files are stored in that directory, otherwise the
+   cache is stored next to the grid file as "CASE.EGRID.grid_cache".
+*/
+
+char * ecl_grid_alloc_cache_filename( const char * grid_file ) {
+  const char * cache_dir = getenv( ECL_GRID_CACHE_DIR_ENV );
+
+  if (getenv( ECL_GRID_NO_CACHE_ENV ))
+    return NULL;
+
+  if (cache_dir) {
+    char * abs_path = util_alloc_abs_path( grid_file );
+    char * basename;
+    char * extension;
+    char * cache_file;
+    uint64_t path_hash = ecl_grid_cache_hash( 0xCBF29CE484222325ULL , abs_path , strlen( abs_path ));
+
+    util_alloc_file_components( grid_file , NULL , &basename , &extension );
+    cache_file = util_alloc_sprintf( "%s%c%s.%s.%016llx.%s" , cache_dir , UTIL_PATH_SEP_CHAR , basename ,
+                                     extension ? extension : "" , (unsigned long long) path_hash , ECL_GRID_CACHE_EXT );
+    free( extension );
+    free( basename );
+    free( abs_path );
+    return cache_file;
+  } else
+    return util_alloc_sprintf( "%s.%s" , grid_file , ECL_GRID_CACHE_EXT );
+}
+
+
+static ecl_grid_type * ecl_grid_load_case_cache__( const char * case_input , bool apply_mapaxes , bool use_cache) {
+  ecl_grid_type * ecl_grid = NULL;
+  char * grid_file = ecl_grid_alloc_case_filename( case_input );
+  if (grid_file != NULL) {
+
+    if (util_file_exists( grid_file )) {
+      char * cache_file = use_cache ? ecl_grid_alloc_cache_filename( grid_file ) : NULL;
+
+      if (cache_file)
+        ecl_grid = ecl_grid_fread_cache( grid_file , apply_mapaxes , cache_file );
+
+      if (ecl_grid == NULL) {
+        ecl_grid = ecl_grid_alloc__( grid_file , apply_mapaxes);
+        if (ecl_grid && cache_file)
+          ecl_grid_fwrite_cache( ecl_grid , grid_file , apply_mapaxes , cache_file );
+      }
+      free( cache_file );
+    }
+
+    free( grid_file );
+  }
+  return ecl_grid;
+}
+
+/*
+  The grid cache is opt-in: ecl_grid_load_case() only uses the cache
+  when the environment variable ECL_GRID_CACHE_DIR is set, whereas
+  ecl_grid_load_case_cached() always uses the cache - stored next to
+  the grid file unless ECL_GRID_CACHE_DIR is set. Setting
+  ECL_GRID_NO_CACHE disables the cache in both cases.
+*/
+
+ecl_grid_type * ecl_grid_load_case__( const char * case_input , bool apply_mapaxes) {
+  return ecl_grid_load_case_cache__( case_input , apply_mapaxes , getenv( ECL_GRID_CACHE_DIR_ENV ) != NULL );
+}
+
+ecl_grid_type * ecl_grid_load_case( const char * case_input ) {
+  bool apply_mapaxes = true;
+  return ecl_grid_load_case__( case_input , apply_mapaxes );
+}
+
+ecl_grid_type * ecl_grid_load_case_cached( const char * case_input ) {
+  bool apply_mapaxes = true;
+  return ecl_grid_load_case_cache__( case_input , apply_mapaxes , true );
+}
+
+
+
+bool ecl_grid_exists( const char * case_input ) {
+  bool exists = false;
+  char * grid_file = ecl_grid_alloc_case_filename( case_input );
+  if (grid_file != NULL) {
+    exists = true;
+    free( grid_file );
+  }
+  return exists;
+}
+
+
+static bool ecl_grid_compare_coarse_cells(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool verbose) {
+  if (vector_get_size( g1->coarse_cells ) == vector_get_size( g2->coarse_cells )) {
+    bool equal = true;
+    int c;
+
+    for (c = 0; c < vector_get_size( g1->coarse_cells ); c++) {
+      const ecl_coarse_cell_type * coarse_cell1 = vector_iget_const( g1->coarse_cells , c);
+      const ecl_coarse_cell_type * coarse_cell2 = vector_iget_const( g2->coarse_cells , c);
+
+      equal = ecl_coarse_cell_equal( coarse_cell1 , coarse_cell2 );
+      if (!equal)
+        if (verbose) fprintf(stderr,"Difference in coarse cell:%d \n",c );
+
+    }
+    return equal;
+  } else
+    return false;
+}
+
+
+static bool ecl_grid_compare_cells(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool include_nnc , bool verbose) {
+  int g;
+  bool equal = true;
+  for (g = 0; g < g1->size; g++) {
+    bool this_equal = true;
+    ecl_cell_type cell1 , cell2;
+    ecl_cell_type *c1 = ecl_grid_get_cell_geometry( g1 , g , &cell1 );
+    ecl_cell_type *c2 = ecl_grid_get_cell_geometry( g2 , g , &cell2 );
+    ecl_cell_compare(g1 , g2 , c1 , c2 , g , include_nnc , &this_equal);
+
+    if (!this_equal) {
+      if (verbose) {
+        int i,j,k;
+        ecl_grid_get_ijk1( g1 , g , &i , &j , &k);
+
+        printf("Difference in cell: %d : %d,%d,%d  nnc_equal:%d Volume:%g \n",g,i,j,k , ecl_grid_cell_nnc_equal( g1 , g2 , g ) , ecl_cell_get_volume( c1 ));
+        printf("-----------------------------------------------------------------\n");
+        ecl_cell_dump_ascii( g1 , c1 , g , i , j , k , stdout , NULL);
+        printf("-----------------------------------------------------------------\n");
+        ecl_cell_dump_ascii( g2 , c2 , g , i , j , k , stdout , NULL );
+        printf("-----------------------------------------------------------------\n");
+
+      }
+      equal = false;
+      break;
+    }
+  }
+  return equal;
+}
+
+static bool ecl_grid_compare_index(const ecl_grid_type * g1 , const ecl_grid_type * g2, bool verbose) {
+  bool equal = true;
+
+  if (g1->total_active != g2->total_active) {
+    if (verbose)
+      fprintf(stderr,"Difference in total active:%d / %d\n",g1->total_active , g2->total_active);
+    equal = false;
+  }
+
+  if (equal) {
+    if (memcmp( g1->index_map , g2->index_map , g1->size * sizeof * g1->index_map ) != 0) {
+      equal = false;
+      if (verbose)
+        fprintf(stderr,"Difference in index map \n");
+    }
+  }
+
+  if (equal) {
+    if (memcmp( g1->inv_index_map , g2->inv_index_map , g1->total_active * sizeof * g1->inv_index_map ) != 0) {
+      equal = false;
+      if (verbose)
+        fprintf(stderr,"Difference in inverse index map \n");
+    }
+  }
+
+  if (equal && (g1->dualp_flag != FILEHEAD_SINGLE_POROSITY)) {
+    if (g1->total_active_fracture != g2->total_active_fracture) {
+      if (verbose)
+        fprintf(stderr,"Difference in toal_active_fracture %d / %d \n",g1->total_active_fracture , g2->total_active_fracture);
+      equal = false;
     }
 
     if (equal) {
@@ -3779,10 +5037,11 @@ bool ecl_grid_compare(const ecl_grid_type * g1 , const ecl_grid_type * g2 , bool
 */
 
 
-bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j , int k, double x , double y , double z) {
+static bool ecl_grid_cell_contains_xyz__( const ecl_grid_type * ecl_grid , int i, int j , int k, double x , double y , double z , bool cache_volume) {
   const double min_volume = 1e-9;
   point_type p;
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , ecl_grid_get_global_index3( ecl_grid , i, j , k ));
+  ecl_cell_type cell_buffer;
+  ecl_cell_type * cell = ecl_grid_get_cell_geometry( ecl_grid , ecl_grid_get_global_index3( ecl_grid , i, j , k ) , &cell_buffer );
   point_set( &p , x , y , z);
   /*
     1. first check if the point z value is below the deepest point of
@@ -3882,7 +5141,7 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
     }
 
     {
-      double signed_volume = ecl_cell_get_signed_volume( cell );
+      double signed_volume = cache_volume ? ecl_cell_get_signed_volume( cell ) : ecl_cell_peek_signed_volume( cell );
       if (fabs( signed_volume) > min_volume) {
         double sign = 1.0;
         point_type * p0;
@@ -3919,98 +5178,628 @@ bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j
 
 
 
+bool ecl_grid_cell_contains_xyz3( const ecl_grid_type * ecl_grid , int i, int j , int k, double x , double y , double z) {
+  return ecl_grid_cell_contains_xyz__( ecl_grid , i , j , k , x , y , z , true );
+}
+
+
 bool ecl_grid_cell_contains_xyz1( const ecl_grid_type * ecl_grid , int global_index, double x , double y , double z) {
   int i,j,k;
   ecl_grid_get_ijk1( ecl_grid , global_index , &i , &j , &k);
   return ecl_grid_cell_contains_xyz3( ecl_grid , i,j,k,x ,y  , z);
 }
 
+
+static bool ecl_grid_cell_contains_xyz1__( const ecl_grid_type * ecl_grid , int global_index, double x , double y , double z , bool cache_volume) {
+  int i,j,k;
+  ecl_grid_get_ijk1( ecl_grid , global_index , &i , &j , &k);
+  return ecl_grid_cell_contains_xyz__( ecl_grid , i,j,k,x ,y  , z , cache_volume);
+}
+
+/*
+   Box coordinates are not inclusive, i.e. [i1,i2). The cells in the
+   inner box have already been checked, and are skipped.
+*/
+static int ecl_grid_box_contains_xyz( const ecl_grid_type * grid , const int box[6] , const int inner_box[6] , const point_type * p , bool cache_volume) {
+
+  int i,j,k;
+  int global_index = -1;
+  for (k=box[4]; k < box[5]; k++)
+    for (j=box[2]; j < box[3]; j++)
+      for (i=box[0]; i < box[1]; i++) {
+        if ((i >= inner_box[0]) && (i < inner_box[1]) &&
+            (j >= inner_box[2]) && (j < inner_box[3]) &&
+            (k >= inner_box[4]) && (k < inner_box[5]))
+          continue;
+
+        global_index = ecl_grid_get_global_index3( grid , i , j , k);
+        if (ecl_grid_cell_contains_xyz1__( grid , global_index , p->x , p->y , p->z , cache_volume))
+          return global_index;
+      }
+  return -1;  /* Returning -1; did not find xyz. */
+}
+
+
 /**
-   This function returns the global index for the cell (in layer 'k')
-   which contains the point x,y. Observe that if you are looking for
-   (i,j) you must call the function ecl_grid_get_ijk1() on the return value.
+ * Search for given xyz coordinate around global start_index in boxes of size 2, 4, 8, ..., 64.
+ */
+static int ecl_grid_get_global_index_from_xyz_around_box(const ecl_grid_type * grid , int start_index, const point_type * p , bool cache_volume) {
+  int box[6];
+  int inner_box[6];
+  int i,j,k;
+  int bx;
+
+  ecl_grid_get_ijk1( grid , start_index , &i , &j , &k);
+  inner_box[0] = i; inner_box[1] = i + 1;
+  inner_box[2] = j; inner_box[3] = j + 1;
+  inner_box[4] = k; inner_box[5] = k + 1;
+
+  for (bx = 2; bx <= 64; bx *= 2) {
+    int global_index;
+
+    box[0] = util_int_max( 0 , i - bx );
+    box[2] = util_int_max( 0 , j - bx );
+    box[4] = util_int_max( 0 , k - bx );
+
+    box[1] = util_int_min( grid->nx , i + bx );
+    box[3] = util_int_min( grid->ny , j + bx );
+    box[5] = util_int_min( grid->nz , k + bx );
+
+    global_index = ecl_grid_box_contains_xyz( grid , box , inner_box , p , cache_volume);
+    if (global_index >= 0)
+      return global_index;
+
+    memcpy( inner_box , box , sizeof box );
+  }
+  return -1;
+}
+
+
+
+/*
+   The xyz index is a 2D bin grid in the xy plane, where each bin
+   lists the cells whose bounding box overlaps the bin. The number of
+   bins equals the number of columns in the grid, i.e. a point lookup
+   only needs to consider the cells in roughly one column instead of
+   all the cells in the grid. The cells in a bin are stored in
+   increasing global index, so the lookup returns the same cell as a
+   linear scan. The bins are stored in compressed form: the cells in
+   bin b are cells[offset[b] ... offset[b+1]). The z range of each
+   cell is stored alongside, rounded outwards to float, so that most
+   cells in the bin are rejected without looking at the cell corners.
+
+   The index is created the first time ecl_grid_get_global_index_from_xyz()
+   must fall back to a full search, or by ecl_grid_init_xyz_index(), and
+   can be freed with ecl_grid_free_xyz_index(). Tainted cells can never contain a point,
+   and are not included.
 */
 
-int ecl_grid_get_global_index_from_xy( const ecl_grid_type * ecl_grid , int k , bool lower_layer , double x , double y) {
+struct ecl_grid_xyz_index_struct {
+  int      nbx , nby;
+  double   x0 , y0;
+  double   x1 , y1;
+  double   dx , dy;
+  int    * offset;
+  int    * cells;
+  float  * zmin;
+  float  * zmax;
+};
 
-  int i,j;
-  for (j=0; j < ecl_grid->ny; j++)
-    for (i=0; i < ecl_grid->nx; i++) {
-      int global_index = ecl_grid_get_global_index3( ecl_grid , i , j , k );
-      if (ecl_cell_layer_contains_xy( ecl_grid_get_cell( ecl_grid , global_index ) , lower_layer , x , y))
-        return global_index;
+
+static void ecl_grid_xyz_index_free( ecl_grid_xyz_index_type * xyz_index ) {
+  free( xyz_index->offset );
+  free( xyz_index->cells );
+  free( xyz_index->zmin );
+  free( xyz_index->zmax );
+  free( xyz_index );
+}
+
+
+static int ecl_grid_xyz_index_get_bin( double x0 , double dx , int nb , double x ) {
+  int b = (int) floor( (x - x0) / dx );
+  return util_int_min( util_int_max( b , 0 ) , nb - 1 );
+}
+
+
+/*
+  Will divide a rectangle of size width x height in approximately
+  num_bins square bins.
+*/
+
+static void ecl_grid_index_get_bin_dims( int num_bins , double width , double height , int * nbx , int * nby) {
+  if ((width > 0) && (height > 0)) {
+    *nbx = util_int_max( 1 , (int) ceil( sqrt( num_bins * width / height )));
+    *nbx = util_int_min( *nbx , num_bins );
+    *nby = util_int_max( 1 , num_bins / *nbx );
+  } else if (width > 0) {
+    *nbx = num_bins;
+    *nby = 1;
+  } else {
+    *nbx = 1;
+    *nby = (height > 0) ? num_bins : 1;
+  }
+}
+
+
+static bool ecl_grid_xyz_index_get_bin_box( const ecl_grid_xyz_index_type * xyz_index , const ecl_cell_type * cell , int * bx1 , int * bx2 , int * by1 , int * by2) {
+  if (GET_CELL_FLAG( cell , CELL_FLAG_TAINTED ))
+    return false;
+
+  *bx1 = ecl_grid_xyz_index_get_bin( xyz_index->x0 , xyz_index->dx , xyz_index->nbx , ecl_cell_min_x( cell ));
+  *bx2 = ecl_grid_xyz_index_get_bin( xyz_index->x0 , xyz_index->dx , xyz_index->nbx , ecl_cell_max_x( cell ));
+  *by1 = ecl_grid_xyz_index_get_bin( xyz_index->y0 , xyz_index->dy , xyz_index->nby , ecl_cell_min_y( cell ));
+  *by2 = ecl_grid_xyz_index_get_bin( xyz_index->y0 , xyz_index->dy , xyz_index->nby , ecl_cell_max_y( cell ));
+  return true;
+}
+
+
+static ecl_grid_xyz_index_type * ecl_grid_xyz_index_alloc( const ecl_grid_type * grid ) {
+  ecl_grid_xyz_index_type * xyz_index = util_malloc( sizeof * xyz_index );
+  double xmin = 0 , xmax = 0 , ymin = 0 , ymax = 0;
+  bool empty = true;
+  int global_index;
+
+  for (global_index = 0; global_index < grid->size; global_index++) {
+    ecl_cell_type cell_buffer;
+    const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer );
+    if (!GET_CELL_FLAG( cell , CELL_FLAG_TAINTED )) {
+      if (empty) {
+        xmin = ecl_cell_min_x( cell );
+        xmax = ecl_cell_max_x( cell );
+        ymin = ecl_cell_min_y( cell );
+        ymax = ecl_cell_max_y( cell );
+        empty = false;
+      } else {
+        xmin = util_double_min( xmin , ecl_cell_min_x( cell ));
+        xmax = util_double_max( xmax , ecl_cell_max_x( cell ));
+        ymin = util_double_min( ymin , ecl_cell_min_y( cell ));
+        ymax = util_double_max( ymax , ecl_cell_max_y( cell ));
+      }
+    }
+  }
+
+  {
+    double width  = xmax - xmin;
+    double height = ymax - ymin;
+
+    ecl_grid_index_get_bin_dims( util_int_max( 1 , grid->nx * grid->ny ) , width , height , &xyz_index->nbx , &xyz_index->nby );
+    xyz_index->x0 = xmin;
+    xyz_index->y0 = ymin;
+    xyz_index->x1 = xmax;
+    xyz_index->y1 = ymax;
+    xyz_index->dx = (width > 0)  ? width  / xyz_index->nbx : 1;
+    xyz_index->dy = (height > 0) ? height / xyz_index->nby : 1;
+  }
+
+  {
+    const int num_bins = xyz_index->nbx * xyz_index->nby;
+    int * count = util_calloc( num_bins + 1 , sizeof * count );
+    int bin;
+
+    for (bin = 0; bin < num_bins; bin++)
+      count[bin] = 0;
+
+    for (global_index = 0; global_index < grid->size; global_index++) {
+      int bx1 , bx2 , by1 , by2 , bx , by;
+      ecl_cell_type cell_buffer;
+      if (ecl_grid_xyz_index_get_bin_box( xyz_index , ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer ) , &bx1 , &bx2 , &by1 , &by2 ))
+        for (by = by1; by <= by2; by++)
+          for (bx = bx1; bx <= bx2; bx++)
+            count[ bx + by * xyz_index->nbx ]++;
+    }
+
+    xyz_index->offset = util_calloc( num_bins + 1 , sizeof * xyz_index->offset );
+    xyz_index->offset[0] = 0;
+    for (bin = 0; bin < num_bins; bin++)
+      xyz_index->offset[bin + 1] = xyz_index->offset[bin] + count[bin];
+
+    xyz_index->cells = util_calloc( xyz_index->offset[num_bins] + 1 , sizeof * xyz_index->cells );
+    xyz_index->zmin  = util_calloc( xyz_index->offset[num_bins] + 1 , sizeof * xyz_index->zmin );
+    xyz_index->zmax  = util_calloc( xyz_index->offset[num_bins] + 1 , sizeof * xyz_index->zmax );
+    for (bin = 0; bin < num_bins; bin++)
+      count[bin] = xyz_index->offset[bin];
+
+    for (global_index = 0; global_index < grid->size; global_index++) {
+      ecl_cell_type cell_buffer;
+      const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer );
+      int bx1 , bx2 , by1 , by2 , bx , by;
+      if (ecl_grid_xyz_index_get_bin_box( xyz_index , cell , &bx1 , &bx2 , &by1 , &by2 )) {
+        float zmin = nextafterf( (float) ecl_cell_min_z( cell ) , -HUGE_VALF );
+        float zmax = nextafterf( (float) ecl_cell_max_z( cell ) ,  HUGE_VALF );
+
+        for (by = by1; by <= by2; by++)
+          for (bx = bx1; bx <= bx2; bx++) {
+            bin = bx + by * xyz_index->nbx;
+            xyz_index->cells[ count[bin] ] = global_index;
+            xyz_index->zmin[ count[bin] ] = zmin;
+            xyz_index->zmax[ count[bin] ] = zmax;
+            count[bin]++;
+          }
+      }
+    }
+    free( count );
+  }
+  return xyz_index;
+}
+
+
+static int ecl_grid_xyz_index_lookup( const ecl_grid_type * grid , const ecl_grid_xyz_index_type * xyz_index , double x , double y , double z , bool cache_volume) {
+  if ((x < xyz_index->x0) || (x > xyz_index->x1))
+    return -1;
+
+  if ((y < xyz_index->y0) || (y > xyz_index->y1))
+    return -1;
+
+  {
+    int bx = ecl_grid_xyz_index_get_bin( xyz_index->x0 , xyz_index->dx , xyz_index->nbx , x );
+    int by = ecl_grid_xyz_index_get_bin( xyz_index->y0 , xyz_index->dy , xyz_index->nby , y );
+    int bin = bx + by * xyz_index->nbx;
+    int pos;
+
+    for (pos = xyz_index->offset[bin]; pos < xyz_index->offset[bin + 1]; pos++) {
+      if ((z >= xyz_index->zmin[pos]) && (z <= xyz_index->zmax[pos])) {
+        int global_index = xyz_index->cells[pos];
+        if (ecl_grid_cell_contains_xyz1__( grid , global_index , x , y , z , cache_volume))
+          return global_index;
+      }
+    }
+  }
+  return -1;
+}
+
+
+static const ecl_grid_xyz_index_type * ecl_grid_get_xyz_index( ecl_grid_type * grid ) {
+  if (grid->xyz_index == NULL) {
+    ecl_grid_assert_geometry( grid );
+    grid->xyz_index = ecl_grid_xyz_index_alloc( grid );
+  }
+  return grid->xyz_index;
+}
+
+
+void ecl_grid_init_xyz_index( ecl_grid_type * grid ) {
+  ecl_grid_get_xyz_index( grid );
+}
+
+
+/**
+   Will free the spatial index used by ecl_grid_get_global_index_from_xyz();
+   the index will be recreated if it is needed again.
+*/
+
+void ecl_grid_free_xyz_index( ecl_grid_type * grid ) {
+  if (grid->xyz_index) {
+    ecl_grid_xyz_index_free( grid->xyz_index );
+    grid->xyz_index = NULL;
+  }
+}
+
+
+
+/*
+   The xy index is the map view counterpart of the xyz index: a 2D
+   bin grid over the footprints of the nx*ny columns of one surface in
+   the grid, where each bin lists the columns whose footprint bounding
+   box overlaps the bin, in increasing order of i + j*nx. A point
+   lookup then only tests the footprints of the few columns in one
+   bin instead of all the columns in the layer, and returns the same
+   column as a scan through the layer in (j,i) order.
+
+   There are two kinds of surfaces:
+
+     ECL_GRID_XY_CELL_FACE: the lower (corners 0-3) or upper (corners
+        4-7) face of the cells in layer k, as used by
+        ecl_grid_get_global_index_from_xy().
+
+     ECL_GRID_XY_CORNER_LEVEL: the quadrilaterals spanned by the
+        corner points on level k in [0,nz], as used by
+        ecl_grid_get_ij_from_xy().
+
+   The indices are created on demand and cached in the grid; they can
+   be freed with ecl_grid_free_xy_index().
+*/
+
+#define ECL_GRID_XY_CELL_FACE     0
+#define ECL_GRID_XY_CORNER_LEVEL  1
+#define ECL_GRID_XY_INDEX_PAD     1e-6
+
+struct ecl_grid_xy_index_struct {
+  int      surface_type;
+  int      k;
+  bool     lower_layer;
+  int      nbx , nby;
+  double   x0 , y0;
+  double   x1 , y1;
+  double   dx , dy;
+  int    * offset;
+  int    * columns;
+};
+
+
+static void ecl_grid_xy_index_free( ecl_grid_xy_index_type * xy_index ) {
+  free( xy_index->offset );
+  free( xy_index->columns );
+  free( xy_index );
+}
+
+
+static void ecl_grid_xy_index_free__( void * arg ) {
+  ecl_grid_xy_index_free( (ecl_grid_xy_index_type *) arg );
+}
+
+
+/*
+  Will get the four points of the footprint of column (i,j), in
+  counter clockwise order for a right handed grid. Returns false if
+  the column does not have a valid footprint, i.e. for tainted cells.
+*/
+
+static bool ecl_grid_xy_index_get_footprint( const ecl_grid_type * grid , int surface_type , int k , bool lower_layer , int i , int j , double xlist[4] , double ylist[4]) {
+  if (surface_type == ECL_GRID_XY_CELL_FACE) {
+    ecl_cell_type cell_buffer;
+    const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , ecl_grid_get_global_index3( grid , i , j , k ) , &cell_buffer );
+    const int corner_offset = lower_layer ? 0 : 4;
+    const int corner_order[4] = { 0 , 1 , 3 , 2 };
+    int c;
+
+    if (GET_CELL_FLAG( cell , CELL_FLAG_TAINTED ))
+      return false;
+
+    for (c = 0; c < 4; c++) {
+      xlist[c] = cell->corner_list[ corner_offset + corner_order[c] ].x;
+      ylist[c] = cell->corner_list[ corner_offset + corner_order[c] ].y;
+    }
+  } else {
+    double z;
+    ecl_grid_get_corner_xyz( grid , i     , j     , k , &xlist[0] , &ylist[0] , &z );
+    ecl_grid_get_corner_xyz( grid , i + 1 , j     , k , &xlist[1] , &ylist[1] , &z );
+    ecl_grid_get_corner_xyz( grid , i + 1 , j + 1 , k , &xlist[2] , &ylist[2] , &z );
+    ecl_grid_get_corner_xyz( grid , i     , j + 1 , k , &xlist[3] , &ylist[3] , &z );
+  }
+  return true;
+}
+
+
+static void ecl_grid_xy_index_get_bin_box( const ecl_grid_xy_index_type * xy_index , const double xlist[4] , const double ylist[4] , int * bx1 , int * bx2 , int * by1 , int * by2) {
+  double xmin = util_double_min( util_double_min( xlist[0] , xlist[1] ) , util_double_min( xlist[2] , xlist[3] ));
+  double xmax = util_double_max( util_double_max( xlist[0] , xlist[1] ) , util_double_max( xlist[2] , xlist[3] ));
+  double ymin = util_double_min( util_double_min( ylist[0] , ylist[1] ) , util_double_min( ylist[2] , ylist[3] ));
+  double ymax = util_double_max( util_double_max( ylist[0] , ylist[1] ) , util_double_max( ylist[2] , ylist[3] ));
+
+  *bx1 = ecl_grid_xyz_index_get_bin( xy_index->x0 , xy_index->dx , xy_index->nbx , xmin - ECL_GRID_XY_INDEX_PAD );
+  *bx2 = ecl_grid_xyz_index_get_bin( xy_index->x0 , xy_index->dx , xy_index->nbx , xmax + ECL_GRID_XY_INDEX_PAD );
+  *by1 = ecl_grid_xyz_index_get_bin( xy_index->y0 , xy_index->dy , xy_index->nby , ymin - ECL_GRID_XY_INDEX_PAD );
+  *by2 = ecl_grid_xyz_index_get_bin( xy_index->y0 , xy_index->dy , xy_index->nby , ymax + ECL_GRID_XY_INDEX_PAD );
+}
+
+
+static ecl_grid_xy_index_type * ecl_grid_xy_index_alloc( const ecl_grid_type * grid , int surface_type , int k , bool lower_layer ) {
+  ecl_grid_xy_index_type * xy_index = util_malloc( sizeof * xy_index );
+  const int nx = grid->nx;
+  const int num_columns = grid->nx * grid->ny;
+  double xmin = 0 , xmax = 0 , ymin = 0 , ymax = 0;
+  bool empty = true;
+  int column;
+
+  xy_index->surface_type = surface_type;
+  xy_index->k = k;
+  xy_index->lower_layer = lower_layer;
+
+  for (column = 0; column < num_columns; column++) {
+    double xlist[4] , ylist[4];
+    if (ecl_grid_xy_index_get_footprint( grid , surface_type , k , lower_layer , column % nx , column / nx , xlist , ylist )) {
+      int c;
+      for (c = 0; c < 4; c++) {
+        if (empty) {
+          xmin = xmax = xlist[c];
+          ymin = ymax = ylist[c];
+          empty = false;
+        } else {
+          xmin = util_double_min( xmin , xlist[c] );
+          xmax = util_double_max( xmax , xlist[c] );
+          ymin = util_double_min( ymin , ylist[c] );
+          ymax = util_double_max( ymax , ylist[c] );
+        }
+      }
+    }
+  }
+
+  xmin -= ECL_GRID_XY_INDEX_PAD;
+  xmax += ECL_GRID_XY_INDEX_PAD;
+  ymin -= ECL_GRID_XY_INDEX_PAD;
+  ymax += ECL_GRID_XY_INDEX_PAD;
+  ecl_grid_index_get_bin_dims( util_int_max( 1 , num_columns ) , xmax - xmin , ymax - ymin , &xy_index->nbx , &xy_index->nby );
+  xy_index->x0 = xmin;
+  xy_index->y0 = ymin;
+  xy_index->x1 = xmax;
+  xy_index->y1 = ymax;
+  xy_index->dx = (xmax - xmin) / xy_index->nbx;
+  xy_index->dy = (ymax - ymin) / xy_index->nby;
+
+  {
+    const int num_bins = xy_index->nbx * xy_index->nby;
+    int * count = util_calloc( num_bins , sizeof * count );
+    int bin , pass;
+
+    for (bin = 0; bin < num_bins; bin++)
+      count[bin] = 0;
+
+    xy_index->offset = util_calloc( num_bins + 1 , sizeof * xy_index->offset );
+    xy_index->columns = NULL;
+
+    /* The first pass counts the columns in each bin, the second pass fills in the columns. */
+    for (pass = 0; pass < 2; pass++) {
+      for (column = 0; column < num_columns; column++) {
+        double xlist[4] , ylist[4];
+        int bx1 , bx2 , by1 , by2 , bx , by;
+
+        if (ecl_grid_xy_index_get_footprint( grid , surface_type , k , lower_layer , column % nx , column / nx , xlist , ylist )) {
+          ecl_grid_xy_index_get_bin_box( xy_index , xlist , ylist , &bx1 , &bx2 , &by1 , &by2 );
+          for (by = by1; by <= by2; by++)
+            for (bx = bx1; bx <= bx2; bx++) {
+              bin = bx + by * xy_index->nbx;
+              if (pass == 0)
+                count[bin]++;
+              else {
+                xy_index->columns[ count[bin] ] = column;
+                count[bin]++;
+              }
+            }
+        }
+      }
+
+      if (pass == 0) {
+        xy_index->offset[0] = 0;
+        for (bin = 0; bin < num_bins; bin++)
+          xy_index->offset[bin + 1] = xy_index->offset[bin] + count[bin];
+
+        xy_index->columns = util_calloc( xy_index->offset[num_bins] + 1 , sizeof * xy_index->columns );
+        for (bin = 0; bin < num_bins; bin++)
+          count[bin] = xy_index->offset[bin];
+      }
+    }
+    free( count );
+  }
+  return xy_index;
+}
+
+
+static bool ecl_grid_xy_index_column_contains( const ecl_grid_type * grid , const ecl_grid_xy_index_type * xy_index , int column , double x , double y) {
+  const int i = column % grid->nx;
+  const int j = column / grid->nx;
+
+  if (xy_index->surface_type == ECL_GRID_XY_CELL_FACE) {
+    ecl_cell_type cell_buffer;
+    const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , ecl_grid_get_global_index3( grid , i , j , xy_index->k ) , &cell_buffer );
+    return ecl_cell_layer_contains_xy( cell , xy_index->lower_layer , x , y );
+  } else {
+    double xlist[5] , ylist[5];
+    ecl_grid_xy_index_get_footprint( grid , xy_index->surface_type , xy_index->k , false , i , j , xlist , ylist );
+    xlist[4] = xlist[0];
+    ylist[4] = ylist[0];
+    return geo_util_inside_polygon__( xlist , ylist , 5 , x , y , true );
+  }
+}
+
+
+/*
+  Returns the column, i.e. i + j*nx, containing the point (x,y) or -1.
+*/
+
+static int ecl_grid_xy_index_lookup( const ecl_grid_type * grid , const ecl_grid_xy_index_type * xy_index , double x , double y) {
+  if ((x < xy_index->x0) || (x > xy_index->x1))
+    return -1;
+
+  if ((y < xy_index->y0) || (y > xy_index->y1))
+    return -1;
+
+  {
+    int bx = ecl_grid_xyz_index_get_bin( xy_index->x0 , xy_index->dx , xy_index->nbx , x );
+    int by = ecl_grid_xyz_index_get_bin( xy_index->y0 , xy_index->dy , xy_index->nby , y );
+    int bin = bx + by * xy_index->nbx;
+    int pos;
+
+    for (pos = xy_index->offset[bin]; pos < xy_index->offset[bin + 1]; pos++) {
+      int column = xy_index->columns[pos];
+      if (ecl_grid_xy_index_column_contains( grid , xy_index , column , x , y ))
+        return column;
     }
-  return -1; /* Did not find x,y */
+  }
+  return -1;
 }
 
 
+static const ecl_grid_xy_index_type * ecl_grid_get_xy_index( const ecl_grid_type * grid , int surface_type , int k , bool lower_layer ) {
+  ecl_grid_type * ecl_grid = (ecl_grid_type *) grid;
 
-int ecl_grid_get_global_index_from_xy_top( const ecl_grid_type * ecl_grid , double x , double y) {
-  return ecl_grid_get_global_index_from_xy( ecl_grid , ecl_grid->nz - 1 , false , x , y );
-}
+  if (surface_type == ECL_GRID_XY_CORNER_LEVEL)
+    lower_layer = false;
 
-int ecl_grid_get_global_index_from_xy_bottom( const ecl_grid_type * ecl_grid , double x , double y) {
-  return ecl_grid_get_global_index_from_xy( ecl_grid , 0 , true , x , y );
+  if (ecl_grid->xy_index_list == NULL)
+    ecl_grid->xy_index_list = vector_alloc_new();
+
+  {
+    int index;
+    for (index = 0; index < vector_get_size( ecl_grid->xy_index_list ); index++) {
+      const ecl_grid_xy_index_type * xy_index = vector_iget_const( ecl_grid->xy_index_list , index );
+      if ((xy_index->surface_type == surface_type) && (xy_index->k == k) && (xy_index->lower_layer == lower_layer))
+        return xy_index;
+    }
+  }
+
+  ecl_grid_assert_geometry( grid );
+  {
+    ecl_grid_xy_index_type * xy_index = ecl_grid_xy_index_alloc( grid , surface_type , k , lower_layer );
+    vector_append_owned_ref( ecl_grid->xy_index_list , xy_index , ecl_grid_xy_index_free__ );
+    return xy_index;
+  }
 }
 
 
-static void ecl_grid_clear_visited( ecl_grid_type * grid ) {
-  if (grid->visited == NULL)
-    grid->visited = util_calloc( grid->size , sizeof * grid->visited );
+/**
+   Will free the spatial indices used by ecl_grid_get_ij_from_xy() and
+   ecl_grid_get_global_index_from_xy(); the indices will be recreated
+   if they are needed again.
+*/
 
-  {
-    int i;
-    for (i=0; i < grid->size; i++)
-      grid->visited[i] = false;
+void ecl_grid_free_xy_index( ecl_grid_type * grid ) {
+  if (grid->xy_index_list) {
+    vector_free( grid->xy_index_list );
+    grid->xy_index_list = NULL;
   }
 }
 
 
-/*
-   Box coordinates are not inclusive, i.e. [i1,i2)
+/**
+   This function returns the global index for the cell (in layer 'k')
+   which contains the point x,y. Observe that if you are looking for
+   (i,j) you must call the function ecl_grid_get_ijk1() on the return value.
+
+   The lookup uses a spatial index of the layer which is created on
+   the first call for each (k,lower_layer) combination, see the
+   ecl_grid_xy_index_struct above. Creating the index modifies the
+   grid; concurrent calls on the same grid are only safe after the
+   index has been created.
 */
-static int ecl_grid_box_contains_xyz( const ecl_grid_type * grid , int i1, int i2 , int j1 , int j2 , int k1 , int k2 , const point_type * p) {
 
-  int i,j,k;
-  int global_index = -1;
-  for (k=k1; k < k2; k++)
-    for (j=j1; j < j2; j++)
-      for (i=i1; i < i2; i++) {
-        global_index = ecl_grid_get_global_index3( grid , i , j , k);
-        if (!grid->visited[ global_index ]) {
-          grid->visited[ global_index ] = true;
-          if (ecl_grid_cell_contains_xyz1( grid , global_index , p->x , p->y , p->z )) {
-            return global_index;
-          }
-        }
-      }
-  return -1;  /* Returning -1; did not find xyz. */
+int ecl_grid_get_global_index_from_xy( const ecl_grid_type * ecl_grid , int k , bool lower_layer , double x , double y) {
+  const ecl_grid_xy_index_type * xy_index = ecl_grid_get_xy_index( ecl_grid , ECL_GRID_XY_CELL_FACE , k , lower_layer );
+  int column = ecl_grid_xy_index_lookup( ecl_grid , xy_index , x , y );
+  if (column >= 0)
+    return column + k * ecl_grid->nx * ecl_grid->ny;
+  else
+    return -1; /* Did not find x,y */
 }
 
 
 /**
- * Search for given xyz coordinate around global start_index in a box of size bx
- */
-static int ecl_grid_get_global_index_from_xyz_around_box(ecl_grid_type * grid , double x , double y , double z , int start_index, int bx, point_type * p) {
-  /* Try neighbours */
-    int i,j,k;
-    int i1,i2,j1,j2,k1,k2;
-    int nx,ny,nz;
-    ecl_grid_get_dims( grid , &nx , &ny , &nz , NULL);
-    ecl_grid_get_ijk1( grid , start_index , &i , &j , &k);
+   Batch version of ecl_grid_get_global_index_from_xy(); the global
+   index of the cell containing (x[ip],y[ip]) is stored in
+   global_index[ip], -1 for points outside the layer. The points are
+   searched in parallel when OpenMP is enabled.
+*/
+
+void ecl_grid_get_global_index_from_xy_batch( const ecl_grid_type * ecl_grid , int k , bool lower_layer , int num_points , const double * x , const double * y , int * global_index) {
+  const ecl_grid_xy_index_type * xy_index = ecl_grid_get_xy_index( ecl_grid , ECL_GRID_XY_CELL_FACE , k , lower_layer );
+  const int layer_offset = k * ecl_grid->nx * ecl_grid->ny;
+  int ip;
+
+#pragma omp parallel for if (num_points > ECL_GRID_XYZ_CHUNK_SIZE)
+  for (ip = 0; ip < num_points; ip++) {
+    int column = ecl_grid_xy_index_lookup( ecl_grid , xy_index , x[ip] , y[ip] );
+    global_index[ip] = (column >= 0) ? column + layer_offset : -1;
+  }
+}
 
-    i1 = util_int_max( 0 , i - bx );
-    j1 = util_int_max( 0 , j - bx );
-    k1 = util_int_max( 0 , k - bx );
 
-    i2 = util_int_min( nx , i + bx );
-    j2 = util_int_min( ny , j + bx );
-    k2 = util_int_min( nz , k + bx );
 
-    int global_index = ecl_grid_box_contains_xyz( grid , i1 , i2 , j1 , j2 , k1 , k2 , p);
-    return global_index;
+int ecl_grid_get_global_index_from_xy_top( const ecl_grid_type * ecl_grid , double x , double y) {
+  return ecl_grid_get_global_index_from_xy( ecl_grid , ecl_grid->nz - 1 , false , x , y );
 }
 
+int ecl_grid_get_global_index_from_xy_bottom( const ecl_grid_type * ecl_grid , double x , double y) {
+  return ecl_grid_get_global_index_from_xy( ecl_grid , 0 , true , x , y );
+}
 
 
 /**
@@ -4018,60 +5807,114 @@ static int ecl_grid_get_global_index_from_xyz_around_box(ecl_grid_type * grid ,
    world coordinates (x,y,z), if no cell can be found the function
    will return -1.
 
-   The function is basically based on scanning through the cells in
-   natural (i fastest) order and querying whether the cell[i,j,k]
-   contains the (x,y,z) point; not very elegant :-(
+   If several cells contain the point the cell with the lowest global
+   index is returned. The full search uses a spatial index of the
+   cells which is created on the first call; see the
+   ecl_grid_xyz_index_struct above.
 
    The last argument - 'start_index' - can be used to speed things up
    a bit if you have reasonable guess of where the the (x,y,z) is
    located. The start_index value is used as this:
 
 
-     start_index == 0: I do not have a clue, start from the beginning
-        and scan through the grid linearly.
+     start_index < 0: I do not have a clue, use the spatial index
+        directly.
 
 
-     start_index != 0:
+     start_index >= 0:
         1. Check the cell 'start_index'.
         2. Check the neighbours (i +/- 1, j +/- 1, k +/- 1 ).
-        3. Give up and do a linear search starting from start_index.
+        3. Give up and search the spatial index.
 
-*/
-int ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index) {
-  int global_index;
-  point_type p;
-  point_set( &p , x , y , z);
-  ecl_grid_clear_visited( grid );
+   Where cells overlap the start_index can therefor decide which of
+   the containing cells is returned; whether the spatial index has
+   already been built does not affect the result.
 
+*/
+static int ecl_grid_get_global_index_from_xyz__(ecl_grid_type * grid , const point_type * p , int start_index , bool cache_volume) {
   if (start_index >= 0) {
+    int global_index;
+
     /* Try start index */
-    if (ecl_grid_cell_contains_xyz1( grid , start_index , x,y,z))
+    if (ecl_grid_cell_contains_xyz1__( grid , start_index , p->x , p->y , p->z , cache_volume))
       return start_index;
-    else {
-      /* Try boxes 2, 4, 8, ..., 64  */
-      for (int bx = 1; bx <= 6; bx++) {
-        global_index = ecl_grid_get_global_index_from_xyz_around_box(grid, x, y, z,
-                                                                     start_index,
-                                                                     1<<bx, &p);
-        if (global_index >= 0)
-          return global_index;
-      }
-    }
+
+    /* Try boxes 2, 4, 8, ..., 64 */
+    global_index = ecl_grid_get_global_index_from_xyz_around_box( grid , start_index , p , cache_volume);
+    if (global_index >= 0)
+      return global_index;
   }
 
   /*
-    OK - the attempted shortcuts did not pay off. Perform full linear search.
+    OK - the attempted shortcuts did not pay off. Search the spatial index.
   */
+  return ecl_grid_xyz_index_lookup( grid , ecl_grid_get_xyz_index( grid ) , p->x , p->y , p->z , cache_volume);
+}
+
+
+int ecl_grid_get_global_index_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index) {
+  point_type p;
+  point_set( &p , x , y , z);
+  return ecl_grid_get_global_index_from_xyz__( grid , &p , start_index , true );
+}
+
+
+/**
+   Will find the global index of the cells containing the points
+   (x[i],y[i],z[i]), i = 0,1,...,num_points-1 and store them in
+   global_index[i]; points which are not in the grid get the value -1.
+
+   If start_index is different from NULL, start_index[i] is used as
+   start_index for point i, and the result is the same as calling
+   ecl_grid_get_global_index_from_xyz() for each point with that
+   start_index. Otherwise the points are searched in chunks of
+   ECL_GRID_XYZ_CHUNK_SIZE points, and the result for the previous
+   point in the same chunk is used as start_index, which is efficient
+   for points along a well path; the first point in each chunk is
+   searched without a start_index. Where cells overlap, i.e. a point
+   is contained in several cells, the result can then differ from
+   chaining calls to ecl_grid_get_global_index_from_xyz() through all
+   the points; for points contained in only one cell it is the same.
+
+   The chunks are searched in parallel
+   when OpenMP is enabled. Apart from creating the spatial index the
+   search does not modify the grid; when ecl_grid_init_xyz_index() has
+   been called several threads can call this function concurrently on
+   the same grid. Concurrent calls to functions which modify the grid,
+   including ecl_grid_get_global_index_from_xyz(), are not allowed.
+*/
 
-  global_index = -1;
+void ecl_grid_get_global_index_from_xyz_batch(ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , const int * start_index , int * global_index) {
+  const int num_chunks = (num_points + ECL_GRID_XYZ_CHUNK_SIZE - 1) / ECL_GRID_XYZ_CHUNK_SIZE;
+  int chunk;
 
-  for (int index = 0; index < grid->size; index++) {
-    if (ecl_grid_cell_contains_xyz1( grid , index , x , y , z))
-      return index;
+  if (num_points <= 0)
+    return;
+
+  ecl_grid_init_xyz_index( grid );
+
+#pragma omp parallel for schedule(dynamic) if (num_chunks > 1)
+  for (chunk = 0; chunk < num_chunks; chunk++) {
+    const int first = chunk * ECL_GRID_XYZ_CHUNK_SIZE;
+    const int last  = util_int_min( num_points , first + ECL_GRID_XYZ_CHUNK_SIZE );
+    int hint = -1;
+    int ip;
+
+    for (ip = first; ip < last; ip++) {
+      point_type p;
+
+      point_set( &p , x[ip] , y[ip] , z[ip] );
+      if (start_index)
+        hint = start_index[ip];
+
+      global_index[ip] = ecl_grid_get_global_index_from_xyz__( grid , &p , hint , false );
+      if (global_index[ip] >= 0)
+        hint = global_index[ip];
+    }
   }
-  return -1;
 }
 
+
 bool ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , double z , int start_index, int *i, int *j, int *k ) {
   int g = ecl_grid_get_global_index_from_xyz(grid, x, y, z, start_index);
   if (g < 0)
@@ -4082,94 +5925,102 @@ bool ecl_grid_get_ijk_from_xyz(ecl_grid_type * grid , double x , double y , doub
 }
 
 
-static bool ecl_grid_sublayer_contanins_xy__(const ecl_grid_type * grid , double x , double y , int k , int i1 , int i2 , int j1 , int j2, geo_polygon_type * polygon) {
-  int i,j;
+/**
+   Will find the column (i,j) whose footprint on corner level k, i.e.
+   the quadrilateral spanned by the corner points (i,j,k), (i+1,j,k),
+   (i+1,j+1,k) and (i,j+1,k), contains the point (x,y). Valid values
+   for k are [0,nz]. Returns false if the point is outside the grid.
+
+   The lookup uses a spatial index of the corner level which is
+   created on the first call for each k; see the
+   ecl_grid_xy_index_struct.
+*/
 
-  geo_polygon_reset( polygon );
+bool ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j) {
+  const ecl_grid_xy_index_type * xy_index = ecl_grid_get_xy_index( grid , ECL_GRID_XY_CORNER_LEVEL , k , false );
+  int column = ecl_grid_xy_index_lookup( grid , xy_index , x , y );
 
-  /* Bottom edge */
-  for (i=i1; i < i2; i++) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i , j1 , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
-  }
+  if (column >= 0) {
+    *i = column % grid->nx;
+    *j = column / grid->nx;
+    return true;
+  } else
+    return false;
+}
 
-  /* Right edge */
-  for (j=j1; j < j2; j++) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i2 , j , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
-  }
 
-  /* Top edge */
-  for (i=i2; i > i1; i--) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i , j2 , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
-  }
+/**
+   Batch version of ecl_grid_get_ij_from_xy(); for points outside the
+   grid i[ip] and j[ip] are set to -1. The points are searched in
+   parallel when OpenMP is enabled.
+*/
 
-  /* Left edge */
-  for (j=j2; j > j1; j--) {
-    double corner_pos[3];
-    ecl_grid_get_corner_xyz( grid , i1 , j , k , &corner_pos[0] , &corner_pos[1] , &corner_pos[2]);
-    geo_polygon_add_point( polygon , corner_pos[0] , corner_pos[1]);
+void ecl_grid_get_ij_from_xy_batch( const ecl_grid_type * grid , int k , int num_points , const double * x , const double * y , int * i , int * j) {
+  const ecl_grid_xy_index_type * xy_index = ecl_grid_get_xy_index( grid , ECL_GRID_XY_CORNER_LEVEL , k , false );
+  int ip;
+
+#pragma omp parallel for if (num_points > ECL_GRID_XYZ_CHUNK_SIZE)
+  for (ip = 0; ip < num_points; ip++) {
+    int column = ecl_grid_xy_index_lookup( grid , xy_index , x[ip] , y[ip] );
+    if (column >= 0) {
+      i[ip] = column % grid->nx;
+      j[ip] = column / grid->nx;
+    } else {
+      i[ip] = -1;
+      j[ip] = -1;
+    }
   }
-  geo_polygon_close( polygon );
-  return geo_polygon_contains_point__( polygon , x  , y , true );
 }
 
 
 
-bool ecl_grid_get_ij_from_xy( const ecl_grid_type * grid , double x , double y , int k , int* i, int* j) {
-  geo_polygon_type * polygon = geo_polygon_alloc( NULL );
-  int nx = ecl_grid_get_nx( grid );
-  int ny = ecl_grid_get_ny( grid );
-  bool inside = ecl_grid_sublayer_contanins_xy__(grid , x , y , k , 0 , nx , 0 , ny , polygon);
-  if (inside) {
-    int i1 = 0;
-    int i2 = nx;
-    int j1 = 0;
-    int j2 = ny;
-
-    while (true) {
-      if ((i2 - i1) > 1) {
-        int ic = (i1 + i2) / 2;
-        if (ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , ic , j1 , j2 , polygon))
-          i2 = ic;
-        else {
-          if (!ecl_grid_sublayer_contanins_xy__(grid , x , y , k , ic , i2 , j1 , j2 , polygon))
-            util_abort("%s: point nowhere to be found ... \n",__func__);
-          i1 = ic;
-        }
-      }
-
-      if ((j2 - j1) > 1) {
-        int jc = (j1 + j2) / 2;
-        if (ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , i2 , j1 , jc , polygon))
-          j2 = jc;
-        else {
-          if (!ecl_grid_sublayer_contanins_xy__(grid , x , y , k , i1 , i2 , jc , j2 , polygon))
-            util_abort("%s: point nowhere to be found ... \n",__func__);
-          j1 = jc;
-        }
-      }
+/*
+  The blocking functions collect values from scattered (x,y,z) points
+  in the cells containing the points. There are two modes:
+
+   ecl_grid_alloc_blocking_variables(): All values are stored in a
+      double_vector for each cell, and can be evaluated with an
+      arbitrary block_function_ftype in ecl_grid_block_eval3d().
+
+   ecl_grid_alloc_blocking_accumulators(): Only the count, mean,
+      sum of squared deviations, min and max are kept for each cell,
+      in flat arrays of size nx*ny*nz. The values are folded in with
+      Welford's algorithm, and the statistics are available through
+      ecl_grid_get_block_stat1() and ecl_grid_init_block_stat_data().
+      The memory usage does not depend on the number of values, and
+      there are no per-cell allocations.
+
+  The same functions ecl_grid_init_blocking(),
+  ecl_grid_block_value_3d() and ecl_grid_block_values_3d() are used to
+  add values in both modes.
+*/
 
-      if ((i2 - i1) == 1 && (j2 - j1) == 1) {
-        *i = i1;
-        *j = j1;
-        break;
-      }
-    }
+static void ecl_grid_free_blocking( ecl_grid_type * grid ) {
+  if (grid->values != NULL) {
+    int i;
+    for (i=0; i < grid->block_size; i++)
+      double_vector_free( grid->values[i] );
+    free( grid->values );
+    grid->values = NULL;
   }
 
-  geo_polygon_free( polygon );
-  return inside;
+  free( grid->block_count );
+  free( grid->block_mean );
+  free( grid->block_m2 );
+  free( grid->block_min );
+  free( grid->block_max );
+  grid->block_count = NULL;
+  grid->block_mean = NULL;
+  grid->block_m2 = NULL;
+  grid->block_min = NULL;
+  grid->block_max = NULL;
+  grid->block_dim = 0;
 }
 
 
-
 void ecl_grid_alloc_blocking_variables(ecl_grid_type * grid, int block_dim) {
   int index;
+  ecl_grid_free_blocking( grid );
   grid->block_dim = block_dim;
   if (block_dim == 2)
     grid->block_size = grid->nx* grid->ny; // Not supported
@@ -4181,18 +6032,61 @@ void ecl_grid_alloc_blocking_variables(ecl_grid_type * grid, int block_dim) {
   grid->values         = util_calloc( grid->block_size , sizeof * grid->values );
   for (index = 0; index < grid->block_size; index++)
     grid->values[index] = double_vector_alloc( 0 , 0.0 );
+  grid->last_block_index = 0;
+}
+
+
+void ecl_grid_alloc_blocking_accumulators(ecl_grid_type * grid) {
+  ecl_grid_free_blocking( grid );
+  grid->block_dim   = 3;
+  grid->block_size  = grid->size;
+  grid->block_count = util_calloc( grid->block_size , sizeof * grid->block_count );
+  grid->block_mean  = util_calloc( grid->block_size , sizeof * grid->block_mean );
+  grid->block_m2    = util_calloc( grid->block_size , sizeof * grid->block_m2 );
+  grid->block_min   = util_calloc( grid->block_size , sizeof * grid->block_min );
+  grid->block_max   = util_calloc( grid->block_size , sizeof * grid->block_max );
+  ecl_grid_init_blocking( grid );
 }
 
 
 
 void ecl_grid_init_blocking(ecl_grid_type * grid) {
   int index;
-  for (index = 0; index < grid->block_size; index++)
-    double_vector_reset(grid->values[index]);
+  if (grid->block_count != NULL) {
+    memset( grid->block_count , 0 , grid->block_size * sizeof * grid->block_count );
+    for (index = 0; index < grid->block_size; index++) {
+      grid->block_mean[index] = 0;
+      grid->block_m2[index] = 0;
+      grid->block_min[index] = 0;
+      grid->block_max[index] = 0;
+    }
+  } else {
+    for (index = 0; index < grid->block_size; index++)
+      double_vector_reset(grid->values[index]);
+  }
   grid->last_block_index = 0;
 }
 
 
+static void ecl_grid_block_add__(ecl_grid_type * grid , int global_index , double value) {
+  if (grid->block_count != NULL) {
+    int count = grid->block_count[global_index] + 1;
+    double delta = value - grid->block_mean[global_index];
+
+    grid->block_mean[global_index] += delta / count;
+    grid->block_m2[global_index] += delta * (value - grid->block_mean[global_index]);
+    if (count == 1) {
+      grid->block_min[global_index] = value;
+      grid->block_max[global_index] = value;
+    } else {
+      grid->block_min[global_index] = util_double_min( grid->block_min[global_index] , value );
+      grid->block_max[global_index] = util_double_max( grid->block_max[global_index] , value );
+    }
+    grid->block_count[global_index] = count;
+  } else
+    double_vector_append( grid->values[global_index] , value);
+}
+
 
 
 bool ecl_grid_block_value_3d(ecl_grid_type * grid, double x , double y , double z , double value) {
@@ -4201,7 +6095,7 @@ bool ecl_grid_block_value_3d(ecl_grid_type * grid, double x , double y , double
   {
     int global_index = ecl_grid_get_global_index_from_xyz( grid , x , y , z , grid->last_block_index);
     if (global_index >= 0) {
-      double_vector_append( grid->values[global_index] , value);
+      ecl_grid_block_add__( grid , global_index , value );
       grid->last_block_index = global_index;
       return true;
     } else
@@ -4210,17 +6104,152 @@ bool ecl_grid_block_value_3d(ecl_grid_type * grid, double x , double y , double
 }
 
 
+/*
+  Blocks num_points values, value[i] is added to the cell containing
+  the point (x[i],y[i],z[i]). Points outside the grid are ignored; the
+  return value is the number of values which were blocked.
+
+  The points are typically scattered, so the cells are located
+  directly in the spatial index, without trying the cells around the
+  previous point first, in parallel when OpenMP is enabled. A point
+  contained in several overlapping cells is blocked into the cell with
+  the lowest global index, whereas ecl_grid_block_value_3d() might use
+  a cell close to the previous point; apart from that the result is
+  exactly the same as calling ecl_grid_block_value_3d() for each point.
+
+  The values are also added in parallel: every thread owns a range of
+  global indices and adds the values of the points in its cells, in
+  input order. Each cell therefore sees the same sequence of Welford
+  updates (or double_vector_append() calls) as in a serial insertion,
+  and the result does not depend on the number of threads. Per-thread
+  accumulators combined afterwards would give slightly different
+  rounding and need a copy of the accumulators for every thread.
+*/
+
+int ecl_grid_block_values_3d(ecl_grid_type * grid , int num_points , const double * x , const double * y , const double * z , const double * value) {
+  int num_blocked = 0;
+  if (grid->block_dim != 3)
+    util_abort("%s: Wrong blocking dimension \n",__func__);
+
+  if (num_points > 0) {
+    int * global_index = util_calloc( num_points , sizeof * global_index );
+    int ip;
+
+    const ecl_grid_xyz_index_type * xyz_index = ecl_grid_get_xyz_index( grid );
+
+#pragma omp parallel for if (num_points > ECL_GRID_XYZ_CHUNK_SIZE)
+    for (ip = 0; ip < num_points; ip++)
+      global_index[ip] = ecl_grid_xyz_index_lookup( grid , xyz_index , x[ip] , y[ip] , z[ip] , false );
+
+    {
+      int last_index = -1;
+      for (ip = 0; ip < num_points; ip++) {
+        if (global_index[ip] >= 0) {
+          last_index = global_index[ip];
+          num_blocked++;
+        }
+      }
+      if (last_index >= 0)
+        grid->last_block_index = last_index;
+    }
+
+#pragma omp parallel if (num_blocked > ECL_GRID_XYZ_CHUNK_SIZE)
+    {
+      int num_threads = 1;
+      int thread_nr = 0;
+      int index1 , index2;
+      int point_nr;
+
+#if defined(_OPENMP)
+      num_threads = omp_get_num_threads();
+      thread_nr = omp_get_thread_num();
+#endif
+      index1 = (int) (((int64_t) grid->block_size * thread_nr) / num_threads);
+      index2 = (int) (((int64_t) grid->block_size * (thread_nr + 1)) / num_threads);
+
+      for (point_nr = 0; point_nr < num_points; point_nr++) {
+        int g = global_index[point_nr];
+        if ((g >= index1) && (g < index2))
+          ecl_grid_block_add__( grid , g , value[point_nr] );
+      }
+    }
+    free( global_index );
+  }
+  return num_blocked;
+}
+
+
 
 
 double ecl_grid_block_eval3d(ecl_grid_type * grid , int i, int j , int k ,block_function_ftype * blockf ) {
   int global_index = ecl_grid_get_global_index3(grid , i,j,k);
+  if (grid->values == NULL)
+    util_abort("%s: blocking variables have not been allocated - use ecl_grid_get_block_stat1() with accumulators.\n",__func__);
   return blockf( grid->values[global_index]);
 }
 
 
 int ecl_grid_get_block_count3d(const ecl_grid_type * grid , int i , int j, int k) {
   int global_index = ecl_grid_get_global_index3(grid , i,j,k);
-  return double_vector_size( grid->values[global_index]);
+  if (grid->block_count != NULL)
+    return grid->block_count[global_index];
+  else
+    return double_vector_size( grid->values[global_index]);
+}
+
+
+/*
+  Statistics of the values blocked into one cell; only available
+  after ecl_grid_alloc_blocking_accumulators(). The variance is the
+  population variance, i.e. the squared deviations are divided by the
+  count. For cells without values all the statistics are zero.
+*/
+
+double ecl_grid_get_block_stat1(const ecl_grid_type * grid , int global_index , ecl_grid_block_stat_enum stat) {
+  int count;
+  if (grid->block_count == NULL)
+    util_abort("%s: blocking accumulators have not been allocated - call ecl_grid_alloc_blocking_accumulators() first.\n",__func__);
+
+  count = grid->block_count[global_index];
+  switch (stat) {
+  case ECL_GRID_BLOCK_COUNT:
+    return count;
+  case ECL_GRID_BLOCK_SUM:
+    return grid->block_mean[global_index] * count;
+  case ECL_GRID_BLOCK_MEAN:
+    return grid->block_mean[global_index];
+  case ECL_GRID_BLOCK_VARIANCE:
+    return (count > 0) ? grid->block_m2[global_index] / count : 0;
+  case ECL_GRID_BLOCK_STD:
+    return (count > 0) ? sqrt( grid->block_m2[global_index] / count ) : 0;
+  case ECL_GRID_BLOCK_MIN:
+    return grid->block_min[global_index];
+  case ECL_GRID_BLOCK_MAX:
+    return grid->block_max[global_index];
+  default:
+    util_abort("%s: invalid statistic:%d \n",__func__ , stat);
+    return 0;
+  }
+}
+
+
+double ecl_grid_get_block_stat3(const ecl_grid_type * grid , int i , int j , int k , ecl_grid_block_stat_enum stat) {
+  return ecl_grid_get_block_stat1( grid , ecl_grid_get_global_index3( grid , i , j , k ) , stat );
+}
+
+
+/*
+  Fills data[0 .. nx*ny*nz) with the statistic stat for all cells.
+*/
+
+void ecl_grid_init_block_stat_data(const ecl_grid_type * grid , ecl_grid_block_stat_enum stat , double * data) {
+  int g;
+  if (grid->block_count == NULL)
+    util_abort("%s: blocking accumulators have not been allocated - call ecl_grid_alloc_blocking_accumulators() first.\n",__func__);
+
+#pragma omp parallel for if (grid->block_size > 100000)
+  for (g = 0; g < grid->block_size; g++)
+    data[g] = ecl_grid_get_block_stat1( grid , g , stat );
 }
 
 /* End of blocking functions                                     */
@@ -4235,12 +6264,7 @@ void ecl_grid_free(ecl_grid_type * grid) {
   util_safe_free(grid->inv_fracture_index_map);
   util_safe_free(grid->mapaxes);
 
-  if (grid->values != NULL) {
-    int i;
-    for (i=0; i < grid->block_size; i++)
-      double_vector_free( grid->values[i] );
-    free( grid->values );
-  }
+  ecl_grid_free_blocking( grid );
   if (ECL_GRID_MAINGRID_LGR_NR == grid->lgr_nr) { /* This is the main grid. */
     vector_free( grid->LGR_list );
     int_vector_free( grid->lgr_index_map);
@@ -4248,11 +6272,15 @@ void ecl_grid_free(ecl_grid_type * grid) {
   }
   if (grid->coord_kw != NULL)
     ecl_kw_free( grid->coord_kw );
+  util_safe_free( grid->cell_active );
 
   vector_free( grid->coarse_cells );
   hash_free( grid->children );
   util_safe_free( grid->parent_name );
-  util_safe_free( grid->visited );
+  if (grid->xyz_index)
+    ecl_grid_xyz_index_free( grid->xyz_index );
+  if (grid->xy_index_list)
+    vector_free( grid->xy_index_list );
   util_safe_free( grid->name );
   free( grid );
 }
@@ -4267,15 +6295,16 @@ void ecl_grid_free__( void * arg ) {
 
 
 void ecl_grid_get_distance(const ecl_grid_type * grid , int global_index1, int global_index2 , double *dx , double *dy , double *dz) {
-  ecl_cell_type * cell1 = ecl_grid_get_cell( grid , global_index1);
-  ecl_cell_type * cell2 = ecl_grid_get_cell( grid , global_index2);
+  point_type center1;
+  point_type center2;
+  ecl_cell_type cell_buffer;
 
-  ecl_cell_assert_center( cell1 );
-  ecl_cell_assert_center( cell2 );
+  ecl_cell_compute_center( ecl_grid_get_cell_geometry( grid , global_index1 , &cell_buffer ) , &center1 );
+  ecl_cell_compute_center( ecl_grid_get_cell_geometry( grid , global_index2 , &cell_buffer ) , &center2 );
   {
-    *dx = cell1->center.x - cell2->center.x;
-    *dy = cell1->center.y - cell2->center.y;
-    *dz = cell1->center.z - cell2->center.z;
+    *dx = center1.x - center2.x;
+    *dy = center1.y - center2.y;
+    *dz = center1.z - center2.z;
   }
 }
 
@@ -4358,8 +6387,7 @@ int ecl_grid_get_nactive_fracture( const ecl_grid_type * grid ) {
 
 
 int ecl_grid_get_parent_cell1( const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid, global_index );
-  return cell->host_cell;
+  return ecl_grid_get_host_cell__( grid , global_index );
 }
 
 
@@ -4485,12 +6513,13 @@ void ecl_grid_get_ijk1A(const ecl_grid_type *ecl_grid , int active_index , int *
 
 
 void ecl_grid_get_xyz1(const ecl_grid_type * grid , int global_index , double *xpos , double *ypos , double *zpos) {
-  ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  ecl_cell_assert_center( cell );
+  point_type center;
+  ecl_cell_type cell_buffer;
+  ecl_cell_compute_center( ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer ) , &center );
   {
-    *xpos = cell->center.x;
-    *ypos = cell->center.y;
-    *zpos = cell->center.z;
+    *xpos = center.x;
+    *ypos = center.y;
+    *zpos = center.z;
   }
 }
 
@@ -4513,7 +6542,8 @@ void ecl_grid_get_xyz3(const ecl_grid_type * grid , int i, int j , int k, double
 
 void ecl_grid_get_cell_corner_xyz1(const ecl_grid_type * grid , int global_index , int corner_nr , double * xpos , double * ypos , double * zpos ) {
   if ((corner_nr >= 0) &&  (corner_nr <= 7)) {
-    const ecl_cell_type * cell  = ecl_grid_get_cell( grid , global_index );
+    ecl_cell_type cell_buffer;
+    const ecl_cell_type * cell  = ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer );
     const point_type      point = cell->corner_list[ corner_nr ];
     *xpos = point.x;
     *ypos = point.y;
@@ -4569,9 +6599,10 @@ void ecl_grid_get_xyz1A(const ecl_grid_type * grid , int active_index , double *
 
 
 double ecl_grid_get_cdepth1(const ecl_grid_type * grid , int global_index) {
-  ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  ecl_cell_assert_center( cell );
-  return cell->center.z;
+  point_type center;
+  ecl_cell_type cell_buffer;
+  ecl_cell_compute_center( ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer ) , &center );
+  return center.z;
 }
 
 
@@ -4619,7 +6650,8 @@ int ecl_grid_locate_depth( const ecl_grid_type * grid , double depth , int i , i
 */
 
 double ecl_grid_get_top1(const ecl_grid_type * grid , int global_index) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+  ecl_cell_type cell_buffer;
+  const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer );
   double depth = 0;
   int ij;
 
@@ -4661,7 +6693,8 @@ double ecl_grid_get_top1A(const ecl_grid_type * grid , int active_index) {
 */
 
 double ecl_grid_get_bottom1(const ecl_grid_type * grid , int global_index) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+  ecl_cell_type cell_buffer;
+  const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer );
   double depth = 0;
   int ij;
 
@@ -4686,8 +6719,7 @@ double ecl_grid_get_bottom1A(const ecl_grid_type * grid , int active_index) {
 
 
 
-double ecl_grid_get_cell_dz1( const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+static double ecl_cell_get_dz( const ecl_cell_type * cell ) {
   double dz = 0;
   int ij;
 
@@ -4698,6 +6730,12 @@ double ecl_grid_get_cell_dz1( const ecl_grid_type * grid , int global_index ) {
 }
 
 
+double ecl_grid_get_cell_dz1( const ecl_grid_type * grid , int global_index ) {
+  ecl_cell_type cell_buffer;
+  return ecl_cell_get_dz( ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer ) );
+}
+
+
 double ecl_grid_get_cell_dz3( const ecl_grid_type * grid , int i , int j , int k) {
   const int global_index = ecl_grid_get_global_index3(grid , i,j,k);
   return ecl_grid_get_cell_dz1( grid , global_index );
@@ -4726,8 +6764,7 @@ double ecl_grid_get_cell_thickness1A( const ecl_grid_type * grid , int active_in
 
 
 
-double ecl_grid_get_cell_dx1( const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+static double ecl_cell_get_dx( const ecl_cell_type * cell ) {
   double dx = 0;
   double dy = 0;
   int c;
@@ -4743,6 +6780,12 @@ double ecl_grid_get_cell_dx1( const ecl_grid_type * grid , int global_index ) {
 }
 
 
+double ecl_grid_get_cell_dx1( const ecl_grid_type * grid , int global_index ) {
+  ecl_cell_type cell_buffer;
+  return ecl_cell_get_dx( ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer ) );
+}
+
+
 double ecl_grid_get_cell_dx3( const ecl_grid_type * grid , int i , int j , int k) {
   const int global_index = ecl_grid_get_global_index3(grid , i,j,k);
   return ecl_grid_get_cell_dx1( grid , global_index );
@@ -4764,8 +6807,7 @@ double ecl_grid_get_cell_dx1A( const ecl_grid_type * grid , int active_index) {
 
 */
 
-double ecl_grid_get_cell_dy1( const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
+static double ecl_cell_get_dy( const ecl_cell_type * cell ) {
   double dx = 0;
   double dy = 0;
 
@@ -4784,6 +6826,12 @@ double ecl_grid_get_cell_dy1( const ecl_grid_type * grid , int global_index ) {
 }
 
 
+double ecl_grid_get_cell_dy1( const ecl_grid_type * grid , int global_index ) {
+  ecl_cell_type cell_buffer;
+  return ecl_cell_get_dy( ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer ) );
+}
+
+
 double ecl_grid_get_cell_dy3( const ecl_grid_type * grid , int i , int j , int k) {
   const int global_index = ecl_grid_get_global_index3(grid , i,j,k);
   return ecl_grid_get_cell_dy1( grid , global_index );
@@ -4796,10 +6844,38 @@ double ecl_grid_get_cell_dy1A( const ecl_grid_type * grid , int active_index) {
 
 
 const nnc_info_type * ecl_grid_get_cell_nnc_info1( const ecl_grid_type * grid , int global_index) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  return cell->nnc_info;
+  return ecl_grid_get_cell_nnc__( grid , global_index );
+}
+
+/*
+  Will return the number of nnc starting in cell global_index, and set
+  the lgr_nr, global_index2 and nnc_index pointers to the connections
+  of the cell. This is the preferred way to access the nnc of a grid;
+  the function does not allocate anything, and when there are no
+  pending nnc it does not modify the grid, so it can be called
+  concurrently. The pointers are invalidated when new nnc are added to
+  the grid.
+*/
+
+int ecl_grid_get_cell_nnc_row( const ecl_grid_type * grid , int global_index , const int ** lgr_nr , const int ** global_index2 , const int ** nnc_index) {
+  ecl_grid_assert_nnc( grid );
+  {
+    int num_nnc = ecl_grid_get_cell_num_nnc__( grid , global_index );
+    if (num_nnc > 0) {
+      int offset = grid->nnc_offset[global_index];
+      *lgr_nr        = &grid->nnc_lgr_nr[offset];
+      *global_index2 = &grid->nnc_global_index[offset];
+      *nnc_index     = &grid->nnc_input_index[offset];
+    } else {
+      *lgr_nr        = NULL;
+      *global_index2 = NULL;
+      *nnc_index     = NULL;
+    }
+    return num_nnc;
+  }
 }
 
+
 const nnc_info_type * ecl_grid_get_cell_nnc_info3( const ecl_grid_type * grid , int i , int j , int k) {
   const int global_index = ecl_grid_get_global_index3(grid , i,j,k);
   return ecl_grid_get_cell_nnc_info1(grid, global_index);
@@ -4830,8 +6906,8 @@ bool ecl_grid_cell_active3(const ecl_grid_type * ecl_grid, int i , int j , int k
 /*****************************************************************/
 
 bool ecl_grid_cell_invalid1(const ecl_grid_type * ecl_grid , int global_index) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index);
-  return GET_CELL_FLAG(cell , CELL_FLAG_TAINTED);
+  int cell_flags = ecl_grid_get_cell_flags( ecl_grid , global_index );
+  return (cell_flags & CELL_FLAG_TAINTED);
 }
 
 bool ecl_grid_cell_invalid3(const ecl_grid_type * ecl_grid , int i , int j , int k) {
@@ -4846,11 +6922,11 @@ double ecl_grid_cell_invalid1A(const ecl_grid_type * grid , int active_index) {
 
 
 bool ecl_grid_cell_valid1(const ecl_grid_type * ecl_grid , int global_index) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index);
-  if (GET_CELL_FLAG(cell , CELL_FLAG_TAINTED))
+  int cell_flags = ecl_grid_get_cell_flags( ecl_grid , global_index );
+  if (cell_flags & CELL_FLAG_TAINTED)
     return false;
   else
-    return (GET_CELL_FLAG(cell , CELL_FLAG_VALID));
+    return (cell_flags & CELL_FLAG_VALID);
 }
 
 bool ecl_grid_cell_valid3(const ecl_grid_type * ecl_grid , int i , int j , int k) {
@@ -4978,8 +7054,7 @@ ecl_grid_type * ecl_grid_get_lgr_from_lgr_nr(const ecl_grid_type * main_grid, in
 
 
 const ecl_grid_type * ecl_grid_get_cell_lgr1(const ecl_grid_type * grid , int global_index ) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index);
-  return cell->lgr;
+  return ecl_grid_get_cell_lgr__( grid , global_index );
 }
 
 
@@ -5107,7 +7182,8 @@ bool ecl_grid_cell_regular3( const ecl_grid_type * ecl_grid, int i,int j,int k)
 */
 
 int ecl_grid_get_cell_twist1( const ecl_grid_type * ecl_grid, int global_index ) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
+  ecl_cell_type cell_buffer;
+  ecl_cell_type * cell = ecl_grid_get_cell_geometry( ecl_grid , global_index , &cell_buffer );
   return ecl_cell_get_twist( cell );
 }
 
@@ -5119,7 +7195,8 @@ int ecl_grid_get_cell_twist3(const ecl_grid_type * ecl_grid, int i, int j , int
 
 
 double ecl_grid_get_cell_volume1( const ecl_grid_type * ecl_grid, int global_index ) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
+  ecl_cell_type cell_buffer;
+  ecl_cell_type * cell = ecl_grid_get_cell_geometry( ecl_grid , global_index , &cell_buffer );
   int i,j,k;
   ecl_grid_get_ijk1( ecl_grid , global_index, &i , &j , &k);
   return ecl_cell_get_volume( cell );
@@ -5134,7 +7211,8 @@ double ecl_grid_get_cell_volume1A( const ecl_grid_type * ecl_grid, int active_in
 
 
 double ecl_grid_get_cell_volume1_tskille( const ecl_grid_type * ecl_grid, int global_index ) {
-  ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
+  ecl_cell_type cell_buffer;
+  ecl_cell_type * cell = ecl_grid_get_cell_geometry( ecl_grid , global_index , &cell_buffer );
   return ecl_cell_get_volume_tskille( cell );
 }
 
@@ -5516,7 +7594,8 @@ static void ecl_grid_dump__(const ecl_grid_type * grid , FILE * stream) {
   {
     int i;
     for (i=0; i < grid->size; i++) {
-      const ecl_cell_type * cell = ecl_grid_get_cell( grid , i );
+      ecl_cell_type cell_buffer;
+      const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , i , &cell_buffer );
       ecl_cell_dump( cell , stream );
     }
   }
@@ -5535,11 +7614,12 @@ static void ecl_grid_dump_ascii__(ecl_grid_type * grid , bool active_only , FILE
   {
     int l;
     for (l=0; l < grid->size; l++) {
-      ecl_cell_type * cell = ecl_grid_get_cell( grid , l );
-      if (cell->active_index[MATRIX_INDEX] >= 0 || !active_only) {
+      ecl_cell_type cell_buffer;
+      ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , l , &cell_buffer );
+      if (grid->index_map[l] >= 0 || !active_only) {
         int i,j,k;
         ecl_grid_get_ijk1( grid , l , &i , &j , &k);
-        ecl_cell_dump_ascii( cell , i,j,k , stream , NULL);
+        ecl_cell_dump_ascii( grid , cell , l , i,j,k , stream , NULL);
       }
     }
   }
@@ -5575,17 +7655,19 @@ void ecl_grid_dump_ascii(ecl_grid_type * grid , bool active_only , FILE * stream
 
 
 void ecl_grid_dump_ascii_cell1(ecl_grid_type * grid , int global_index , FILE * stream , const double * offset) {
-  ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
+  ecl_cell_type cell_buffer;
+  ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer );
   int i,j,k;
   ecl_grid_get_ijk1( grid , global_index , &i , &j , &k);
-  ecl_cell_dump_ascii(cell , i,j,k, stream , offset);
+  ecl_cell_dump_ascii(grid , cell , global_index , i,j,k, stream , offset);
 }
 
 
 void ecl_grid_dump_ascii_cell3(ecl_grid_type * grid , int i , int j , int k , FILE * stream , const double * offset) {
   int global_index  = ecl_grid_get_global_index3(grid , i,j,k);
-  ecl_cell_type * cell = ecl_grid_get_cell( grid , global_index );
-  ecl_cell_dump_ascii(cell , i,j,k, stream , offset);
+  ecl_cell_type cell_buffer;
+  ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer );
+  ecl_cell_dump_ascii(grid , cell , global_index , i,j,k, stream , offset);
 }
 
 /*****************************************************************/
@@ -5774,7 +7856,8 @@ static void ecl_grid_fwrite_GRID__( const ecl_grid_type * grid , int coords_size
       for (j=0; j < grid->ny; j++) {
         for (i=0; i < grid->nx; i++) {
           int global_index = ecl_grid_get_global_index__(grid , i , j , k );
-          const ecl_cell_type * cell = ecl_grid_get_cell( grid ,  global_index );
+          ecl_cell_type cell_buffer;
+          const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid ,  global_index , &cell_buffer );
 
           ecl_cell_fwrite_GRID( grid , cell , false , coords_size , i,j,k,global_index,coords_kw , corners_kw , fortio );
         }
@@ -5786,7 +7869,8 @@ static void ecl_grid_fwrite_GRID__( const ecl_grid_type * grid , int coords_size
         for (j=0; j < grid->ny; j++) {
           for (i=0; i < grid->nx; i++) {
             int global_index = ecl_grid_get_global_index__(grid , i , j , k - grid->nz );
-            const ecl_cell_type * cell = ecl_grid_get_cell( grid ,  global_index );
+            ecl_cell_type cell_buffer;
+            const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid ,  global_index , &cell_buffer );
 
             ecl_cell_fwrite_GRID( grid , cell , true , coords_size , i,j,k,global_index ,  coords_kw , corners_kw , fortio );
           }
@@ -5897,11 +7981,9 @@ static int ecl_grid_get_valid_index( const ecl_grid_type * grid , int i , int j
   int delta = (k1 < k2) ? 1 : -1 ;
 
   while (true) {
-    ecl_cell_type * cell;
     global_index = ecl_grid_get_global_index3( grid , i , j , k );
 
-    cell = ecl_grid_get_cell( grid ,  global_index );
-    if (GET_CELL_FLAG(cell , CELL_FLAG_VALID))
+    if (ecl_grid_get_cell_flags( grid ,  global_index ) & CELL_FLAG_VALID)
       return global_index;
     else {
       k += delta;
@@ -5935,8 +8017,10 @@ static bool ecl_grid_init_coord_section__( const ecl_grid_type * grid , int i, i
     point_type top_point;
     point_type bottom_point;
 
-    const ecl_cell_type * bottom_cell = ecl_grid_get_cell( grid , bottom_index );
-    const ecl_cell_type * top_cell    = ecl_grid_get_cell( grid , top_index);
+    ecl_cell_type bottom_buffer;
+    ecl_cell_type top_buffer;
+    const ecl_cell_type * bottom_cell = ecl_grid_get_cell_geometry( grid , bottom_index , &bottom_buffer );
+    const ecl_cell_type * top_cell    = ecl_grid_get_cell_geometry( grid , top_index , &top_buffer );
 
     /*
       2---3
@@ -6068,7 +8152,8 @@ static void ecl_grid_init_zcorn_data__( const ecl_grid_type * grid , float * zco
     for (i=0; i < nx; i++) {
       for (k=0; k < nz; k++) {
         const int cell_index   = ecl_grid_get_global_index3( grid , i,j,k);
-        const ecl_cell_type * cell = ecl_grid_get_cell( grid , cell_index );
+        ecl_cell_type cell_buffer;
+        const ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , cell_index , &cell_buffer );
         int l;
 
         for (l=0; l < 2; l++) {
@@ -6139,13 +8224,13 @@ int ecl_grid_get_zcorn_size( const ecl_grid_type * grid ) {
 void ecl_grid_init_actnum_data( const ecl_grid_type * grid , int * actnum ) {
   int i;
   for (i=0; i < grid->size; i++) {
-    const ecl_cell_type * cell = ecl_grid_get_cell( grid , i );
-    if (cell->coarse_group == COARSE_GROUP_NONE)
-      actnum[i] = cell->active;
+    int coarse_group = ecl_grid_get_coarse_group__( grid , i );
+    if (coarse_group == COARSE_GROUP_NONE)
+      actnum[i] = grid->cell_active[i];
     else {
       /* In the case of coarse cells we must query the coarse cell for
          the original, uncoarsened distribution of actnum values. */
-      ecl_coarse_cell_type * coarse_cell = ecl_grid_iget_coarse_group( grid , cell->coarse_group );
+      ecl_coarse_cell_type * coarse_cell = ecl_grid_iget_coarse_group( grid , coarse_group );
 
       /* 1: Set all the elements in the coarse group to inactive. */
       {
@@ -6174,6 +8259,89 @@ void ecl_grid_init_actnum_data( const ecl_grid_type * grid , int * actnum ) {
 }
 
 
+/*
+  Calculates one geometric property for all the cells in the grid;
+  if active_only is true the data vector should have one element for
+  each active cell, otherwise one element for each cell. The cells
+  are processed in parallel when OpenMP is enabled, and the values
+  are identical to the values from the per cell functions like
+  ecl_grid_get_cell_volume1(). For grids which store the cells, i.e.
+  grids from GRID files and the rectangular grids, calculating the
+  volumes will also initialize the volume cache of the cells; grids
+  with compact geometry do not cache the volumes.
+*/
+
+static void ecl_grid_init_geometry_data__( const ecl_grid_type * grid , ecl_grid_geometry_enum property , bool active_only , double * double_data , float * float_data) {
+  const int size = active_only ? grid->total_active : grid->size;
+  int index;
+
+  if ((property < ECL_GRID_VOLUME) || (property > ECL_GRID_DZ))
+    util_abort("%s: invalid geometry property:%d \n",__func__ , property);
+
+  ecl_grid_assert_geometry( grid );
+
+#pragma omp parallel for
+  for (index = 0; index < size; index++) {
+    int global_index = active_only ? grid->inv_index_map[index] : index;
+    ecl_cell_type cell_buffer;
+    ecl_cell_type * cell = ecl_grid_get_cell_geometry( grid , global_index , &cell_buffer );
+    double value = 0;
+
+    switch (property) {
+    case ECL_GRID_VOLUME:
+      value = ecl_cell_get_volume( cell );
+      break;
+    case ECL_GRID_CENTER_X:
+    case ECL_GRID_CENTER_Y:
+    case ECL_GRID_DEPTH:
+      {
+        point_type center;
+        ecl_cell_compute_center( cell , &center );
+        if (property == ECL_GRID_CENTER_X)
+          value = center.x;
+        else if (property == ECL_GRID_CENTER_Y)
+          value = center.y;
+        else
+          value = center.z;
+      }
+      break;
+    case ECL_GRID_DX:
+      value = ecl_cell_get_dx( cell );
+      break;
+    case ECL_GRID_DY:
+      value = ecl_cell_get_dy( cell );
+      break;
+    case ECL_GRID_DZ:
+      value = ecl_cell_get_dz( cell );
+      break;
+    }
+
+    if (double_data)
+      double_data[index] = value;
+    else
+      float_data[index] = value;
+  }
+}
+
+
+void ecl_grid_init_geometry_data( const ecl_grid_type * grid , ecl_grid_geometry_enum property , bool active_only , double * data) {
+  ecl_grid_init_geometry_data__( grid , property , active_only , data , NULL );
+}
+
+
+void ecl_grid_init_geometry_data_float( const ecl_grid_type * grid , ecl_grid_geometry_enum property , bool active_only , float * data) {
+  ecl_grid_init_geometry_data__( grid , property , active_only , NULL , data );
+}
+
+
+ecl_kw_type * ecl_grid_alloc_geometry_kw( const ecl_grid_type * grid , ecl_grid_geometry_enum property , const char * kw_name , bool active_only) {
+  int size = active_only ? grid->total_active : grid->size;
+  ecl_kw_type * ecl_kw = ecl_kw_alloc( kw_name , size , ECL_FLOAT_TYPE );
+  ecl_grid_init_geometry_data_float( grid , property , active_only , ecl_kw_get_ptr( ecl_kw ));
+  return ecl_kw;
+}
+
+
 int * ecl_grid_alloc_actnum_data( const ecl_grid_type * grid ) {
   int * actnum = util_calloc( grid->size , sizeof * actnum);
   ecl_grid_init_actnum_data( grid , actnum );
@@ -6223,10 +8391,8 @@ void ecl_grid_global_kw_copy( const ecl_grid_type * grid , ecl_kw_type * target_
 
 static void ecl_grid_init_hostnum_data( const ecl_grid_type * grid , int * hostnum ) {
   int i;
-  for (i=0; i < grid->size; i++) {
-    const ecl_cell_type * cell = ecl_grid_get_cell(grid , i );
-    hostnum[i] = cell->host_cell;
-  }
+  for (i=0; i < grid->size; i++)
+    hostnum[i] = ecl_grid_get_host_cell__( grid , i );
 }
 
 int * ecl_grid_alloc_hostnum_data( const ecl_grid_type * grid ) {
@@ -6246,10 +8412,8 @@ ecl_kw_type * ecl_grid_alloc_hostnum_kw( const ecl_grid_type * grid ) {
 
 static void ecl_grid_init_corsnum_data( const ecl_grid_type * grid , int * corsnum ) {
   int i;
-  for (i=0; i < grid->size; i++) {
-    const ecl_cell_type * cell = ecl_grid_get_cell(grid , i );
-    corsnum[i] = cell->coarse_group + 1;
-  }
+  for (i=0; i < grid->size; i++)
+    corsnum[i] = ecl_grid_get_coarse_group__( grid , i ) + 1;
 }
 
 int * ecl_grid_alloc_corsnum_data( const ecl_grid_type * grid ) {
@@ -6287,11 +8451,10 @@ void ecl_grid_reset_actnum( ecl_grid_type * grid , const int * actnum ) {
   const int global_size = ecl_grid_get_global_size( grid );
   int g;
   for (g=0; g < global_size; g++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
     if (actnum)
-      cell->active = actnum[g];
+      grid->cell_active[g] = actnum[g];
     else
-      cell->active = 1;
+      grid->cell_active[g] = 1;
   }
   ecl_grid_update_index( grid );
 }
@@ -6303,16 +8466,16 @@ static void  ecl_grid_fwrite_self_nnc( const ecl_grid_type * grid , fortio_type
   int_vector_type * g2 = int_vector_alloc(0 , default_index );
   int g;
 
-  for (g=0; g < ecl_grid_get_global_size(grid); g++) {
-    ecl_cell_type * cell = ecl_grid_get_cell( grid , g );
-    const nnc_info_type * nnc_info = cell->nnc_info;
-    if (nnc_info) {
-      const nnc_vector_type * nnc_vector = nnc_info_get_self_vector(nnc_info);
+  ecl_grid_assert_nnc( grid );
+  if (grid->nnc_offset) {
+    for (g=0; g < ecl_grid_get_global_size(grid); g++) {
       int i;
-      for (i = 0; i < nnc_vector_get_size( nnc_vector ); i++) {
-        int nnc_index = nnc_vector_iget_nnc_index( nnc_vector , i );
-        int_vector_iset( g1 , nnc_index , 1 + g );
-        int_vector_iset( g2 , nnc_index , 1 + nnc_vector_iget_grid_index( nnc_vector , i ));
+      for (i = grid->nnc_offset[g]; i < grid->nnc_offset[g + 1]; i++) {
+        if (grid->nnc_lgr_nr[i] == grid->lgr_nr) {
+          int nnc_index = grid->nnc_input_index[i];
+          int_vector_iset( g1 , nnc_index , 1 + g );
+          int_vector_iset( g2 , nnc_index , 1 + grid->nnc_global_index[i] );
+        }
       }
     }
   }
@@ -6454,12 +8617,7 @@ void ecl_grid_fwrite_EGRID( ecl_grid_type * grid , const char * filename, bool o
 
 
 void ecl_grid_fwrite_depth( const ecl_grid_type * grid , fortio_type * init_file , ert_ecl_unit_enum output_unit) {
-  ecl_kw_type * depth_kw = ecl_kw_alloc("DEPTH" , ecl_grid_get_nactive(grid) , ECL_FLOAT_TYPE );
-  {
-    float * depth_ptr = ecl_kw_get_ptr(depth_kw);
-    for (int i = 0; i < ecl_grid_get_nactive( grid ); i++)
-      depth_ptr[i] = ecl_grid_get_cdepth1A( grid , i );
-  }
+  ecl_kw_type * depth_kw = ecl_grid_alloc_geometry_kw( grid , ECL_GRID_DEPTH , "DEPTH" , true );
   ecl_kw_scale_float( depth_kw , ecl_grid_output_scaling( grid , output_unit ));
   ecl_kw_fwrite( depth_kw , init_file );
   ecl_kw_free( depth_kw );
@@ -6467,28 +8625,14 @@ void ecl_grid_fwrite_depth( const ecl_grid_type * grid , fortio_type * init_file
 
 
 void ecl_grid_fwrite_dims( const ecl_grid_type * grid , fortio_type * init_file,  ert_ecl_unit_enum output_unit) {
-  ecl_kw_type * dx = ecl_kw_alloc("DX" , ecl_grid_get_nactive(grid) , ECL_FLOAT_TYPE );
-  ecl_kw_type * dy = ecl_kw_alloc("DY" , ecl_grid_get_nactive(grid) , ECL_FLOAT_TYPE );
-  ecl_kw_type * dz = ecl_kw_alloc("DZ" , ecl_grid_get_nactive(grid) , ECL_FLOAT_TYPE );
+  ecl_kw_type * dx = ecl_grid_alloc_geometry_kw( grid , ECL_GRID_DX , "DX" , true );
+  ecl_kw_type * dy = ecl_grid_alloc_geometry_kw( grid , ECL_GRID_DY , "DY" , true );
+  ecl_kw_type * dz = ecl_grid_alloc_geometry_kw( grid , ECL_GRID_DZ , "DZ" , true );
   {
-    {
-      float * dx_ptr = ecl_kw_get_ptr(dx);
-      float * dy_ptr = ecl_kw_get_ptr(dy);
-      float * dz_ptr = ecl_kw_get_ptr(dz);
-
-      for (int i = 0; i < ecl_grid_get_nactive( grid ); i++) {
-        dx_ptr[i] = ecl_grid_get_cell_dx1A( grid , i );
-        dy_ptr[i] = ecl_grid_get_cell_dy1A( grid , i );
-        dz_ptr[i] = ecl_grid_get_cell_dz1A( grid , i );
-      }
-    }
-
-    {
-      float scale_factor = ecl_grid_output_scaling( grid , output_unit );
-      ecl_kw_scale_float( dx , scale_factor );
-      ecl_kw_scale_float( dy , scale_factor );
-      ecl_kw_scale_float( dz , scale_factor );
-    }
+    float scale_factor = ecl_grid_output_scaling( grid , output_unit );
+    ecl_kw_scale_float( dx , scale_factor );
+    ecl_kw_scale_float( dy , scale_factor );
+    ecl_kw_scale_float( dz , scale_factor );
   }
   ecl_kw_fwrite( dx , init_file );
   ecl_kw_fwrite( dy , init_file );
@@ -6573,7 +8717,8 @@ void ecl_grid_fprintf_grdecl(ecl_grid_type * grid , FILE * stream ) {
 */
 
 void ecl_grid_cell_ri_export( const ecl_grid_type * ecl_grid , int global_index , double * ri_points) {
-  const ecl_cell_type * cell = ecl_grid_get_cell( ecl_grid , global_index );
+  ecl_cell_type cell_buffer;
+  const ecl_cell_type * cell = ecl_grid_get_cell_geometry( ecl_grid , global_index , &cell_buffer );
   int offset = global_index * 8 * 3;
   ecl_cell_ri_export( cell , &ri_points[ offset ] );
 }
@@ -6596,14 +8741,11 @@ bool ecl_grid_dual_grid( const ecl_grid_type * ecl_grid ) {
 }
 
 static int ecl_grid_get_num_nnc__( const ecl_grid_type * grid ) {
-  int g;
-  int num_nnc = 0;
-  for (g = 0; g < grid->size; g++) {
-    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , g );
-    if (nnc_info)
-      num_nnc += nnc_info_get_total_size( nnc_info );
-  }
-  return num_nnc;
+  ecl_grid_assert_nnc( grid );
+  if (grid->nnc_offset)
+    return grid->nnc_offset[grid->size];
+  else
+    return 0;
 }
 
 
@@ -21,6 +21,15 @@
 #include <stdbool.h>
 #include <string.h>
 #include <math.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
+
+#include <ert/util/build_config.h>
+
+#ifdef HAVE_PREAD
+#include <unistd.h>
+#endif
 
 #include <ert/util/util.h>
 #include <ert/util/buffer.h>
@@ -95,33 +104,22 @@ UTIL_IS_INSTANCE_FUNCTION(ecl_kw , ECL_KW_TYPE_ID )
 
 
 /*****************************************************************/
-/* Format string used when reading and writing formatted
-   files. Observe the following about these format strings:
+/* Format string used when writing formatted files. Observe the
+   following about these format strings:
 
-    1. The format string for reading double contains two '%'
-       identifiers, that is because doubles are read by parsing a
-       prefix and power separately.
-
-    2. For both double and float the write format contains two '%'
+    1. For both double and float the write format contains two '%'
        characters - that is because the values are split in a prefix
        and a power prior to writing - see the function
-       __fprintf_scientific().
+       __sprintf_scientific().
 
-    3. The logical type involves converting back and forth between 'T'
+    2. The logical type involves converting back and forth between 'T'
        and 'F' and internal logical representation. The format strings
-       are therefor for reading/writing a character.
+       are therefor for writing a character.
 
+   The formatted data is read with the scanners in the
+   ecl_kw_fmt_xxx() functions, see ecl_kw_fread_data().
 */
 
-#define READ_FMT_CHAR     "%8c"
-#define READ_FMT_C010     "%10c"
-#define READ_FMT_FLOAT    "%gE"
-#define READ_FMT_INT      "%d"
-#define READ_FMT_MESS     "%8c"
-#define READ_FMT_BOOL     "  %c"
-#define READ_FMT_DOUBLE   "%lgD%d"
-
-
 #define WRITE_FMT_CHAR    " '%-8s'"
 #define WRITE_FMT_C010    " '%-10s'"
 #define WRITE_FMT_INT     " %11d"
@@ -160,36 +158,6 @@ UTIL_IS_INSTANCE_FUNCTION(ecl_kw , ECL_KW_TYPE_ID )
 
 
 
-static const char * get_read_fmt( ecl_type_enum ecl_type ) {
-  switch(ecl_type) {
-  case(ECL_CHAR_TYPE):
-    return READ_FMT_CHAR;
-    break;
-  case(ECL_C010_TYPE):
-    return READ_FMT_C010;
-    break;
-  case(ECL_INT_TYPE):
-    return READ_FMT_INT;
-    break;
-  case(ECL_FLOAT_TYPE):
-    return READ_FMT_FLOAT;
-    break;
-  case(ECL_DOUBLE_TYPE):
-    return READ_FMT_DOUBLE;
-    break;
-  case(ECL_BOOL_TYPE):
-    return READ_FMT_BOOL;
-    break;
-  case(ECL_MESS_TYPE):
-    return READ_FMT_MESS;
-    break;
-  default:
-    util_abort("%s: invalid ecl_type:%d \n",__func__ , ecl_type);
-    return NULL;
-  }
-}
-
-
 const char * ecl_kw_get_write_fmt( ecl_type_enum ecl_type ) {
   switch(ecl_type) {
   case(ECL_CHAR_TYPE):
@@ -508,12 +476,12 @@ static void ecl_kw_initialize(ecl_kw_type * ecl_kw , const char *header ,  int s
   ecl_kw->size = size;
 }
 
-static size_t ecl_kw_fortio_data_size( const ecl_kw_type * ecl_kw) {
-  const int blocksize  = get_blocksize( ecl_kw->ecl_type );
-  const int num_blocks = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+static size_t ecl_kw_fortio_data_size__( ecl_type_enum ecl_type , int size) {
+  const int blocksize  = get_blocksize( ecl_type );
+  const int num_blocks = size / blocksize + (size % blocksize == 0 ? 0 : 1);
 
   return num_blocks * (4 + 4) +                                           // Fortran fluff for each block
-    ecl_kw->size * ecl_util_get_sizeof_ctype_fortio( ecl_kw->ecl_type );  // Actual data
+    (size_t) size * ecl_util_get_sizeof_ctype_fortio( ecl_type );         // Actual data
 }
 
 
@@ -525,9 +493,12 @@ static size_t ecl_kw_fortio_data_size( const ecl_kw_type * ecl_kw) {
 */
 
 size_t ecl_kw_fortio_size( const ecl_kw_type * ecl_kw ) {
-  size_t size = ECL_KW_HEADER_FORTIO_SIZE;
-  size += ecl_kw_fortio_data_size(ecl_kw );
-  return size;
+  return ecl_kw_fortio_size__( ecl_kw->ecl_type , ecl_kw->size );
+}
+
+
+size_t ecl_kw_fortio_size__( ecl_type_enum ecl_type , int size ) {
+  return ECL_KW_HEADER_FORTIO_SIZE + ecl_kw_fortio_data_size__( ecl_type , size );
 }
 
 
@@ -572,6 +543,17 @@ ecl_kw_type * ecl_kw_alloc_new_shared(const char * header ,  int size, ecl_type_
 }
 
 
+/*
+  Returns true if the data of the keyword is not owned by the keyword,
+  i.e. it has been created with ecl_kw_alloc_new_shared() or it uses
+  the memory of a mapped file directly.
+*/
+
+bool ecl_kw_data_is_shared( const ecl_kw_type * ecl_kw ) {
+  return ecl_kw->shared_data;
+}
+
+
 
 ecl_kw_type * ecl_kw_alloc_empty() {
   ecl_kw_type *ecl_kw;
@@ -1068,95 +1050,521 @@ static bool ecl_kw_fscanf_qstring(char *s , const char *fmt , int len, FILE *str
 
 
 
+/*****************************************************************/
 /*
-  This rather painful parsing is because formatted eclipse double
-  format : 0.ddddD+01 - difficult to parse the 'D';
+  Reading of formatted data. The formatted keyword data is read in
+  large chunks from the FILE stream into a memory buffer, and the
+  elements are parsed directly from the buffer with hand written
+  scanners; this is much faster than calling fscanf() for every
+  element. The numeric elements are parsed in chunks of
+  ECL_KW_FMT_CHUNK_SIZE elements: first the token boundaries in the
+  chunk are located, and then the tokens are converted - in parallel
+  if the keyword is large and OpenMP is enabled.
+
+  The double precision numbers in formatted files use the Fortran 'D'
+  exponent, i.e. 0.12345678901234D+03, and for exponents with three
+  digits Fortran will drop the exponent character completely,
+  i.e. 0.12345678901234+103; the number scanner handles all of these.
 */
-/** Should be: NESTED */
-
-static double __fscanf_ECL_double( FILE * stream , const char * fmt) {
-  int    read_count , power;
-  double value , arg;
-  read_count = fscanf( stream , fmt , &arg , &power);
-  if (read_count == 2)
-    value = arg * pow(10 , power );
-  else {
-    util_abort("%s: read failed \n",__func__);
-    value = -1;
+
+#define ECL_KW_FMT_BUFFER_SIZE  65536
+#define ECL_KW_FMT_CHUNK_SIZE   4096
+#define ECL_KW_FMT_MAX_DIGITS   19
+#define ECL_KW_FMT_TOKEN_LENGTH 64
+
+typedef struct {
+  FILE        * stream;
+  char        * data;
+  size_t        alloc_size;
+  size_t        data_size;     /* The number of valid bytes in data. */
+  size_t        pos;           /* The current parse position in data. */
+  offset_type   data_offset;   /* The file offset of data[0]. */
+  bool          at_eof;
+} ecl_kw_fmt_buffer_type;
+
+
+static void ecl_kw_fmt_buffer_init( ecl_kw_fmt_buffer_type * fmt_buffer , fortio_type * fortio ) {
+  fmt_buffer->stream      = fortio_get_FILE( fortio );
+  fmt_buffer->alloc_size  = ECL_KW_FMT_BUFFER_SIZE;
+  fmt_buffer->data        = util_malloc( fmt_buffer->alloc_size );
+  fmt_buffer->data_size   = 0;
+  fmt_buffer->pos         = 0;
+  fmt_buffer->data_offset = fortio_ftell( fortio );
+  fmt_buffer->at_eof      = false;
+  fmt_buffer->data[0]     = '\0';
+}
+
+
+static void ecl_kw_fmt_buffer_free_data( ecl_kw_fmt_buffer_type * fmt_buffer ) {
+  free( fmt_buffer->data );
+}
+
+
+static offset_type ecl_kw_fmt_buffer_tell( const ecl_kw_fmt_buffer_type * fmt_buffer ) {
+  return fmt_buffer->data_offset + fmt_buffer->pos;
+}
+
+
+/*
+  Will discard the buffered data in front of the file offset
+  @keep_offset, and then read more data from the stream. Returns
+  false if no more data could be read.
+*/
+
+static bool ecl_kw_fmt_buffer_fill( ecl_kw_fmt_buffer_type * fmt_buffer , offset_type keep_offset ) {
+  if (fmt_buffer->at_eof)
+    return false;
+
+  {
+    size_t keep_pos = keep_offset - fmt_buffer->data_offset;
+    if (keep_pos > 0) {
+      memmove( fmt_buffer->data , &fmt_buffer->data[keep_pos] , fmt_buffer->data_size - keep_pos );
+      fmt_buffer->data_size   -= keep_pos;
+      fmt_buffer->pos         -= keep_pos;
+      fmt_buffer->data_offset += keep_pos;
+    }
+  }
+
+  if (2 * fmt_buffer->data_size > fmt_buffer->alloc_size) {
+    fmt_buffer->alloc_size *= 2;
+    fmt_buffer->data = util_realloc( fmt_buffer->data , fmt_buffer->alloc_size );
+  }
+
+  {
+    size_t read_size = fmt_buffer->alloc_size - fmt_buffer->data_size - 1;
+    size_t bytes_read = fread( &fmt_buffer->data[fmt_buffer->data_size] , 1 , read_size , fmt_buffer->stream );
+
+    if (bytes_read < read_size)
+      fmt_buffer->at_eof = true;
+
+    fmt_buffer->data_size += bytes_read;
+    fmt_buffer->data[fmt_buffer->data_size] = '\0';
+    return (bytes_read > 0);
+  }
+}
+
+
+static inline bool ecl_kw_fmt_isspace( char c ) {
+  return (c == ' ' || c == '\n' || c == '\t' || c == '\r');
+}
+
+
+/*
+  Will locate the next whitespace separated token in the buffer, and
+  return the file offset and length of the token. The buffer will
+  retain the data from file offset @keep_offset; i.e. tokens found
+  earlier in the same chunk are still valid. Returns false if there
+  are no more tokens.
+*/
+
+static bool ecl_kw_fmt_buffer_next_token( ecl_kw_fmt_buffer_type * fmt_buffer , offset_type keep_offset , offset_type * token_offset , int * token_length) {
+  while (true) {
+    while ((fmt_buffer->pos < fmt_buffer->data_size) && ecl_kw_fmt_isspace( fmt_buffer->data[fmt_buffer->pos] ))
+      fmt_buffer->pos++;
+
+    if (fmt_buffer->pos < fmt_buffer->data_size)
+      break;
+
+    if (!ecl_kw_fmt_buffer_fill( fmt_buffer , (keep_offset < 0) ? ecl_kw_fmt_buffer_tell( fmt_buffer ) : keep_offset ))
+      return false;
+  }
+
+  *token_offset = ecl_kw_fmt_buffer_tell( fmt_buffer );
+  if (keep_offset < 0)
+    keep_offset = *token_offset;
+
+  while (true) {
+    while ((fmt_buffer->pos < fmt_buffer->data_size) && !ecl_kw_fmt_isspace( fmt_buffer->data[fmt_buffer->pos] ))
+      fmt_buffer->pos++;
+
+    if (fmt_buffer->pos < fmt_buffer->data_size)
+      break;
+
+    if (!ecl_kw_fmt_buffer_fill( fmt_buffer , keep_offset ))
+      break;
   }
-  return value;
+
+  *token_length = ecl_kw_fmt_buffer_tell( fmt_buffer ) - *token_offset;
+  return true;
+}
+
+
+static const char * ecl_kw_fmt_buffer_get_ptr( const ecl_kw_fmt_buffer_type * fmt_buffer , offset_type offset ) {
+  return &fmt_buffer->data[ offset - fmt_buffer->data_offset ];
 }
 
+
+/*
+  Reads a quoted string of the form 'xxxxxxxx' with @len characters
+  between the quotes. Characters in front of the opening quote are
+  skipped.
+*/
+
+static bool ecl_kw_fmt_buffer_read_qstring( ecl_kw_fmt_buffer_type * fmt_buffer , char * s , int len) {
+  while (true) {
+    while ((fmt_buffer->pos < fmt_buffer->data_size) && (fmt_buffer->data[fmt_buffer->pos] != '\''))
+      fmt_buffer->pos++;
+
+    if ((fmt_buffer->pos + len + 2) <= fmt_buffer->data_size)
+      break;
+
+    if (!ecl_kw_fmt_buffer_fill( fmt_buffer , ecl_kw_fmt_buffer_tell( fmt_buffer )))
+      return false;
+  }
+
+  memcpy( s , &fmt_buffer->data[fmt_buffer->pos + 1] , len );
+  s[len] = '\0';
+  fmt_buffer->pos += len + 2;
+  return true;
+}
+
+
+
+static const double ecl_kw_fmt_pow10[] = {1e0  , 1e1  , 1e2  , 1e3  , 1e4  , 1e5  , 1e6  , 1e7  ,
+                                          1e8  , 1e9  , 1e10 , 1e11 , 1e12 , 1e13 , 1e14 , 1e15 ,
+                                          1e16 , 1e17 , 1e18 , 1e19 , 1e20 , 1e21 , 1e22 };
+
+static const float ecl_kw_fmt_pow10f[] = {1e0f , 1e1f , 1e2f , 1e3f , 1e4f , 1e5f , 1e6f , 1e7f ,
+                                          1e8f , 1e9f , 1e10f };
+
+/*
+  Copies the token to @buffer with the exponent character normalized
+  to 'E', so that it can be parsed with strtod() / strtof(). This is
+  the fallback for the numbers which can not be handled exactly by
+  the fast paths, and special values like 'NaN'.
+*/
+
+static bool ecl_kw_fmt_normalize_token( const char * token , int length , char * buffer) {
+  int  src , target = 0;
+
+  if (length > ECL_KW_FMT_TOKEN_LENGTH)
+    return false;
+
+  for (src = 0; src < length; src++) {
+    char c = token[src];
+    if (c == 'D' || c == 'd')
+      c = 'E';
+    else if ((c == '+' || c == '-') && (src > 0) && isdigit( token[src - 1] ))
+      buffer[target++] = 'E';      /* Fortran exponent without exponent character: 0.123+103 */
+
+    buffer[target++] = c;
+  }
+  buffer[target] = '\0';
+  return true;
+}
+
+
+static bool ecl_kw_fmt_parse_double_strtod( const char * token , int length , double * value) {
+  char buffer[ECL_KW_FMT_TOKEN_LENGTH + 2];
+  if (ecl_kw_fmt_normalize_token( token , length , buffer )) {
+    char * end;
+    *value = strtod( buffer , &end );
+    return (end != buffer) && (*end == '\0');
+  } else
+    return false;
+}
+
+
+static bool ecl_kw_fmt_parse_float_strtof( const char * token , int length , float * value) {
+  char buffer[ECL_KW_FMT_TOKEN_LENGTH + 2];
+  if (ecl_kw_fmt_normalize_token( token , length , buffer )) {
+    char * end;
+    *value = strtof( buffer , &end );
+    return (end != buffer) && (*end == '\0');
+  } else
+    return false;
+}
+
+
+#define ECL_KW_FMT_SCAN_ERROR    0
+#define ECL_KW_FMT_SCAN_EXACT    1
+#define ECL_KW_FMT_SCAN_INEXACT  2
+
+/*
+  Scans the floating point number in the interval [token, token +
+  length) into a sign, an integer significand and a decimal
+  exponent. Returns ECL_KW_FMT_SCAN_INEXACT if the significand had
+  more than ECL_KW_FMT_MAX_DIGITS digits, or the token could not be
+  scanned, but might still be a valid number for strtod().
+*/
+
+static int ecl_kw_fmt_scan_number( const char * token , int length , bool * negative , uint64_t * significand , int * exponent) {
+  const char * end = &token[length];
+  const char * p = token;
+  bool exact = true;
+  int num_digits = 0;
+
+  *negative = false;
+  *significand = 0;
+  *exponent = 0;
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    *negative = (*p == '-');
+    p++;
+  }
+
+  {
+    bool has_digits = false;
+    while (p < end && isdigit( *p )) {
+      if (num_digits < ECL_KW_FMT_MAX_DIGITS) {
+        if (*significand > 0 || *p != '0') {
+          *significand = 10 * *significand + (*p - '0');
+          num_digits++;
+        }
+      } else {
+        exact = false;
+        (*exponent)++;
+      }
+      has_digits = true;
+      p++;
+    }
+
+    if (p < end && *p == '.') {
+      p++;
+      while (p < end && isdigit( *p )) {
+        if (num_digits < ECL_KW_FMT_MAX_DIGITS) {
+          if (*significand > 0 || *p != '0') {
+            *significand = 10 * *significand + (*p - '0');
+            num_digits++;
+          }
+          (*exponent)--;
+        } else
+          exact = false;
+        has_digits = true;
+        p++;
+      }
+    }
+
+    if (!has_digits)
+      return ECL_KW_FMT_SCAN_INEXACT;
+  }
+
+  if (p < end) {
+    int exp_sign = 1;
+    int exp_value = 0;
+
+    if (*p == 'E' || *p == 'e' || *p == 'D' || *p == 'd')
+      p++;
+
+    if (p < end && (*p == '-' || *p == '+')) {
+      if (*p == '-')
+        exp_sign = -1;
+      p++;
+    }
+
+    if (p == end)
+      return ECL_KW_FMT_SCAN_ERROR;
+
+    while (p < end && isdigit( *p )) {
+      if (exp_value < 10000)
+        exp_value = 10 * exp_value + (*p - '0');
+      p++;
+    }
+
+    if (p != end)
+      return ECL_KW_FMT_SCAN_ERROR;
+
+    *exponent += exp_sign * exp_value;
+  }
+
+  return exact ? ECL_KW_FMT_SCAN_EXACT : ECL_KW_FMT_SCAN_INEXACT;
+}
+
+
+/*
+  Parses a double precision number. If the significand is less than
+  2^53 and the decimal exponent is at most 22 in magnitude the result
+  is found by one multiplication or division of two exactly
+  represented numbers, and is therefor correctly rounded. All other
+  numbers are passed on to strtod().
+*/
+
+static bool ecl_kw_fmt_parse_double( const char * token , int length , double * value) {
+  bool negative;
+  uint64_t significand;
+  int exponent;
+  int scan = ecl_kw_fmt_scan_number( token , length , &negative , &significand , &exponent );
+
+  if (scan == ECL_KW_FMT_SCAN_ERROR)
+    return false;
+
+  if ((scan == ECL_KW_FMT_SCAN_EXACT) && (significand < (UINT64_C(1) << 53)) && (exponent >= -22) && (exponent <= 22)) {
+    double v = (double) significand;
+    if (exponent < 0)
+      v /= ecl_kw_fmt_pow10[ -exponent ];
+    else
+      v *= ecl_kw_fmt_pow10[ exponent ];
+
+    *value = negative ? -v : v;
+    return true;
+  } else
+    return ecl_kw_fmt_parse_double_strtod( token , length , value );
+}
+
+
+/*
+  Parses a single precision number. The number is rounded directly to
+  float, like strtof() does; going through double would round twice,
+  which can differ in the last bit. The fast path is the same as for
+  double, with the limits for exactly represented floats: significand
+  less than 2^24 and a decimal exponent of at most 10 in magnitude.
+*/
+
+static bool ecl_kw_fmt_parse_float( const char * token , int length , float * value) {
+  bool negative;
+  uint64_t significand;
+  int exponent;
+  int scan = ecl_kw_fmt_scan_number( token , length , &negative , &significand , &exponent );
+
+  if (scan == ECL_KW_FMT_SCAN_ERROR)
+    return false;
+
+  if ((scan == ECL_KW_FMT_SCAN_EXACT) && (significand < (UINT64_C(1) << 24)) && (exponent >= -10) && (exponent <= 10)) {
+    float v = (float) significand;
+    if (exponent < 0)
+      v /= ecl_kw_fmt_pow10f[ -exponent ];
+    else
+      v *= ecl_kw_fmt_pow10f[ exponent ];
+
+    *value = negative ? -v : v;
+    return true;
+  } else
+    return ecl_kw_fmt_parse_float_strtof( token , length , value );
+}
+
+
+static bool ecl_kw_fmt_parse_int( const char * token , int length , int * value) {
+  const char * end = &token[length];
+  const char * p = token;
+  bool negative = false;
+  int64_t v = 0;
+
+  if (p < end && (*p == '-' || *p == '+')) {
+    negative = (*p == '-');
+    p++;
+  }
+
+  if (p == end)
+    return false;
+
+  while (p < end) {
+    if (!isdigit( *p ))
+      return false;
+
+    v = 10 * v + (*p - '0');
+    if (v > INT_MAX + (int64_t) 1)
+      return false;
+    p++;
+  }
+
+  if (negative)
+    v = -v;
+
+  if (v > INT_MAX)
+    return false;
+
+  *value = (int) v;
+  return true;
+}
+
+
+/*
+  Will parse the token and store the value in element @elm of the
+  keyword.
+*/
+
+static bool ecl_kw_fmt_parse_elm( ecl_kw_type * ecl_kw , int elm , const char * token , int length) {
+  switch (ecl_kw->ecl_type) {
+  case(ECL_INT_TYPE):
+    return ecl_kw_fmt_parse_int( token , length , &((int *) ecl_kw->data)[elm] );
+  case(ECL_FLOAT_TYPE):
+    return ecl_kw_fmt_parse_float( token , length , &((float *) ecl_kw->data)[elm] );
+  case(ECL_DOUBLE_TYPE):
+    return ecl_kw_fmt_parse_double( token , length , &((double *) ecl_kw->data)[elm] );
+  case(ECL_BOOL_TYPE):
+    if (token[0] == BOOL_TRUE_CHAR)
+      ecl_kw_iset_bool( ecl_kw , elm , true );
+    else if (token[0] == BOOL_FALSE_CHAR)
+      ecl_kw_iset_bool( ecl_kw , elm , false );
+    else
+      util_abort("%s: Logical value: [%c] not recogniced - aborting \n", __func__ , token[0]);
+    return true;
+  default:
+    util_abort("%s: Internal error: internal eclipse_type: %d not recognized - aborting \n",__func__ , ecl_kw->ecl_type);
+    return false;
+  }
+}
+
+
+static void ecl_kw_fmt_fread_string_data( ecl_kw_type * ecl_kw , ecl_kw_fmt_buffer_type * fmt_buffer , const char * filename) {
+  int index;
+  for (index = 0; index < ecl_kw->size; index++) {
+    if (!ecl_kw_fmt_buffer_read_qstring( fmt_buffer , &ecl_kw->data[ index * ecl_kw->sizeof_ctype ] , ECL_STRING8_LENGTH))
+      util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - premature file end? \n",__func__ ,
+                 index , ecl_kw->header8 , filename);
+  }
+}
+
+
+static void ecl_kw_fmt_fread_numeric_data( ecl_kw_type * ecl_kw , ecl_kw_fmt_buffer_type * fmt_buffer , const char * filename) {
+  offset_type * token_offset = util_calloc( ECL_KW_FMT_CHUNK_SIZE , sizeof * token_offset );
+  int         * token_length = util_calloc( ECL_KW_FMT_CHUNK_SIZE , sizeof * token_length );
+  int chunk_start;
+
+  for (chunk_start = 0; chunk_start < ecl_kw->size; chunk_start += ECL_KW_FMT_CHUNK_SIZE) {
+    int chunk_size = util_int_min( ECL_KW_FMT_CHUNK_SIZE , ecl_kw->size - chunk_start );
+    int error_index = -1;
+    int i;
+
+    for (i = 0; i < chunk_size; i++) {
+      offset_type keep_offset = (i == 0) ? -1 : token_offset[0];
+      if (!ecl_kw_fmt_buffer_next_token( fmt_buffer , keep_offset , &token_offset[i] , &token_length[i] ))
+        util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - premature file end? \n",__func__ ,
+                   chunk_start + i , ecl_kw->header8 , filename);
+    }
+
+    {
+      const ecl_kw_fmt_buffer_type * const_buffer = fmt_buffer;
+#pragma omp parallel for if (ecl_kw->size > 4 * ECL_KW_FMT_CHUNK_SIZE)
+      for (i = 0; i < chunk_size; i++) {
+        const char * token = ecl_kw_fmt_buffer_get_ptr( const_buffer , token_offset[i] );
+        if (!ecl_kw_fmt_parse_elm( ecl_kw , chunk_start + i , token , token_length[i] )) {
+#pragma omp critical
+          {
+            if ((error_index < 0) || (i < error_index))
+              error_index = i;
+          }
+        }
+      }
+    }
+
+    if (error_index >= 0)
+      util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ ,
+                 chunk_start + error_index , ecl_kw->header8 , filename);
+  }
+
+  free( token_length );
+  free( token_offset );
+}
+
+
 bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
   const char null_char         = '\0';
   bool fmt_file                = fortio_fmt_file( fortio );
   if (ecl_kw->size > 0) {
     const int blocksize = get_blocksize( ecl_kw->ecl_type );
     if (fmt_file) {
-      const int blocks      = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
-      const char * read_fmt = get_read_fmt( ecl_kw->ecl_type );
-      FILE * stream         = fortio_get_FILE(fortio);
-      int    offset         = 0;
-      int    index          = 0;
-      int    ib,ir;
-      for (ib = 0; ib < blocks; ib++) {
-        int read_elm = util_int_min((ib + 1) * blocksize , ecl_kw->size) - ib * blocksize;
-        for (ir = 0; ir < read_elm; ir++) {
-          switch(ecl_kw->ecl_type) {
-          case(ECL_CHAR_TYPE):
-            ecl_kw_fscanf_qstring(&ecl_kw->data[offset] , read_fmt , 8, stream);
-            break;
-          case(ECL_INT_TYPE):
-            {
-              int iread = fscanf(stream , read_fmt , (int *) &ecl_kw->data[offset]);
-              if (iread != 1)
-                util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ , offset / ecl_kw->sizeof_ctype , ecl_kw->header8 , fortio_filename_ref(fortio));
-            }
-            break;
-          case(ECL_FLOAT_TYPE):
-            {
-              int iread = fscanf(stream , read_fmt , (float *) &ecl_kw->data[offset]);
-              if (iread != 1) {
-                util_abort("%s: after reading %d values reading of keyword:%s from:%s failed - aborting \n",__func__ ,
-                           offset / ecl_kw->sizeof_ctype ,
-                           ecl_kw->header8 ,
-                           fortio_filename_ref(fortio));
-              }
-            }
-            break;
-          case(ECL_DOUBLE_TYPE):
-            {
-              double value = __fscanf_ECL_double( stream , read_fmt );
-              ecl_kw_iset(ecl_kw , index , &value);
-            }
-            break;
-          case(ECL_BOOL_TYPE):
-            {
-              char bool_char;
-              if (fscanf(stream , read_fmt , &bool_char) == 1) {
-                if (bool_char == BOOL_TRUE_CHAR)
-                  ecl_kw_iset_bool(ecl_kw , index , true);
-                else if (bool_char == BOOL_FALSE_CHAR)
-                  ecl_kw_iset_bool(ecl_kw , index , false);
-                else
-                  util_abort("%s: Logical value: [%c] not recogniced - aborting \n", __func__ , bool_char);
-              } else
-                util_abort("%s: read failed - premature file end? \n",__func__ );
-            }
-            break;
-          case(ECL_MESS_TYPE):
-            ecl_kw_fscanf_qstring(&ecl_kw->data[offset] , read_fmt , 8 , stream);
-            break;
-          default:
-            util_abort("%s: Internal error: internal eclipse_type: %d not recognized - aborting \n",__func__ , ecl_kw->ecl_type);
-          }
-          offset += ecl_kw->sizeof_ctype;
-          index++;
-        }
-      }
+      ecl_kw_fmt_buffer_type fmt_buffer;
+      ecl_kw_fmt_buffer_init( &fmt_buffer , fortio );
+
+      if (ecl_kw->ecl_type == ECL_CHAR_TYPE || ecl_kw->ecl_type == ECL_MESS_TYPE)
+        ecl_kw_fmt_fread_string_data( ecl_kw , &fmt_buffer , fortio_filename_ref( fortio ));
+      else
+        ecl_kw_fmt_fread_numeric_data( ecl_kw , &fmt_buffer , fortio_filename_ref( fortio ));
 
-      /* Skip the trailing newline */
-      fortio_fseek( fortio , 1 , SEEK_CUR);
+      /* Position the stream after the data, and skip the trailing newline. */
+      fortio_fseek( fortio , ecl_kw_fmt_buffer_tell( &fmt_buffer ) + 1 , SEEK_SET);
+      ecl_kw_fmt_buffer_free_data( &fmt_buffer );
       return true;
     } else {
       bool read_ok = true;
@@ -1205,29 +1613,163 @@ bool ecl_kw_fread_data(ecl_kw_type *ecl_kw, fortio_type *fortio) {
 }
 
 
+/*
+  The gather engine used by ecl_kw_fread_indexed_data(). The requested
+  elements are sorted on file position, and neighboring elements are
+  merged into runs of contiguous file content; the runs can span
+  several Fortran records, the record markers are then just skipped
+  like the other bytes between the requested elements. Each run is
+  read with one positional read into a staging buffer, and the
+  elements are then scattered from the staging buffer to their
+  position in the caller's buffer. Elements which are further apart
+  than ECL_KW_GATHER_MAX_GAP bytes start a new run, and a run is never
+  longer than ECL_KW_GATHER_MAX_RUN bytes.
+
+  If the file is memory mapped the elements are copied directly from
+  the mapping; on platforms without pread() the run is read with
+  fseek() and fread().
+*/
+
+#define ECL_KW_GATHER_MAX_GAP   4096
+#define ECL_KW_GATHER_MAX_RUN   (1024 * 1024)
+
+typedef struct {
+  int  element_index;
+  int  target_index;
+} ecl_kw_gather_elm_type;
+
+
+static int ecl_kw_gather_elm_cmp( const void * arg1 , const void * arg2 ) {
+  const ecl_kw_gather_elm_type * elm1 = (const ecl_kw_gather_elm_type *) arg1;
+  const ecl_kw_gather_elm_type * elm2 = (const ecl_kw_gather_elm_type *) arg2;
+
+  if (elm1->element_index != elm2->element_index)
+    return (elm1->element_index < elm2->element_index) ? -1 : 1;
+  else
+    return (elm1->target_index < elm2->target_index) ? -1 : (elm1->target_index > elm2->target_index);
+}
+
+
+static offset_type ecl_kw_gather_offset( offset_type data_offset , int element_index , int element_size , int block_size) {
+  int block_index = element_index / block_size;
+  return data_offset + (offset_type) (2*block_index + 1) * 4 + (offset_type) element_index * element_size;
+}
+
+
+/*
+  Returns a pointer to the @run_size bytes at file offset @offset;
+  either directly into the memory mapping, or - if the file is not
+  mapped, or the run lies outside the mapping - read into the staging
+  buffer *stage, which is allocated on first use.
+*/
+
+static const char * ecl_kw_gather_read_run( fortio_type * fortio , offset_type offset , size_t run_size , char ** stage_ptr) {
+  const char * mmap_ptr = fortio_mmap_ptr( fortio , offset );
+  char * stage;
+
+  if (mmap_ptr && (offset + (offset_type) run_size <= fortio_mmap_size( fortio )))
+    return mmap_ptr;
+
+  if (*stage_ptr == NULL) {
+    if (!fortio_assert_stream_open( fortio ))
+      util_abort("%s: failed to open stream for %s \n",__func__ , fortio_filename_ref( fortio ));
+
+    /*
+      The stream might have buffered data which has not yet been
+      written to the file descriptor.
+    */
+    fortio_fflush( fortio );
+    *stage_ptr = util_malloc( ECL_KW_GATHER_MAX_RUN );
+  }
+  stage = *stage_ptr;
+
+#ifdef HAVE_PREAD
+  {
+    size_t bytes_read = 0;
+    while (bytes_read < run_size) {
+      ssize_t count = pread( fortio_fileno( fortio ) , &stage[bytes_read] , run_size - bytes_read , offset + bytes_read );
+      if (count <= 0)
+        util_abort("%s: failed to read %zu bytes from %s at offset %lld \n",__func__ , run_size , fortio_filename_ref( fortio ) , (long long) offset);
+      bytes_read += count;
+    }
+  }
+#else
+  fortio_fseek( fortio , offset , SEEK_SET );
+  util_fread( stage , 1 , run_size , fortio_get_FILE( fortio ) , __func__ );
+#endif
+  return stage;
+}
+
+
 void ecl_kw_fread_indexed_data(fortio_type * fortio, offset_type data_offset, ecl_type_enum ecl_type, int element_count, const int_vector_type* index_map, char* buffer) {
     const int block_size = get_blocksize( ecl_type );
-    FILE *stream  = fortio_get_FILE( fortio );
-    int index;
+    const int num_elm    = int_vector_size( index_map );
     int element_size = ecl_util_get_sizeof_ctype(ecl_type);
 
     if(ecl_type == ECL_CHAR_TYPE || ecl_type == ECL_MESS_TYPE) {
         element_size = ECL_STRING8_LENGTH;
     }
 
+    if (num_elm == 0)
+      return;
+
+    {
+      ecl_kw_gather_elm_type * elm_list = util_malloc( num_elm * sizeof * elm_list );
+      char * stage = NULL;
+      bool sorted = true;
+      int index;
 
-    for(index = 0; index < int_vector_size(index_map); index++) {
+      for (index = 0; index < num_elm; index++) {
         int element_index = int_vector_iget(index_map, index);
 
         if(element_index < 0 || element_index >= element_count) {
             util_abort("%s: Element index is out of range 0 <= %d < %d\n", __func__, element_index, element_count);
         }
-        fortio_data_fseek(fortio, data_offset, element_index, element_size, element_count, block_size);
-        util_fread(&buffer[index * element_size], element_size, 1, stream, __func__);
+        elm_list[index].element_index = element_index;
+        elm_list[index].target_index  = index;
+        if (index > 0 && element_index < elm_list[index - 1].element_index)
+          sorted = false;
+      }
+      if (!sorted)
+        qsort( elm_list , num_elm , sizeof * elm_list , ecl_kw_gather_elm_cmp );
+
+      index = 0;
+      while (index < num_elm) {
+        const int         run_start  = index;
+        const offset_type run_offset = ecl_kw_gather_offset( data_offset , elm_list[index].element_index , element_size , block_size );
+        offset_type       run_end    = run_offset + element_size;
+
+        index++;
+        while (index < num_elm) {
+          offset_type elm_offset = ecl_kw_gather_offset( data_offset , elm_list[index].element_index , element_size , block_size );
+          if (elm_offset - run_end > ECL_KW_GATHER_MAX_GAP)
+            break;
+
+          if (elm_offset + element_size - run_offset > ECL_KW_GATHER_MAX_RUN)
+            break;
+
+          if (elm_offset + element_size > run_end)
+            run_end = elm_offset + element_size;
+          index++;
+        }
+
+        {
+          const char * run_data = ecl_kw_gather_read_run( fortio , run_offset , run_end - run_offset , &stage );
+          int i;
+          for (i = run_start; i < index; i++) {
+            const ecl_kw_gather_elm_type * elm = &elm_list[i];
+            offset_type elm_offset = ecl_kw_gather_offset( data_offset , elm->element_index , element_size , block_size );
+            memcpy( &buffer[elm->target_index * element_size] , &run_data[elm_offset - run_offset] , element_size );
+          }
+        }
+      }
+
+      free( stage );
+      free( elm_list );
     }
 
-    if (ECL_ENDIAN_FLIP) {
-        util_endian_flip_vector(buffer, element_size, int_vector_size(index_map));
+    if (ECL_ENDIAN_FLIP && ecl_type != ECL_CHAR_TYPE && ecl_type != ECL_MESS_TYPE) {
+        util_endian_flip_vector(buffer, element_size, num_elm);
     }
 }
 
@@ -1519,6 +2061,249 @@ ecl_kw_type *ecl_kw_fread_alloc(fortio_type *fortio) {
 
 
 
+/*****************************************************************/
+/*
+  Functions to instantiate keywords from a memory image of a binary
+  file, typically a file which has been mapped with fortio_mmap().
+*/
+
+static int ecl_kw_mmap_marker( const char * ptr ) {
+  int marker;
+  memcpy( &marker , ptr , sizeof marker );
+  if (ECL_ENDIAN_FLIP)
+    util_endian_flip_vector( &marker , sizeof marker , 1 );
+  return marker;
+}
+
+
+static bool ecl_kw_mmap_record_ok( const char * record_ptr , int record_size , offset_type avail ) {
+  if (avail < (offset_type) record_size + 8)
+    return false;
+
+  if (ecl_kw_mmap_marker( record_ptr ) != record_size)
+    return false;
+
+  if (ecl_kw_mmap_marker( &record_ptr[ 4 + record_size ] ) != record_size)
+    return false;
+
+  return true;
+}
+
+
+static bool ecl_kw_init_mmap_data( ecl_kw_type * ecl_kw , char * data_ptr , offset_type avail , bool share) {
+  const bool string_type = (ecl_kw->ecl_type == ECL_CHAR_TYPE || ecl_kw->ecl_type == ECL_MESS_TYPE);
+  const size_t byte_size = (size_t) ecl_kw->size * ecl_kw->sizeof_ctype;
+
+  if (ecl_kw->size == 0)
+    return true;
+
+  /*
+     Zero copy: the data is contained in one record, with native
+     endianness and suitable alignment; the keyword can use the
+     memory directly. Otherwise - in particular for the big endian
+     ECLIPSE files on little endian hosts - the data is copied and
+     byte swapped here, when the keyword is loaded.
+  */
+  if (share && !string_type && !ECL_ENDIAN_FLIP) {
+    char * first_elm = &data_ptr[4];
+    if ((((size_t) first_elm) % ecl_kw->sizeof_ctype) == 0) {
+      if (ecl_kw_mmap_record_ok( data_ptr , byte_size , avail )) {
+        ecl_kw_set_shared_ref( ecl_kw , first_elm );
+        return true;
+      }
+    }
+  }
+
+  ecl_kw_alloc_data( ecl_kw );
+  {
+    offset_type pos = 0;
+
+    if (string_type) {
+      /* The string data must be \0 terminated element by element; i.e. no continous mapping. */
+      const int blocksize  = get_blocksize( ecl_kw->ecl_type );
+      const int num_blocks = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+      int ib;
+      for (ib = 0; ib < num_blocks; ib++) {
+        int read_elm    = util_int_min((ib + 1) * blocksize , ecl_kw->size) - ib * blocksize;
+        int record_size = read_elm * ECL_STRING8_LENGTH;
+        int ir;
+
+        if (!ecl_kw_mmap_record_ok( &data_ptr[pos] , record_size , avail - pos ))
+          return false;
+
+        for (ir = 0; ir < read_elm; ir++) {
+          char * target = &ecl_kw->data[(ib * blocksize + ir) * ecl_kw->sizeof_ctype];
+          memcpy( target , &data_ptr[ pos + 4 + ir * ECL_STRING8_LENGTH ] , ECL_STRING8_LENGTH );
+          target[ ECL_STRING8_LENGTH ] = '\0';
+        }
+        pos += record_size + 8;
+      }
+    } else {
+      /* Record by record - like fortio_fread_buffer(). */
+      size_t bytes_copied = 0;
+      while (bytes_copied < byte_size) {
+        int record_size;
+
+        if (avail - pos < 4)
+          return false;
+
+        record_size = ecl_kw_mmap_marker( &data_ptr[pos] );
+        if ((record_size < 0) || ((size_t) record_size > byte_size - bytes_copied))
+          return false;
+
+        if (!ecl_kw_mmap_record_ok( &data_ptr[pos] , record_size , avail - pos ))
+          return false;
+
+        {
+          char * target = &ecl_kw->data[ bytes_copied ];
+          if (ECL_ENDIAN_FLIP)
+            util_endian_flip_vector_copy( target , &data_ptr[ pos + 4 ] , ecl_kw->sizeof_ctype , record_size / ecl_kw->sizeof_ctype );
+          else
+            memcpy( target , &data_ptr[ pos + 4 ] , record_size );
+        }
+        bytes_copied += record_size;
+        pos += record_size + 8;
+      }
+    }
+  }
+  return true;
+}
+
+
+static ecl_kw_type * ecl_kw_alloc_mmap__( char * kw_ptr , offset_type avail , bool share) {
+  const int header_data_size   = ECL_KW_HEADER_DATA_SIZE;
+  const int header_fortio_size = ECL_KW_HEADER_FORTIO_SIZE;
+
+  if (!ecl_kw_mmap_record_ok( kw_ptr , header_data_size , avail ))
+    return NULL;
+
+  {
+    char header[ECL_STRING8_LENGTH + 1];
+    char ecl_type_str[ECL_TYPE_LENGTH + 1];
+    ecl_type_enum ecl_type;
+    int size;
+
+    memcpy( header , &kw_ptr[4] , ECL_STRING8_LENGTH );
+    header[ECL_STRING8_LENGTH] = '\0';
+
+    size = ecl_kw_mmap_marker( &kw_ptr[4 + ECL_STRING8_LENGTH] );
+
+    memcpy( ecl_type_str , &kw_ptr[4 + ECL_STRING8_LENGTH + sizeof size] , ECL_TYPE_LENGTH );
+    ecl_type_str[ECL_TYPE_LENGTH] = '\0';
+
+    ecl_type = ecl_util_get_type_from_name( ecl_type_str );
+    if ((ecl_type == ECL_C010_TYPE) || (size < 0))
+      return NULL;
+
+    {
+      ecl_kw_type * ecl_kw = ecl_kw_alloc_empty();
+      ecl_kw_initialize( ecl_kw , header , size , ecl_type );
+      if (!ecl_kw_init_mmap_data( ecl_kw , &kw_ptr[ header_fortio_size ] , avail - header_fortio_size , share)) {
+        ecl_kw_free( ecl_kw );
+        ecl_kw = NULL;
+      }
+      return ecl_kw;
+    }
+  }
+}
+
+
+/**
+   Will instantiate a new ecl_kw instance from the memory image of a
+   binary keyword; @kw_ptr should point to the start of the keyword
+   header and @avail is the number of bytes available from @kw_ptr.
+
+   When the keyword is numeric, stored in one fortran record, properly
+   aligned and no endian flipping is required, the new keyword will
+   use the memory at @kw_ptr as shared storage - i.e. no copying is
+   involved and the memory must outlive the keyword. In all other
+   cases the data is copied (and endian flipped) into private storage
+   owned by the keyword.
+
+   Will return NULL if the memory does not contain a complete and
+   consistent keyword.
+*/
+
+ecl_kw_type * ecl_kw_alloc_mmap( char * kw_ptr , offset_type avail ) {
+  return ecl_kw_alloc_mmap__( kw_ptr , avail , true );
+}
+
+
+/**
+   Like ecl_kw_alloc_mmap(), but the data is always copied into private
+   storage, i.e. the memory at @kw_ptr can be released as soon as the
+   function returns.
+*/
+
+ecl_kw_type * ecl_kw_alloc_memory_copy( const char * kw_ptr , offset_type avail ) {
+  return ecl_kw_alloc_mmap__( (char *) kw_ptr , avail , false );
+}
+
+
+static char * ecl_kw_write_memory_marker( char * ptr , int record_size ) {
+  int marker = record_size;
+  if (ECL_ENDIAN_FLIP)
+    util_endian_flip_vector( &marker , sizeof marker , 1 );
+  memcpy( ptr , &marker , sizeof marker );
+  return ptr + sizeof marker;
+}
+
+
+/**
+   Will write the keyword to @buffer exactly as it would be written to
+   an unformatted file by ecl_kw_fwrite(), i.e. the header record
+   followed by the data records. The buffer must have room for
+   ecl_kw_fortio_size() bytes. This is the inverse of
+   ecl_kw_alloc_memory_copy().
+*/
+
+void ecl_kw_write_memory_image( const ecl_kw_type * ecl_kw , char * buffer ) {
+  const int blocksize  = get_blocksize( ecl_kw->ecl_type );
+  const int num_blocks = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+  const bool string_type = (ecl_kw->ecl_type == ECL_CHAR_TYPE || ecl_kw->ecl_type == ECL_MESS_TYPE);
+  char * ptr = buffer;
+  int block_nr;
+
+  ptr = ecl_kw_write_memory_marker( ptr , ECL_KW_HEADER_DATA_SIZE );
+  memcpy( ptr , ecl_kw->header8 , ECL_STRING8_LENGTH );
+  ptr += ECL_STRING8_LENGTH;
+  {
+    int size = ecl_kw->size;
+    if (ECL_ENDIAN_FLIP)
+      util_endian_flip_vector( &size , sizeof size , 1 );
+    memcpy( ptr , &size , sizeof size );
+    ptr += sizeof size;
+  }
+  memcpy( ptr , ecl_util_get_type_name( ecl_kw->ecl_type ) , ECL_TYPE_LENGTH );
+  ptr += ECL_TYPE_LENGTH;
+  ptr = ecl_kw_write_memory_marker( ptr , ECL_KW_HEADER_DATA_SIZE );
+
+  for (block_nr = 0; block_nr < num_blocks; block_nr++) {
+    int this_blocksize = util_int_min((block_nr + 1)*blocksize , ecl_kw->size) - block_nr*blocksize;
+    const char * block_data = &ecl_kw->data[block_nr * blocksize * ecl_kw->sizeof_ctype];
+    int record_size;
+
+    if (string_type) {
+      int i;
+      record_size = this_blocksize * ECL_STRING8_LENGTH;
+      ptr = ecl_kw_write_memory_marker( ptr , record_size );
+      for (i = 0; i < this_blocksize; i++)
+        memcpy( &ptr[i * ECL_STRING8_LENGTH] , &block_data[i * ecl_kw->sizeof_ctype] , ECL_STRING8_LENGTH );
+    } else {
+      record_size = this_blocksize * ecl_kw->sizeof_ctype;
+      ptr = ecl_kw_write_memory_marker( ptr , record_size );
+      if (ECL_ENDIAN_FLIP)
+        util_endian_flip_vector_copy( ptr , block_data , ecl_kw->sizeof_ctype , this_blocksize );
+      else
+        memcpy( ptr , block_data , record_size );
+    }
+    ptr += record_size;
+    ptr = ecl_kw_write_memory_marker( ptr , record_size );
+  }
+}
+
+
+
 void ecl_kw_fskip(fortio_type *fortio) {
   ecl_kw_type *tmp_kw;
   tmp_kw = ecl_kw_fread_alloc(fortio );
@@ -1528,39 +2313,51 @@ void ecl_kw_fskip(fortio_type *fortio) {
 
 
 
-static void ecl_kw_fwrite_data_unformatted( ecl_kw_type * ecl_kw , fortio_type * fortio ) {
-  if (ECL_ENDIAN_FLIP)
-    ecl_kw_endian_convert_data(ecl_kw);
+/*
+  The binary data is written through a staging buffer with room for
+  one block; the keyword itself is never modified. This way the same
+  keyword can be written to several fortio instances concurrently,
+  and it is also safe to write keywords which reference read-only
+  memory, e.g. a memory mapped file.
+
+  For numerical types the staging buffer is only used when the data
+  must be endian flipped; for the string types the staging buffer is
+  used to strip off the terminating \0 characters, so that each
+  block can be written as one record.
+*/
 
-  {
-    const int blocksize  = get_blocksize( ecl_kw->ecl_type );
-    const int num_blocks = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
-    int block_nr;
+static void ecl_kw_fwrite_data_unformatted( const ecl_kw_type * ecl_kw , fortio_type * fortio ) {
+  const int blocksize  = get_blocksize( ecl_kw->ecl_type );
+  const int num_blocks = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+  const bool string_type = (ecl_kw->ecl_type == ECL_CHAR_TYPE || ecl_kw->ecl_type == ECL_MESS_TYPE);
+  char * buffer = NULL;
+  int block_nr;
 
-    for (block_nr = 0; block_nr < num_blocks; block_nr++) {
-      int this_blocksize = util_int_min((block_nr + 1)*blocksize , ecl_kw->size) - block_nr*blocksize;
-      if (ecl_kw->ecl_type == ECL_CHAR_TYPE || ecl_kw->ecl_type == ECL_MESS_TYPE) {
-        /*
-           Due to the terminating \0 characters there is not a
-           continous file/memory mapping - the \0 characters arel
-           skipped.
-        */
-        FILE *stream      = fortio_get_FILE(fortio);
-        int   record_size = this_blocksize * ECL_STRING8_LENGTH;     /* The total size in bytes of the record written by the fortio layer. */
-        int   i;
-        fortio_init_write(fortio , record_size );
-        for (i = 0; i < this_blocksize; i++)
-          fwrite(&ecl_kw->data[(block_nr * blocksize + i) * ecl_kw->sizeof_ctype] , 1 , ECL_STRING8_LENGTH , stream);
-        fortio_complete_write(fortio , record_size);
-      } else {
-        int   record_size = this_blocksize * ecl_kw->sizeof_ctype;  /* The total size in bytes of the record written by the fortio layer. */
-        fortio_fwrite_record(fortio , &ecl_kw->data[block_nr * blocksize * ecl_kw->sizeof_ctype] , record_size);
-      }
+  if (string_type)
+    buffer = util_malloc( blocksize * ECL_STRING8_LENGTH );
+  else if (ECL_ENDIAN_FLIP)
+    buffer = util_malloc( blocksize * ecl_kw->sizeof_ctype );
+
+  for (block_nr = 0; block_nr < num_blocks; block_nr++) {
+    int this_blocksize = util_int_min((block_nr + 1)*blocksize , ecl_kw->size) - block_nr*blocksize;
+    const char * block_data = &ecl_kw->data[block_nr * blocksize * ecl_kw->sizeof_ctype];
+
+    if (string_type) {
+      int i;
+      for (i = 0; i < this_blocksize; i++)
+        memcpy( &buffer[i * ECL_STRING8_LENGTH] , &block_data[i * ecl_kw->sizeof_ctype] , ECL_STRING8_LENGTH );
+      fortio_fwrite_record(fortio , buffer , this_blocksize * ECL_STRING8_LENGTH);
+    } else {
+      int record_size = this_blocksize * ecl_kw->sizeof_ctype;  /* The total size in bytes of the record written by the fortio layer. */
+      if (ECL_ENDIAN_FLIP) {
+        util_endian_flip_vector_copy( buffer , block_data , ecl_kw->sizeof_ctype , this_blocksize );
+        fortio_fwrite_record(fortio , buffer , record_size);
+      } else
+        fortio_fwrite_record(fortio , block_data , record_size);
     }
   }
 
-  if (ECL_ENDIAN_FLIP)
-    ecl_kw_endian_convert_data(ecl_kw);
+  free( buffer );
 }
 
 
@@ -1579,97 +2376,314 @@ static void ecl_kw_fwrite_data_unformatted( ecl_kw_type * ecl_kw , fortio_type *
         1. To force the radix part to start with 0.
         2. To use 'D' as the exponent start for double values.
 
-     If you are more proficient with C fprintf() format strings than I
-     am, the __fprintf_scientific() function should be removed, and
-     the WRITE_FMT_DOUBLE and WRITE_FMT_FLOAT format specifiers
-     updated accordingly.
+     The function is only used as a fallback for the values which are
+     not handled by the fast path in ecl_kw_fmt_render_scientific();
+     the formatting of this function is the definition of the
+     formatted output.
   */
 
-   static void __fprintf_scientific(FILE * stream, const char * fmt , double x) {
-    double pow_x = ceil(log10(fabs(x)));
-    double arg_x   = x / pow(10.0 , pow_x);
-    if (x != 0.0) {
-      if (fabs(arg_x) == 1.0) {
-        arg_x *= 0.10;
-        pow_x += 1;
-      }
-    } else {
-      arg_x = 0.0;
-      pow_x = 0.0;
+static char * __sprintf_scientific(char * p , const char * fmt , double x) {
+  double pow_x = ceil(log10(fabs(x)));
+  double arg_x   = x / pow(10.0 , pow_x);
+  if (x != 0.0) {
+    if (fabs(arg_x) == 1.0) {
+      arg_x *= 0.10;
+      pow_x += 1;
     }
-    fprintf(stream , fmt , arg_x , (int) pow_x);
+  } else {
+    arg_x = 0.0;
+    pow_x = 0.0;
   }
+  return p + sprintf(p , fmt , arg_x , (int) pow_x);
+}
 
 
-static void ecl_kw_fwrite_data_formatted( ecl_kw_type * ecl_kw , fortio_type * fortio ) {
+/*
+  The formatted output is rendered into a memory buffer, and written
+  to the stream with one fwrite() call for each block. The float and
+  double values are formatted without calling log10(), pow() and
+  fprintf() for every element; the output is byte identical to
+  __sprintf_scientific():
+
+    1. The decimal exponent ceil(log10(|x|)) is found by comparing
+       with a cache of the powers of ten, i.e. pow(10.0 , k) for the
+       exponents k encountered in the current keyword. If |x| is
+       very close to a power of ten, where the rounding of log10()
+       matters, or outside the range of the cache, the value is
+       formatted with __sprintf_scientific().
+
+    2. The mantissa x / pow(10.0 , k) is then computed as in
+       __sprintf_scientific(), and the digits are generated from the
+       exact binary value of the mantissa with integer arithmetic,
+       with the same round-half-even rule as printf().
+*/
+
+#define ECL_KW_FMT_POW10_MAX      300
+#define ECL_KW_FMT_FAST_MAX_EXP   290
+#define ECL_KW_FMT_POW10_MARGIN   1e-12
+#define ECL_KW_FMT_MAX_ELM_WIDTH  32
+
+typedef struct {
+  double value[2 * ECL_KW_FMT_POW10_MAX + 1];
+  bool   valid[2 * ECL_KW_FMT_POW10_MAX + 1];
+} ecl_kw_fmt_pow10_type;
+
+
+static double ecl_kw_fmt_cache_pow10( ecl_kw_fmt_pow10_type * pow10_cache , int k) {
+  int index = k + ECL_KW_FMT_POW10_MAX;
+  if (!pow10_cache->valid[index]) {
+    pow10_cache->value[index] = pow(10.0 , k);
+    pow10_cache->valid[index] = true;
+  }
+  return pow10_cache->value[index];
+}
+
+
+static char * ecl_kw_fmt_render_exponent( char * p , int exponent ) {
+  if (exponent < 0) {
+    *p++ = '-';
+    exponent = -exponent;
+  } else
+    *p++ = '+';
+
+  if (exponent >= 100) {
+    *p++ = '0' + exponent / 100;
+    exponent %= 100;
+  }
+  *p++ = '0' + exponent / 10;
+  *p++ = '0' + exponent % 10;
+  return p;
+}
+
+
+/*
+  Renders the number x, which must satisfy 0 < |x| < 1, as
+  [-]0.ddd with @decimals digits, right aligned in a field of @width
+  characters; i.e. the same as sprintf(p , "%<width>.<decimals>f" ,
+  x). Returns NULL if the value can not be handled.
+*/
+
+static char * ecl_kw_fmt_render_fraction( char * p , double x , int decimals , int width) {
+  static const uint64_t pow5_table[]  = {1 , 5 , 25 , 125 , 625 , 3125 , 15625 , 78125 , 390625 , 1953125 , 9765625 ,
+                                   48828125 , 244140625 , 1220703125 , UINT64_C(6103515625)};
+  static const uint64_t pow10_table[] = {1 , 10 , 100 , 1000 , 10000 , 100000 , 1000000 , 10000000 , 100000000 ,
+                                   1000000000 , UINT64_C(10000000000) , UINT64_C(100000000000) ,
+                                   UINT64_C(1000000000000) , UINT64_C(10000000000000) ,
+                                   UINT64_C(100000000000000)};
+  int      exp2;
+  double   mantissa = frexp( fabs(x) , &exp2 );
+  uint64_t M        = (uint64_t) ldexp( mantissa , 53 );   /* |x| = M * 2^(exp2 - 53) exactly. */
+  int      shift    = 53 - exp2 - decimals;                /* |x| * 10^decimals = M * 5^decimals / 2^shift */
+  uint64_t q;
+
+  if (shift < 27 || shift > 62)
+    return NULL;
 
   {
+    const uint64_t c    = pow5_table[ decimals ];
+    const uint64_t mask = (UINT64_C(1) << 26) - 1;
+    uint64_t hi_part    = (M >> 26) * c;                   /* M * c = hi_part * 2^26 + lo_part */
+    uint64_t lo_part    = (M & mask) * c;
+    uint64_t sum        = hi_part + (lo_part >> 26);       /* M * c = sum * 2^26 + (lo_part & mask) */
+    int      t          = shift - 26;
+    uint64_t rem        = ((sum & ((UINT64_C(1) << t) - 1)) << 26) | (lo_part & mask);
+    uint64_t half       = UINT64_C(1) << (shift - 1);
+
+    q = sum >> t;
+    if (rem > half || (rem == half && (q & 1)))
+      q++;
+  }
 
-    FILE * stream           = fortio_get_FILE( fortio );
-    const int blocksize     = get_blocksize( ecl_kw->ecl_type );
-    const  int columns      = get_columns( ecl_kw->ecl_type );
-    const  char * write_fmt = ecl_kw_get_write_fmt( ecl_kw->ecl_type );
-    const int num_blocks    = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
-    int block_nr;
-
-    for (block_nr = 0; block_nr < num_blocks; block_nr++) {
-      int this_blocksize = util_int_min((block_nr + 1)*blocksize , ecl_kw->size) - block_nr*blocksize;
-      int num_lines      = this_blocksize / columns + ( this_blocksize % columns == 0 ? 0 : 1);
-      int line_nr;
-      for (line_nr = 0; line_nr < num_lines; line_nr++) {
-        int num_columns = util_int_min( (line_nr + 1)*columns , this_blocksize) - columns * line_nr;
-        int col_nr;
-        for (col_nr =0; col_nr < num_columns; col_nr++) {
-          int data_index  = block_nr * blocksize + line_nr * columns + col_nr;
-          void * data_ptr = ecl_kw_iget_ptr_static( ecl_kw , data_index );
-          switch (ecl_kw->ecl_type) {
-          case(ECL_CHAR_TYPE):
-            fprintf(stream , write_fmt , data_ptr);
-            break;
-          case(ECL_C010_TYPE):
-            fprintf(stream , write_fmt , data_ptr);
-            break;
-          case(ECL_INT_TYPE):
-            {
-              int int_value = ((int *) data_ptr)[0];
-              fprintf(stream , write_fmt , int_value);
-            }
-            break;
-          case(ECL_BOOL_TYPE):
-            {
-              bool bool_value = ((bool *) data_ptr)[0];
-              if (bool_value)
-                fprintf(stream , write_fmt , BOOL_TRUE_CHAR);
-              else
-                fprintf(stream , write_fmt , BOOL_FALSE_CHAR);
-            }
-            break;
-          case(ECL_FLOAT_TYPE):
-            {
-              float float_value = ((float *) data_ptr)[0];
-              __fprintf_scientific( stream , write_fmt , float_value );
-            }
-            break;
-          case(ECL_DOUBLE_TYPE):
-            {
-              double double_value = ((double *) data_ptr)[0];
-              __fprintf_scientific( stream , write_fmt , double_value );
-            }
-            break;
-          case(ECL_MESS_TYPE):
-            util_abort("%s: internal fuckup : message type keywords should NOT have data ??\n",__func__);
-            break;
+  {
+    char digits[24];
+    int  length = 0;
+    int  i;
+
+    digits[length++] = (q >= pow10_table[decimals]) ? '1' : '0';
+    if (q >= pow10_table[decimals])
+      q -= pow10_table[decimals];
+
+    digits[length++] = '.';
+    for (i = decimals - 1; i >= 0; i--) {
+      digits[length + i] = '0' + q % 10;
+      q /= 10;
+    }
+    length += decimals;
+
+    for (i = length + (x < 0 ? 1 : 0); i < width; i++)
+      *p++ = ' ';
+
+    if (x < 0)
+      *p++ = '-';
+
+    memcpy( p , digits , length );
+    return p + length;
+  }
+}
+
+
+static char * ecl_kw_fmt_render_scientific( char * p , double x , ecl_kw_fmt_pow10_type * pow10_cache , const char * fmt , int decimals , int width , char exp_char) {
+  double abs_x = fabs(x);
+  if (x == 0.0) {
+    int i;
+    *p++ = ' ';
+    *p++ = ' ';
+    for (i = decimals + 2; i < width; i++)
+      *p++ = ' ';
+    *p++ = '0';
+    *p++ = '.';
+    for (i = 0; i < decimals; i++)
+      *p++ = '0';
+    *p++ = exp_char;
+    return ecl_kw_fmt_render_exponent( p , 0 );
+  }
+
+  if (!(abs_x > 1e-290 && abs_x < 1e290))
+    return __sprintf_scientific( p , fmt , x );
+
+  {
+    int exp2;
+    int k;
+
+    frexp( abs_x , &exp2 );
+    k = (int) floor( (exp2 - 1) * 0.30102999566398120 );   /* 10^k <= 2^(exp2 - 1) <= |x| */
+    while (abs_x > ecl_kw_fmt_cache_pow10( pow10_cache , k ))
+      k++;
+    while (abs_x <= ecl_kw_fmt_cache_pow10( pow10_cache , k - 1))
+      k--;
+
+    /* Now pow(10 , k - 1) < |x| <= pow(10 , k) */
+    if ((abs_x <= ecl_kw_fmt_cache_pow10( pow10_cache , k - 1) * (1 + ECL_KW_FMT_POW10_MARGIN)) ||
+        (abs_x >= ecl_kw_fmt_cache_pow10( pow10_cache , k ) * (1 - ECL_KW_FMT_POW10_MARGIN)))
+      return __sprintf_scientific( p , fmt , x );
+
+    {
+      char * end = ecl_kw_fmt_render_fraction( p + 2 , x / ecl_kw_fmt_cache_pow10( pow10_cache , k ) , decimals , width );
+      if (end == NULL)
+        return __sprintf_scientific( p , fmt , x );
+
+      p[0] = ' ';
+      p[1] = ' ';
+      *end++ = exp_char;
+      return ecl_kw_fmt_render_exponent( end , k );
+    }
+  }
+}
+
+
+static char * ecl_kw_fmt_render_int( char * p , int value ) {
+  char digits[12];
+  int  num_digits = 0;
+  unsigned int u = (value < 0) ? 0u - (unsigned int) value : (unsigned int) value;
+
+  do {
+    digits[num_digits++] = '0' + u % 10;
+    u /= 10;
+  } while (u > 0);
+
+  if (value < 0)
+    digits[num_digits++] = '-';
+
+  {
+    int i;
+    *p++ = ' ';
+    for (i = num_digits; i < 11; i++)
+      *p++ = ' ';
+
+    while (num_digits > 0)
+      *p++ = digits[--num_digits];
+  }
+  return p;
+}
+
+
+static char * ecl_kw_fmt_render_string( char * p , const char * s , int width) {
+  int length = strlen( s );
+  int i;
+
+  *p++ = ' ';
+  *p++ = '\'';
+  memcpy( p , s , length );
+  p += length;
+  for (i = length; i < width; i++)
+    *p++ = ' ';
+  *p++ = '\'';
+  return p;
+}
+
+
+static void ecl_kw_fwrite_data_formatted( const ecl_kw_type * ecl_kw , fortio_type * fortio ) {
+  FILE * stream           = fortio_get_FILE( fortio );
+  const int blocksize     = get_blocksize( ecl_kw->ecl_type );
+  const  int columns      = get_columns( ecl_kw->ecl_type );
+  const  char * write_fmt = ecl_kw_get_write_fmt( ecl_kw->ecl_type );
+  const int num_blocks    = ecl_kw->size / blocksize + (ecl_kw->size % blocksize == 0 ? 0 : 1);
+  char * buffer           = util_malloc( blocksize * (ECL_KW_FMT_MAX_ELM_WIDTH + 1) + 1 );
+  ecl_kw_fmt_pow10_type * pow10_cache = NULL;
+  int block_nr;
+
+  if (ecl_kw->ecl_type == ECL_FLOAT_TYPE || ecl_kw->ecl_type == ECL_DOUBLE_TYPE)
+    pow10_cache = util_malloc( sizeof * pow10_cache );
+  if (pow10_cache)
+    memset( pow10_cache->valid , 0 , sizeof pow10_cache->valid );
+
+  for (block_nr = 0; block_nr < num_blocks; block_nr++) {
+    int this_blocksize = util_int_min((block_nr + 1)*blocksize , ecl_kw->size) - block_nr*blocksize;
+    int num_lines      = this_blocksize / columns + ( this_blocksize % columns == 0 ? 0 : 1);
+    char * p           = buffer;
+    int line_nr;
+    for (line_nr = 0; line_nr < num_lines; line_nr++) {
+      int num_columns = util_int_min( (line_nr + 1)*columns , this_blocksize) - columns * line_nr;
+      int col_nr;
+      for (col_nr =0; col_nr < num_columns; col_nr++) {
+        int data_index  = block_nr * blocksize + line_nr * columns + col_nr;
+        void * data_ptr = ecl_kw_iget_ptr_static( ecl_kw , data_index );
+        switch (ecl_kw->ecl_type) {
+        case(ECL_CHAR_TYPE):
+          p = ecl_kw_fmt_render_string( p , data_ptr , ECL_STRING8_LENGTH );
+          break;
+        case(ECL_C010_TYPE):
+          p = ecl_kw_fmt_render_string( p , data_ptr , ECL_STRING10_LENGTH );
+          break;
+        case(ECL_INT_TYPE):
+          p = ecl_kw_fmt_render_int( p , ((int *) data_ptr)[0] );
+          break;
+        case(ECL_BOOL_TYPE):
+          {
+            bool bool_value = ((bool *) data_ptr)[0];
+            *p++ = ' ';
+            *p++ = ' ';
+            *p++ = bool_value ? BOOL_TRUE_CHAR : BOOL_FALSE_CHAR;
           }
+          break;
+        case(ECL_FLOAT_TYPE):
+          {
+            float float_value = ((float *) data_ptr)[0];
+            p = ecl_kw_fmt_render_scientific( p , float_value , pow10_cache , write_fmt , 8 , 11 , 'E' );
+          }
+          break;
+        case(ECL_DOUBLE_TYPE):
+          {
+            double double_value = ((double *) data_ptr)[0];
+            p = ecl_kw_fmt_render_scientific( p , double_value , pow10_cache , write_fmt , 14 , 17 , 'D' );
+          }
+          break;
+        case(ECL_MESS_TYPE):
+          util_abort("%s: internal fuckup : message type keywords should NOT have data ??\n",__func__);
+          break;
         }
-        fprintf(stream , "\n");
       }
+      *p++ = '\n';
     }
+    fwrite( buffer , 1 , p - buffer , stream );
   }
+
+  free( pow10_cache );
+  free( buffer );
 }
 
 
-void ecl_kw_fwrite_data(const ecl_kw_type *_ecl_kw , fortio_type *fortio) {
-  ecl_kw_type *ecl_kw = (ecl_kw_type *) _ecl_kw;
+void ecl_kw_fwrite_data(const ecl_kw_type *ecl_kw , fortio_type *fortio) {
   bool  fmt_file      = fortio_fmt_file( fortio );
 
   if (fmt_file)
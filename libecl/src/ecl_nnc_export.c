@@ -16,7 +16,10 @@
    for more detals.
 */
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
+#include <ert/util/util.h>
 #include <ert/util/int_vector.h>
 
 #include <ert/ecl/ecl_file.h>
@@ -33,52 +36,84 @@ int ecl_nnc_export_get_size( const ecl_grid_type * grid ) {
 
 
 
-static int  ecl_nnc_export__( const ecl_grid_type * grid , int lgr_index1 , const ecl_file_type * init_file , ecl_nnc_type * nnc_data, int * nnc_offset) {
-  int nnc_index = *nnc_offset;
-  int lgr_nr1 = ecl_grid_get_lgr_nr( grid );
-  int global_index1;
-  int valid_trans = 0 ;
+/*
+  The nnc of one grid are exported in parallel; the transmissibility
+  keywords are looked up once for each lgr the grid is connected to
+  before the cells are visited, and every cell writes its connections
+  to the slots given by the nnc rows of the grid.
+*/
+
+static int  ecl_nnc_export__( const ecl_grid_type * grid , const ecl_file_type * init_file , ecl_nnc_type * nnc_data, int * nnc_offset) {
+  const int lgr_nr1 = ecl_grid_get_lgr_nr( grid );
+  const int global_size = ecl_grid_get_global_size( grid );
   const ecl_grid_type * global_grid = ecl_grid_get_global_grid( grid );
+  int * row_offset = util_calloc( global_size + 1 , sizeof * row_offset );
+  int_vector_type * lgr_nr_list = int_vector_alloc( 0 , 0 );
+  const ecl_kw_type ** tran_kw_list;
+  int max_lgr_nr = 0;
+  int valid_trans = 0;
+  int global_index1;
 
   if (!global_grid)
     global_grid = grid;
 
+  row_offset[0] = *nnc_offset;
+  for (global_index1 = 0; global_index1 < global_size; global_index1++) {
+    const int * lgr_nr2;
+    const int * global_index2;
+    const int * nnc_index;
+    int num_nnc = ecl_grid_get_cell_nnc_row( grid , global_index1 , &lgr_nr2 , &global_index2 , &nnc_index );
+    int i;
+
+    for (i = 0; i < num_nnc; i++) {
+      if (int_vector_safe_iget( lgr_nr_list , lgr_nr2[i] ) == 0) {
+        int_vector_iset( lgr_nr_list , lgr_nr2[i] , 1 );
+        max_lgr_nr = util_int_max( max_lgr_nr , lgr_nr2[i] );
+      }
+    }
+    row_offset[global_index1 + 1] = row_offset[global_index1] + num_nnc;
+  }
 
-  for (global_index1 = 0; global_index1 < ecl_grid_get_global_size( grid ); global_index1++) {
-    const nnc_info_type * nnc_info = ecl_grid_get_cell_nnc_info1( grid , global_index1 );
-    if (nnc_info) {
-      int lgr_index2;
-      for (lgr_index2=0; lgr_index2 < nnc_info_get_size( nnc_info ); lgr_index2++) {
-        const nnc_vector_type * nnc_vector = nnc_info_iget_vector( nnc_info , lgr_index2 );
-        const int_vector_type * grid2_index_list = nnc_vector_get_grid_index_list( nnc_vector );
-        const int_vector_type * nnc_index_list = nnc_vector_get_nnc_index_list( nnc_vector );
-        int lgr_nr2 = nnc_vector_get_lgr_nr( nnc_vector );
-        const ecl_kw_type * tran_kw = ecl_nnc_export_get_tranx_kw(global_grid  , init_file , lgr_nr1 , lgr_nr2 );
-
-        int index2;
-        ecl_nnc_type nnc;
-
-        nnc.grid_nr1 = lgr_nr1;
-        nnc.grid_nr2 = lgr_nr2;
-        nnc.global_index1 = global_index1;
-
-        for (index2 = 0; index2 < nnc_vector_get_size( nnc_vector ); index2++) {
-          nnc.global_index2 = int_vector_iget( grid2_index_list , index2 );
-          nnc.input_index = int_vector_iget( nnc_index_list, index2 );
-          if(tran_kw) {
-            nnc.trans = ecl_kw_iget_as_double(tran_kw, nnc.input_index);
-            valid_trans++;
-          }else{
-            nnc.trans = ERT_ECL_DEFAULT_NNC_TRANS;
-          }
+  tran_kw_list = util_calloc( max_lgr_nr + 1 , sizeof * tran_kw_list );
+  {
+    int lgr_nr2;
+    for (lgr_nr2 = 0; lgr_nr2 <= max_lgr_nr; lgr_nr2++) {
+      if (int_vector_safe_iget( lgr_nr_list , lgr_nr2 ) == 1)
+        tran_kw_list[lgr_nr2] = ecl_nnc_export_get_tranx_kw( global_grid , init_file , lgr_nr1 , lgr_nr2 );
+      else
+        tran_kw_list[lgr_nr2] = NULL;
+    }
+  }
 
-          nnc_data[nnc_index] = nnc;
-          nnc_index++;
-        }
-      }
+#pragma omp parallel for reduction(+:valid_trans)
+  for (global_index1 = 0; global_index1 < global_size; global_index1++) {
+    const int * lgr_nr2;
+    const int * global_index2;
+    const int * nnc_index;
+    int num_nnc = ecl_grid_get_cell_nnc_row( grid , global_index1 , &lgr_nr2 , &global_index2 , &nnc_index );
+    int i;
+
+    for (i = 0; i < num_nnc; i++) {
+      const ecl_kw_type * tran_kw = tran_kw_list[ lgr_nr2[i] ];
+      ecl_nnc_type * nnc = &nnc_data[ row_offset[global_index1] + i ];
+
+      nnc->grid_nr1 = lgr_nr1;
+      nnc->grid_nr2 = lgr_nr2[i];
+      nnc->global_index1 = global_index1;
+      nnc->global_index2 = global_index2[i];
+      nnc->input_index = nnc_index[i];
+      if (tran_kw) {
+        nnc->trans = ecl_kw_iget_as_double( tran_kw , nnc->input_index );
+        valid_trans++;
+      } else
+        nnc->trans = ERT_ECL_DEFAULT_NNC_TRANS;
     }
   }
-  *nnc_offset = nnc_index;
+
+  *nnc_offset = row_offset[global_size];
+  free( tran_kw_list );
+  int_vector_free( lgr_nr_list );
+  free( row_offset );
   return valid_trans;
 }
 
@@ -86,15 +121,14 @@ static int  ecl_nnc_export__( const ecl_grid_type * grid , int lgr_index1 , cons
 int  ecl_nnc_export( const ecl_grid_type * grid , const ecl_file_type * init_file , ecl_nnc_type * nnc_data) {
   int nnc_index = 0;
   int total_valid_trans = 0;
-  total_valid_trans = ecl_nnc_export__( grid , 0 , init_file , nnc_data , &nnc_index );
+  total_valid_trans = ecl_nnc_export__( grid , init_file , nnc_data , &nnc_index );
   {
     int lgr_index;
     for (lgr_index = 0; lgr_index < ecl_grid_get_num_lgr(grid); lgr_index++) {
       ecl_grid_type * igrid = ecl_grid_iget_lgr( grid , lgr_index );
-      total_valid_trans += ecl_nnc_export__( igrid , lgr_index , init_file , nnc_data , &nnc_index );
+      total_valid_trans += ecl_nnc_export__( igrid , init_file , nnc_data , &nnc_index );
     }
   }
-  nnc_index = ecl_nnc_export_get_size( grid );
   ecl_nnc_sort( nnc_data , nnc_index );
   return total_valid_trans;
 }
@@ -151,8 +185,129 @@ static int ecl_nnc_sort_cmp__( const void * nnc1 , const void * nnc2) {
 }
 
 
+/*
+  The nnc are sorted with a LSD radix sort when the four fields
+  compared by ecl_nnc_sort_cmp() can be packed in a 64 bit key; that
+  is the case unless the grids are very large. The fields are packed
+  relative to their minimum value, in the same order as they are
+  compared. Short lists, and lists where the key does not fit, are
+  sorted with qsort().
+*/
+
+#define ECL_NNC_RADIX_BITS      11
+#define ECL_NNC_RADIX_MIN_SIZE  256
+
+
+static int ecl_nnc_sort_key_bits( int min_value , int max_value ) {
+  uint64_t range = (uint64_t) ((int64_t) max_value - (int64_t) min_value);
+  int bits = 0;
+  while (range >> bits)
+    bits++;
+  return bits;
+}
+
+
+static void ecl_nnc_sort_fields( const ecl_nnc_type * nnc , int fields[4]) {
+  fields[0] = nnc->grid_nr1;
+  fields[1] = nnc->grid_nr2;
+  fields[2] = nnc->global_index1;
+  fields[3] = nnc->global_index2;
+}
+
+
+static bool ecl_nnc_radix_sort( ecl_nnc_type * nnc_list , int size ) {
+  int min_value[4];
+  int max_value[4];
+  int bits[4];
+  int total_bits = 0;
+  int f , i;
+
+  ecl_nnc_sort_fields( &nnc_list[0] , min_value );
+  ecl_nnc_sort_fields( &nnc_list[0] , max_value );
+  for (i = 1; i < size; i++) {
+    int fields[4];
+    ecl_nnc_sort_fields( &nnc_list[i] , fields );
+    for (f = 0; f < 4; f++) {
+      min_value[f] = util_int_min( min_value[f] , fields[f] );
+      max_value[f] = util_int_max( max_value[f] , fields[f] );
+    }
+  }
+
+  for (f = 0; f < 4; f++) {
+    bits[f] = ecl_nnc_sort_key_bits( min_value[f] , max_value[f] );
+    total_bits += bits[f];
+  }
+
+  if (total_bits > 64)
+    return false;
+
+  {
+    uint64_t * key = util_calloc( size , sizeof * key );
+    uint64_t * tmp_key = util_calloc( size , sizeof * tmp_key );
+    int * index = util_calloc( size , sizeof * index );
+    int * tmp_index = util_calloc( size , sizeof * tmp_index );
+    int shift;
+
+#pragma omp parallel for private(f)
+    for (i = 0; i < size; i++) {
+      int fields[4];
+      uint64_t k = 0;
+      ecl_nnc_sort_fields( &nnc_list[i] , fields );
+      for (f = 0; f < 4; f++) {
+        if (bits[f] > 0)
+          k = (k << bits[f]) | (uint64_t) ((int64_t) fields[f] - (int64_t) min_value[f]);
+      }
+      key[i] = k;
+      index[i] = i;
+    }
+
+    for (shift = 0; shift < total_bits; shift += ECL_NNC_RADIX_BITS) {
+      int count[(1 << ECL_NNC_RADIX_BITS) + 1];
+      const uint64_t mask = (1 << ECL_NNC_RADIX_BITS) - 1;
+
+      memset( count , 0 , sizeof count );
+      for (i = 0; i < size; i++)
+        count[((key[i] >> shift) & mask) + 1]++;
+
+      for (i = 0; i < (1 << ECL_NNC_RADIX_BITS); i++)
+        count[i + 1] += count[i];
+
+      for (i = 0; i < size; i++) {
+        int dst = count[(key[i] >> shift) & mask]++;
+        tmp_key[dst] = key[i];
+        tmp_index[dst] = index[i];
+      }
+
+      {
+        uint64_t * swap_key = key;
+        int * swap_index = index;
+        key = tmp_key;
+        index = tmp_index;
+        tmp_key = swap_key;
+        tmp_index = swap_index;
+      }
+    }
+
+    {
+      ecl_nnc_type * copy = util_alloc_copy( nnc_list , size * sizeof * nnc_list );
+#pragma omp parallel for
+      for (i = 0; i < size; i++)
+        nnc_list[i] = copy[index[i]];
+      free( copy );
+    }
+
+    free( tmp_index );
+    free( index );
+    free( tmp_key );
+    free( key );
+  }
+  return true;
+}
+
+
 void ecl_nnc_sort( ecl_nnc_type * nnc_list , int size) {
-  qsort( nnc_list , size , sizeof * nnc_list , ecl_nnc_sort_cmp__ );
+  if ((size < ECL_NNC_RADIX_MIN_SIZE) || !ecl_nnc_radix_sort( nnc_list , size ))
+    qsort( nnc_list , size , sizeof * nnc_list , ecl_nnc_sort_cmp__ );
 }
 
 
@@ -0,0 +1,532 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_pack.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <ert/util/build_config.h>
+#include <ert/util/ert_api_config.h>
+#include <ert/util/util.h>
+#include <ert/util/buffer.h>
+#include <ert/util/vector.h>
+
+#ifdef ERT_HAVE_THREAD_POOL
+#include <ert/util/thread_pool.h>
+#endif
+
+#ifdef HAVE_PREAD
+#include <unistd.h>
+#endif
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/ecl_pack.h>
+
+/*
+  This file implements a compressed container for the keywords of an
+  ECLIPSE file, typically a unified restart or summary file created by
+  the ecl_pack program. Every keyword is compressed independently with
+  zlib, and a keyword index is stored at the end of the file; a single
+  keyword can therefor be loaded by reading and uncompressing only
+  that keyword. The packed files are opened transparently by
+  ecl_file_open().
+
+  The keywords are stored in the same form as in an unformatted file,
+  i.e. the header record followed by the data records; the offset of
+  a keyword in the keyword index is the offset the keyword would have
+  had in the corresponding unformatted file. The file is written in
+  native byte order, and has the layout:
+
+     ECL_PACK_ID            : int
+     ECL_PACK_VERSION       : int
+     compressed keywords    : ...
+     block index            : num_kw * 4 * int64_t
+     keyword index          : see ecl_file_view_buffer_store()
+     block index offset     : int64_t
+     number of keywords     : int
+     ECL_PACK_ID            : int
+
+  Each element in the block index consists of the offset of the
+  keyword in the unformatted file, the offset of the compressed
+  keyword in the packed file, the compressed size and the uncompressed
+  size.
+
+  The writer compresses the keywords in batches, using a thread pool
+  when available; the compressed keywords are written to the file in
+  the order they were added. Without zlib support the packed files
+  can neither be written nor read.
+*/
+
+#define ECL_PACK_TYPE_ID    771231
+#define ECL_PACK_ID         661993
+#define ECL_PACK_VERSION    1
+
+#define ECL_PACK_HEADER_SIZE  (2 * sizeof(int))
+#define ECL_PACK_TRAILER_SIZE (sizeof(int64_t) + 2 * sizeof(int))
+
+/* The writer starts compressing when this many bytes, or keywords, are waiting. */
+#define ECL_PACK_BATCH_BYTES  (64 * 1024 * 1024)
+#define ECL_PACK_BATCH_SIZE   256
+
+
+typedef struct {
+  int64_t  offset;     /* Offset of the keyword in the unformatted file. */
+  int64_t  zoffset;    /* Offset of the compressed keyword in the packed file. */
+  int64_t  zsize;
+  int64_t  size;
+} ecl_pack_block_type;
+
+
+struct ecl_pack_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  FILE                * stream;
+  int                   num_kw;
+  ecl_pack_block_type * blocks;            /* Sorted on offset. */
+  int64_t               kw_index_offset;
+  int64_t               kw_index_size;
+};
+
+
+typedef struct {
+  int64_t          offset;    /* Offset of the keyword in the unformatted file. */
+  char           * data;      /* The unformatted image of the keyword. */
+  size_t           size;
+  char           * zdata;
+  unsigned long    zsize;
+} ecl_pack_job_type;
+
+
+struct ecl_pack_writer_struct {
+  FILE          * stream;
+  char          * filename;
+  int             num_threads;
+  bool            write_ok;
+  int             num_kw;
+  int64_t         offset;       /* Offset of the next keyword in the unformatted file. */
+  int64_t         zoffset;      /* Offset of the next keyword in the packed file. */
+  buffer_type   * block_index;
+  buffer_type   * kw_index;
+  vector_type   * jobs;
+  size_t          job_bytes;
+};
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_pack , ECL_PACK_TYPE_ID )
+
+
+/*
+  Only checks the first integer of the file; use ecl_pack_open() to
+  actually validate the file.
+*/
+
+bool ecl_pack_is_packed_file( const char * filename ) {
+  bool packed = false;
+  FILE * stream = fopen( filename , "rb");
+  if (stream) {
+    int id;
+    if (fread( &id , sizeof id , 1 , stream ) == 1)
+      packed = (id == ECL_PACK_ID);
+    fclose( stream );
+  }
+  return packed;
+}
+
+
+/*
+  With pread() the function does not use the file position of the
+  stream, and several threads can read from the same packed file.
+*/
+
+static bool ecl_pack_fread_at( FILE * stream , void * target , size_t size , int64_t offset ) {
+#ifdef HAVE_PREAD
+  char * target_ptr = target;
+  size_t bytes_read = 0;
+  int fd = fileno( stream );
+
+  while (bytes_read < size) {
+    ssize_t count = pread( fd , &target_ptr[bytes_read] , size - bytes_read , offset + bytes_read );
+    if (count <= 0)
+      break;
+    bytes_read += count;
+  }
+  return (bytes_read == size);
+#else
+  if (util_fseek( stream , offset , SEEK_SET ) != 0)
+    return false;
+  return (fread( target , 1 , size , stream ) == size);
+#endif
+}
+
+
+static bool ecl_pack_fread_index( ecl_pack_type * pack ) {
+  int64_t file_size;
+  int64_t index_offset;
+  int header[2];
+
+  if (util_fseek( pack->stream , 0 , SEEK_END ) != 0)
+    return false;
+
+  file_size = util_ftell( pack->stream );
+  if (file_size < (int64_t) (ECL_PACK_HEADER_SIZE + ECL_PACK_TRAILER_SIZE))
+    return false;
+
+  if (!ecl_pack_fread_at( pack->stream , header , sizeof header , 0 ))
+    return false;
+
+  if ((header[0] != ECL_PACK_ID) || (header[1] != ECL_PACK_VERSION))
+    return false;
+
+  {
+    char trailer[ECL_PACK_TRAILER_SIZE];
+    int id;
+
+    if (!ecl_pack_fread_at( pack->stream , trailer , sizeof trailer , file_size - ECL_PACK_TRAILER_SIZE ))
+      return false;
+
+    memcpy( &index_offset , trailer , sizeof index_offset );
+    memcpy( &pack->num_kw , &trailer[sizeof index_offset] , sizeof pack->num_kw );
+    memcpy( &id , &trailer[sizeof index_offset + sizeof pack->num_kw] , sizeof id );
+
+    if ((id != ECL_PACK_ID) || (pack->num_kw < 0) || (index_offset < (int64_t) ECL_PACK_HEADER_SIZE))
+      return false;
+  }
+
+  {
+    int64_t block_index_size = (int64_t) pack->num_kw * sizeof * pack->blocks;
+    int64_t index_size = file_size - ECL_PACK_TRAILER_SIZE - index_offset;
+    int ikw;
+
+    if (index_size < block_index_size + (int64_t) sizeof(int))
+      return false;
+
+    pack->blocks = util_calloc( pack->num_kw + 1 , sizeof * pack->blocks );
+    if (!ecl_pack_fread_at( pack->stream , pack->blocks , block_index_size , index_offset ))
+      return false;
+
+    for (ikw = 0; ikw < pack->num_kw; ikw++) {
+      const ecl_pack_block_type * block = &pack->blocks[ikw];
+      if ((block->zoffset < (int64_t) ECL_PACK_HEADER_SIZE) || (block->zsize < 0) || (block->size < 0))
+        return false;
+
+      if (block->zoffset + block->zsize > index_offset)
+        return false;
+
+      if ((ikw > 0) && (block->offset <= pack->blocks[ikw - 1].offset))
+        return false;
+    }
+
+    pack->kw_index_offset = index_offset + block_index_size;
+    pack->kw_index_size   = index_size - block_index_size;
+  }
+  return true;
+}
+
+
+/*
+  Will open the packed file @filename and load the block index;
+  returns NULL if the file can not be opened, is not a valid packed
+  file, or if zlib support is not available.
+*/
+
+ecl_pack_type * ecl_pack_open( const char * filename ) {
+#ifdef ERT_HAVE_ZLIB
+  FILE * stream = fopen( filename , "rb");
+  if (stream) {
+    ecl_pack_type * pack = util_malloc( sizeof * pack );
+    UTIL_TYPE_ID_INIT( pack , ECL_PACK_TYPE_ID );
+    pack->stream = stream;
+    pack->num_kw = 0;
+    pack->blocks = NULL;
+    pack->kw_index_offset = 0;
+    pack->kw_index_size = 0;
+
+    if (ecl_pack_fread_index( pack ))
+      return pack;
+
+    ecl_pack_free( pack );
+  }
+#endif
+  return NULL;
+}
+
+
+void ecl_pack_free( ecl_pack_type * pack ) {
+  fclose( pack->stream );
+  util_safe_free( pack->blocks );
+  free( pack );
+}
+
+
+int ecl_pack_get_size( const ecl_pack_type * pack ) {
+  return pack->num_kw;
+}
+
+
+/*
+  Returns a buffer with the keyword index of the packed file, in the
+  format of ecl_file_view_buffer_store(); i.e. it can be loaded with
+  ecl_file_view_buffer_load(). Returns NULL if the index can not be
+  read.
+*/
+
+buffer_type * ecl_pack_alloc_kw_index( const ecl_pack_type * pack ) {
+  buffer_type * buffer = buffer_alloc( pack->kw_index_size );
+  char * data = util_malloc( pack->kw_index_size );
+
+  if (ecl_pack_fread_at( pack->stream , data , pack->kw_index_size , pack->kw_index_offset )) {
+    buffer_fwrite( buffer , data , 1 , pack->kw_index_size );
+    buffer_fseek( buffer , 0 , SEEK_SET );
+  } else {
+    buffer_free( buffer );
+    buffer = NULL;
+  }
+
+  free( data );
+  return buffer;
+}
+
+
+static int ecl_pack_block_cmp( const void * arg1 , const void * arg2 ) {
+  const int64_t * offset = arg1;
+  const ecl_pack_block_type * block = arg2;
+
+  if (*offset < block->offset)
+    return -1;
+  else if (*offset > block->offset)
+    return 1;
+  else
+    return 0;
+}
+
+
+/*
+  Will load the keyword which is located at @offset in the
+  corresponding unformatted file; only this keyword is read and
+  uncompressed. Returns NULL if there is no keyword at @offset, or if
+  the keyword can not be loaded.
+*/
+
+ecl_kw_type * ecl_pack_alloc_kw( const ecl_pack_type * pack , offset_type offset ) {
+  ecl_kw_type * ecl_kw = NULL;
+#ifdef ERT_HAVE_ZLIB
+  int64_t key = offset;
+  const ecl_pack_block_type * block = bsearch( &key , pack->blocks , pack->num_kw , sizeof * pack->blocks , ecl_pack_block_cmp );
+
+  if (block) {
+    char * zdata = util_malloc( block->zsize + 1 );
+    char * data = util_malloc( block->size + 1 );
+
+    if (ecl_pack_fread_at( pack->stream , zdata , block->zsize , block->zoffset ))
+      if (util_uncompress_buffer( zdata , block->zsize , data , block->size ))
+        ecl_kw = ecl_kw_alloc_memory_copy( data , block->size );
+
+    free( data );
+    free( zdata );
+  }
+#endif
+  return ecl_kw;
+}
+
+
+/*****************************************************************/
+
+#ifdef ERT_HAVE_ZLIB
+
+static void ecl_pack_job_free( ecl_pack_job_type * job ) {
+  util_safe_free( job->data );
+  util_safe_free( job->zdata );
+  free( job );
+}
+
+
+static void ecl_pack_job_free__( void * arg ) {
+  ecl_pack_job_free( (ecl_pack_job_type *) arg );
+}
+
+
+static void * ecl_pack_job_compress__( void * arg ) {
+  ecl_pack_job_type * job = arg;
+
+  job->zsize = job->size + job->size / 1000 + 64;
+  job->zdata = util_malloc( job->zsize );
+  util_compress_buffer( job->data , job->size , job->zdata , &job->zsize );
+
+  free( job->data );
+  job->data = NULL;
+  return NULL;
+}
+
+
+/*
+  Will compress all the waiting keywords, and write them to the file
+  in the order they were added.
+*/
+
+static void ecl_pack_writer_flush( ecl_pack_writer_type * writer ) {
+  int num_jobs = vector_get_size( writer->jobs );
+  bool compressed = false;
+  int i;
+
+#ifdef ERT_HAVE_THREAD_POOL
+  if ((writer->num_threads > 1) && (num_jobs > 1)) {
+    thread_pool_type * tp = thread_pool_alloc( util_int_min( writer->num_threads , num_jobs ) , true );
+    for (i = 0; i < num_jobs; i++)
+      thread_pool_add_job( tp , ecl_pack_job_compress__ , vector_iget( writer->jobs , i ));
+    thread_pool_join( tp );
+    thread_pool_free( tp );
+    compressed = true;
+  }
+#endif
+
+  if (!compressed) {
+    for (i = 0; i < num_jobs; i++)
+      ecl_pack_job_compress__( vector_iget( writer->jobs , i ));
+  }
+
+  for (i = 0; i < num_jobs; i++) {
+    const ecl_pack_job_type * job = vector_iget_const( writer->jobs , i );
+    ecl_pack_block_type block;
+
+    block.offset  = job->offset;
+    block.zoffset = writer->zoffset;
+    block.zsize   = job->zsize;
+    block.size    = job->size;
+    buffer_fwrite( writer->block_index , &block , sizeof block , 1 );
+
+    if (fwrite( job->zdata , 1 , job->zsize , writer->stream ) != job->zsize)
+      writer->write_ok = false;
+    writer->zoffset += job->zsize;
+  }
+
+  vector_clear( writer->jobs );
+  writer->job_bytes = 0;
+}
+
+#endif
+
+
+/*
+  Will create a new packed file @filename; the keywords are compressed
+  with @num_threads threads. Returns NULL if the file can not be
+  created, or if zlib support is not available.
+*/
+
+ecl_pack_writer_type * ecl_pack_writer_alloc( const char * filename , int num_threads ) {
+#ifdef ERT_HAVE_ZLIB
+  FILE * stream = fopen( filename , "wb");
+  if (stream) {
+    ecl_pack_writer_type * writer = util_malloc( sizeof * writer );
+    int header[2] = { ECL_PACK_ID , ECL_PACK_VERSION };
+
+    writer->stream      = stream;
+    writer->filename    = util_alloc_string_copy( filename );
+    writer->num_threads = util_int_max( 1 , num_threads );
+    writer->num_kw      = 0;
+    writer->offset      = 0;
+    writer->zoffset     = sizeof header;
+    writer->block_index = buffer_alloc( 1024 );
+    writer->kw_index    = buffer_alloc( 1024 );
+    writer->jobs        = vector_alloc_new();
+    writer->job_bytes   = 0;
+    writer->write_ok    = (fwrite( header , sizeof header , 1 , stream ) == 1);
+
+    return writer;
+  }
+#endif
+  return NULL;
+}
+
+
+/*
+  The keyword is copied, and can be modified or freed as soon as the
+  function returns.
+*/
+
+void ecl_pack_writer_add_kw( ecl_pack_writer_type * writer , const ecl_kw_type * ecl_kw ) {
+#ifdef ERT_HAVE_ZLIB
+  ecl_pack_job_type * job = util_malloc( sizeof * job );
+
+  job->offset = writer->offset;
+  job->size   = ecl_kw_fortio_size( ecl_kw );
+  job->data   = util_malloc( job->size );
+  job->zdata  = NULL;
+  job->zsize  = 0;
+  ecl_kw_write_memory_image( ecl_kw , job->data );
+
+  {
+    ecl_file_kw_type * file_kw = ecl_file_kw_alloc( ecl_kw , writer->offset );
+    ecl_file_kw_buffer_store( file_kw , writer->kw_index );
+    ecl_file_kw_free( file_kw );
+  }
+
+  writer->offset += job->size;
+  writer->num_kw++;
+  writer->job_bytes += job->size;
+  vector_append_owned_ref( writer->jobs , job , ecl_pack_job_free__ );
+
+  if ((writer->job_bytes >= ECL_PACK_BATCH_BYTES) || (vector_get_size( writer->jobs ) >= ECL_PACK_BATCH_SIZE))
+    ecl_pack_writer_flush( writer );
+#endif
+}
+
+
+/*
+  Will write the remaining keywords and the index, close the file and
+  free the writer. Returns false if writing failed; in that case the
+  incomplete file is removed.
+*/
+
+bool ecl_pack_writer_close( ecl_pack_writer_type * writer ) {
+  bool write_ok = false;
+#ifdef ERT_HAVE_ZLIB
+  ecl_pack_writer_flush( writer );
+  {
+    int64_t index_offset = writer->zoffset;
+    int id = ECL_PACK_ID;
+
+    if (buffer_stream_fwrite_n( writer->block_index , 0 , buffer_get_size( writer->block_index ) , writer->stream ) != buffer_get_size( writer->block_index ))
+      writer->write_ok = false;
+
+    if (fwrite( &writer->num_kw , sizeof writer->num_kw , 1 , writer->stream ) != 1)
+      writer->write_ok = false;
+
+    if (buffer_stream_fwrite_n( writer->kw_index , 0 , buffer_get_size( writer->kw_index ) , writer->stream ) != buffer_get_size( writer->kw_index ))
+      writer->write_ok = false;
+
+    if ((fwrite( &index_offset , sizeof index_offset , 1 , writer->stream ) != 1) ||
+        (fwrite( &writer->num_kw , sizeof writer->num_kw , 1 , writer->stream ) != 1) ||
+        (fwrite( &id , sizeof id , 1 , writer->stream ) != 1))
+      writer->write_ok = false;
+  }
+
+  write_ok = (fclose( writer->stream ) == 0) && writer->write_ok;
+  if (!write_ok)
+    remove( writer->filename );
+
+  buffer_free( writer->block_index );
+  buffer_free( writer->kw_index );
+  vector_free( writer->jobs );
+  free( writer->filename );
+  free( writer );
+#endif
+  return write_ok;
+}
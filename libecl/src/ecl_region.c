@@ -19,6 +19,8 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
 
 #include <ert/util/int_vector.h>
 #include <ert/util/util.h>
@@ -61,6 +63,16 @@
    elements. This is checked, and the program will fail hard if it is
    not satisfied.
 
+   The selection is stored as a bitset with one bit for each cell in
+   the grid, packed in 64 bit words. The set operations
+   ecl_region_intersection(), ecl_region_union(), ... and
+   ecl_region_invert_selection() work on whole words, and the number
+   of selected cells is counted with popcount, without creating the
+   index lists. The index lists are created on demand by iterating
+   over the set bits, skipping empty words, i.e. the cost is
+   proportional to the number of selected cells. The lists are kept
+   until the selection changes.
+
    Example:
    --------
 
@@ -95,7 +107,8 @@
 
 struct ecl_region_struct {
   UTIL_TYPE_ID_DECLARATION;
-  bool                * active_mask;          /* This marks active|inactive in the region, which is unrelated to active in the grid. */
+  uint64_t            * active_mask;          /* Bitset marking active|inactive in the region, which is unrelated to active in the grid. */
+  int                   num_words;
   int_vector_type     * global_index_list;    /* This is a list of the cells in the region - irrespective of whether they are active in the grid or not. */
   int_vector_type     * active_index_list;    /* This means cells in the region which are also active in the grid */
   int_vector_type     * global_active_list;   /* This is a list of (maximum) nactive elements, where the values are in the [0,..nx*ny*nz) range. */
@@ -116,6 +129,84 @@ UTIL_IS_INSTANCE_FUNCTION( ecl_region , ECL_REGION_TYPE_ID)
 UTIL_SAFE_CAST_FUNCTION( ecl_region , ECL_REGION_TYPE_ID)
 
 
+#define ECL_REGION_WORD_BITS 64
+
+static inline bool ecl_region_mask_get( const uint64_t * mask , int index ) {
+  return (mask[ index / ECL_REGION_WORD_BITS ] >> (index % ECL_REGION_WORD_BITS)) & 1;
+}
+
+
+static inline void ecl_region_mask_set( uint64_t * mask , int index , bool value ) {
+  uint64_t bit = UINT64_C(1) << (index % ECL_REGION_WORD_BITS);
+  if (value)
+    mask[ index / ECL_REGION_WORD_BITS ] |= bit;
+  else
+    mask[ index / ECL_REGION_WORD_BITS ] &= ~bit;
+}
+
+
+static inline int ecl_region_popcount( uint64_t word ) {
+#ifdef __GNUC__
+  return __builtin_popcountll( word );
+#else
+  word = word - ((word >> 1) & UINT64_C(0x5555555555555555));
+  word = (word & UINT64_C(0x3333333333333333)) + ((word >> 2) & UINT64_C(0x3333333333333333));
+  word = (word + (word >> 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+  return (int) ((word * UINT64_C(0x0101010101010101)) >> 56);
+#endif
+}
+
+
+static inline int ecl_region_ctz( uint64_t word ) {
+#ifdef __GNUC__
+  return __builtin_ctzll( word );
+#else
+  int bit = 0;
+  while ((word & 1) == 0) {
+    word >>= 1;
+    bit++;
+  }
+  return bit;
+#endif
+}
+
+
+/*
+  The bits above grid_vol in the last word are always zero; this
+  returns the mask of the valid bits in the last word.
+*/
+
+static uint64_t ecl_region_tail_mask( const ecl_region_type * region ) {
+  int tail_bits = region->grid_vol % ECL_REGION_WORD_BITS;
+  if (tail_bits == 0)
+    return ~UINT64_C(0);
+  else
+    return (UINT64_C(1) << tail_bits) - 1;
+}
+
+
+/*
+  Sets the bits [index1, index2) to value.
+*/
+
+static void ecl_region_mask_set_range( uint64_t * mask , int index1 , int index2 , bool value ) {
+  while (index1 < index2 && (index1 % ECL_REGION_WORD_BITS) != 0) {
+    ecl_region_mask_set( mask , index1 , value );
+    index1++;
+  }
+
+  while (index1 + ECL_REGION_WORD_BITS <= index2) {
+    mask[ index1 / ECL_REGION_WORD_BITS ] = value ? ~UINT64_C(0) : 0;
+    index1 += ECL_REGION_WORD_BITS;
+  }
+
+  while (index1 < index2) {
+    ecl_region_mask_set( mask , index1 , value );
+    index1++;
+  }
+}
+
+
 static void ecl_region_invalidate_index_list( ecl_region_type * region ) {
   region->global_index_list_valid  = false;
   region->active_index_list_valid  = false;
@@ -142,7 +233,8 @@ ecl_region_type * ecl_region_alloc( const ecl_grid_type * ecl_grid , bool presel
   region->parent_grid = ecl_grid;
   ecl_grid_get_dims( ecl_grid , &region->grid_nx , &region->grid_ny , &region->grid_nz , &region->grid_active);
   region->grid_vol          = region->grid_nx * region->grid_ny * region->grid_nz;
-  region->active_mask       = util_calloc(region->grid_vol , sizeof * region->active_mask );
+  region->num_words         = (region->grid_vol + ECL_REGION_WORD_BITS - 1) / ECL_REGION_WORD_BITS;
+  region->active_mask       = util_calloc(region->num_words , sizeof * region->active_mask );
   region->active_index_list  = int_vector_alloc(0 , 0);
   region->global_index_list  = int_vector_alloc(0 , 0);
   region->global_active_list = int_vector_alloc(0 , 0);
@@ -159,7 +251,7 @@ ecl_region_type * ecl_region_alloc( const ecl_grid_type * ecl_grid , bool presel
 
 ecl_region_type * ecl_region_alloc_copy( const ecl_region_type * ecl_region ) {
   ecl_region_type * new_region = ecl_region_alloc( ecl_region->parent_grid , ecl_region->preselect );
-  memcpy( new_region->active_mask , ecl_region->active_mask , ecl_region->grid_vol * sizeof * ecl_region->active_mask );
+  memcpy( new_region->active_mask , ecl_region->active_mask , ecl_region->num_words * sizeof * ecl_region->active_mask );
   ecl_region_invalidate_index_list( new_region );
   return new_region;
 }
@@ -187,12 +279,20 @@ void ecl_region_free__( void * __region ) {
 
 static void ecl_region_assert_global_index_list( ecl_region_type * region ) {
   if (!region->global_index_list_valid) {
-    int global_index;
-
-    int_vector_reset( region->global_index_list  );
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      if (region->active_mask[ global_index ])
-        int_vector_append( region->global_index_list , global_index );
+    int word_index;
+    int * global_list;
+    int size = 0;
+
+    int_vector_resize( region->global_index_list , ecl_region_get_global_size( region ));
+    global_list = int_vector_get_ptr( region->global_index_list );
+    for (word_index = 0; word_index < region->num_words; word_index++) {
+      uint64_t word = region->active_mask[ word_index ];
+      while (word) {
+        global_list[size] = word_index * ECL_REGION_WORD_BITS + ecl_region_ctz( word );
+        size++;
+        word &= word - 1;
+      }
+    }
 
     region->global_index_list_valid = true;
   }
@@ -201,24 +301,59 @@ static void ecl_region_assert_global_index_list( ecl_region_type * region ) {
 
 static void ecl_region_assert_active_index_list( ecl_region_type * region ) {
   if (!region->active_index_list_valid) {
-    int global_index;
-
-    int_vector_reset( region->active_index_list  );
-    int_vector_reset( region->global_active_list );
-    for (global_index = 0; global_index < region->grid_vol; global_index++) {
-      if (region->active_mask[ global_index ]) {
+    const int max_size = ecl_region_get_global_size( region );
+    int word_index;
+    int * active_list;
+    int * global_active_list;
+    int size = 0;
+
+    int_vector_resize( region->active_index_list , max_size );
+    int_vector_resize( region->global_active_list , max_size );
+    active_list = int_vector_get_ptr( region->active_index_list );
+    global_active_list = int_vector_get_ptr( region->global_active_list );
+    for (word_index = 0; word_index < region->num_words; word_index++) {
+      uint64_t word = region->active_mask[ word_index ];
+      while (word) {
+        int global_index = word_index * ECL_REGION_WORD_BITS + ecl_region_ctz( word );
         int active_index = ecl_grid_get_active_index1( region->parent_grid , global_index );
         if (active_index >= 0) {
-          int_vector_append( region->active_index_list , active_index );
-          int_vector_append( region->global_active_list , global_index );
+          active_list[size] = active_index;
+          global_active_list[size] = global_index;
+          size++;
         }
+        word &= word - 1;
       }
     }
+    int_vector_resize( region->active_index_list , size );
+    int_vector_resize( region->global_active_list , size );
     region->active_index_list_valid = true;
   }
 }
 
 
+/*
+  The number of selected cells, counted directly from the bitset, and
+  the number of selected cells which are active in the grid.
+*/
+
+int ecl_region_get_global_size( const ecl_region_type * region ) {
+  if (region->global_index_list_valid)
+    return int_vector_size( region->global_index_list );
+  else {
+    int count = 0;
+    int word_index;
+    for (word_index = 0; word_index < region->num_words; word_index++)
+      count += ecl_region_popcount( region->active_mask[ word_index ] );
+    return count;
+  }
+}
+
+
+int ecl_region_get_active_size( ecl_region_type * region ) {
+  return int_vector_size( ecl_region_get_active_list( region ));
+}
+
+
 /*****************************************************************/
 
 
@@ -242,11 +377,11 @@ const int_vector_type * ecl_region_get_global_list( ecl_region_type * region ) {
 /*****************************************************************/
 /* Stupid cpp compat/legacy/cruft functions. */
 int ecl_region_get_active_size_cpp(  ecl_region_type * region ) {
-  return int_vector_size( ecl_region_get_active_list( region ));
+  return ecl_region_get_active_size( region );
 }
 
 int ecl_region_get_global_size_cpp( ecl_region_type * region ) {
-  return int_vector_size( ecl_region_get_global_list( region ));
+  return ecl_region_get_global_size( region );
 }
 
 const int * ecl_region_get_active_list_cpp( ecl_region_type * region ) {
@@ -276,9 +411,8 @@ static void ecl_region_assert_kw( const ecl_region_type * region , const ecl_kw_
 /*****************************************************************/
 
 void ecl_region_reset( ecl_region_type * ecl_region ) {
-  int i;
-  for (i=0; i < ecl_region->grid_vol; i++)
-    ecl_region->active_mask[i] = ecl_region->preselect;
+  memset( ecl_region->active_mask , 0 , ecl_region->num_words * sizeof * ecl_region->active_mask );
+  ecl_region_mask_set_range( ecl_region->active_mask , 0 , ecl_region->grid_vol , ecl_region->preselect );
   ecl_region_invalidate_index_list( ecl_region );
 }
 
@@ -287,7 +421,7 @@ void ecl_region_reset( ecl_region_type * ecl_region ) {
 
 static void ecl_region_select_cell__( ecl_region_type * region , int i , int j , int k, bool select) {
   int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-  region->active_mask[global_index] = select;
+  ecl_region_mask_set( region->active_mask , global_index , select );
   ecl_region_invalidate_index_list( region );
 }
 
@@ -314,14 +448,14 @@ static void ecl_region_select_equal__( ecl_region_type * region , const ecl_kw_t
       int global_index;
       for (global_index = 0; global_index < region->grid_vol; global_index++) {
         if (kw_data[ global_index ] == value)
-          region->active_mask[ global_index ] = select;
+          ecl_region_mask_set( region->active_mask , global_index , select );
       }
     } else {
       int active_index;
       for (active_index = 0; active_index < region->grid_active; active_index++) {
         if (kw_data[active_index] == value) {
           int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
+          ecl_region_mask_set( region->active_mask , global_index , select );
         }
       }
     }
@@ -351,14 +485,14 @@ static void ecl_region_select_bool_equal__( ecl_region_type * region , const ecl
       int global_index;
       for (global_index = 0; global_index < region->grid_vol; global_index++) {
         if (ecl_kw_iget_bool(ecl_kw , global_index) == value)
-          region->active_mask[ global_index ] = select;
+          ecl_region_mask_set( region->active_mask , global_index , select );
       }
     } else {
       int active_index;
       for (active_index = 0; active_index < region->grid_active; active_index++) {
         if (ecl_kw_iget_bool(ecl_kw , active_index) == value) {
           int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
+          ecl_region_mask_set( region->active_mask , global_index , select );
         }
       }
     }
@@ -400,14 +534,14 @@ static void ecl_region_select_in_interval__( ecl_region_type * region , const ec
       int global_index;
       for (global_index = 0; global_index < region->grid_vol; global_index++) {
         if (kw_data[ global_index ] >= min_value && kw_data[ global_index ] < max_value)
-          region->active_mask[ global_index ] = select;
+          ecl_region_mask_set( region->active_mask , global_index , select );
       }
     } else {
       int active_index;
       for (active_index = 0; active_index < region->grid_active; active_index++) {
         if (kw_data[ active_index ] >= min_value && kw_data[ active_index ] < max_value) {
           int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-          region->active_mask[ global_index ] = select;
+          ecl_region_mask_set( region->active_mask , global_index , select );
         }
       }
     }
@@ -453,10 +587,10 @@ static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl
         for (global_index = 0; global_index < region->grid_vol; global_index++) {
           if (select_less) {
             if (kw_data[ global_index ] < float_limit)
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
           } else {
             if (kw_data[ global_index ] >= float_limit)
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
           }
         }
       } else {
@@ -465,12 +599,12 @@ static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl
           if (select_less) {
             if (kw_data[ active_index ] < float_limit) {
               int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
             }
           } else {
             if (kw_data[ active_index ] >= float_limit) {
               int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
             }
           }
         }
@@ -483,10 +617,10 @@ static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl
         for (global_index = 0; global_index < region->grid_vol; global_index++) {
           if (select_less) {
             if (kw_data[ global_index ] < int_limit)
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
           } else {
             if (kw_data[ global_index ] > int_limit)
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
           }
         }
       } else {
@@ -495,12 +629,12 @@ static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl
           if (select_less) {
             if (kw_data[ active_index ] < int_limit) {
               int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
             }
           } else {
             if (kw_data[ active_index ] > int_limit) {
               int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
             }
           }
         }
@@ -513,10 +647,10 @@ static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl
         for (global_index = 0; global_index < region->grid_vol; global_index++) {
           if (select_less) {
             if (kw_data[ global_index ] < double_limit)
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
           } else {
             if (kw_data[ global_index ] >= double_limit)
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
           }
         }
       } else {
@@ -525,12 +659,12 @@ static void ecl_region_select_with_limit__( ecl_region_type * region , const ecl
           if (select_less) {
             if (kw_data[ active_index ] < double_limit) {
               int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
             }
           } else {
             if (kw_data[ active_index ] >= double_limit) {
               int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
             }
           }
         }
@@ -580,10 +714,10 @@ static void ecl_region_cmp_select__( ecl_region_type * region , const ecl_kw_typ
         for (global_index = 0; global_index < region->grid_vol; global_index++) {
           if (select_less) {
             if (kw1_data[ global_index ] < kw2_data[ global_index ])
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
           } else {
             if (kw1_data[ global_index ] >= kw2_data[ global_index ] )
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
           }
         }
       } else {
@@ -592,12 +726,12 @@ static void ecl_region_cmp_select__( ecl_region_type * region , const ecl_kw_typ
           if (select_less) {
             if (kw1_data[ active_index ] < kw2_data[ active_index] ) {
               int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
             }
           } else {
             if (kw1_data[ active_index ] >= kw2_data[ active_index ]) {
               int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index );
-              region->active_mask[ global_index ] = select;
+              ecl_region_mask_set( region->active_mask , global_index , select );
             }
           }
         }
@@ -640,7 +774,7 @@ static void ecl_region_select_from_box__( ecl_region_type * region , const ecl_b
   int box_index;
 
   for (box_index = 0; box_index < box_size; box_index++)
-    region->active_mask[ active_list[box_index] ] = select;
+    ecl_region_mask_set( region->active_mask , active_list[box_index] , select );
 
   ecl_region_invalidate_index_list( region );
 }
@@ -705,7 +839,7 @@ static void ecl_region_select_i1i2__( ecl_region_type * region , int i1 , int i2
       for (j = 0; j < region->grid_ny; j++)
         for (i = i1; i <= i2; i++) {
           int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
+          ecl_region_mask_set( region->active_mask , global_index , select );
         }
   }
   ecl_region_invalidate_index_list( region );
@@ -745,7 +879,7 @@ static void ecl_region_select_j1j2__( ecl_region_type * region , int j1 , int j2
       for ( j = j1; j <= j2; j++)
         for ( i = 0; i < region->grid_nx; i++) {
           int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
+          ecl_region_mask_set( region->active_mask , global_index , select );
         }
   }
   ecl_region_invalidate_index_list( region );
@@ -779,13 +913,10 @@ static void ecl_region_select_k1k2__( ecl_region_type * region , int k1 , int k2
   k1 = util_int_max(0 , k1);
   k2 = util_int_min(region->grid_nz - 1 , k2);
   {
-    int i,j,k;
-    for (k = k1; k <= k2; k++)
-      for (j = 0; j < region->grid_ny; j++)
-        for (i = 0; i < region->grid_nx; i++) {
-          int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-          region->active_mask[global_index] = select;
-        }
+    /* The layers k1..k2 are one contiguous range of global indices. */
+    const int layer_size = region->grid_nx * region->grid_ny;
+    if (k1 <= k2)
+      ecl_region_mask_set_range( region->active_mask , k1 * layer_size , (k2 + 1) * layer_size , select );
   }
   ecl_region_invalidate_index_list( region );
 }
@@ -816,11 +947,11 @@ static void ecl_region_select_from_depth__( ecl_region_type * region , double de
     if (select_deep) {
       // The select/deselect mechanism should be applied to deep cells.
       if (cell_depth >= depth_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( region->active_mask , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to shallow cells.
       if (cell_depth <= depth_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( region->active_mask , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( region );
@@ -854,11 +985,11 @@ static void ecl_region_select_from_volume__( ecl_region_type * region , double v
     if (select_small) {
       // The select/deselect mechanism should be applied to small cells.
       if (cell_size <= volum_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( region->active_mask , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to large cells.
       if (cell_size >= volum_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( region->active_mask , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( region );
@@ -890,11 +1021,11 @@ static void ecl_region_select_from_dz__( ecl_region_type * region , double dz_li
     if (select_thin) {
       // The select/deselect mechanism should be applied to thin cells.
       if (cell_dz <= dz_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( region->active_mask , global_index , select );
     } else {
       // The select/deselect mechanism should be applied to thick cells.
       if (cell_dz >= dz_limit)
-        region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( region->active_mask , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( region );
@@ -922,10 +1053,10 @@ static void ecl_region_select_active_cells__( ecl_region_type * ecl_region , boo
   for (global_index = 0; global_index < ecl_region->grid_vol; global_index++) {
     if (select_active) {
       if (ecl_grid_get_active_index1( ecl_region->parent_grid , global_index) >= 0)
-        ecl_region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( ecl_region->active_mask , global_index , select );
     } else {
       if (ecl_grid_get_active_index1( ecl_region->parent_grid , global_index) < 0)
-        ecl_region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( ecl_region->active_mask , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( ecl_region );
@@ -955,7 +1086,7 @@ void ecl_region_deselect_inactive_cells( ecl_region_type * region ) {
 
 static void ecl_region_select_global_index__( ecl_region_type * region , int global_index , bool select) {
   if ((global_index >= 0) && (global_index < region->grid_vol))
-    region->active_mask[ global_index ] = select;
+    ecl_region_mask_set( region->active_mask , global_index , select );
   else
     util_abort("%s: global_index:%d invalid - legal interval: [0,%d) \n",__func__ , global_index , region->grid_vol);
   ecl_region_invalidate_index_list( region );
@@ -971,6 +1102,68 @@ void ecl_region_deselect_global_index( ecl_region_type * region , int global_ind
 
 /*****************************************************************/
 
+/**
+   The cylinder and polygon selections below test the cell centers in
+   the xy plane. The helper functions compute the centers of the cells
+   in the top layer, which are used as the position of the column, and
+   select or deselect all the cells in the marked columns.
+
+   Computing the top layer centers touches all the j slices of the
+   grid, i.e. for a grid with lazy geometry the geometry of all the
+   cells is initialized. Afterwards the cell geometry can be accessed
+   from several threads.
+*/
+
+static void ecl_region_init_column_xy( const ecl_region_type * region , double * x , double * y ) {
+  const int nx = region->grid_nx;
+  const int ny = region->grid_ny;
+  int i,j;
+
+  for (j=0; j < ny; j++) {
+    for (i=0; i < nx; i++) {
+      double z;
+      ecl_grid_get_xyz3( region->parent_grid , i , j , 0 , &x[i + j*nx] , &y[i + j*nx] , &z);
+    }
+  }
+}
+
+
+/*
+  Selects or deselects all the cells in the columns with
+  column_select[i + j*nx] == true. The words of the bitset are
+  independent, so they are updated in parallel.
+*/
+
+static void ecl_region_select_columns__( ecl_region_type * region , const bool * column_select , bool select) {
+  const int layer_size = region->grid_nx * region->grid_ny;
+  int word_index;
+
+#pragma omp parallel for if (region->num_words > 1024)
+  for (word_index = 0; word_index < region->num_words; word_index++) {
+    const int global1 = word_index * ECL_REGION_WORD_BITS;
+    const int global2 = util_int_min( region->grid_vol , global1 + ECL_REGION_WORD_BITS );
+    int column = global1 % layer_size;
+    uint64_t bits = 0;
+    int global_index;
+
+    for (global_index = global1; global_index < global2; global_index++) {
+      if (column_select[column])
+        bits |= UINT64_C(1) << (global_index - global1);
+
+      column++;
+      if (column == layer_size)
+        column = 0;
+    }
+
+    if (select)
+      region->active_mask[ word_index ] |= bits;
+    else
+      region->active_mask[ word_index ] &= ~bits;
+  }
+  ecl_region_invalidate_index_list( region );
+}
+
+
 /**
    Here comes functions for selecting all the cells which are in the
    vertical cylinder located at (x0,y0) with radius R. The functions
@@ -983,52 +1176,63 @@ void ecl_region_deselect_global_index( ecl_region_type * region , int global_ind
    ecl_region_clyinder_select__() with select_inside == true.
 */
 
+static bool ecl_region_cylinder_contains( double x0 , double y0 , double R2 , bool select_inside , double x , double y) {
+  double pointR2 = (x - x0) * (x - x0) + (y - y0) * (y - y0);
+  if ((pointR2 < R2) && (select_inside))
+    return true;
+  else if ((pointR2 > R2) && (!select_inside))
+    return true;
+  else
+    return false;
+}
+
+
 static void ecl_region_cylinder_select__( ecl_region_type * region , double x0 , double y0, double R , double z1 , double z2 , bool select_inside , bool select) {
+  const int layer_size = region->grid_nx * region->grid_ny;
   double R2 = R*R;
+  double * column_x = util_calloc( layer_size , sizeof * column_x );
+  double * column_y = util_calloc( layer_size , sizeof * column_y );
 
+  ecl_region_init_column_xy( region , column_x , column_y );
   if (z1 < z2) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++) {
-      double x,y,z;
-      ecl_grid_get_xyz1( region->parent_grid , global_index , &x , &y , &z);
-      if ((z >= z1) && (z <= z2)) {
-        double pointR2 = (x - x0) * (x - x0) + (y - y0) * (y - y0);
-        if ((pointR2 < R2) && (select_inside))
-          region->active_mask[ global_index ] = select;
-        else if ((pointR2 > R2) && (!select_inside))
-          region->active_mask[ global_index ] = select;
-      }
-    }
-  } else {
-    const int nx = region->grid_nx;
-    const int ny = region->grid_ny;
-    const int nz = region->grid_nz;
-    int i,j;
-    for (i=0; i < nx; i++) {
-      for (j=0; j < ny; j++) {
+    /*
+      Every cell center is tested, the words of the bitset are
+      processed in parallel.
+    */
+    int word_index;
+#pragma omp parallel for if (region->num_words > 1024)
+    for (word_index = 0; word_index < region->num_words; word_index++) {
+      const int global1 = word_index * ECL_REGION_WORD_BITS;
+      const int global2 = util_int_min( region->grid_vol , global1 + ECL_REGION_WORD_BITS );
+      uint64_t bits = 0;
+      int global_index;
+
+      for (global_index = global1; global_index < global2; global_index++) {
         double x,y,z;
-        ecl_grid_get_xyz3( region->parent_grid , i,j,0 , &x , &y , &z);
-        {
-          double pointR2 = (x - x0) * (x - x0) + (y - y0) * (y - y0);
-          bool select_column = false;
-
-          if ((pointR2 < R2) && (select_inside))
-            select_column = true;
-          else if ((pointR2 > R2) && (!select_inside))
-            select_column = true;
-
-          if (select_column) {
-            int k;
-            for (k=0; k < nz; k++) {
-              int global_index = ecl_grid_get_global_index3( region->parent_grid , i,j,k);
-              region->active_mask[ global_index ] = select;
-            }
-          }
-        }
+        ecl_grid_get_xyz1( region->parent_grid , global_index , &x , &y , &z);
+        if ((z >= z1) && (z <= z2) && ecl_region_cylinder_contains( x0 , y0 , R2 , select_inside , x , y ))
+          bits |= UINT64_C(1) << (global_index - global1);
       }
+
+      if (select)
+        region->active_mask[ word_index ] |= bits;
+      else
+        region->active_mask[ word_index ] &= ~bits;
     }
+    ecl_region_invalidate_index_list( region );
+  } else {
+    bool * column_select = util_calloc( layer_size , sizeof * column_select );
+    int column;
+
+    for (column = 0; column < layer_size; column++)
+      column_select[column] = ecl_region_cylinder_contains( x0 , y0 , R2 , select_inside , column_x[column] , column_y[column] );
+
+    ecl_region_select_columns__( region , column_select , select );
+    free( column_select );
   }
-  ecl_region_invalidate_index_list( region );
+
+  free( column_y );
+  free( column_x );
 }
 
 
@@ -1075,9 +1279,9 @@ static void ecl_region_plane_select__( ecl_region_type * region, const double n[
       ecl_grid_get_xyz1( region->parent_grid , global_index , &x , &y , &z);
       D = a*x + b*y + c*z + d;
       if ((D >= 0) && (select_above))
-        region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( region->active_mask , global_index , select );
       else if ((D < 0) && (!select_above))
-        region->active_mask[ global_index ] = select;
+        ecl_region_mask_set( region->active_mask , global_index , select );
     }
   }
   ecl_region_invalidate_index_list( region );
@@ -1124,35 +1328,190 @@ void ecl_region_deselect_below_plane( ecl_region_type * region, const double n[3
 */
 
 
-static void ecl_region_polygon_select__( ecl_region_type * region ,
-                                         const geo_polygon_type * polygon ,
-                                         bool select_inside , bool select) {
+/*
+  Point in polygon test with a bounding box and an index of the
+  polygon edges in horizontal bands; the point only needs to be tested
+  against the edges in its band instead of all the edges in the
+  polygon.
+
+  The result is exactly the same as geo_polygon_contains_point(), which
+  counts the edges with ymin < y0 <= ymax which are crossed by a ray
+  from (x0,y0) in the positive x direction. All such edges are found
+  in the band of y0, because the band index is a nondecreasing
+  function of y, and an edge is added to all the bands from the band
+  of ymin to the band of ymax. Points with y0 outside the bounding box,
+  or with x0 to the right of it, can not cross any edges.
+*/
+
+typedef struct {
+  double   xmax , ymin , ymax;
+  double   band_height;
+  int      num_bands;
+  int    * band_offset;     /* The edges in band b are band_edges[band_offset[b] .. band_offset[b+1]). */
+  int    * band_edges;
+  double * x1, * y1, * x2, * y2;
+} ecl_region_polygon_index_type;
+
+
+static int ecl_region_polygon_index_get_band( const ecl_region_polygon_index_type * index , double y ) {
+  double band = floor( (y - index->ymin) / index->band_height );
+  if (band < 0)
+    return 0;
+  else if (band >= index->num_bands)
+    return index->num_bands - 1;
+  else
+    return (int) band;
+}
+
+
+static ecl_region_polygon_index_type * ecl_region_polygon_index_alloc( const geo_polygon_type * polygon ) {
+  ecl_region_polygon_index_type * index = util_malloc( sizeof * index );
+  const int num_points = geo_polygon_get_size( polygon );
+  int num_edges = 0;
+  int point_nr;
+
+  index->x1 = util_calloc( util_int_max( 1 , num_points ) , sizeof * index->x1 );
+  index->y1 = util_calloc( util_int_max( 1 , num_points ) , sizeof * index->y1 );
+  index->x2 = util_calloc( util_int_max( 1 , num_points ) , sizeof * index->x2 );
+  index->y2 = util_calloc( util_int_max( 1 , num_points ) , sizeof * index->y2 );
+  index->xmax = 0;
+  index->ymin = 0;
+  index->ymax = 0;
+
+  for (point_nr = 0; point_nr < num_points; point_nr++) {
+    double x1,y1,x2,y2;
+    geo_polygon_iget_xy( polygon , point_nr , &x1 , &y1 );
+    geo_polygon_iget_xy( polygon , (point_nr + 1) % num_points , &x2 , &y2 );
+
+    if (point_nr == 0) {
+      index->xmax = x1;
+      index->ymin = y1;
+      index->ymax = y1;
+    } else {
+      index->xmax = util_double_max( index->xmax , x1 );
+      index->ymin = util_double_min( index->ymin , y1 );
+      index->ymax = util_double_max( index->ymax , y1 );
+    }
 
-  const int define_k = 0;                  // The k-level where the polygon is checked.
-  const int k1       = 0;                  // Selection range in k
-  const int k2       = region->grid_nz;
+    /* Horizontal and degenerate edges are never crossed. */
+    if (y1 != y2) {
+      index->x1[num_edges] = x1;
+      index->y1[num_edges] = y1;
+      index->x2[num_edges] = x2;
+      index->y2[num_edges] = y2;
+      num_edges++;
+    }
+  }
 
+  index->num_bands = util_int_max( 1 , num_edges );
+  index->band_height = (index->ymax > index->ymin) ? (index->ymax - index->ymin) / index->num_bands : 1;
+  index->band_offset = util_calloc( index->num_bands + 1 , sizeof * index->band_offset );
   {
-    int i,j;
-    for (i=0; i < region->grid_nx; i++) {
-      for (j=0; j < region->grid_ny; j++) {
-        double x,y,z;
-        bool inside;
-        int global_index = ecl_grid_get_global_index3( region->parent_grid , i , j , define_k);
+    int * count = util_calloc( index->num_bands , sizeof * count );
+    int edge,band;
 
-        ecl_grid_get_xyz1( region->parent_grid , global_index , &x , &y , &z);
-        inside = geo_polygon_contains_point( polygon , x , y );
+    for (band = 0; band < index->num_bands; band++)
+      count[band] = 0;
 
-        if (select_inside == inside) {
-          int k;
-          for (k=k1; k < k2; k++) {
-            global_index = ecl_grid_get_global_index3( region->parent_grid , i , j , k);
-            region->active_mask[ global_index ] = select;
-          }
+    for (edge = 0; edge < num_edges; edge++) {
+      int band1 = ecl_region_polygon_index_get_band( index , util_double_min( index->y1[edge] , index->y2[edge] ));
+      int band2 = ecl_region_polygon_index_get_band( index , util_double_max( index->y1[edge] , index->y2[edge] ));
+      for (band = band1; band <= band2; band++)
+        count[band]++;
+    }
+
+    index->band_offset[0] = 0;
+    for (band = 0; band < index->num_bands; band++) {
+      index->band_offset[band + 1] = index->band_offset[band] + count[band];
+      count[band] = index->band_offset[band];
+    }
+
+    index->band_edges = util_calloc( util_int_max( 1 , index->band_offset[ index->num_bands ] ) , sizeof * index->band_edges );
+    for (edge = 0; edge < num_edges; edge++) {
+      int band1 = ecl_region_polygon_index_get_band( index , util_double_min( index->y1[edge] , index->y2[edge] ));
+      int band2 = ecl_region_polygon_index_get_band( index , util_double_max( index->y1[edge] , index->y2[edge] ));
+      for (band = band1; band <= band2; band++) {
+        index->band_edges[ count[band] ] = edge;
+        count[band]++;
+      }
+    }
+    free( count );
+  }
+
+  if (num_points == 0)
+    index->num_bands = 0;
+
+  return index;
+}
+
+
+static void ecl_region_polygon_index_free( ecl_region_polygon_index_type * index ) {
+  free( index->band_edges );
+  free( index->band_offset );
+  free( index->x1 );
+  free( index->y1 );
+  free( index->x2 );
+  free( index->y2 );
+  free( index );
+}
+
+
+static bool ecl_region_polygon_index_contains( const ecl_region_polygon_index_type * index , double x0 , double y0 ) {
+  bool inside = false;
+
+  if (index->num_bands == 0)
+    return false;
+
+  if ((y0 <= index->ymin) || (y0 > index->ymax) || (x0 > index->xmax))
+    return false;
+
+  {
+    int band = ecl_region_polygon_index_get_band( index , y0 );
+    int pos;
+
+    for (pos = index->band_offset[band]; pos < index->band_offset[band + 1]; pos++) {
+      int edge = index->band_edges[pos];
+      double x1 = index->x1[edge]; double y1 = index->y1[edge];
+      double x2 = index->x2[edge]; double y2 = index->y2[edge];
+
+      if ((y0 > util_double_min(y1,y2)) && (y0 <= util_double_max(y1,y2))) {
+        if (x0 <= util_double_max(x1,x2)) {
+          double xc = (y0 - y1) * (x2 - x1) / (y2 - y1) + x1;
+          if ((x1 == x2) || (x0 <= xc))
+            inside = !inside;
         }
       }
     }
   }
+  return inside;
+}
+
+
+static void ecl_region_polygon_select__( ecl_region_type * region ,
+                                         const geo_polygon_type * polygon ,
+                                         bool select_inside , bool select) {
+
+  const int layer_size = region->grid_nx * region->grid_ny;
+  double * column_x = util_calloc( layer_size , sizeof * column_x );
+  double * column_y = util_calloc( layer_size , sizeof * column_y );
+  bool * column_select = util_calloc( layer_size , sizeof * column_select );
+  ecl_region_polygon_index_type * index = ecl_region_polygon_index_alloc( polygon );
+  int column;
+
+  ecl_region_init_column_xy( region , column_x , column_y );
+
+#pragma omp parallel for if (layer_size > 10000)
+  for (column = 0; column < layer_size; column++) {
+    bool inside = ecl_region_polygon_index_contains( index , column_x[column] , column_y[column] );
+    column_select[column] = (select_inside == inside);
+  }
+
+  ecl_region_select_columns__( region , column_select , select );
+
+  ecl_region_polygon_index_free( index );
+  free( column_select );
+  free( column_y );
+  free( column_x );
 }
 
 void ecl_region_select_inside_polygon( ecl_region_type * region , const geo_polygon_type * polygon) {
@@ -1179,7 +1538,7 @@ void ecl_region_deselect_outside_polygon( ecl_region_type * region , const geo_p
 static void ecl_region_select_active_index__( ecl_region_type * region , int active_index , bool select) {
   if ((active_index >= 0) && (active_index < region->grid_active)) {
     int global_index = ecl_grid_get_global_index1A( region->parent_grid , active_index);
-    region->active_mask[ global_index ] = select;
+    ecl_region_mask_set( region->active_mask , global_index , select );
   } else
     util_abort("%s: active_index:%d invalid - legal interval: [0,%d) \n",__func__ , active_index , region->grid_vol);
   ecl_region_invalidate_index_list( region );
@@ -1207,7 +1566,7 @@ static void ecl_region_select_from_layer__( ecl_region_type * region , const lay
     int index;
     for (index = 0; index < int_vector_size( i_list ); index++) {
       int global_index = ecl_grid_get_global_index3( region->parent_grid , i[index] , j[index] , k);
-      region->active_mask[ global_index ] = select;
+      ecl_region_mask_set( region->active_mask , global_index , select );
     }
 
   }
@@ -1230,9 +1589,7 @@ void ecl_region_deselect_from_layer( ecl_region_type * region , const layer_type
 /*****************************************************************/
 
 static void ecl_region_select_all__( ecl_region_type * region , bool select) {
-  int global_index;
-  for (global_index = 0; global_index < region->grid_vol; global_index++)
-    region->active_mask[ global_index ] = select;
+  ecl_region_mask_set_range( region->active_mask , 0 , region->grid_vol , select );
   ecl_region_invalidate_index_list( region );
 }
 
@@ -1249,9 +1606,12 @@ void ecl_region_deselect_all( ecl_region_type * region ) {
 /*****************************************************************/
 
 void ecl_region_invert_selection( ecl_region_type * region ) {
-  int global_index;
-  for (global_index = 0; global_index < region->grid_vol; global_index++)
-    region->active_mask[ global_index ] = !region->active_mask[ global_index ];
+  int word_index;
+  for (word_index = 0; word_index < region->num_words; word_index++)
+    region->active_mask[ word_index ] = ~region->active_mask[ word_index ];
+
+  if (region->num_words > 0)
+    region->active_mask[ region->num_words - 1 ] &= ecl_region_tail_mask( region );
   ecl_region_invalidate_index_list( region );
 }
 
@@ -1265,18 +1625,18 @@ void ecl_region_invert_selection( ecl_region_type * region ) {
 
 bool ecl_region_contains_ijk( const ecl_region_type * ecl_region , int i , int j , int k) {
   int global_index = ecl_grid_get_global_index3( ecl_region->parent_grid , i , j , k );
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_mask_get( ecl_region->active_mask , global_index );
 }
 
 
 bool ecl_region_contains_global( const ecl_region_type * ecl_region , int global_index) {
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_mask_get( ecl_region->active_mask , global_index );
 }
 
 
 bool ecl_region_contains_active( const ecl_region_type * ecl_region , int active_index) {
   int global_index = ecl_grid_get_global_index1A( ecl_region->parent_grid , active_index );
-  return ecl_region->active_mask[ global_index ];
+  return ecl_region_mask_get( ecl_region->active_mask , global_index );
 }
 
 
@@ -1295,11 +1655,16 @@ bool ecl_region_contains_active( const ecl_region_type * ecl_region , int active
 
 void ecl_region_intersection( ecl_region_type * region , const ecl_region_type * new_region ) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] = (region->active_mask[global_index] && new_region->active_mask[global_index]);
+    int word_index;
+    uint64_t changed = 0;
+    for (word_index = 0; word_index < region->num_words; word_index++) {
+      uint64_t word = region->active_mask[word_index] & new_region->active_mask[word_index];
+      changed |= word ^ region->active_mask[word_index];
+      region->active_mask[word_index] = word;
+    }
 
-    ecl_region_invalidate_index_list( region );
+    if (changed)
+      ecl_region_invalidate_index_list( region );
   } else
     util_abort("%s: The two regions do not share grid - aborting \n",__func__);
 }
@@ -1313,11 +1678,16 @@ void ecl_region_intersection( ecl_region_type * region , const ecl_region_type *
 */
 void ecl_region_union( ecl_region_type * region , const ecl_region_type * new_region ) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] = (region->active_mask[global_index] || new_region->active_mask[global_index]);
+    int word_index;
+    uint64_t changed = 0;
+    for (word_index = 0; word_index < region->num_words; word_index++) {
+      uint64_t word = region->active_mask[word_index] | new_region->active_mask[word_index];
+      changed |= word ^ region->active_mask[word_index];
+      region->active_mask[word_index] = word;
+    }
 
-    ecl_region_invalidate_index_list( region );
+    if (changed)
+      ecl_region_invalidate_index_list( region );
   } else
     util_abort("%s: The two regions do not share grid - aborting \n",__func__);
 }
@@ -1331,29 +1701,38 @@ void ecl_region_union( ecl_region_type * region , const ecl_region_type * new_re
 */
 void ecl_region_subtract( ecl_region_type * region , const ecl_region_type * new_region) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] &= !new_region->active_mask[global_index];
+    int word_index;
+    uint64_t changed = 0;
+    for (word_index = 0; word_index < region->num_words; word_index++) {
+      uint64_t word = region->active_mask[word_index] & ~new_region->active_mask[word_index];
+      changed |= word ^ region->active_mask[word_index];
+      region->active_mask[word_index] = word;
+    }
 
-    ecl_region_invalidate_index_list( region );
+    if (changed)
+      ecl_region_invalidate_index_list( region );
   } else
     util_abort("%s: The two regions do not share grid - aborting \n",__func__);
 }
 
 
 /**
-   Will update the selection in @region to seselect the elements which
-   are either in region or new_region:
+   Will update the selection in @region to select the elements which
+   are in exactly one of region and new_region:
 
    A ^= B
 */
 void ecl_region_xor( ecl_region_type * region , const ecl_region_type * new_region) {
   if (region->parent_grid == new_region->parent_grid) {
-    int global_index;
-    for (global_index = 0; global_index < region->grid_vol; global_index++)
-      region->active_mask[global_index] ^= !new_region->active_mask[global_index];
+    int word_index;
+    uint64_t changed = 0;
+    for (word_index = 0; word_index < region->num_words; word_index++) {
+      changed |= new_region->active_mask[word_index];
+      region->active_mask[word_index] ^= new_region->active_mask[word_index];
+    }
 
-    ecl_region_invalidate_index_list( region );
+    if (changed)
+      ecl_region_invalidate_index_list( region );
   } else
     util_abort("%s: The two regions do not share grid - aborting \n",__func__);
 }
@@ -1486,7 +1865,7 @@ const char * ecl_region_get_name( const ecl_region_type * region ) {
 
 bool ecl_region_equal( const ecl_region_type * region1 , const ecl_region_type * region2) {
   if (region1->parent_grid == region2->parent_grid) {  // Must be exactly the same grid instance to compare as equal.
-    if (memcmp(region1->active_mask , region2->active_mask , region1->grid_vol * sizeof * region1->active_mask ) == 0)
+    if (memcmp(region1->active_mask , region2->active_mask , region1->num_words * sizeof * region1->active_mask ) == 0)
       return true;
     else
       return false;
@@ -0,0 +1,531 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_region_stat.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <ert/util/util.h>
+#include <ert/util/type_macros.h>
+
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region_stat.h>
+
+
+/*
+  The ecl_region_stat type computes statistics of one or more value
+  keywords grouped by the value of an integer region keyword like
+  FIPNUM, EQLNUM or SATNUM, for all regions in one pass over the
+  active cells of the grid:
+
+     ecl_kw_type * value_kw[2] = { soil_kw , swat_kw };
+     ecl_region_stat_type * stat = ecl_region_stat_alloc( grid , fipnum_kw , 2 , value_kw , porv_kw );
+
+     for (i = 0; i < ecl_region_stat_get_num_regions( stat ); i++) {
+        int region = ecl_region_stat_iget_region( stat , i );
+        printf("Region:%d  oil volume:%g \n", region , ecl_region_stat_iget_sum( stat , 0 , region ));
+     }
+
+     ecl_region_stat_free( stat );
+
+  All the keywords can have either nactive or nx*ny*nz elements, the
+  region keyword must be of integer type. Only the cells which are
+  active in the grid are considered.
+
+  The optional weight keyword, typically pore volume PORV from the
+  INIT file or the cell volumes from ecl_grid_alloc_geometry_kw(),
+  goes into the sum and the mean:
+
+     sum  = sum( w * v )
+     mean = sum( w * v ) / sum( w )
+
+  With weight_kw == NULL all the weights are 1. The min and max are
+  the unweighted extremal values. For regions without any cells the
+  count and all the statistics are zero.
+
+  When the region values span at most ECL_REGION_STAT_MAX_DENSE
+  values the results are stored in arrays covering all the values from
+  the smallest to the largest region value. Wider ranges, e.g. one
+  stray region value of 2000000000, are compacted to the sorted list
+  of distinct region values first and looked up with binary search, so
+  the memory usage is bounded by the number of active cells and not by
+  the region values.
+
+  The active cells are split in at most ECL_REGION_STAT_MAX_CHUNKS
+  chunks which are reduced in parallel when OpenMP is enabled, and the
+  partial results are combined in chunk order afterwards. Every chunk
+  has its own accumulators for all the regions; when there are more
+  than ECL_REGION_STAT_MAX_DENSE regions the cells are reduced in one
+  chunk instead. The number of chunks only depends on the size of the
+  grid and the number of regions, so the result does not depend on
+  the number of threads.
+*/
+
+#define ECL_REGION_STAT_TYPE_ID    66120953
+#define ECL_REGION_STAT_CHUNK_SIZE 65536
+#define ECL_REGION_STAT_MAX_CHUNKS 64
+#define ECL_REGION_STAT_MAX_DENSE  65536
+
+
+struct ecl_region_stat_struct {
+  UTIL_TYPE_ID_DECLARATION;
+  int        num_values;
+  int        min_region;
+  int        num_regions;     /* max_region - min_region + 1, or the number of distinct region values when compacted. */
+  int      * region_values;   /* [num_regions] sorted distinct region values when compacted, NULL for a dense range. */
+  int      * count;           /* [num_regions] */
+  double   * weight;          /* [num_regions] */
+  double   * sum;             /* [num_values * num_regions] - the statistics for value nr v are at offset v * num_regions. */
+  double   * min;
+  double   * max;
+};
+
+
+/*
+  Typed view of a keyword which is indexed with either the active or
+  the global index.
+*/
+
+typedef struct {
+  ecl_type_enum   ecl_type;
+  const void    * data;
+  bool            global;
+} ecl_region_stat_kw_type;
+
+
+UTIL_IS_INSTANCE_FUNCTION( ecl_region_stat , ECL_REGION_STAT_TYPE_ID )
+UTIL_SAFE_CAST_FUNCTION( ecl_region_stat , ECL_REGION_STAT_TYPE_ID )
+
+
+static void ecl_region_stat_init_kw( ecl_region_stat_kw_type * stat_kw , const ecl_grid_type * grid , const ecl_kw_type * ecl_kw) {
+  int kw_size = ecl_kw_get_size( ecl_kw );
+
+  stat_kw->ecl_type = ecl_kw_get_type( ecl_kw );
+  stat_kw->data = ecl_kw_get_ptr( ecl_kw );
+  if (kw_size == ecl_grid_get_global_size( grid ))
+    stat_kw->global = true;
+  else if (kw_size == ecl_grid_get_active_size( grid ))
+    stat_kw->global = false;
+  else
+    util_abort("%s: size mismatch for keyword:%s  size:%d  grid active:%d  grid global:%d \n",__func__ ,
+               ecl_kw_get_header( ecl_kw ) , kw_size , ecl_grid_get_active_size( grid ) , ecl_grid_get_global_size( grid ));
+
+  if (!((stat_kw->ecl_type == ECL_FLOAT_TYPE) || (stat_kw->ecl_type == ECL_DOUBLE_TYPE) || (stat_kw->ecl_type == ECL_INT_TYPE)))
+    util_abort("%s: keyword:%s must be of float, double or integer type \n",__func__ , ecl_kw_get_header( ecl_kw ));
+}
+
+
+static inline double ecl_region_stat_kw_iget( const ecl_region_stat_kw_type * stat_kw , int active_index , int global_index) {
+  int index = stat_kw->global ? global_index : active_index;
+  switch (stat_kw->ecl_type) {
+  case ECL_FLOAT_TYPE:
+    return ((const float *) stat_kw->data)[index];
+  case ECL_DOUBLE_TYPE:
+    return ((const double *) stat_kw->data)[index];
+  default:
+    return ((const int *) stat_kw->data)[index];
+  }
+}
+
+
+static inline int ecl_region_stat_region_iget( const ecl_region_stat_kw_type * region_kw , int active_index , int global_index) {
+  const int * data = region_kw->data;
+  return region_kw->global ? data[global_index] : data[active_index];
+}
+
+
+static ecl_region_stat_type * ecl_region_stat_alloc_empty( int num_values , int min_region , int num_regions , const int * region_values ) {
+  ecl_region_stat_type * region_stat = util_malloc( sizeof * region_stat );
+  int i;
+
+  UTIL_TYPE_ID_INIT( region_stat , ECL_REGION_STAT_TYPE_ID );
+  region_stat->num_values  = num_values;
+  region_stat->min_region  = min_region;
+  region_stat->num_regions = num_regions;
+  region_stat->region_values = region_values ? util_alloc_copy( region_values , num_regions * sizeof * region_values ) : NULL;
+  region_stat->count  = util_calloc( num_regions , sizeof * region_stat->count );
+  region_stat->weight = util_calloc( num_regions , sizeof * region_stat->weight );
+  region_stat->sum    = util_calloc( num_values * num_regions , sizeof * region_stat->sum );
+  region_stat->min    = util_calloc( num_values * num_regions , sizeof * region_stat->min );
+  region_stat->max    = util_calloc( num_values * num_regions , sizeof * region_stat->max );
+
+  for (i = 0; i < num_regions; i++) {
+    region_stat->count[i] = 0;
+    region_stat->weight[i] = 0;
+  }
+
+  for (i = 0; i < num_values * num_regions; i++) {
+    region_stat->sum[i] = 0;
+    region_stat->min[i] = 0;
+    region_stat->max[i] = 0;
+  }
+  return region_stat;
+}
+
+
+void ecl_region_stat_free( ecl_region_stat_type * region_stat ) {
+  free( region_stat->region_values );
+  free( region_stat->count );
+  free( region_stat->weight );
+  free( region_stat->sum );
+  free( region_stat->min );
+  free( region_stat->max );
+  free( region_stat );
+}
+
+
+/*
+  Returns the internal index of region_value, or -1 if the value is
+  outside the region range.
+*/
+
+static int ecl_region_stat_lookup( const ecl_region_stat_type * region_stat , int region_value ) {
+  if (region_stat->region_values) {
+    int lower = 0;
+    int upper = region_stat->num_regions;
+
+    while (lower < upper) {
+      int mid = lower + (upper - lower) / 2;
+      if (region_stat->region_values[mid] < region_value)
+        lower = mid + 1;
+      else
+        upper = mid;
+    }
+
+    if ((lower < region_stat->num_regions) && (region_stat->region_values[lower] == region_value))
+      return lower;
+    else
+      return -1;
+  } else {
+    int64_t region = (int64_t) region_value - region_stat->min_region;
+    if ((region >= 0) && (region < region_stat->num_regions))
+      return region;
+    else
+      return -1;
+  }
+}
+
+
+/*
+  Reduces the active cells [active1, active2) into region_stat.
+*/
+
+static void ecl_region_stat_reduce( ecl_region_stat_type * region_stat ,
+                                    const ecl_grid_type * grid ,
+                                    const ecl_region_stat_kw_type * region_kw ,
+                                    const ecl_region_stat_kw_type * value_kw ,
+                                    const ecl_region_stat_kw_type * weight_kw ,
+                                    int active1 , int active2) {
+  const int num_regions = region_stat->num_regions;
+  int active_index;
+
+  for (active_index = active1; active_index < active2; active_index++) {
+    int global_index = ecl_grid_get_global_index1A( grid , active_index );
+    int region = ecl_region_stat_lookup( region_stat , ecl_region_stat_region_iget( region_kw , active_index , global_index ));
+    double weight = weight_kw ? ecl_region_stat_kw_iget( weight_kw , active_index , global_index ) : 1.0;
+    bool first = (region_stat->count[region] == 0);
+    int value_nr;
+
+    region_stat->count[region]++;
+    region_stat->weight[region] += weight;
+    for (value_nr = 0; value_nr < region_stat->num_values; value_nr++) {
+      int offset = value_nr * num_regions + region;
+      double value = ecl_region_stat_kw_iget( &value_kw[value_nr] , active_index , global_index );
+
+      region_stat->sum[offset] += weight * value;
+      if (first) {
+        region_stat->min[offset] = value;
+        region_stat->max[offset] = value;
+      } else {
+        region_stat->min[offset] = util_double_min( region_stat->min[offset] , value );
+        region_stat->max[offset] = util_double_max( region_stat->max[offset] , value );
+      }
+    }
+  }
+}
+
+
+static void ecl_region_stat_merge( ecl_region_stat_type * region_stat , const ecl_region_stat_type * chunk_stat ) {
+  const int num_regions = region_stat->num_regions;
+  int region;
+
+  for (region = 0; region < num_regions; region++) {
+    if (chunk_stat->count[region] > 0) {
+      bool first = (region_stat->count[region] == 0);
+      int value_nr;
+
+      region_stat->count[region] += chunk_stat->count[region];
+      region_stat->weight[region] += chunk_stat->weight[region];
+      for (value_nr = 0; value_nr < region_stat->num_values; value_nr++) {
+        int offset = value_nr * num_regions + region;
+
+        region_stat->sum[offset] += chunk_stat->sum[offset];
+        if (first) {
+          region_stat->min[offset] = chunk_stat->min[offset];
+          region_stat->max[offset] = chunk_stat->max[offset];
+        } else {
+          region_stat->min[offset] = util_double_min( region_stat->min[offset] , chunk_stat->min[offset] );
+          region_stat->max[offset] = util_double_max( region_stat->max[offset] , chunk_stat->max[offset] );
+        }
+      }
+    }
+  }
+}
+
+
+static int ecl_region_stat_cmp( const void * arg1 , const void * arg2 ) {
+  int value1 = *((const int *) arg1);
+  int value2 = *((const int *) arg2);
+
+  if (value1 < value2)
+    return -1;
+  else if (value1 > value2)
+    return 1;
+  else
+    return 0;
+}
+
+
+/*
+  Returns the sorted distinct region values of the active cells, the
+  number of distinct values is returned in *num_regions.
+*/
+
+static int * ecl_region_stat_alloc_region_values( const ecl_grid_type * grid , const ecl_region_stat_kw_type * region_kw , int * num_regions) {
+  const int active_size = ecl_grid_get_active_size( grid );
+  int * region_values = util_calloc( active_size , sizeof * region_values );
+  int active_index;
+  int size = 0;
+
+  for (active_index = 0; active_index < active_size; active_index++) {
+    int global_index = ecl_grid_get_global_index1A( grid , active_index );
+    region_values[active_index] = ecl_region_stat_region_iget( region_kw , active_index , global_index );
+  }
+  qsort( region_values , active_size , sizeof * region_values , ecl_region_stat_cmp );
+
+  for (active_index = 0; active_index < active_size; active_index++) {
+    if ((size == 0) || (region_values[size - 1] != region_values[active_index]))
+      region_values[size++] = region_values[active_index];
+  }
+
+  *num_regions = size;
+  return util_realloc( region_values , util_int_max( 1 , size ) * sizeof * region_values );
+}
+
+
+ecl_region_stat_type * ecl_region_stat_alloc( const ecl_grid_type * grid , const ecl_kw_type * region_kw , int num_values , const ecl_kw_type ** value_kw , const ecl_kw_type * weight_kw) {
+  const int active_size = ecl_grid_get_active_size( grid );
+  ecl_region_stat_kw_type   region_stat_kw;
+  ecl_region_stat_kw_type   weight_stat_kw;
+  ecl_region_stat_kw_type * value_stat_kw = util_calloc( util_int_max( 1 , num_values ) , sizeof * value_stat_kw );
+  ecl_region_stat_type    * region_stat;
+  int * region_values = NULL;
+  int min_region = 0;
+  int max_region = -1;
+  int num_regions;
+
+  ecl_region_stat_init_kw( &region_stat_kw , grid , region_kw );
+  if (region_stat_kw.ecl_type != ECL_INT_TYPE)
+    util_abort("%s: region keyword:%s must be of integer type \n",__func__ , ecl_kw_get_header( region_kw ));
+
+  if (weight_kw)
+    ecl_region_stat_init_kw( &weight_stat_kw , grid , weight_kw );
+
+  {
+    int value_nr;
+    for (value_nr = 0; value_nr < num_values; value_nr++)
+      ecl_region_stat_init_kw( &value_stat_kw[value_nr] , grid , value_kw[value_nr] );
+  }
+
+  /* Find the range of region values among the active cells. */
+  {
+    int active_index;
+    for (active_index = 0; active_index < active_size; active_index++) {
+      int global_index = ecl_grid_get_global_index1A( grid , active_index );
+      int region = ecl_region_stat_region_iget( &region_stat_kw , active_index , global_index );
+
+      if (active_index == 0) {
+        min_region = region;
+        max_region = region;
+      } else {
+        min_region = util_int_min( min_region , region );
+        max_region = util_int_max( max_region , region );
+      }
+    }
+  }
+
+  /*
+    The range is computed in 64 bit, INT_MIN .. INT_MAX would overflow
+    an int.
+  */
+  {
+    int64_t range = (int64_t) max_region - min_region + 1;
+    if (range > ECL_REGION_STAT_MAX_DENSE)
+      region_values = ecl_region_stat_alloc_region_values( grid , &region_stat_kw , &num_regions );
+    else
+      num_regions = range;
+  }
+
+  region_stat = ecl_region_stat_alloc_empty( num_values , min_region , num_regions , region_values );
+  if (active_size > 0) {
+    const int num_chunks = (num_regions > ECL_REGION_STAT_MAX_DENSE) ? 1 : util_int_min( ECL_REGION_STAT_MAX_CHUNKS , (active_size + ECL_REGION_STAT_CHUNK_SIZE - 1) / ECL_REGION_STAT_CHUNK_SIZE );
+    const int chunk_size = (active_size + num_chunks - 1) / num_chunks;
+    ecl_region_stat_type ** chunk_stat = util_calloc( num_chunks , sizeof * chunk_stat );
+    int chunk;
+
+#pragma omp parallel for schedule(dynamic) if (num_chunks > 1)
+    for (chunk = 0; chunk < num_chunks; chunk++) {
+      int active1 = chunk * chunk_size;
+      int active2 = util_int_min( active_size , active1 + chunk_size );
+
+      chunk_stat[chunk] = ecl_region_stat_alloc_empty( num_values , min_region , num_regions , region_values );
+      ecl_region_stat_reduce( chunk_stat[chunk] , grid , &region_stat_kw , value_stat_kw , weight_kw ? &weight_stat_kw : NULL , active1 , active2 );
+    }
+
+    for (chunk = 0; chunk < num_chunks; chunk++) {
+      ecl_region_stat_merge( region_stat , chunk_stat[chunk] );
+      ecl_region_stat_free( chunk_stat[chunk] );
+    }
+    free( chunk_stat );
+  }
+
+  free( region_values );
+  free( value_stat_kw );
+  return region_stat;
+}
+
+
+/*****************************************************************/
+
+int ecl_region_stat_get_num_values( const ecl_region_stat_type * region_stat ) {
+  return region_stat->num_values;
+}
+
+
+/*
+  The smallest and largest region value found among the active
+  cells. If the grid has no active cells max_region < min_region.
+*/
+
+int ecl_region_stat_get_min_region( const ecl_region_stat_type * region_stat ) {
+  return region_stat->min_region;
+}
+
+
+int ecl_region_stat_get_max_region( const ecl_region_stat_type * region_stat ) {
+  if (region_stat->region_values)
+    return region_stat->region_values[ region_stat->num_regions - 1 ];
+  else
+    return region_stat->min_region + region_stat->num_regions - 1;
+}
+
+
+/*
+  The regions are numbered [0, num_regions) in increasing order of
+  region value. For a dense range this includes the values between
+  min_region and max_region without any cells.
+*/
+
+int ecl_region_stat_get_num_regions( const ecl_region_stat_type * region_stat ) {
+  return region_stat->num_regions;
+}
+
+
+int ecl_region_stat_iget_region( const ecl_region_stat_type * region_stat , int index ) {
+  if ((index < 0) || (index >= region_stat->num_regions))
+    util_abort("%s: invalid index:%d - valid range: [0,%d) \n",__func__ , index , region_stat->num_regions);
+
+  if (region_stat->region_values)
+    return region_stat->region_values[index];
+  else
+    return region_stat->min_region + index;
+}
+
+
+/*
+  Returns the internal index of region_value, or -1 if no cells have
+  this region value.
+*/
+
+static int ecl_region_stat_get_region_index( const ecl_region_stat_type * region_stat , int region_value ) {
+  int region = ecl_region_stat_lookup( region_stat , region_value );
+  if ((region >= 0) && (region_stat->count[region] > 0))
+    return region;
+  else
+    return -1;
+}
+
+
+static int ecl_region_stat_get_offset( const ecl_region_stat_type * region_stat , int value_nr , int region_value ) {
+  if ((value_nr < 0) || (value_nr >= region_stat->num_values))
+    util_abort("%s: invalid value_nr:%d - valid range: [0,%d) \n",__func__ , value_nr , region_stat->num_values);
+  {
+    int region = ecl_region_stat_get_region_index( region_stat , region_value );
+    if (region >= 0)
+      return value_nr * region_stat->num_regions + region;
+    else
+      return -1;
+  }
+}
+
+
+int ecl_region_stat_get_count( const ecl_region_stat_type * region_stat , int region_value ) {
+  int region = ecl_region_stat_get_region_index( region_stat , region_value );
+  return (region >= 0) ? region_stat->count[region] : 0;
+}
+
+
+/*
+  The sum of the weights; i.e. the pore volume or bulk volume of the
+  region, or the number of cells when no weight keyword was given.
+*/
+
+double ecl_region_stat_get_weight( const ecl_region_stat_type * region_stat , int region_value ) {
+  int region = ecl_region_stat_get_region_index( region_stat , region_value );
+  return (region >= 0) ? region_stat->weight[region] : 0;
+}
+
+
+double ecl_region_stat_iget_sum( const ecl_region_stat_type * region_stat , int value_nr , int region_value ) {
+  int offset = ecl_region_stat_get_offset( region_stat , value_nr , region_value );
+  return (offset >= 0) ? region_stat->sum[offset] : 0;
+}
+
+
+double ecl_region_stat_iget_mean( const ecl_region_stat_type * region_stat , int value_nr , int region_value ) {
+  int offset = ecl_region_stat_get_offset( region_stat , value_nr , region_value );
+  if (offset >= 0) {
+    double weight = ecl_region_stat_get_weight( region_stat , region_value );
+    return (weight != 0) ? region_stat->sum[offset] / weight : 0;
+  } else
+    return 0;
+}
+
+
+double ecl_region_stat_iget_min( const ecl_region_stat_type * region_stat , int value_nr , int region_value ) {
+  int offset = ecl_region_stat_get_offset( region_stat , value_nr , region_value );
+  return (offset >= 0) ? region_stat->min[offset] : 0;
+}
+
+
+double ecl_region_stat_iget_max( const ecl_region_stat_type * region_stat , int value_nr , int region_value ) {
+  int offset = ecl_region_stat_get_offset( region_stat , value_nr , region_value );
+  return (offset >= 0) ? region_stat->max[offset] : 0;
+}
@@ -140,6 +140,8 @@ struct ecl_smspec_struct {
   float_vector_type * params_default;
 
   char              * restart_case;
+  int_vector_type   * file_index;                    /* When loaded with a key filter: the position in the PARAMS vector on file for each params_index; otherwise NULL. */
+  int                 file_params_size;              /* The size of the PARAMS vector on file. */
 };
 
 
@@ -273,6 +275,8 @@ static ecl_smspec_type * ecl_smspec_alloc_empty(bool write_mode , const char * k
   ecl_smspec->params_default = float_vector_alloc(0 , PARAMS_GLOBAL_DEFAULT);
   ecl_smspec->write_mode = write_mode;
   ecl_smspec->need_nums = false;
+  ecl_smspec->file_index = NULL;
+  ecl_smspec->file_params_size = 0;
 
   return ecl_smspec;
 }
@@ -1073,7 +1077,48 @@ static bool ecl_smspec_check_header( ecl_file_type * header ) {
 }
 
 
-static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * header_file , bool include_restart) {
+/*
+  Loading with a key filter: only the nodes where the gen_key1 or
+  gen_key2 key matches one of the patterns in @key_filter are
+  internalized, in addition to the nodes with time information, which
+  are always required. The selected nodes get consecutive params_index
+  values, and the position of the corresponding element in the PARAMS
+  vector on file is stored in the file_index vector; the data loader
+  reads only those elements from the file.
+*/
+
+static bool ecl_smspec_node_selected( const smspec_node_type * smspec_node , const stringlist_type * key_filter) {
+  if (key_filter == NULL)
+    return true;
+
+  {
+    const char * keyword = smspec_node_get_keyword( smspec_node );
+    if (util_string_equal( keyword , "TIME" ) ||
+        util_string_equal( keyword , "DAY" )  ||
+        util_string_equal( keyword , "MONTH" ) ||
+        util_string_equal( keyword , "YEAR" ))
+      return true;
+  }
+
+  {
+    const char * gen_key1 = smspec_node_get_gen_key1( smspec_node );
+    const char * gen_key2 = smspec_node_get_gen_key2( smspec_node );
+    int i;
+
+    for (i=0; i < stringlist_get_size( key_filter ); i++) {
+      const char * pattern = stringlist_iget( key_filter , i );
+      if (gen_key1 && (util_fnmatch( pattern , gen_key1 ) == 0))
+        return true;
+
+      if (gen_key2 && (util_fnmatch( pattern , gen_key2 ) == 0))
+        return true;
+    }
+  }
+  return false;
+}
+
+
+static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * header_file , bool include_restart , const stringlist_type * key_filter) {
   ecl_file_type * header = ecl_file_open( header_file , 0);
   if (header && ecl_smspec_check_header( header )) {
     ecl_kw_type *wells     = ecl_file_iget_named_kw(header, WGNAMES_KW  , 0);
@@ -1114,6 +1159,9 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
     ecl_smspec->grid_dims[1] = ecl_kw_iget_int(dimens , DIMENS_SMSPEC_NY_INDEX );
     ecl_smspec->grid_dims[2] = ecl_kw_iget_int(dimens , DIMENS_SMSPEC_NZ_INDEX );
     ecl_smspec_set_params_size( ecl_smspec , ecl_kw_get_size(keywords));
+    ecl_smspec->file_params_size = ecl_kw_get_size(keywords);
+    if (key_filter)
+      ecl_smspec->file_index = int_vector_alloc( 0 , 0 );
 
     ecl_util_get_file_type( header_file , &ecl_smspec->formatted , NULL );
 
@@ -1141,7 +1189,14 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
 
         if (smspec_node != NULL) {
           /** OK - we know this is valid shit. */
-          ecl_smspec_add_node( ecl_smspec , smspec_node );
+          if (ecl_smspec_node_selected( smspec_node , key_filter )) {
+            if (key_filter) {
+              smspec_node_set_params_index( smspec_node , int_vector_size( ecl_smspec->file_index ));
+              int_vector_append( ecl_smspec->file_index , params_index );
+            }
+            ecl_smspec_add_node( ecl_smspec , smspec_node );
+          } else
+            smspec_node_free( smspec_node );
         }
 
         free( kw );
@@ -1151,6 +1206,11 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
       }
     }
 
+    if (key_filter) {
+      ecl_smspec->params_size = int_vector_size( ecl_smspec->file_index );
+      float_vector_resize( ecl_smspec->params_default , ecl_smspec->params_size );
+    }
+
     ecl_smspec->header_file = util_alloc_realpath( header_file );
     if (include_restart)
       ecl_smspec_load_restart( ecl_smspec , header );
@@ -1164,7 +1224,13 @@ static bool ecl_smspec_fread_header(ecl_smspec_type * ecl_smspec, const char * h
 
 
 
-ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * key_join_string , bool include_restart) {
+/*
+  Loads the header; if @key_filter is different from NULL only the
+  nodes matching the patterns in @key_filter are loaded, see
+  ecl_smspec_node_selected().
+*/
+
+ecl_smspec_type * ecl_smspec_fread_alloc_filtered(const char *header_file, const char * key_join_string , bool include_restart , const stringlist_type * key_filter) {
   ecl_smspec_type *ecl_smspec;
 
   {
@@ -1174,7 +1240,7 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
     util_safe_free(path);
   }
 
-  if (ecl_smspec_fread_header(ecl_smspec , header_file , include_restart)) {
+  if (ecl_smspec_fread_header(ecl_smspec , header_file , include_restart , key_filter)) {
 
     if (hash_has_key( ecl_smspec->misc_var_index , "TIME")) {
       const smspec_node_type * time_node = hash_get(ecl_smspec->misc_var_index , "TIME");
@@ -1214,6 +1280,30 @@ ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * k
 }
 
 
+ecl_smspec_type * ecl_smspec_fread_alloc(const char *header_file, const char * key_join_string , bool include_restart) {
+  return ecl_smspec_fread_alloc_filtered( header_file , key_join_string , include_restart , NULL );
+}
+
+
+/*
+  Returns the position in the PARAMS vector on file for each
+  params_index, or NULL if all the parameters on file have been
+  loaded and the params_index is the position in the file.
+*/
+
+const int_vector_type * ecl_smspec_get_file_index( const ecl_smspec_type * smspec ) {
+  return smspec->file_index;
+}
+
+
+int ecl_smspec_get_file_params_size( const ecl_smspec_type * smspec ) {
+  if (smspec->file_index)
+    return smspec->file_params_size;
+  else
+    return smspec->params_size;
+}
+
+
 int ecl_smspec_get_num_groups(const ecl_smspec_type * ecl_smspec) {
   return hash_get_size(ecl_smspec->group_var_index);
 }
@@ -1613,6 +1703,8 @@ void ecl_smspec_free(ecl_smspec_type *ecl_smspec) {
   hash_free(ecl_smspec->gen_var_index);
   util_safe_free( ecl_smspec->header_file );
   int_vector_free( ecl_smspec->index_map );
+  if (ecl_smspec->file_index)
+    int_vector_free( ecl_smspec->file_index );
   float_vector_free( ecl_smspec->params_default );
   vector_free( ecl_smspec->smspec_nodes );
   free( ecl_smspec->restart_case );
@@ -105,6 +105,7 @@ struct ecl_sum_struct {
   char              * base;       /* Only the basename. */
   char              * ecl_case;   /* This is the current case, with optional path component. == path + base*/
   char              * ext;        /* Only to support selective loading of formatted|unformatted and unified|multiple. (can be NULL) */
+  stringlist_type   * key_filter; /* Only the keys matching these patterns are loaded; NULL to load all keys. */
 };
 
 
@@ -162,6 +163,7 @@ static ecl_sum_type * ecl_sum_alloc__( const char * input_arg , const char * key
 
   ecl_sum->smspec = NULL;
   ecl_sum->data   = NULL;
+  ecl_sum->key_filter = NULL;
 
   return ecl_sum;
 }
@@ -172,6 +174,7 @@ static bool ecl_sum_fread_data( ecl_sum_type * ecl_sum , const stringlist_type *
     ecl_sum_free_data( ecl_sum );
 
   ecl_sum->data = ecl_sum_data_alloc( ecl_sum->smspec );
+  ecl_sum_data_set_columnar( ecl_sum->data , true );
   if (ecl_sum_data_fread( ecl_sum->data , data_files )) {
     if (include_restart) {
 
@@ -183,7 +186,7 @@ static bool ecl_sum_fread_data( ecl_sum_type * ecl_sum , const stringlist_type *
 
 
 static void ecl_sum_fread_history( ecl_sum_type * ecl_sum ) {
-  ecl_sum_type * history = ecl_sum_fread_alloc_case__( ecl_smspec_get_restart_case( ecl_sum->smspec ) , ":" , true);
+  ecl_sum_type * history = ecl_sum_fread_alloc_case_filtered( ecl_smspec_get_restart_case( ecl_sum->smspec ) , ":" , true , ecl_sum->key_filter);
   if (history) {
     ecl_sum_data_add_case(ecl_sum->data , history->data );
     ecl_sum_free( history );
@@ -193,7 +196,7 @@ static void ecl_sum_fread_history( ecl_sum_type * ecl_sum ) {
 
 
 static bool ecl_sum_fread(ecl_sum_type * ecl_sum , const char *header_file , const stringlist_type *data_files , bool include_restart) {
-  ecl_sum->smspec = ecl_smspec_fread_alloc( header_file , ecl_sum->key_join_string , include_restart);
+  ecl_sum->smspec = ecl_smspec_fread_alloc_filtered( header_file , ecl_sum->key_join_string , include_restart , ecl_sum->key_filter);
   if (ecl_sum->smspec) {
     bool fmt_file;
     ecl_util_get_file_type( header_file , &fmt_file , NULL);
@@ -249,7 +252,20 @@ static bool ecl_sum_fread_case( ecl_sum_type * ecl_sum , bool include_restart) {
 
 
 ecl_sum_type * ecl_sum_fread_alloc(const char *header_file , const stringlist_type *data_files , const char * key_join_string) {
+  return ecl_sum_fread_alloc_filtered( header_file , data_files , key_join_string , NULL );
+}
+
+
+/*
+  As ecl_sum_fread_alloc(), but only the keys matching the patterns in
+  @key_filter are loaded; see ecl_sum_fread_alloc_case_filtered().
+*/
+
+ecl_sum_type * ecl_sum_fread_alloc_filtered(const char *header_file , const stringlist_type *data_files , const char * key_join_string , const stringlist_type * key_filter) {
   ecl_sum_type * ecl_sum = ecl_sum_alloc__( header_file , key_join_string );
+  if (key_filter)
+    ecl_sum->key_filter = stringlist_alloc_deep_copy( key_filter );
+
   ecl_sum_fread( ecl_sum , header_file , data_files , false );
   return ecl_sum;
 }
@@ -356,6 +372,8 @@ void ecl_sum_free( ecl_sum_type * ecl_sum ) {
   free( ecl_sum->ecl_case );
 
   free( ecl_sum->key_join_string );
+  if (ecl_sum->key_filter)
+    stringlist_free( ecl_sum->key_filter );
   free( ecl_sum );
 }
 
@@ -390,7 +408,25 @@ void ecl_sum_free__(void * __ecl_sum) {
 
 
 ecl_sum_type * ecl_sum_fread_alloc_case__(const char * input_file , const char * key_join_string , bool include_restart){
+  return ecl_sum_fread_alloc_case_filtered( input_file , key_join_string , include_restart , NULL );
+}
+
+
+/**
+   As ecl_sum_fread_alloc_case__(), but only the summary vectors where
+   the key matches one of the (wildcard) patterns in @key_filter are
+   loaded, e.g. {"WOPR:*" , "FOPT"}. The time information is always
+   loaded. Only the selected elements of the PARAMS vectors are read
+   from the files, so memory usage and load time are proportional to
+   the number of selected keys. If @key_filter is NULL all the keys
+   are loaded.
+*/
+
+ecl_sum_type * ecl_sum_fread_alloc_case_filtered(const char * input_file , const char * key_join_string , bool include_restart , const stringlist_type * key_filter){
   ecl_sum_type * ecl_sum     = ecl_sum_alloc__(input_file , key_join_string);
+  if (key_filter)
+    ecl_sum->key_filter = stringlist_alloc_deep_copy( key_filter );
+
   if (ecl_sum_fread_case( ecl_sum , include_restart))
     return ecl_sum;
   else {
@@ -201,6 +201,25 @@
       ecl_sum_data_get_xxx : Expects the time direction given as a ministep_nr.
       ecl_sum_data_iget_xxx: Expects the time direction given as an internal index.
 
+
+
+   Row and columnar storage
+   ------------------------
+   When the data is loaded each ministep is stored as one PARAMS row
+   in an ecl_sum_tstep instance. Extracting the time series for one
+   key from this layout means visiting every row, which is slow when
+   there are many keys and many ministeps. In columnar mode the data
+   is transposed when the index is built, so that the time series of
+   each parameter is one contiguous vector:
+
+        columns[ params_index * column_length + internal_index ]
+
+   The tsteps are kept, but only hold a strided view into the columns;
+   i.e. all the ecl_sum_tstep functions work as before. The columns
+   are rebuilt each time the index is rebuilt; tsteps which have been
+   added without a rebuild of the index (see ecl_sum_data_add_new_tstep())
+   keep their own rows and the columns are not used until the next
+   rebuild.
 */
 
 
@@ -225,9 +244,16 @@ struct ecl_sum_data_struct {
   time_interval_type     * sim_time;               /* The time interval sim_time goes from the first time value where we have
                                                       data to the end of the simulation. In the case of restarts the start
                                                       value might disagree with the simulation start reported by the smspec file. */
+  bool                     columnar;               /* Should the data be stored in columns when the index is built? */
+  float                  * columns;                /* The columnar storage; NULL when the tsteps own their data. */
+  int                      column_length;          /* The number of tsteps stored in columns. */
 };
 
 
+#define COLUMN_TILE_TSTEPS 64
+#define COLUMN_TILE_PARAMS 256
+
+
 
 
 
@@ -235,6 +261,7 @@ struct ecl_sum_data_struct {
 
  void ecl_sum_data_free( ecl_sum_data_type * data ) {
   vector_free( data->data );
+  free( data->columns );
   int_vector_free( data->report_first_index );
   int_vector_free( data->report_last_index  );
   time_interval_free( data->sim_time );
@@ -268,6 +295,9 @@ ecl_sum_data_type * ecl_sum_data_alloc(ecl_smspec_type * smspec) {
   data->data        = vector_alloc_new();
   data->smspec      = smspec;
   data->__min_time  = 0;
+  data->columnar    = false;
+  data->columns     = NULL;
+  data->column_length = 0;
 
   data->report_first_index    = int_vector_alloc( 0 , INVALID_MINISTEP_NR );
   data->report_last_index     = int_vector_alloc( 0 , INVALID_MINISTEP_NR );
@@ -306,6 +336,125 @@ static ecl_sum_tstep_type * ecl_sum_data_iget_ministep( const ecl_sum_data_type
 
 
 
+/*
+  Transposes the data of all the tsteps into newly allocated columns,
+  and lets the tsteps view their data in the columns. The transpose is
+  done in tiles of COLUMN_TILE_TSTEPS x COLUMN_TILE_PARAMS elements, so
+  that both the rows which are read and the columns which are written
+  stay in cache. The rows owned by the tsteps are freed as soon as they
+  have been copied.
+
+  The tsteps may already be views into the current columns, in a
+  different order; the old columns are therefor kept until all the
+  tsteps have been updated.
+*/
+
+static void ecl_sum_data_build_columns( ecl_sum_data_type * data ) {
+  const int num_tstep = vector_get_size( data->data );
+  const int params_size = ecl_smspec_get_params_size( data->smspec );
+  float * old_columns = data->columns;
+
+  data->columns = NULL;
+  data->column_length = 0;
+  if ((num_tstep > 0) && (params_size > 0)) {
+    float * columns = util_malloc( (size_t) num_tstep * params_size * sizeof * columns );
+    int tstep1;
+
+    for (tstep1 = 0; tstep1 < num_tstep; tstep1 += COLUMN_TILE_TSTEPS) {
+      const int tstep2 = util_int_min( num_tstep , tstep1 + COLUMN_TILE_TSTEPS );
+      int param1;
+
+      for (param1 = 0; param1 < params_size; param1 += COLUMN_TILE_PARAMS) {
+        const int param2 = util_int_min( params_size , param1 + COLUMN_TILE_PARAMS );
+        int tstep_index;
+
+        for (tstep_index = tstep1; tstep_index < tstep2; tstep_index++) {
+          const ecl_sum_tstep_type * tstep = ecl_sum_data_iget_ministep( data , tstep_index );
+          const float * row = ecl_sum_tstep_get_data_ptr( tstep );
+          const size_t stride = ecl_sum_tstep_get_data_stride( tstep );
+          float * target = &columns[ (size_t) param1 * num_tstep + tstep_index ];
+          int param;
+
+          for (param = param1; param < param2; param++) {
+            *target = row[ (size_t) param * stride ];
+            target += num_tstep;
+          }
+        }
+      }
+
+      if (!old_columns) {
+        int tstep_index;
+        for (tstep_index = tstep1; tstep_index < tstep2; tstep_index++)
+          ecl_sum_tstep_set_data_view( ecl_sum_data_iget_ministep( data , tstep_index ) , &columns[ tstep_index ] , num_tstep );
+      }
+    }
+
+    if (old_columns) {
+      int tstep_index;
+      for (tstep_index = 0; tstep_index < num_tstep; tstep_index++)
+        ecl_sum_tstep_set_data_view( ecl_sum_data_iget_ministep( data , tstep_index ) , &columns[ tstep_index ] , num_tstep );
+    }
+
+    data->columns = columns;
+    data->column_length = num_tstep;
+  }
+  free( old_columns );
+}
+
+
+/*
+  Moves the data back from the columns to rows owned by the tsteps.
+*/
+
+static void ecl_sum_data_free_columns( ecl_sum_data_type * data ) {
+  if (data->columns) {
+    int tstep_index;
+    for (tstep_index = 0; tstep_index < vector_get_size( data->data ); tstep_index++)
+      ecl_sum_tstep_detach_data( ecl_sum_data_iget_ministep( data , tstep_index ));
+
+    free( data->columns );
+    data->columns = NULL;
+    data->column_length = 0;
+  }
+}
+
+
+/*
+  Returns the column with the time series of @params_index, or NULL if
+  the data is not (completely) stored in columns.
+*/
+
+static const float * ecl_sum_data_get_column( const ecl_sum_data_type * data , int params_index ) {
+  if (data->columns && (data->column_length == vector_get_size( data->data ))) {
+    if ((params_index >= 0) && (params_index < ecl_smspec_get_params_size( data->smspec )))
+      return &data->columns[ (size_t) params_index * data->column_length ];
+  }
+  return NULL;
+}
+
+
+/*
+  Selects between row storage and columnar storage; see the
+  documentation at the top of the file. The ecl_sum_data instances
+  loaded from file use columnar storage, whereas the instances created
+  for writing use rows, because the tsteps are appended one at a time.
+*/
+
+void ecl_sum_data_set_columnar( ecl_sum_data_type * data , bool columnar ) {
+  data->columnar = columnar;
+  if (columnar) {
+    if (data->index_valid)
+      ecl_sum_data_build_columns( data );
+  } else
+    ecl_sum_data_free_columns( data );
+}
+
+
+bool ecl_sum_data_is_columnar( const ecl_sum_data_type * data ) {
+  return data->columnar;
+}
+
+
 void ecl_sum_data_report2internal_range(const ecl_sum_data_type * data , int report_step , int * index1 , int * index2 ){
   if (index1 != NULL)
     *index1 = int_vector_safe_iget( data->report_first_index , report_step );
@@ -835,6 +984,9 @@ static void ecl_sum_data_build_index( ecl_sum_data_type * sum_data ) {
     }
   }
   sum_data->index_valid = true;
+
+  if (sum_data->columnar)
+    ecl_sum_data_build_columns( sum_data );
 }
 
 
@@ -925,16 +1077,27 @@ static void ecl_sum_data_add_ecl_file(ecl_sum_data_type * data         ,
 
     for (ikw = 0; ikw < num_ministep; ikw++) {
       ecl_kw_type * ministep_kw = ecl_file_view_iget_named_kw( summary_view , MINISTEP_KW , ikw);
-      ecl_kw_type * params_kw   = ecl_file_view_iget_named_kw( summary_view , PARAMS_KW   , ikw);
 
       {
         ecl_sum_tstep_type * tstep;
         int ministep_nr = ecl_kw_iget_int( ministep_kw , 0 );
-        tstep = ecl_sum_tstep_alloc_from_file( report_step ,
-                                               ministep_nr ,
-                                               params_kw ,
-                                               ecl_file_view_get_src_file( summary_view ),
-                                               smspec );
+
+        /*
+          When the smspec has been loaded with a key filter only the
+          selected elements of the PARAMS keyword are read.
+        */
+        if (ecl_smspec_get_file_index( smspec ))
+          tstep = ecl_sum_tstep_alloc_from_file_index( report_step ,
+                                                       ministep_nr ,
+                                                       summary_view ,
+                                                       ikw ,
+                                                       smspec );
+        else
+          tstep = ecl_sum_tstep_alloc_from_file( report_step ,
+                                                 ministep_nr ,
+                                                 ecl_file_view_iget_named_kw( summary_view , PARAMS_KW , ikw),
+                                                 ecl_file_view_get_src_file( summary_view ),
+                                                 smspec );
 
         if (tstep != NULL) {
           if (load_end == 0 || (ecl_sum_tstep_get_sim_time( tstep ) < load_end))
@@ -1097,6 +1260,7 @@ void ecl_sum_data_fread_restart( ecl_sum_data_type * data , const stringlist_typ
 
 ecl_sum_data_type * ecl_sum_data_fread_alloc( ecl_smspec_type * smspec , const stringlist_type * filelist , bool include_restart) {
   ecl_sum_data_type * data = ecl_sum_data_alloc( smspec );
+  data->columnar = true;
   ecl_sum_data_fread__( data , 0 , filelist );
 
   /*****************************************************************/
@@ -1457,9 +1621,25 @@ time_t_vector_type *  ecl_sum_data_alloc_time_vector( const ecl_sum_data_type *
 
 
 void ecl_sum_data_init_data_vector( const ecl_sum_data_type * data , double_vector_type * data_vector , int data_index , bool report_only) {
+  const float * column = ecl_sum_data_get_column( data , data_index );
   double_vector_reset( data_vector );
   double_vector_append( data_vector , ecl_smspec_get_start_time( data->smspec ));
-  if (report_only) {
+  if (column) {
+    if (report_only) {
+      int report_step;
+      for (report_step = data->first_report_step; report_step <= data->last_report_step; report_step++)
+        double_vector_append( data_vector , column[ int_vector_iget(data->report_last_index , report_step) ]);
+    } else {
+      const int length = data->column_length;
+      double * target;
+      int i;
+
+      double_vector_resize( data_vector , length + 1 );
+      target = double_vector_get_ptr( data_vector ) + 1;
+      for (i = 0; i < length; i++)
+        target[i] = column[i];
+    }
+  } else if (report_only) {
     int report_step;
     for (report_step = data->first_report_step; report_step <= data->last_report_step; report_step++) {
       int last_index = int_vector_iget(data->report_last_index , report_step);
@@ -26,6 +26,8 @@
 #include <ert/ecl/ecl_kw.h>
 #include <ert/ecl/ecl_smspec.h>
 #include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_util.h>
 
 #define ECL_SUM_TSTEP_ID 88631
 
@@ -49,6 +51,12 @@ Header direction: ecl_smspec   DAYS     WWCT:OP_3     FOPT     BPR:15,10,25
   The ecl_sum_tstep structure corresponds to one 'horizontal line' in
   the summary data.
 
+  The tstep will normally own its data as a contiguous PARAMS row. In
+  the columnar storage mode of ecl_sum_data the data of all the tsteps
+  is instead stored as one contiguous vector for each parameter, and
+  the tstep only holds a view into that storage: element @index of the
+  tstep is found at data[index * data_stride].
+
   These timesteps correspond exactly to the simulators timesteps,
   i.e. when convergence is poor they are closely spaced. In the
   ECLIPSE summary files these time steps are called "MINISTEPS" - and
@@ -59,6 +67,8 @@ Header direction: ecl_smspec   DAYS     WWCT:OP_3     FOPT     BPR:15,10,25
 struct ecl_sum_tstep_struct {
   UTIL_TYPE_ID_DECLARATION;
   float                  * data;            /* A memcpy copy of the PARAMS vector in ecl_kw instance - the raw data. */
+  size_t                   data_stride;     /* Distance between consecutive elements in data; 1 when the tstep owns the data. */
+  bool                     data_owner;      /* False when data is a view into the columnar storage of ecl_sum_data. */
   time_t                   sim_time;        /* The true time (i.e. 20.th of october 2010) of corresponding to this timestep. */
   int                      ministep;        /* The ECLIPSE internal time-step number; one ministep per numerical timestep. */
   int                      report_step;     /* The report step this time-step is part of - in general there can be many timestep for each report step. */
@@ -76,10 +86,12 @@ ecl_sum_tstep_type * ecl_sum_tstep_alloc_remap_copy( const ecl_sum_tstep_type *
   target->smspec = new_smspec;
   target->data = util_malloc( params_size * sizeof * target->data );
   target->data_size = params_size;
+  target->data_stride = 1;
+  target->data_owner = true;
   for (int i=0; i < params_size; i++) {
 
     if (params_map[i] >= 0)
-      target->data[i] = src->data[ params_map[i] ];
+      target->data[i] = src->data[ (size_t) params_map[i] * src->data_stride ];
     else
       target->data[i] = default_value;
 
@@ -89,7 +101,11 @@ ecl_sum_tstep_type * ecl_sum_tstep_alloc_remap_copy( const ecl_sum_tstep_type *
 
 ecl_sum_tstep_type * ecl_sum_tstep_alloc_copy( const ecl_sum_tstep_type * src ) {
   ecl_sum_tstep_type * target = util_alloc_copy(src , sizeof * src );
-  target->data = util_alloc_copy( src->data , src->data_size * sizeof * src->data );
+  target->data = util_malloc( src->data_size * sizeof * target->data );
+  target->data_stride = 1;
+  target->data_owner = true;
+  for (int i=0; i < src->data_size; i++)
+    target->data[i] = src->data[ (size_t) i * src->data_stride ];
   return target;
 }
 
@@ -102,6 +118,8 @@ static ecl_sum_tstep_type * ecl_sum_tstep_alloc( int report_step , int ministep_
   tstep->ministep    = ministep_nr;
   tstep->data_size   = ecl_smspec_get_params_size( smspec );
   tstep->data        = util_calloc( tstep->data_size , sizeof * tstep->data );
+  tstep->data_stride = 1;
+  tstep->data_owner  = true;
   return tstep;
 }
 
@@ -111,7 +129,8 @@ UTIL_SAFE_CAST_FUNCTION_CONST( ecl_sum_tstep , ECL_SUM_TSTEP_ID)
 
 
 void ecl_sum_tstep_free( ecl_sum_tstep_type * ministep ) {
-  free( ministep->data );
+  if (ministep->data_owner)
+    free( ministep->data );
   free( ministep );
 }
 
@@ -216,6 +235,48 @@ ecl_sum_tstep_type * ecl_sum_tstep_alloc_from_file( int report_step    ,
 }
 
 
+/*
+  Loads the tstep from PARAMS keyword nr @params_nr in @summary_view
+  for an smspec which has been loaded with a key filter; only the
+  elements in the file index of the smspec are read from the
+  file. For binary files the elements are read directly from the file
+  with ecl_file_view_index_fload_kw(), for formatted files the full
+  PARAMS keyword must be loaded.
+*/
+
+ecl_sum_tstep_type * ecl_sum_tstep_alloc_from_file_index( int report_step ,
+                                                          int ministep_nr ,
+                                                          const ecl_file_view_type * summary_view ,
+                                                          int params_nr ,
+                                                          const ecl_smspec_type * smspec) {
+
+  const int_vector_type * file_index = ecl_smspec_get_file_index( smspec );
+  const char * src_file = ecl_file_view_get_src_file( summary_view );
+  int data_size = ecl_file_view_iget_named_size( summary_view , PARAMS_KW , params_nr );
+
+  if (data_size == ecl_smspec_get_file_params_size( smspec )) {
+    ecl_sum_tstep_type * ministep = ecl_sum_tstep_alloc( report_step , ministep_nr , smspec);
+    bool fmt_file;
+
+    ecl_util_get_file_type( src_file , &fmt_file , NULL );
+    if (fmt_file) {
+      const ecl_kw_type * params_kw = ecl_file_view_iget_named_kw( summary_view , PARAMS_KW , params_nr );
+      const float * params_data = ecl_kw_get_float_ptr( params_kw );
+      int i;
+      for (i=0; i < int_vector_size( file_index ); i++)
+        ministep->data[i] = params_data[ int_vector_iget( file_index , i ) ];
+    } else
+      ecl_file_view_index_fload_kw( summary_view , PARAMS_KW , params_nr , file_index , (char *) ministep->data );
+
+    ecl_sum_tstep_set_time_info( ministep , smspec );
+    return ministep;
+  } else {
+    fprintf(stderr , "** Warning size mismatch between timestep loaded from:%s and header:%s - timestep discarded.\n" , src_file , ecl_smspec_get_header_file( smspec ));
+    return NULL;
+  }
+}
+
+
 /*
   Should be called in write mode.
 */
@@ -235,7 +296,7 @@ ecl_sum_tstep_type * ecl_sum_tstep_alloc_new( int report_step , int ministep , f
 
 double ecl_sum_tstep_iget(const ecl_sum_tstep_type * ministep , int index) {
   if ((index >= 0) && (index < ministep->data_size))
-    return ministep->data[index];
+    return ministep->data[(size_t) index * ministep->data_stride];
   else {
     util_abort("%s: param index:%d invalid: Valid range: [0,%d) \n",__func__ , index , ministep->data_size);
     return -1;
@@ -286,7 +347,7 @@ void ecl_sum_tstep_fwrite( const ecl_sum_tstep_type * ministep , const int_vecto
     {
       int i;
       for (i=0; i < compact_size; i++)
-        data[i] = ministep->data[ index[i] ];
+        data[i] = ministep->data[ (size_t) index[i] * ministep->data_stride ];
     }
     ecl_kw_fwrite( params_kw , fortio );
     ecl_kw_free( params_kw );
@@ -296,9 +357,59 @@ void ecl_sum_tstep_fwrite( const ecl_sum_tstep_type * ministep , const int_vecto
 
 /*****************************************************************/
 
+/*
+  Low level access to the data storage; used by ecl_sum_data to move
+  the data of the tstep in and out of the columnar storage.
+*/
+
+const float * ecl_sum_tstep_get_data_ptr( const ecl_sum_tstep_type * tstep ) {
+  return tstep->data;
+}
+
+
+size_t ecl_sum_tstep_get_data_stride( const ecl_sum_tstep_type * tstep ) {
+  return tstep->data_stride;
+}
+
+
+/*
+  Lets the tstep use the external storage @data, where element @index
+  is found at data[index * stride]; the current data of the tstep is
+  discarded. The external storage is not owned by the tstep, and must
+  stay alive as long as the tstep is using it.
+*/
+
+void ecl_sum_tstep_set_data_view( ecl_sum_tstep_type * tstep , float * data , size_t stride ) {
+  if (tstep->data_owner)
+    free( tstep->data );
+
+  tstep->data = data;
+  tstep->data_stride = stride;
+  tstep->data_owner = false;
+}
+
+
+/*
+  Copies the data from the external storage into a PARAMS row owned
+  by the tstep itself.
+*/
+
+void ecl_sum_tstep_detach_data( ecl_sum_tstep_type * tstep ) {
+  if (!tstep->data_owner) {
+    float * data = util_malloc( tstep->data_size * sizeof * data );
+    for (int i=0; i < tstep->data_size; i++)
+      data[i] = tstep->data[ (size_t) i * tstep->data_stride ];
+
+    tstep->data = data;
+    tstep->data_stride = 1;
+    tstep->data_owner = true;
+  }
+}
+
+
 void ecl_sum_tstep_iset( ecl_sum_tstep_type * tstep , int index , float value) {
   if ((index < tstep->data_size) && (index >= 0))
-    tstep->data[index] = value;
+    tstep->data[(size_t) index * tstep->data_stride] = value;
   else
     util_abort("%s: index:%d invalid. Valid range: [0,%d) \n",__func__  ,index , tstep->data_size);
 }
@@ -388,13 +388,51 @@ ecl_file_enum ecl_util_inspect_extension(const char * ext , bool *_fmt_file, int
 
 ecl_file_enum ecl_util_get_file_type(const char * filename, bool *_fmt_file, int * _report_nr) {
 
+  if (ecl_util_packed_file( filename )) {
+    /*
+      A packed file, e.g. CASE.UNRST.z, has the type of the file it
+      was packed from; the packed container is always binary.
+    */
+    char * plain_file = util_alloc_substring_copy( filename , 0 , strlen( filename ) - strlen( ECL_PACKED_FILE_SUFFIX ));
+    ecl_file_enum file_type = ecl_util_get_file_type( plain_file , _fmt_file , _report_nr );
+    if (_fmt_file != NULL)
+      *_fmt_file = false;
+    free( plain_file );
+    return file_type;
+  }
+
+  {
   char *ext = strrchr(filename , '.');
   if (ext != NULL) {
     ext++;
     return ecl_util_inspect_extension( ext , _fmt_file , _report_nr);
   } else
     return ECL_OTHER_FILE;
+  }
+}
+
+
+/**
+   Files written by the ecl_pack_writer are zlib compressed containers
+   which can only be read by ecl_file_open(); to avoid that other
+   readers mistake them for plain ECLIPSE files they get the suffix
+   ECL_PACKED_FILE_SUFFIX appended to the name of the unformatted
+   file, i.e. CASE.UNRST.z.
+*/
+
+bool ecl_util_packed_file(const char * filename) {
+  const int filename_length = strlen( filename );
+  const int suffix_length = strlen( ECL_PACKED_FILE_SUFFIX );
+
+  if (filename_length > suffix_length)
+    return (strcmp( &filename[ filename_length - suffix_length ] , ECL_PACKED_FILE_SUFFIX ) == 0);
+  else
+    return false;
+}
+
 
+char * ecl_util_alloc_packed_filename(const char * filename) {
+  return util_alloc_sprintf( "%s%s" , filename , ECL_PACKED_FILE_SUFFIX );
 }
 
 
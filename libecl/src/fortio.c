@@ -22,10 +22,14 @@
 #include <string.h>
 #include <errno.h>
 
+#include <ert/util/build_config.h>
 #include <ert/util/util.h>
 #include <ert/util/type_macros.h>
 #include <ert/ecl/fortio.h>
 
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #define FORTIO_ID  345116
 
@@ -90,6 +94,14 @@ struct fortio_struct {
   */
   bool               readable;
   offset_type        read_size;
+
+  /*
+    Optional private memory image of the complete file, see fortio_mmap().
+    The mapping is independent of the stream, i.e. it survives
+    fortio_fclose_stream() and is only released by fortio_fclose().
+  */
+  char             * mmap_data;
+  offset_type        mmap_size;
 };
 
 
@@ -105,6 +117,8 @@ static fortio_type * fortio_alloc__(const char *filename , bool fmt_file , bool
   fortio->stream_owner       = stream_owner;
   fortio->read_size          = 0;
   fortio->readable           = readable;
+  fortio->mmap_data          = NULL;
+  fortio->mmap_size          = 0;
   return fortio;
 }
 
@@ -396,6 +410,7 @@ bool fortio_assert_stream_open( fortio_type * fortio ) {
 
 
 static void fortio_free__(fortio_type * fortio) {
+  fortio_munmap( fortio );
   util_safe_free(fortio->filename);
   free(fortio);
 }
@@ -820,6 +835,82 @@ bool fortio_read_at_eof( fortio_type * fortio ) {
 }
 
 
+/*****************************************************************/
+
+/**
+   Will map the complete file into memory; the mapping is private and
+   writable, i.e. modifications to the mapped memory are never
+   propagated back to the file but are served as copy-on-write pages
+   by the kernel. The function returns false if the file could not be
+   mapped - e.g. on platforms without mmap(), for empty files or if
+   the fortio instance is not opened for reading; the fortio instance
+   is then still fully functional through the ordinary stream based
+   functions.
+
+   Observe that the mapping is a snapshot of the file size when
+   fortio_mmap() is called; data appended to the file after that
+   point is not visible through fortio_mmap_ptr().
+*/
+
+bool fortio_mmap( fortio_type * fortio ) {
+#ifdef HAVE_MMAP
+  if (fortio->mmap_data)
+    return true;
+
+  if (!fortio->readable || (fortio->stream == NULL))
+    return false;
+
+  {
+    offset_type file_size = util_fd_size( fortio_fileno( fortio ));
+    if (file_size > 0) {
+      void * data = mmap( NULL , file_size , PROT_READ | PROT_WRITE , MAP_PRIVATE , fortio_fileno( fortio ) , 0 );
+      if (data != MAP_FAILED) {
+        fortio->mmap_data = data;
+        fortio->mmap_size = file_size;
+        return true;
+      }
+    }
+  }
+#endif
+  return false;
+}
+
+
+void fortio_munmap( fortio_type * fortio ) {
+#ifdef HAVE_MMAP
+  if (fortio->mmap_data) {
+    munmap( fortio->mmap_data , fortio->mmap_size );
+    fortio->mmap_data = NULL;
+    fortio->mmap_size = 0;
+  }
+#endif
+}
+
+
+bool fortio_is_mapped( const fortio_type * fortio ) {
+  return (fortio->mmap_data != NULL);
+}
+
+
+/**
+   Will return a pointer to file offset @offset in the memory mapped
+   image of the file, or NULL if the file is not mapped or @offset is
+   outside the mapped region.
+*/
+
+char * fortio_mmap_ptr( const fortio_type * fortio , offset_type offset ) {
+  if (fortio->mmap_data && (offset >= 0) && (offset < fortio->mmap_size))
+    return &fortio->mmap_data[offset];
+  else
+    return NULL;
+}
+
+
+offset_type fortio_mmap_size( const fortio_type * fortio ) {
+  return fortio->mmap_size;
+}
+
+
 /*****************************************************************/
 void          fortio_fflush(fortio_type * fortio) { fflush( fortio->stream); }
 FILE        * fortio_get_FILE(const fortio_type *fortio)        { return fortio->stream; }
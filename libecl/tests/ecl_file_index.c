@@ -0,0 +1,124 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+
+void write_file( const char * filename , int num_blocks , bool append) {
+  fortio_type * fortio;
+  int block;
+  if (append)
+    fortio = fortio_open_append( filename , false , ECL_ENDIAN_FLIP );
+  else
+    fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+
+  for (block = 0; block < num_blocks; block++) {
+    ecl_kw_type * seqnum = ecl_kw_alloc( "SEQNUM" , 1 , ECL_INT_TYPE );
+    ecl_kw_type * pressure = ecl_kw_alloc( "PRESSURE" , 1500 , ECL_FLOAT_TYPE );
+
+    ecl_kw_iset_int( seqnum , 0 , block );
+    ecl_kw_scalar_set_float( pressure , block * 1.5 );
+    ecl_kw_fwrite( seqnum , fortio );
+    ecl_kw_fwrite( pressure , fortio );
+
+    ecl_kw_free( seqnum );
+    ecl_kw_free( pressure );
+  }
+  fortio_fclose( fortio );
+}
+
+
+void test_equal( const char * filename , int flags ) {
+  ecl_file_type * ref_file = ecl_file_open( filename , 0 );
+  ecl_file_type * ecl_file = ecl_file_open( filename , flags );
+  int i;
+
+  test_assert_int_equal( ecl_file_get_size( ref_file ) , ecl_file_get_size( ecl_file ));
+  test_assert_int_equal( ecl_file_get_num_named_kw( ref_file , "SEQNUM" ) , ecl_file_get_num_named_kw( ecl_file , "SEQNUM" ));
+  for (i=0; i < ecl_file_get_size( ref_file ); i++)
+    test_assert_true( ecl_kw_equal( ecl_file_iget_kw( ref_file , i ) , ecl_file_iget_kw( ecl_file , i )));
+
+  ecl_file_close( ecl_file );
+  ecl_file_close( ref_file );
+}
+
+
+void test_index( ) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_index");
+  char * index_file = ecl_file_alloc_index_filename( "CASE.UNRST" );
+  test_assert_string_equal( index_file , "CASE.UNRST.index" );
+
+  write_file( "CASE.UNRST" , 5 , false );
+  test_equal( "CASE.UNRST" , ECL_FILE_INDEX );
+  test_assert_true( util_file_exists( index_file ));
+
+  /* Loaded from the existing index file. */
+  test_equal( "CASE.UNRST" , ECL_FILE_INDEX );
+
+  /* Appending to the file will invalidate the index. */
+  write_file( "CASE.UNRST" , 2 , true );
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "CASE.UNRST" , ECL_FILE_INDEX );
+    test_assert_int_equal( ecl_file_get_num_named_kw( ecl_file , "SEQNUM" ) , 7 );
+    ecl_file_close( ecl_file );
+  }
+  test_equal( "CASE.UNRST" , ECL_FILE_INDEX );
+
+  /* A corrupt index file is ignored. */
+  {
+    FILE * stream = util_fopen( index_file , "r+");
+    util_ftruncate( stream , util_file_size( index_file ) - 7 );
+    fclose( stream );
+  }
+  test_equal( "CASE.UNRST" , ECL_FILE_INDEX );
+  {
+    FILE * stream = util_fopen( index_file , "w");
+    fprintf(stream , "Not an index file");
+    fclose( stream );
+  }
+  test_equal( "CASE.UNRST" , ECL_FILE_INDEX | ECL_FILE_CLOSE_STREAM );
+
+  /* Explicitly written index file. */
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "CASE.UNRST" , 0 );
+    test_assert_true( ecl_file_write_index( ecl_file , index_file ));
+    test_assert_false( ecl_file_write_index( ecl_file , "does/not/exist/CASE.UNRST.index" ));
+    test_assert_false( util_entry_exists( "does" ));
+    ecl_file_close( ecl_file );
+  }
+  test_equal( "CASE.UNRST" , ECL_FILE_INDEX );
+
+  free( index_file );
+  test_work_area_free( work_area );
+}
+
+
+int main(int argc , char ** argv) {
+  test_index();
+  exit(0);
+}
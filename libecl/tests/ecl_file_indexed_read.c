@@ -0,0 +1,194 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_indexed_read.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/fortio.h>
+
+#define SIZE 5003
+
+
+void create_file( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , true );
+  ecl_kw_type * int_kw    = ecl_kw_alloc( "INT" , SIZE , ECL_INT_TYPE );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "DOUBLE" , SIZE , ECL_DOUBLE_TYPE );
+  ecl_kw_type * char_kw   = ecl_kw_alloc( "CHAR" , 333 , ECL_CHAR_TYPE );
+  int i;
+
+  for (i = 0; i < SIZE; i++) {
+    ecl_kw_iset_int( int_kw , i , 3*i + 1 );
+    ecl_kw_iset_double( double_kw , i , i * 0.125 );
+  }
+  for (i = 0; i < ecl_kw_get_size( char_kw ); i++) {
+    char * s = util_alloc_sprintf( "C%d" , i );
+    ecl_kw_iset_string8( char_kw , i , s );
+    free( s );
+  }
+
+  ecl_kw_fwrite( int_kw , fortio );
+  ecl_kw_fwrite( double_kw , fortio );
+  ecl_kw_fwrite( char_kw , fortio );
+
+  ecl_kw_free( int_kw );
+  ecl_kw_free( double_kw );
+  ecl_kw_free( char_kw );
+  fortio_fclose( fortio );
+}
+
+
+/*
+  The index map is unsorted, has duplicates, spans several Fortran
+  records and has both dense and sparse regions.
+*/
+int_vector_type * alloc_index_map( int size ) {
+  int_vector_type * index_map = int_vector_alloc( 0 , 0 );
+  int i;
+
+  for (i = size - 1; i >= size - 50; i--)
+    int_vector_append( index_map , i );
+
+  for (i = 0; i < size; i += 7)
+    int_vector_append( index_map , i );
+
+  for (i = 990; i < 1010 && i < size; i++)
+    int_vector_append( index_map , i );
+
+  int_vector_append( index_map , 0 );
+  int_vector_append( index_map , size / 2 );
+  int_vector_append( index_map , size / 2 );
+  return index_map;
+}
+
+
+void test_indexed_read( const char * filename , int flags ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , flags );
+  ecl_kw_type * int_kw    = ecl_file_iget_named_kw( ecl_file , "INT" , 0 );
+  ecl_kw_type * double_kw = ecl_file_iget_named_kw( ecl_file , "DOUBLE" , 0 );
+  ecl_kw_type * char_kw   = ecl_file_iget_named_kw( ecl_file , "CHAR" , 0 );
+
+  {
+    int_vector_type * index_map = alloc_index_map( SIZE );
+    int * int_buffer = util_malloc( int_vector_size( index_map ) * sizeof * int_buffer );
+    double * double_buffer = util_malloc( int_vector_size( index_map ) * sizeof * double_buffer );
+    int i;
+
+    ecl_file_indexed_read( ecl_file , "INT" , 0 , index_map , (char *) int_buffer );
+    ecl_file_indexed_read( ecl_file , "DOUBLE" , 0 , index_map , (char *) double_buffer );
+    for (i = 0; i < int_vector_size( index_map ); i++) {
+      int index = int_vector_iget( index_map , i );
+      test_assert_int_equal( int_buffer[i] , ecl_kw_iget_int( int_kw , index ));
+      test_assert_double_equal( double_buffer[i] , ecl_kw_iget_double( double_kw , index ));
+    }
+
+    free( int_buffer );
+    free( double_buffer );
+    int_vector_free( index_map );
+  }
+
+  {
+    int_vector_type * index_map = alloc_index_map( ecl_kw_get_size( char_kw ));
+    char * char_buffer = util_malloc( int_vector_size( index_map ) * 8 );
+    int i;
+
+    ecl_file_indexed_read( ecl_file , "CHAR" , 0 , index_map , char_buffer );
+    for (i = 0; i < int_vector_size( index_map ); i++) {
+      int index = int_vector_iget( index_map , i );
+      test_assert_int_equal( memcmp( &char_buffer[8*i] , ecl_kw_iget_char_ptr( char_kw , index ) , 8 ) , 0 );
+    }
+
+    free( char_buffer );
+    int_vector_free( index_map );
+  }
+
+  {
+    int_vector_type * index_map = int_vector_alloc( 0 , 0 );
+    ecl_file_indexed_read( ecl_file , "INT" , 0 , index_map , NULL );
+    int_vector_free( index_map );
+  }
+
+  ecl_file_close( ecl_file );
+}
+
+
+/*
+  The file grows after it has been mapped; the keyword appended
+  afterwards lies outside the mapping and must be read from the file
+  descriptor instead.
+*/
+
+void test_read_outside_mapping( const char * filename ) {
+  fortio_type * fortio = fortio_open_reader( filename , false , true );
+  offset_type data_offset;
+
+  if (!fortio_mmap( fortio )) {
+    fortio_fclose( fortio );
+    return;
+  }
+  test_assert_true( fortio_is_mapped( fortio ));
+  data_offset = fortio_mmap_size( fortio ) + ECL_KW_HEADER_FORTIO_SIZE;
+
+  {
+    fortio_type * writer = fortio_open_append( filename , false , true );
+    ecl_kw_type * ecl_kw = ecl_kw_alloc( "APPEND" , SIZE , ECL_INT_TYPE );
+    int i;
+    for (i = 0; i < SIZE; i++)
+      ecl_kw_iset_int( ecl_kw , i , 7*i );
+    ecl_kw_fwrite( ecl_kw , writer );
+    ecl_kw_free( ecl_kw );
+    fortio_fclose( writer );
+  }
+
+  {
+    int_vector_type * index_map = alloc_index_map( SIZE );
+    int * int_buffer = util_malloc( int_vector_size( index_map ) * sizeof * int_buffer );
+    int i;
+
+    ecl_kw_fread_indexed_data( fortio , data_offset , ECL_INT_TYPE , SIZE , index_map , (char *) int_buffer );
+    for (i = 0; i < int_vector_size( index_map ); i++)
+      test_assert_int_equal( int_buffer[i] , 7 * int_vector_iget( index_map , i ));
+
+    free( int_buffer );
+    int_vector_free( index_map );
+  }
+  fortio_fclose( fortio );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_indexed_read");
+  create_file( "TEST.INIT" );
+
+  test_indexed_read( "TEST.INIT" , 0 );
+  test_indexed_read( "TEST.INIT" , ECL_FILE_CLOSE_STREAM );
+  test_indexed_read( "TEST.INIT" , ECL_FILE_MMAP );
+
+  create_file( "APPEND.INIT" );
+  test_read_outside_mapping( "APPEND.INIT" );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,219 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_kw_budget.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_kw.h>
+#include <ert/ecl/fortio.h>
+
+#define NUM_KW  40
+#define KW_SIZE 1000
+#define KW_BYTES (KW_SIZE * sizeof(float))
+
+
+void create_file( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , true );
+  int ikw;
+  for (ikw = 0; ikw < NUM_KW; ikw++) {
+    ecl_kw_type * kw = ecl_kw_alloc( "FLOAT" , KW_SIZE , ECL_FLOAT_TYPE );
+    int i;
+    for (i = 0; i < KW_SIZE; i++)
+      ecl_kw_iset_float( kw , i , ikw * KW_SIZE + i );
+    ecl_kw_fwrite( kw , fortio );
+    ecl_kw_free( kw );
+  }
+  fortio_fclose( fortio );
+}
+
+
+void test_kw( const ecl_kw_type * kw , int ikw ) {
+  test_assert_float_equal( ecl_kw_iget_float( kw , 0 ) , ikw * KW_SIZE );
+  test_assert_float_equal( ecl_kw_iget_float( kw , KW_SIZE - 1 ) , ikw * KW_SIZE + KW_SIZE - 1 );
+}
+
+
+void load_all( ecl_file_type * ecl_file , bool release ) {
+  int ikw;
+  for (ikw = 0; ikw < NUM_KW; ikw++) {
+    ecl_kw_type * kw = ecl_file_iget_kw( ecl_file , ikw );
+    test_kw( kw , ikw );
+    if (release)
+      ecl_file_release_kw( ecl_file , kw );
+  }
+}
+
+
+void test_unlimited( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  test_assert_size_t_equal( ecl_file_get_max_kw_bytes( ecl_file ) , 0 );
+  load_all( ecl_file , true );
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , NUM_KW * KW_BYTES );
+
+  /* The released keywords are dropped when a limit is set. */
+  test_assert_true( ecl_file_set_max_kw_bytes( ecl_file , 20 * KW_BYTES ));
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , 20 * KW_BYTES );
+  ecl_file_close( ecl_file );
+}
+
+
+void test_budget( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  ecl_kw_type * pinned_kw;
+
+  test_assert_true( ecl_file_set_max_kw_bytes( ecl_file , 20 * KW_BYTES ));
+  pinned_kw = ecl_file_iget_kw( ecl_file , 0 );
+  ecl_file_pin_kw( ecl_file , pinned_kw );
+
+  load_all( ecl_file , true );
+  test_assert_true( ecl_file_get_loaded_kw_bytes( ecl_file ) <= 20 * KW_BYTES );
+
+  /* Evicted keywords are reloaded transparently. */
+  load_all( ecl_file , true );
+  test_assert_true( ecl_file_get_loaded_kw_bytes( ecl_file ) <= 20 * KW_BYTES );
+
+  /* The pinned keyword has survived, although it has been released. */
+  test_assert_ptr_equal( pinned_kw , ecl_file_iget_kw( ecl_file , 0 ));
+  test_kw( pinned_kw , 0 );
+
+  /* With a very small budget only the pinned keyword is retained. */
+  test_assert_true( ecl_file_set_max_kw_bytes( ecl_file , 1 ));
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , KW_BYTES );
+  test_kw( pinned_kw , 0 );
+
+  ecl_file_release_kw( ecl_file , pinned_kw );
+  ecl_file_unpin_kw( ecl_file , pinned_kw );
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , 0 );
+
+  /* Keywords which have not been released are never dropped. */
+  load_all( ecl_file , false );
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , NUM_KW * KW_BYTES );
+
+  test_assert_true( ecl_file_set_max_kw_bytes( ecl_file , 0 ));
+  load_all( ecl_file , false );
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , NUM_KW * KW_BYTES );
+  ecl_file_close( ecl_file );
+}
+
+
+/*
+  Holds on to more keyword pointers than fit in the budget - like the
+  grid and well loaders do - while other keywords are loaded and
+  released; all the held pointers must stay valid.
+*/
+
+void test_held( const char * filename ) {
+  const int num_held = 30;
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  ecl_kw_type * held[NUM_KW];
+  int ikw;
+
+  test_assert_true( ecl_file_set_max_kw_bytes( ecl_file , 4 * KW_BYTES ));
+  for (ikw = 0; ikw < num_held; ikw++)
+    held[ikw] = ecl_file_iget_kw( ecl_file , ikw );
+
+  for (ikw = num_held; ikw < NUM_KW; ikw++) {
+    ecl_kw_type * kw = ecl_file_iget_kw( ecl_file , ikw );
+    test_kw( kw , ikw );
+    ecl_file_release_kw( ecl_file , kw );
+  }
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , num_held * KW_BYTES );
+
+  for (ikw = 0; ikw < num_held; ikw++) {
+    test_kw( held[ikw] , ikw );
+    test_assert_ptr_equal( held[ikw] , ecl_file_iget_kw( ecl_file , ikw ));
+  }
+
+  /* Over the budget a released keyword is dropped at once, and reloaded when it is accessed again. */
+  ecl_file_release_kw( ecl_file , held[0] );
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , (num_held - 1) * KW_BYTES );
+  held[0] = ecl_file_iget_kw( ecl_file , 0 );
+  test_kw( held[0] , 0 );
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , num_held * KW_BYTES );
+
+  /* A released keyword which is accessed again before it is dropped is retained again. */
+  test_assert_true( ecl_file_set_max_kw_bytes( ecl_file , NUM_KW * KW_BYTES ));
+  ecl_file_release_kw( ecl_file , held[1] );
+  test_assert_ptr_equal( held[1] , ecl_file_iget_kw( ecl_file , 1 ));
+  test_assert_true( ecl_file_set_max_kw_bytes( ecl_file , 4 * KW_BYTES ));
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , num_held * KW_BYTES );
+  test_kw( held[1] , 1 );
+
+  ecl_file_close( ecl_file );
+}
+
+
+void test_writable( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_WRITABLE );
+  test_assert_false( ecl_file_set_max_kw_bytes( ecl_file , KW_BYTES ));
+  ecl_file_close( ecl_file );
+}
+
+
+/*
+  Keywords sharing their data - like zero copy keywords in a mapped
+  file - do not count against the budget, and are not evicted.
+*/
+
+void test_shared( ) {
+  inv_map_type * inv_map = inv_map_alloc( );
+  float * data = util_calloc( KW_SIZE , sizeof * data );
+  ecl_kw_type * shared_kw = ecl_kw_alloc_new_shared( "SHARED" , KW_SIZE , ECL_FLOAT_TYPE , data );
+  ecl_kw_type * owned_kw = ecl_kw_alloc( "OWNED" , KW_SIZE , ECL_FLOAT_TYPE );
+  ecl_file_kw_type * shared_file_kw = ecl_file_kw_alloc( shared_kw , 0 );
+  ecl_file_kw_type * owned_file_kw = ecl_file_kw_alloc( owned_kw , 0 );
+
+  test_assert_true( ecl_kw_data_is_shared( shared_kw ));
+  test_assert_false( ecl_kw_data_is_shared( owned_kw ));
+
+  inv_map_set_max_bytes( inv_map , 1 );
+  ecl_file_kw_set_kw( shared_file_kw , shared_kw , inv_map );
+  ecl_file_kw_set_kw( owned_file_kw , owned_kw , inv_map );
+  test_assert_size_t_equal( inv_map_get_used_bytes( inv_map ) , KW_BYTES );
+
+  inv_map_release_kw( inv_map , shared_kw );
+  inv_map_release_kw( inv_map , owned_kw );
+  test_assert_size_t_equal( inv_map_get_used_bytes( inv_map ) , 0 );
+  test_assert_true( ecl_file_kw_is_loaded( shared_file_kw ));
+  test_assert_false( ecl_file_kw_is_loaded( owned_file_kw ));
+
+  ecl_file_kw_free( owned_file_kw );
+  ecl_file_kw_free( shared_file_kw );
+  inv_map_free( inv_map );
+  free( data );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_kw_budget");
+  create_file( "TEST.INIT" );
+
+  test_unlimited( "TEST.INIT" );
+  test_budget( "TEST.INIT" );
+  test_held( "TEST.INIT" );
+  test_writable( "TEST.INIT" );
+  test_shared( );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,148 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_mmap.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/vector.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+
+
+vector_type * alloc_keywords() {
+  vector_type * kw_list = vector_alloc_new();
+  int i;
+  {
+    ecl_kw_type * kw = ecl_kw_alloc( "INT" , 2500 , ECL_INT_TYPE );
+    for (i=0; i < ecl_kw_get_size( kw ); i++)
+      ecl_kw_iset_int( kw , i , i );
+    vector_append_owned_ref( kw_list , kw , ecl_kw_free__ );
+  }
+  {
+    ecl_kw_type * kw = ecl_kw_alloc( "FLOAT" , 17 , ECL_FLOAT_TYPE );
+    for (i=0; i < ecl_kw_get_size( kw ); i++)
+      ecl_kw_iset_float( kw , i , i * 0.25 );
+    vector_append_owned_ref( kw_list , kw , ecl_kw_free__ );
+  }
+  {
+    ecl_kw_type * kw = ecl_kw_alloc( "DOUBLE" , 1001 , ECL_DOUBLE_TYPE );
+    for (i=0; i < ecl_kw_get_size( kw ); i++)
+      ecl_kw_iset_double( kw , i , i * 0.5 );
+    vector_append_owned_ref( kw_list , kw , ecl_kw_free__ );
+  }
+  {
+    ecl_kw_type * kw = ecl_kw_alloc( "CHAR" , 211 , ECL_CHAR_TYPE );
+    for (i=0; i < ecl_kw_get_size( kw ); i++) {
+      char * s = util_alloc_sprintf("S%d" , i );
+      ecl_kw_iset_string8( kw , i , s );
+      free( s );
+    }
+    vector_append_owned_ref( kw_list , kw , ecl_kw_free__ );
+  }
+  {
+    ecl_kw_type * kw = ecl_kw_alloc( "BOOL" , 10 , ECL_BOOL_TYPE );
+    for (i=0; i < ecl_kw_get_size( kw ); i++)
+      ecl_kw_iset_bool( kw , i , (i % 3) == 0 );
+    vector_append_owned_ref( kw_list , kw , ecl_kw_free__ );
+  }
+  {
+    ecl_kw_type * kw = ecl_kw_alloc( "EMPTY" , 0 , ECL_INT_TYPE );
+    vector_append_owned_ref( kw_list , kw , ecl_kw_free__ );
+  }
+  return kw_list;
+}
+
+
+void write_keywords( const char * filename , const vector_type * kw_list ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int i;
+  for (i=0; i < vector_get_size( kw_list ); i++)
+    ecl_kw_fwrite( vector_iget_const( kw_list , i ) , fortio );
+  fortio_fclose( fortio );
+}
+
+
+void test_load( const char * filename , const vector_type * kw_list , int flags) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , flags );
+  int i;
+  test_assert_int_equal( ecl_file_get_size( ecl_file ) , vector_get_size( kw_list ));
+  for (i=0; i < vector_get_size( kw_list ); i++)
+    test_assert_true( ecl_kw_equal( ecl_file_iget_kw( ecl_file , i ) , vector_iget_const( kw_list , i )));
+  ecl_file_close( ecl_file );
+}
+
+
+void test_detach( const char * filename , const vector_type * kw_list ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_MMAP );
+  ecl_kw_type * kw0 = ecl_file_iget_kw( ecl_file , 0 );
+
+  ecl_file_fortio_detach( ecl_file );
+  unlink( filename );
+  test_assert_true( ecl_kw_equal( kw0 , vector_iget_const( kw_list , 0 )));
+  test_assert_true( ecl_kw_equal( ecl_file_iget_kw( ecl_file , 1 ) , vector_iget_const( kw_list , 1 )));
+  ecl_file_close( ecl_file );
+}
+
+
+void test_fortio_mmap( const char * filename ) {
+  fortio_type * fortio = fortio_open_reader( filename , false , ECL_ENDIAN_FLIP );
+  test_assert_false( fortio_is_mapped( fortio ));
+  test_assert_NULL( fortio_mmap_ptr( fortio , 0 ));
+
+  test_assert_true( fortio_mmap( fortio ));
+  test_assert_true( fortio_is_mapped( fortio ));
+  test_assert_true( fortio_mmap_size( fortio ) == util_file_size( filename ));
+  test_assert_not_NULL( fortio_mmap_ptr( fortio , 0 ));
+  test_assert_NULL( fortio_mmap_ptr( fortio , fortio_mmap_size( fortio )));
+  {
+    ecl_kw_type * kw = ecl_kw_alloc_mmap( fortio_mmap_ptr( fortio , 0 ) , fortio_mmap_size( fortio ));
+    test_assert_true( ecl_kw_is_instance( kw ));
+    test_assert_string_equal( ecl_kw_get_header( kw ) , "INT" );
+    ecl_kw_free( kw );
+  }
+  test_assert_NULL( ecl_kw_alloc_mmap( fortio_mmap_ptr( fortio , 0 ) , 100 ));
+
+  fortio_munmap( fortio );
+  test_assert_false( fortio_is_mapped( fortio ));
+  fortio_fclose( fortio );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_mmap");
+  vector_type * kw_list = alloc_keywords();
+
+  write_keywords( "TEST.UNRST" , kw_list );
+  test_fortio_mmap( "TEST.UNRST" );
+  test_load( "TEST.UNRST" , kw_list , 0 );
+  test_load( "TEST.UNRST" , kw_list , ECL_FILE_MMAP );
+  test_load( "TEST.UNRST" , kw_list , ECL_FILE_MMAP + ECL_FILE_CLOSE_STREAM );
+  test_load( "TEST.UNRST" , kw_list , ECL_FILE_MMAP + ECL_FILE_WRITABLE );
+  test_detach( "TEST.UNRST" , kw_list );
+
+  vector_free( kw_list );
+  test_work_area_free( work_area );
+  exit(0);
+}
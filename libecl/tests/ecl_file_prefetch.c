@@ -0,0 +1,193 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_prefetch.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/stringlist.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_file_prefetch.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_endian_flip.h>
+#include <ert/ecl/fortio.h>
+
+#define NUM_STEPS 10
+#define SIZE      5000
+
+
+static float pressure_value( int step , int i ) {
+  return step * 1000 + i;
+}
+
+static double swat_value( int step , int i ) {
+  return step + i * 0.5;
+}
+
+
+void create_unrst( const char * filename ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , ECL_ENDIAN_FLIP );
+  int step , i;
+
+  for (step = 0; step < NUM_STEPS; step++) {
+    ecl_kw_type * seqnum_kw   = ecl_kw_alloc( SEQNUM_KW , 1 , ECL_INT_TYPE );
+    ecl_kw_type * pressure_kw = ecl_kw_alloc( "PRESSURE" , SIZE , ECL_FLOAT_TYPE );
+    ecl_kw_type * swat_kw     = ecl_kw_alloc( "SWAT" , SIZE , ECL_DOUBLE_TYPE );
+
+    ecl_kw_iset_int( seqnum_kw , 0 , step );
+    for (i = 0; i < SIZE; i++) {
+      ecl_kw_iset_float( pressure_kw , i , pressure_value( step , i ));
+      ecl_kw_iset_double( swat_kw , i , swat_value( step , i ));
+    }
+
+    ecl_kw_fwrite( seqnum_kw , fortio );
+    ecl_kw_fwrite( pressure_kw , fortio );
+    ecl_kw_fwrite( swat_kw , fortio );
+
+    ecl_kw_free( seqnum_kw );
+    ecl_kw_free( pressure_kw );
+    ecl_kw_free( swat_kw );
+  }
+  fortio_fclose( fortio );
+}
+
+
+void test_step( ecl_file_type * ecl_file , int step ) {
+  ecl_file_view_type * view = ecl_file_get_restart_view( ecl_file , step , -1 , -1 , -1 );
+  ecl_kw_type * seqnum_kw   = ecl_file_view_iget_named_kw( view , SEQNUM_KW , 0 );
+  ecl_kw_type * pressure_kw = ecl_file_view_iget_named_kw( view , "PRESSURE" , 0 );
+  ecl_kw_type * swat_kw     = ecl_file_view_iget_named_kw( view , "SWAT" , 0 );
+  int i;
+
+  test_assert_int_equal( ecl_kw_iget_int( seqnum_kw , 0 ) , step );
+  for (i = 0; i < SIZE; i++) {
+    test_assert_float_equal( ecl_kw_iget_float( pressure_kw , i ) , pressure_value( step , i ));
+    test_assert_double_equal( ecl_kw_iget_double( swat_kw , i ) , swat_value( step , i ));
+  }
+}
+
+
+void test_walk( const char * filename , int num_blocks , const stringlist_type * kw_list , size_t max_bytes , int flags) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , flags );
+  int step;
+
+  test_assert_true( ecl_file_enable_prefetch( ecl_file , num_blocks , kw_list , max_bytes ));
+  for (step = 0; step < NUM_STEPS; step++)
+    test_step( ecl_file , step );
+
+  /* Going backwards is served by the ordinary loading. */
+  test_step( ecl_file , 3 );
+  ecl_file_close( ecl_file );
+}
+
+
+void test_prefetch( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  ecl_file_view_type * view = ecl_file_get_global_view( ecl_file );
+  ecl_file_kw_type * file_kw = ecl_file_view_iget_named_file_kw( view , "PRESSURE" , 4 );
+  ecl_file_prefetch_type * prefetch = ecl_file_prefetch_alloc( filename , 1 , NULL , 1024 * 1024 );
+
+  test_assert_true( ecl_file_prefetch_is_instance( prefetch ));
+  test_assert_true( ecl_file_prefetch_add( prefetch , file_kw ));
+  test_assert_false( ecl_file_prefetch_add( prefetch , file_kw ));
+
+  /* Wait until the worker has started on the keyword. */
+  while (ecl_file_prefetch_get_used_bytes( prefetch ) == 0)
+    usleep( 1000 );
+  test_assert_size_t_equal( ecl_file_prefetch_get_used_bytes( prefetch ) , SIZE * sizeof(float));
+
+  {
+    ecl_kw_type * ecl_kw = ecl_file_prefetch_take( prefetch , file_kw );
+    int i;
+    test_assert_true( ecl_kw_is_instance( ecl_kw ));
+    for (i = 0; i < SIZE; i++)
+      test_assert_float_equal( ecl_kw_iget_float( ecl_kw , i ) , pressure_value( 4 , i ));
+    ecl_kw_free( ecl_kw );
+  }
+  test_assert_NULL( ecl_file_prefetch_take( prefetch , file_kw ));
+  test_assert_size_t_equal( ecl_file_prefetch_get_used_bytes( prefetch ) , 0 );
+
+  /* Claiming a keyword drops the unclaimed keywords before it. */
+  {
+    ecl_file_kw_type * skipped_kw = ecl_file_view_iget_named_file_kw( view , "PRESSURE" , 2 );
+    ecl_file_kw_type * claimed_kw = ecl_file_view_iget_named_file_kw( view , "PRESSURE" , 3 );
+    ecl_kw_type * ecl_kw;
+
+    test_assert_true( ecl_file_prefetch_add( prefetch , claimed_kw ));
+    test_assert_true( ecl_file_prefetch_add( prefetch , skipped_kw ));
+    while (ecl_file_prefetch_get_used_bytes( prefetch ) < 2 * SIZE * sizeof(float))
+      usleep( 1000 );
+
+    ecl_kw = ecl_file_prefetch_take( prefetch , claimed_kw );
+    test_assert_true( ecl_kw_is_instance( ecl_kw ));
+    test_assert_float_equal( ecl_kw_iget_float( ecl_kw , 0 ) , pressure_value( 3 , 0 ));
+    test_assert_size_t_equal( ecl_file_prefetch_get_used_bytes( prefetch ) , 0 );
+    test_assert_NULL( ecl_file_prefetch_take( prefetch , skipped_kw ));
+    ecl_kw_free( ecl_kw );
+  }
+
+  ecl_file_prefetch_free( prefetch );
+  ecl_file_close( ecl_file );
+}
+
+
+void test_close_active( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  test_assert_true( ecl_file_enable_prefetch( ecl_file , NUM_STEPS , NULL , 1024 * 1024 ));
+  ecl_file_get_restart_view( ecl_file , 0 , -1 , -1 , -1 );
+  ecl_file_close( ecl_file );
+}
+
+
+void test_not_supported( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_MMAP );
+  test_assert_false( ecl_file_enable_prefetch( ecl_file , 2 , NULL , 1024 * 1024 ));
+  test_step( ecl_file , 1 );
+  ecl_file_close( ecl_file );
+
+  ecl_file = ecl_file_open( filename , ECL_FILE_WRITABLE );
+  test_assert_false( ecl_file_enable_prefetch( ecl_file , 2 , NULL , 1024 * 1024 ));
+  ecl_file_close( ecl_file );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_prefetch");
+  stringlist_type * kw_list = stringlist_alloc_new();
+  stringlist_append_copy( kw_list , "PRESSURE" );
+
+  create_unrst( "TEST.UNRST" );
+
+  test_prefetch( "TEST.UNRST" );
+  test_walk( "TEST.UNRST" , 2 , NULL , 1024 * 1024 , 0 );
+  test_walk( "TEST.UNRST" , 3 , kw_list , 1024 * 1024 , 0 );
+  test_walk( "TEST.UNRST" , 2 , NULL , 1 , 0 );
+  test_walk( "TEST.UNRST" , 2 , NULL , 1024 * 1024 , ECL_FILE_CLOSE_STREAM );
+  test_close_active( "TEST.UNRST" );
+  test_not_supported( "TEST.UNRST" );
+
+  stringlist_free( kw_list );
+  test_work_area_free( work_area );
+  exit(0);
+}
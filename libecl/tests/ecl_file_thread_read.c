@@ -0,0 +1,189 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_file_thread_read.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/thread_pool.h>
+#include <ert/util/arg_pack.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/fortio.h>
+
+#define NUM_READERS 8
+#define NUM_KW      200
+#define KW_SIZE     2500
+
+
+void create_file( const char * filename , bool fmt_file ) {
+  fortio_type * fortio = fortio_open_writer( filename , fmt_file , true );
+  int ikw;
+  for (ikw = 0; ikw < NUM_KW; ikw++) {
+    ecl_kw_type * kw = ecl_kw_alloc( "INT" , KW_SIZE , ECL_INT_TYPE );
+    int i;
+    for (i = 0; i < KW_SIZE; i++)
+      ecl_kw_iset_int( kw , i , ikw * KW_SIZE + i );
+    ecl_kw_fwrite( kw , fortio );
+    ecl_kw_free( kw );
+  }
+  fortio_fclose( fortio );
+}
+
+
+/*
+  Each reader visits the keywords in a different order, and checks
+  the content of every keyword.
+*/
+
+void * read_kw__( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  ecl_file_type * ecl_file = arg_pack_iget_ptr( arg_pack , 0 );
+  int reader = arg_pack_iget_int( arg_pack , 1 );
+  ecl_kw_type ** kw_list = arg_pack_iget_ptr( arg_pack , 2 );
+  int iter;
+
+  for (iter = 0; iter < NUM_KW; iter++) {
+    int ikw = (iter + reader * 37) % NUM_KW;
+    ecl_kw_type * kw;
+
+    if (reader % 2)
+      ikw = NUM_KW - 1 - ikw;
+
+    kw = ecl_file_iget_named_kw( ecl_file , "INT" , ikw );
+    test_assert_int_equal( ecl_kw_iget_int( kw , 0 ) , ikw * KW_SIZE );
+    test_assert_int_equal( ecl_kw_iget_int( kw , KW_SIZE - 1 ) , ikw * KW_SIZE + KW_SIZE - 1 );
+    kw_list[ikw] = kw;
+  }
+  return NULL;
+}
+
+
+void test_threads( const char * filename , int flags ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_THREAD_SAFE | flags );
+  thread_pool_type * tp = thread_pool_alloc( NUM_READERS , true );
+  arg_pack_type * arg_list[NUM_READERS];
+  ecl_kw_type * kw_list[NUM_READERS][NUM_KW];
+  int i;
+
+  test_assert_true( ecl_file_flags_set( ecl_file , ECL_FILE_THREAD_SAFE ));
+  test_assert_false( ecl_file_flags_set( ecl_file , ECL_FILE_CLOSE_STREAM ));
+
+  for (i = 0; i < NUM_READERS; i++) {
+    arg_list[i] = arg_pack_alloc( );
+    arg_pack_append_ptr( arg_list[i] , ecl_file );
+    arg_pack_append_int( arg_list[i] , i );
+    arg_pack_append_ptr( arg_list[i] , kw_list[i] );
+    thread_pool_add_job( tp , read_kw__ , arg_list[i] );
+  }
+  thread_pool_join( tp );
+  thread_pool_free( tp );
+
+  /* Every keyword has been loaded exactly once. */
+  for (i = 0; i < NUM_READERS; i++) {
+    int ikw;
+    for (ikw = 0; ikw < NUM_KW; ikw++)
+      test_assert_ptr_equal( kw_list[i][ikw] , kw_list[0][ikw] );
+    arg_pack_free( arg_list[i] );
+  }
+  test_assert_size_t_equal( ecl_file_get_loaded_kw_bytes( ecl_file ) , NUM_KW * KW_SIZE * sizeof(int) );
+
+  ecl_file_close( ecl_file );
+}
+
+
+/*
+  With a memory budget the readers release every keyword when they
+  are done with it, while the other readers may still be using it;
+  the keywords are pinned with the lookup so that they are not
+  evicted underneath the readers.
+*/
+
+void * read_kw_pinned__( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  ecl_file_type * ecl_file = arg_pack_iget_ptr( arg_pack , 0 );
+  int reader = arg_pack_iget_int( arg_pack , 1 );
+  int iter;
+
+  for (iter = 0; iter < 4 * NUM_KW; iter++) {
+    int ikw = (iter + reader * 37) % NUM_KW;
+    ecl_kw_type * kw = ecl_file_iget_named_kw_pinned( ecl_file , "INT" , ikw );
+    int i;
+
+    for (i = 0; i < KW_SIZE; i += 97)
+      test_assert_int_equal( ecl_kw_iget_int( kw , i ) , ikw * KW_SIZE + i );
+
+    ecl_file_release_kw( ecl_file , kw );
+    test_assert_int_equal( ecl_kw_iget_int( kw , KW_SIZE - 1 ) , ikw * KW_SIZE + KW_SIZE - 1 );
+    ecl_file_unpin_kw( ecl_file , kw );
+  }
+  return NULL;
+}
+
+
+void test_threads_budget( const char * filename , int flags ) {
+  const size_t max_bytes = 10 * KW_SIZE * sizeof(int);
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_THREAD_SAFE | flags );
+  thread_pool_type * tp = thread_pool_alloc( NUM_READERS , true );
+  arg_pack_type * arg_list[NUM_READERS];
+  int i;
+
+  test_assert_true( ecl_file_set_max_kw_bytes( ecl_file , max_bytes ));
+  for (i = 0; i < NUM_READERS; i++) {
+    arg_list[i] = arg_pack_alloc( );
+    arg_pack_append_ptr( arg_list[i] , ecl_file );
+    arg_pack_append_int( arg_list[i] , i );
+    thread_pool_add_job( tp , read_kw_pinned__ , arg_list[i] );
+  }
+  thread_pool_join( tp );
+  thread_pool_free( tp );
+
+  for (i = 0; i < NUM_READERS; i++)
+    arg_pack_free( arg_list[i] );
+
+  test_assert_true( ecl_file_get_loaded_kw_bytes( ecl_file ) <= max_bytes );
+  ecl_file_close( ecl_file );
+}
+
+
+void test_writable( const char * filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , ECL_FILE_THREAD_SAFE | ECL_FILE_WRITABLE );
+  test_assert_false( ecl_file_flags_set( ecl_file , ECL_FILE_THREAD_SAFE ));
+  ecl_file_close( ecl_file );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_file_thread_read");
+  create_file( "TEST.INIT" , false );
+  create_file( "TEST.FINIT" , true );
+
+  test_threads( "TEST.INIT" , 0 );
+  test_threads( "TEST.INIT" , ECL_FILE_CLOSE_STREAM );
+  test_threads( "TEST.INIT" , ECL_FILE_MMAP );
+  test_threads( "TEST.FINIT" , 0 );
+  test_threads_budget( "TEST.INIT" , 0 );
+  test_threads_budget( "TEST.INIT" , ECL_FILE_MMAP );
+  test_threads_budget( "TEST.FINIT" , 0 );
+  test_writable( "TEST.INIT" );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -132,8 +132,47 @@ void list_test() {
 
 
 
+/*
+  The nnc are merged when they are read, and the nnc_info views of
+  the cells which do not get new connections are left alone.
+*/
+
+void view_test() {
+  ecl_grid_type * grid0 = ecl_grid_alloc_rectangular( 10 , 10 , 10 , 1 , 1, 1, NULL );
+  const nnc_info_type * nnc_info5;
+  const int * lgr_nr;
+  const int * global_index;
+  const int * nnc_index;
+
+  test_assert_NULL( ecl_grid_get_cell_nnc_info1( grid0 , 5 ));
+  test_assert_int_equal( 0 , ecl_grid_get_cell_nnc_row( grid0 , 5 , &lgr_nr , &global_index , &nnc_index ));
+
+  ecl_grid_add_self_nnc( grid0 , 5 , 6 , 0 );
+  ecl_grid_add_self_nnc( grid0 , 5 , 7 , 1 );
+  nnc_info5 = ecl_grid_get_cell_nnc_info1( grid0 , 5 );
+  test_assert_not_NULL( nnc_info5 );
+  test_assert_int_equal( 2 , ecl_grid_get_cell_nnc_row( grid0 , 5 , &lgr_nr , &global_index , &nnc_index ));
+  test_assert_int_equal( 7 , global_index[1] );
+  test_assert_int_equal( 1 , nnc_index[1] );
+
+  ecl_grid_add_self_nnc( grid0 , 8 , 9 , 2 );
+  test_assert_ptr_equal( nnc_info5 , ecl_grid_get_cell_nnc_info1( grid0 , 5 ));
+  test_assert_int_equal( 1 , ecl_grid_get_cell_nnc_row( grid0 , 8 , &lgr_nr , &global_index , &nnc_index ));
+  test_assert_int_equal( 9 , global_index[0] );
+  verify_simple_nnc( grid0 );
+
+  ecl_grid_add_self_nnc( grid0 , 5 , 4 , 3 );
+  test_assert_int_equal( 3 , nnc_info_get_total_size( ecl_grid_get_cell_nnc_info1( grid0 , 5 )));
+  test_assert_int_equal( 3 , ecl_grid_get_cell_nnc_row( grid0 , 5 , &lgr_nr , &global_index , &nnc_index ));
+  test_assert_int_equal( 4 , global_index[2] );
+
+  ecl_grid_free( grid0 );
+}
+
+
 int main( int argc , char ** argv) {
   simple_test();
+  view_test();
   list_test();
   overwrite_test();
   exit(0);
@@ -0,0 +1,137 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_block_stat.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/double_vector.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+#define NX 6
+#define NY 5
+#define NZ 4
+#define NUM_POINTS 5000
+
+
+/*
+  The points are spread over a box which is larger than the grid, so
+  some of them are not blocked.
+*/
+
+void create_points( double * x , double * y , double * z , double * value ) {
+  int ip;
+  for (ip = 0; ip < NUM_POINTS; ip++) {
+    x[ip] = -1 + (NX + 2) * ((ip * 37) % 1009) / 1009.0;
+    y[ip] = -1 + (NY + 2) * ((ip * 53) % 997) / 997.0;
+    z[ip] = (NZ + 1) * ((ip * 71) % 983) / 983.0;
+    value[ip] = 1000 + sin( ip );
+  }
+}
+
+
+double block_mean( const double_vector_type * values ) {
+  int size = double_vector_size( values );
+  return (size > 0) ? double_vector_sum( values ) / size : 0;
+}
+
+
+void test_stat( ecl_grid_type * grid , const double * x , const double * y , const double * z , const double * value) {
+  ecl_grid_type * ref_grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+  double * data = util_calloc( NX*NY*NZ , sizeof * data );
+  int num_blocked = 0;
+  int ip , g;
+
+  ecl_grid_alloc_blocking_variables( ref_grid , 3 );
+  for (ip = 0; ip < NUM_POINTS; ip++)
+    if (ecl_grid_block_value_3d( ref_grid , x[ip] , y[ip] , z[ip] , value[ip] ))
+      num_blocked++;
+
+  ecl_grid_alloc_blocking_accumulators( grid );
+  test_assert_int_equal( ecl_grid_block_values_3d( grid , NUM_POINTS , x , y , z , value ) , num_blocked );
+  test_assert_true( num_blocked < NUM_POINTS );
+
+  ecl_grid_init_block_stat_data( grid , ECL_GRID_BLOCK_MEAN , data );
+  for (g = 0; g < NX*NY*NZ; g++) {
+    int i,j,k;
+    double_vector_type * values = double_vector_alloc( 0 , 0 );
+    ecl_grid_get_ijk1( grid , g , &i , &j , &k );
+
+    test_assert_int_equal( ecl_grid_get_block_count3d( grid , i , j , k ) , ecl_grid_get_block_count3d( ref_grid , i , j , k ));
+    test_assert_int_equal( (int) ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_COUNT ) , ecl_grid_get_block_count3d( ref_grid , i , j , k ));
+    test_assert_double_equal( ecl_grid_block_eval3d( ref_grid , i , j , k , block_mean ) , ecl_grid_get_block_stat3( grid , i , j , k , ECL_GRID_BLOCK_MEAN ));
+    test_assert_true( data[g] == ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_MEAN ));
+
+    for (ip = 0; ip < NUM_POINTS; ip++)
+      if (ecl_grid_get_global_index_from_xyz( ref_grid , x[ip] , y[ip] , z[ip] , 0 ) == g)
+        double_vector_append( values , value[ip] );
+
+    if (double_vector_size( values ) > 0) {
+      double mean = double_vector_sum( values ) / double_vector_size( values );
+      double var = 0;
+      for (ip = 0; ip < double_vector_size( values ); ip++)
+        var += (double_vector_iget( values , ip ) - mean) * (double_vector_iget( values , ip ) - mean);
+      var /= double_vector_size( values );
+
+      test_assert_double_equal( ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_SUM ) , double_vector_sum( values ));
+      test_assert_double_equal( ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_VARIANCE ) , var );
+      test_assert_double_equal( ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_STD ) , sqrt( var ));
+      test_assert_true( ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_MIN ) == double_vector_get_min( values ));
+      test_assert_true( ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_MAX ) == double_vector_get_max( values ));
+    } else
+      test_assert_true( ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_MAX ) == 0 );
+
+    double_vector_free( values );
+  }
+
+  /* Adding the values one at a time gives the same result as the batch. */
+  ecl_grid_init_blocking( grid );
+  test_assert_int_equal( ecl_grid_get_block_count3d( grid , 0 , 0 , 0 ) , 0 );
+  for (ip = 0; ip < NUM_POINTS; ip++)
+    ecl_grid_block_value_3d( grid , x[ip] , y[ip] , z[ip] , value[ip] );
+  for (g = 0; g < NX*NY*NZ; g++)
+    test_assert_true( data[g] == ecl_grid_get_block_stat1( grid , g , ECL_GRID_BLOCK_MEAN ));
+
+  /* The vector mode accepts the batch insertion as well. */
+  ecl_grid_init_blocking( ref_grid );
+  test_assert_int_equal( ecl_grid_block_values_3d( ref_grid , NUM_POINTS , x , y , z , value ) , num_blocked );
+
+  free( data );
+  ecl_grid_free( ref_grid );
+}
+
+
+int main( int argc , char ** argv) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+  double * x = util_calloc( NUM_POINTS , sizeof * x );
+  double * y = util_calloc( NUM_POINTS , sizeof * y );
+  double * z = util_calloc( NUM_POINTS , sizeof * z );
+  double * value = util_calloc( NUM_POINTS , sizeof * value );
+
+  create_points( x , y , z , value );
+  test_stat( grid , x , y , z , value );
+
+  free( value );
+  free( z );
+  free( y );
+  free( x );
+  ecl_grid_free( grid );
+  exit(0);
+}
@@ -0,0 +1,252 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_cache.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <utime.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/buffer.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+#define NX 6
+#define NY 5
+#define NZ 4
+
+
+void create_egrid__( const char * filename , int nx , int ny , int nz , double dz ) {
+  int * actnum = util_malloc( nx * ny * nz * sizeof * actnum );
+  ecl_grid_type * grid;
+  int i;
+
+  for (i=0; i < nx*ny*nz; i++)
+    actnum[i] = (i % 3) ? 1 : 0;
+
+  grid = ecl_grid_alloc_rectangular( nx , ny , nz , 1 , 2 , dz , actnum );
+  ecl_grid_add_self_nnc( grid , 1 , nx*ny*nz - 1 , 0 );
+  ecl_grid_fwrite_EGRID2( grid , filename , ECL_METRIC_UNITS );
+  ecl_grid_free( grid );
+  free( actnum );
+}
+
+
+void create_egrid( const char * filename , double dz ) {
+  create_egrid__( filename , NX , NY , NZ , dz );
+}
+
+
+/*
+  The file system timestamps can be too coarse to distinguish two
+  writes in quick succession, so the tests set the modification time
+  explicitly.
+*/
+
+void set_mtime( const char * filename , time_t mtime ) {
+  struct utimbuf times;
+  times.actime = mtime;
+  times.modtime = mtime;
+  test_assert_int_equal( utime( filename , &times ) , 0 );
+}
+
+
+void test_load_case( const char * cache_file ) {
+  ecl_grid_type * grid = ecl_grid_alloc( "CACHE.EGRID" );
+
+  /* The cache is opt-in; the plain load_case does not create it. */
+  {
+    ecl_grid_type * grid0 = ecl_grid_load_case( "CACHE.EGRID" );
+    test_assert_true( ecl_grid_compare( grid , grid0 , true , true , true ));
+    test_assert_false( util_file_exists( cache_file ));
+    ecl_grid_free( grid0 );
+  }
+
+  {
+    ecl_grid_type * grid1 = ecl_grid_load_case_cached( "CACHE.EGRID" );
+    test_assert_true( util_file_exists( cache_file ));
+    test_assert_true( ecl_grid_compare( grid , grid1 , true , true , true ));
+    ecl_grid_free( grid1 );
+  }
+
+  {
+    ecl_grid_type * cached = ecl_grid_fread_cache( "CACHE.EGRID" , true , cache_file );
+    ecl_grid_type * grid2 = ecl_grid_load_case_cached( "CACHE.EGRID" );
+
+    test_assert_not_NULL( cached );
+    test_assert_string_equal( ecl_grid_get_name( cached ) , "CACHE.EGRID" );
+    test_assert_not_NULL( ecl_grid_get_cell_nnc_info1( cached , 1 ));
+    test_assert_true( ecl_grid_compare( grid , cached , true , true , true ));
+    test_assert_true( ecl_grid_compare( grid , grid2 , true , true , true ));
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , 2.5 , 3.0 , 1.0 , 0 ) ,
+                           ecl_grid_get_global_index_from_xyz( cached , 2.5 , 3.0 , 1.0 , 0 ));
+
+    /* The apply_mapaxes setting is part of the cache key. */
+    test_assert_NULL( ecl_grid_fread_cache( "CACHE.EGRID" , false , cache_file ));
+
+    ecl_grid_free( grid2 );
+    ecl_grid_free( cached );
+  }
+  ecl_grid_free( grid );
+}
+
+
+void test_invalidate( const char * cache_file ) {
+  create_egrid( "CACHE.EGRID" , 2 );
+  set_mtime( "CACHE.EGRID" , time( NULL ) + 100 );
+  test_assert_NULL( ecl_grid_fread_cache( "CACHE.EGRID" , true , cache_file ));
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "CACHE.EGRID" );
+    ecl_grid_type * grid2 = ecl_grid_load_case_cached( "CACHE.EGRID" );
+    ecl_grid_type * cached;
+    test_assert_true( ecl_grid_compare( grid , grid2 , true , true , true ));
+    cached = ecl_grid_fread_cache( "CACHE.EGRID" , true , cache_file );
+    test_assert_not_NULL( cached );
+    ecl_grid_free( cached );
+    ecl_grid_free( grid2 );
+    ecl_grid_free( grid );
+  }
+}
+
+
+/*
+  A grid file rewritten with the same size and modification time is
+  only detected when the content hash is verified.
+*/
+
+void test_verify( ) {
+  time_t mtime = time( NULL ) - 100;
+
+  create_egrid( "VERIFY.EGRID" , 1 );
+  set_mtime( "VERIFY.EGRID" , mtime );
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "VERIFY.EGRID" );
+    test_assert_true( ecl_grid_fwrite_cache( grid , "VERIFY.EGRID" , true , "VERIFY.grid_cache" ));
+    ecl_grid_free( grid );
+  }
+
+  create_egrid( "VERIFY.EGRID" , 3 );
+  set_mtime( "VERIFY.EGRID" , mtime );
+  {
+    ecl_grid_type * cached = ecl_grid_fread_cache( "VERIFY.EGRID" , true , "VERIFY.grid_cache" );
+    test_assert_not_NULL( cached );
+    ecl_grid_free( cached );
+  }
+
+  util_setenv( "ECL_GRID_CACHE_VERIFY" , "1" );
+  test_assert_NULL( ecl_grid_fread_cache( "VERIFY.EGRID" , true , "VERIFY.grid_cache" ));
+  util_unsetenv( "ECL_GRID_CACHE_VERIFY" );
+}
+
+
+/*
+  Large ZCORN arrays are mapped from the cache file; using the grid
+  must not modify the cache file.
+*/
+
+void test_large( ) {
+  create_egrid__( "LARGE.EGRID" , 40 , 40 , 25 , 1 );
+  {
+    ecl_grid_type * grid = ecl_grid_alloc( "LARGE.EGRID" );
+    ecl_grid_type * cached;
+    buffer_type * before;
+    buffer_type * after;
+
+    test_assert_true( ecl_grid_fwrite_cache( grid , "LARGE.EGRID" , true , "LARGE.grid_cache" ));
+    before = buffer_fread_alloc( "LARGE.grid_cache" );
+    cached = ecl_grid_fread_cache( "LARGE.EGRID" , true , "LARGE.grid_cache" );
+    test_assert_not_NULL( cached );
+    test_assert_true( ecl_grid_compare( grid , cached , true , true , true ));
+    {
+      int g;
+      for (g = 0; g < ecl_grid_get_global_size( grid ); g++)
+        test_assert_double_equal( ecl_grid_get_cell_volume1( grid , g ) , ecl_grid_get_cell_volume1( cached , g ));
+    }
+
+    after = buffer_fread_alloc( "LARGE.grid_cache" );
+    test_assert_int_equal( buffer_get_size( before ) , buffer_get_size( after ));
+    test_assert_int_equal( memcmp( buffer_get_data( before ) , buffer_get_data( after ) , buffer_get_size( before )) , 0 );
+
+    /* The cache file can be removed while the grid is in use. */
+    util_unlink_existing( "LARGE.grid_cache" );
+    test_assert_true( ecl_grid_compare( grid , cached , true , true , true ));
+
+    buffer_free( before );
+    buffer_free( after );
+    ecl_grid_free( cached );
+    ecl_grid_free( grid );
+  }
+}
+
+
+void test_truncated( const char * cache_file ) {
+  buffer_type * buffer = buffer_fread_alloc( cache_file );
+  FILE * stream = util_fopen( "TRUNC.grid_cache" , "w" );
+  util_fwrite( buffer_get_data( buffer ) , 1 , buffer_get_size( buffer ) - 10 , stream , __func__ );
+  fclose( stream );
+  buffer_free( buffer );
+
+  test_assert_NULL( ecl_grid_fread_cache( "CACHE.EGRID" , true , "TRUNC.grid_cache" ));
+  test_assert_NULL( ecl_grid_fread_cache( "CACHE.EGRID" , true , "DOES_NOT_EXIST.grid_cache" ));
+}
+
+
+void test_cache_dir( ) {
+  util_setenv( "ECL_GRID_CACHE_DIR" , "cache" );
+  util_make_path( "cache" );
+  {
+    char * cache_file = ecl_grid_alloc_cache_filename( "CACHE.EGRID" );
+    /* With ECL_GRID_CACHE_DIR set the plain load_case uses the cache. */
+    ecl_grid_type * grid = ecl_grid_load_case( "CACHE.EGRID" );
+
+    test_assert_true( strncmp( cache_file , "cache/CACHE.EGRID." , strlen("cache/CACHE.EGRID.")) == 0 );
+    test_assert_true( util_file_exists( cache_file ));
+    ecl_grid_free( grid );
+    free( cache_file );
+  }
+  util_unsetenv( "ECL_GRID_CACHE_DIR" );
+
+  util_setenv( "ECL_GRID_NO_CACHE" , "1" );
+  test_assert_NULL( ecl_grid_alloc_cache_filename( "CACHE.EGRID" ));
+  util_unsetenv( "ECL_GRID_NO_CACHE" );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grid_cache");
+  char * cache_file;
+
+  util_unsetenv( "ECL_GRID_CACHE_DIR" );
+  util_unsetenv( "ECL_GRID_NO_CACHE" );
+  util_unsetenv( "ECL_GRID_CACHE_VERIFY" );
+  cache_file = ecl_grid_alloc_cache_filename( "CACHE.EGRID" );
+  test_assert_string_equal( cache_file , "CACHE.EGRID.grid_cache" );
+
+  create_egrid( "CACHE.EGRID" , 1 );
+  test_load_case( cache_file );
+  test_invalidate( cache_file );
+  test_truncated( cache_file );
+  test_verify( );
+  test_large( );
+  test_cache_dir( );
+
+  free( cache_file );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,181 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_compact.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+#define NX 6
+#define NY 5
+#define NZ 4
+
+/* Cell (1,1,1) is inactive and collapsed, i.e. it is tainted. */
+#define COLLAPSED_INDEX (1 + NX + NX*NY)
+
+
+/*
+  Tilted pillars, one vertical pillar and one pillar with the same
+  depth at both ends.
+*/
+
+void init_coord( float * coord ) {
+  int i,j;
+  for (j=0; j <= NY; j++) {
+    for (i=0; i <= NX; i++) {
+      float * pillar = &coord[6 * (j * (NX + 1) + i)];
+      pillar[0] = 100 + i * 1.3;
+      pillar[1] = 200 + j * 0.7;
+      pillar[2] = 0;
+      pillar[3] = pillar[0] + 0.1 * i;
+      pillar[4] = pillar[1] - 0.03 * j;
+      pillar[5] = 10;
+    }
+  }
+  coord[6 * (2 * (NX + 1) + 2) + 3] = coord[6 * (2 * (NX + 1) + 2)];
+  coord[6 * (2 * (NX + 1) + 2) + 4] = coord[6 * (2 * (NX + 1) + 2) + 1];
+  coord[6 * (3 * (NX + 1) + 4) + 5] = 0;
+}
+
+
+void init_zcorn( float * zcorn ) {
+  int i,j,k,c;
+  for (k=0; k < NZ; k++)
+    for (j=0; j < NY; j++)
+      for (i=0; i < NX; i++)
+        for (c=0; c < 8; c++) {
+          int ci = i + (c % 2);
+          int cj = j + ((c % 4) / 2);
+          int ck = k + (c / 4);
+          float z = ck * 1.7 + 0.11 * ci + 0.07 * cj;
+          if ((i == 1) && (j == 1) && (k == 1))
+            z = 3.3;
+          zcorn[ ecl_grid_zcorn_index__( NX , NY , i , j , k , c ) ] = z;
+        }
+}
+
+
+/*
+  The corners are calculated from COORD and ZCORN independently of
+  the library; the library must give exactly the same doubles.
+*/
+
+void test_corners( const ecl_grid_type * grid , const float * coord , const float * zcorn ) {
+  int i,j,k,c;
+  for (k=0; k < NZ; k++)
+    for (j=0; j < NY; j++)
+      for (i=0; i < NX; i++)
+        for (c=0; c < 8; c++) {
+          const float * pillar = &coord[6 * ((j + (c % 4) / 2) * (NX + 1) + i + (c % 2))];
+          double z = zcorn[ ecl_grid_zcorn_index__( NX , NY , i , j , k , c ) ];
+          double x0 = pillar[0] , y0 = pillar[1] , z0 = pillar[2];
+          double ex = (double) pillar[3] - x0;
+          double ey = (double) pillar[4] - y0;
+          double ez = (double) pillar[5] - z0;
+          double x = x0 , y = y0;
+          double xpos , ypos , zpos;
+
+          if (ez != 0) {
+            double t = (z - z0) / ez;
+            x = x0 + t * ex;
+            y = y0 + t * ey;
+          }
+
+          ecl_grid_get_cell_corner_xyz3( grid , i , j , k , c , &xpos , &ypos , &zpos );
+          test_assert_true( xpos == x );
+          test_assert_true( ypos == y );
+          test_assert_true( zpos == z );
+        }
+}
+
+
+void test_tainted( const ecl_grid_type * grid ) {
+  int g;
+  for (g = 0; g < NX*NY*NZ; g++) {
+    test_assert_bool_equal( ecl_grid_cell_invalid1( grid , g ) , g == COLLAPSED_INDEX );
+    test_assert_bool_equal( ecl_grid_cell_valid1( grid , g ) , g != COLLAPSED_INDEX );
+  }
+}
+
+
+void test_copy( const ecl_grid_type * grid ) {
+  ecl_grid_type * copy = ecl_grid_alloc_copy( grid );
+  int g;
+
+  test_assert_true( ecl_grid_compare( grid , copy , true , false , true ));
+  for (g = 0; g < NX*NY*NZ; g++)
+    test_assert_true( ecl_grid_get_cell_volume1( grid , g ) == ecl_grid_get_cell_volume1( copy , g ));
+  test_tainted( copy );
+  ecl_grid_free( copy );
+}
+
+
+void test_files( ecl_grid_type * grid ) {
+  ecl_grid_fwrite_EGRID2( grid , "COMPACT.EGRID" , ECL_METRIC_UNITS );
+  ecl_grid_fwrite_GRID2( grid , "COMPACT.GRID" , ECL_METRIC_UNITS );
+  {
+    ecl_grid_type * egrid = ecl_grid_alloc( "COMPACT.EGRID" );
+    ecl_grid_type * grid_file = ecl_grid_alloc( "COMPACT.GRID" );
+    ecl_grid_type * cached;
+
+    /* The GRID file is loaded with stored cells. */
+    test_assert_true( ecl_grid_compare( grid , egrid , true , false , true ));
+    test_assert_true( ecl_grid_compare( egrid , grid_file , true , false , true ));
+
+    test_assert_true( ecl_grid_fwrite_cache( egrid , "COMPACT.EGRID" , true , "COMPACT.grid_cache" ));
+    cached = ecl_grid_fread_cache( "COMPACT.EGRID" , true , "COMPACT.grid_cache" );
+    test_assert_not_NULL( cached );
+    test_assert_true( ecl_grid_compare( egrid , cached , true , false , true ));
+    test_tainted( cached );
+
+    ecl_grid_free( cached );
+    ecl_grid_free( grid_file );
+    ecl_grid_free( egrid );
+  }
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grid_compact");
+  float * coord  = util_malloc( 6 * (NX + 1) * (NY + 1) * sizeof * coord );
+  float * zcorn  = util_malloc( 8 * NX * NY * NZ * sizeof * zcorn );
+  int   * actnum = util_malloc( NX * NY * NZ * sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+
+  init_coord( coord );
+  init_zcorn( zcorn );
+  for (g = 0; g < NX*NY*NZ; g++)
+    actnum[g] = (g == COLLAPSED_INDEX) ? 0 : 1;
+
+  grid = ecl_grid_alloc_GRDECL_data( NX , NY , NZ , zcorn , coord , actnum , false , NULL );
+  test_corners( grid , coord , zcorn );
+  test_tainted( grid );
+  test_copy( grid );
+  test_files( grid );
+
+  ecl_grid_free( grid );
+  free( actnum );
+  free( zcorn );
+  free( coord );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,125 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_corsnum.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_grid.h>
+
+#define NX 4
+#define NY 4
+#define NZ 2
+
+/*
+  Writes a copy of a rectangular EGRID file where the cells with
+  i < 2, j < 2 and k == 0 form coarse group 1.
+*/
+
+void create_coarse_egrid( const char * filename ) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+  ecl_grid_fwrite_EGRID2( grid , "TMP.EGRID" , ECL_METRIC_UNITS );
+  ecl_grid_free( grid );
+  {
+    ecl_file_type * ecl_file = ecl_file_open( "TMP.EGRID" , 0 );
+    fortio_type * fortio = fortio_open_writer( filename , false , true );
+    ecl_kw_type * corsnum_kw = ecl_kw_alloc( CORSNUM_KW , NX*NY*NZ , ECL_INT_TYPE );
+    int i;
+
+    ecl_kw_scalar_set_int( corsnum_kw , 0 );
+    ecl_kw_iset_int( corsnum_kw , 0 , 1 );
+    ecl_kw_iset_int( corsnum_kw , 1 , 1 );
+    ecl_kw_iset_int( corsnum_kw , NX , 1 );
+    ecl_kw_iset_int( corsnum_kw , NX + 1 , 1 );
+
+    for (i=0; i < ecl_file_get_size( ecl_file ); i++) {
+      ecl_kw_type * ecl_kw = ecl_file_iget_kw( ecl_file , i );
+      if (ecl_kw_name_equal( ecl_kw , ENDGRID_KW ))
+        ecl_kw_fwrite( corsnum_kw , fortio );
+      ecl_kw_fwrite( ecl_kw , fortio );
+    }
+
+    ecl_kw_free( corsnum_kw );
+    fortio_fclose( fortio );
+    ecl_file_close( ecl_file );
+  }
+}
+
+
+void test_coarse( const ecl_grid_type * grid ) {
+  test_assert_true( ecl_grid_have_coarse_cells( grid ));
+  test_assert_int_equal( ecl_grid_get_num_coarse_groups( grid ) , 1 );
+  test_assert_true( ecl_grid_cell_in_coarse_group1( grid , NX + 1 ));
+  test_assert_false( ecl_grid_cell_in_coarse_group1( grid , 2 ));
+  test_assert_NULL( ecl_grid_get_cell_coarse_group1( grid , NX*NY ));
+  test_assert_int_equal( ecl_grid_get_active_size( grid ) , NX*NY*NZ - 3 );
+  test_assert_int_equal( ecl_grid_get_active_index1( grid , 0 ) , ecl_grid_get_active_index1( grid , NX + 1 ));
+
+  test_assert_int_equal( ecl_grid_get_parent_cell1( grid , 0 ) , -1 );
+  test_assert_NULL( ecl_grid_get_cell_lgr1( grid , 0 ));
+}
+
+
+void test_copy( ecl_grid_type * grid ) {
+  test_assert_NULL( ecl_grid_get_cell_nnc_info1( grid , 0 ));
+  ecl_grid_add_self_nnc( grid , 0 , NX*NY*NZ - 1 , 0 );
+  test_assert_not_NULL( ecl_grid_get_cell_nnc_info1( grid , 0 ));
+  test_assert_NULL( ecl_grid_get_cell_nnc_info1( grid , 1 ));
+  {
+    ecl_grid_type * copy = ecl_grid_alloc_copy( grid );
+    test_coarse( copy );
+    test_assert_true( ecl_grid_compare( grid , copy , true , true , true ));
+
+    ecl_grid_add_self_nnc( copy , 1 , 2 , 1 );
+    test_assert_false( ecl_grid_compare( grid , copy , true , true , false ));
+    ecl_grid_free( copy );
+  }
+}
+
+
+void test_GRID( const ecl_grid_type * grid ) {
+  ecl_grid_fwrite_GRID2( grid , "COARSE.GRID" , ECL_METRIC_UNITS );
+  {
+    ecl_grid_type * grid2 = ecl_grid_alloc( "COARSE.GRID" );
+    test_coarse( grid2 );
+    test_assert_true( ecl_grid_compare( grid , grid2 , false , false , true ));
+    ecl_grid_free( grid2 );
+  }
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grid_corsnum");
+  ecl_grid_type * grid;
+
+  create_coarse_egrid( "COARSE.EGRID" );
+  grid = ecl_grid_alloc( "COARSE.EGRID" );
+  test_coarse( grid );
+  test_GRID( grid );
+  test_copy( grid );
+
+  ecl_grid_free( grid );
+  test_work_area_free( work_area );
+  exit(0);
+}
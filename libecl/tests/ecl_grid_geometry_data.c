@@ -0,0 +1,112 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_geometry_data.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_grid.h>
+
+
+double cell_value( const ecl_grid_type * grid , ecl_grid_geometry_enum property , int global_index ) {
+  double x,y,z;
+  ecl_grid_get_xyz1( grid , global_index , &x , &y , &z );
+
+  switch (property) {
+  case ECL_GRID_VOLUME:
+    return ecl_grid_get_cell_volume1( grid , global_index );
+  case ECL_GRID_CENTER_X:
+    return x;
+  case ECL_GRID_CENTER_Y:
+    return y;
+  case ECL_GRID_DEPTH:
+    return ecl_grid_get_cdepth1( grid , global_index );
+  case ECL_GRID_DX:
+    return ecl_grid_get_cell_dx1( grid , global_index );
+  case ECL_GRID_DY:
+    return ecl_grid_get_cell_dy1( grid , global_index );
+  case ECL_GRID_DZ:
+    return ecl_grid_get_cell_dz1( grid , global_index );
+  default:
+    test_error_exit("Invalid property:%d\n", property);
+    return 0;
+  }
+}
+
+
+void test_property( const ecl_grid_type * grid , ecl_grid_geometry_enum property ) {
+  const int global_size = ecl_grid_get_global_size( grid );
+  const int active_size = ecl_grid_get_active_size( grid );
+  double * global_data = util_calloc( global_size , sizeof * global_data );
+  double * active_data = util_calloc( active_size , sizeof * active_data );
+  ecl_kw_type * active_kw = ecl_grid_alloc_geometry_kw( grid , property , "DATA" , true );
+  int g;
+
+  ecl_grid_init_geometry_data( grid , property , false , global_data );
+  ecl_grid_init_geometry_data( grid , property , true , active_data );
+
+  test_assert_int_equal( ecl_kw_get_size( active_kw ) , active_size );
+  for (g = 0; g < global_size; g++) {
+    double value = cell_value( grid , property , g );
+    int a = ecl_grid_get_active_index1( grid , g );
+
+    test_assert_true( global_data[g] == value );
+    if (a >= 0) {
+      test_assert_true( active_data[a] == value );
+      test_assert_true( ecl_kw_iget_float( active_kw , a ) == (float) value );
+    }
+  }
+
+  ecl_kw_free( active_kw );
+  free( active_data );
+  free( global_data );
+}
+
+
+int main( int argc , char ** argv) {
+  const int nx = 12;
+  const int ny = 9;
+  const int nz = 7;
+  double * dxv = util_calloc( nx , sizeof * dxv );
+  double * dyv = util_calloc( ny , sizeof * dyv );
+  double * dzv = util_calloc( nz , sizeof * dzv );
+  int * actnum = util_calloc( nx*ny*nz , sizeof * actnum );
+  ecl_grid_type * grid;
+  int i;
+
+  for (i = 0; i < nx; i++) dxv[i] = 1 + 0.5*i;
+  for (i = 0; i < ny; i++) dyv[i] = 2 + 0.25*i;
+  for (i = 0; i < nz; i++) dzv[i] = 0.5 + i;
+  for (i = 0; i < nx*ny*nz; i++) actnum[i] = (i % 5) ? 1 : 0;
+
+  grid = ecl_grid_alloc_dxv_dyv_dzv( nx , ny , nz , dxv , dyv , dzv , actnum );
+  {
+    ecl_grid_geometry_enum property;
+    for (property = ECL_GRID_VOLUME; property <= ECL_GRID_DZ; property++)
+      test_property( grid , property );
+  }
+  ecl_grid_free( grid );
+
+  free( actnum );
+  free( dzv );
+  free( dyv );
+  free( dxv );
+  exit(0);
+}
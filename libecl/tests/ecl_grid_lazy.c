@@ -0,0 +1,196 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_lazy.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+#define NX 10
+#define NY 8
+#define NZ 5
+
+
+/*
+  Creates an EGRID file with slightly tilted pillars and sloping
+  layers, every seventh cell is inactive.
+*/
+
+void create_egrid( const char * filename ) {
+  float * coord  = util_malloc( 6 * (NX + 1) * (NY + 1) * sizeof * coord );
+  float * zcorn  = util_malloc( 8 * NX * NY * NZ * sizeof * zcorn );
+  int   * actnum = util_malloc( NX * NY * NZ * sizeof * actnum );
+  int i,j,k,c;
+
+  for (j=0; j <= NY; j++) {
+    for (i=0; i <= NX; i++) {
+      float * pillar = &coord[6 * (j * (NX + 1) + i)];
+      pillar[0] = i;
+      pillar[1] = 1.5 * j;
+      pillar[2] = 0;
+      pillar[3] = i + 0.25;
+      pillar[4] = 1.5 * j + 0.10;
+      pillar[5] = 2 * NZ;
+    }
+  }
+
+  for (k=0; k < NZ; k++)
+    for (j=0; j < NY; j++)
+      for (i=0; i < NX; i++)
+        for (c=0; c < 8; c++) {
+          int ci = i + (c % 2);
+          int cj = j + ((c % 4) / 2);
+          int ck = k + (c / 4);
+          zcorn[ ecl_grid_zcorn_index__( NX , NY , i , j , k , c ) ] = ck + 0.10 * ci + 0.05 * cj;
+        }
+
+  for (i=0; i < NX*NY*NZ; i++)
+    actnum[i] = (i % 7) ? 1 : 0;
+
+  {
+    ecl_grid_type * grid = ecl_grid_alloc_GRDECL_data( NX , NY , NZ , zcorn , coord , actnum , false , NULL );
+    ecl_grid_fwrite_EGRID2( grid , filename , ECL_METRIC_UNITS );
+    ecl_grid_free( grid );
+  }
+  free( actnum );
+  free( zcorn );
+  free( coord );
+}
+
+
+void test_topology( const ecl_grid_type * grid , const ecl_grid_type * lazy ) {
+  int g;
+  test_assert_int_equal( ecl_grid_get_active_size( grid ) , ecl_grid_get_active_size( lazy ));
+  for (g = 0; g < NX*NY*NZ; g++) {
+    test_assert_int_equal( ecl_grid_get_active_index1( grid , g ) , ecl_grid_get_active_index1( lazy , g ));
+    test_assert_bool_equal( ecl_grid_cell_active1( grid , g ) , ecl_grid_cell_active1( lazy , g ));
+  }
+}
+
+
+void test_cells( const ecl_grid_type * grid , const ecl_grid_type * lazy ) {
+  int g;
+  for (g = NX*NY*NZ - 1; g >= 0; g -= 13) {
+    double x1,y1,z1,x2,y2,z2;
+    ecl_grid_get_xyz1( grid , g , &x1 , &y1 , &z1 );
+    ecl_grid_get_xyz1( lazy , g , &x2 , &y2 , &z2 );
+    test_assert_true( x1 == x2 );
+    test_assert_true( y1 == y2 );
+    test_assert_true( z1 == z2 );
+    test_assert_true( ecl_grid_get_cell_volume1( grid , g ) == ecl_grid_get_cell_volume1( lazy , g ));
+  }
+}
+
+
+void test_search( ecl_grid_type * grid , ecl_grid_type * lazy ) {
+  int g;
+  for (g = 0; g < NX*NY*NZ; g += 11) {
+    double x,y,z;
+    ecl_grid_get_xyz1( grid , g , &x , &y , &z );
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x , y , z , 0 ) ,
+                           ecl_grid_get_global_index_from_xyz( lazy , x , y , z , 0 ));
+  }
+}
+
+
+/*
+  Only one j slice of the lazy grid has been tainted when the cache is
+  written; the remaining slices are tainted before the cache is
+  written.
+*/
+
+void test_cache( const ecl_grid_type * grid ) {
+  ecl_grid_type * lazy = ecl_grid_alloc_lazy( "LAZY.EGRID" );
+  double x,y,z;
+
+  ecl_grid_get_xyz3( lazy , 1 , 2 , 3 , &x , &y , &z );
+  test_assert_true( ecl_grid_fwrite_cache( lazy , "LAZY.EGRID" , true , "LAZY.grid_cache" ));
+  ecl_grid_free( lazy );
+  {
+    ecl_grid_type * cached = ecl_grid_fread_cache( "LAZY.EGRID" , true , "LAZY.grid_cache" );
+    test_assert_not_NULL( cached );
+    test_assert_true( ecl_grid_compare( grid , cached , true , false , true ));
+    ecl_grid_free( cached );
+  }
+}
+
+
+void test_reset_actnum( const ecl_grid_type * grid ) {
+  ecl_grid_type * lazy = ecl_grid_alloc_lazy( "LAZY.EGRID" );
+  int * actnum = util_malloc( NX * NY * NZ * sizeof * actnum );
+  int g;
+
+  for (g = 0; g < NX*NY*NZ; g++)
+    actnum[g] = (g % 2);
+  ecl_grid_reset_actnum( lazy , actnum );
+  test_assert_int_equal( ecl_grid_get_active_size( lazy ) , NX*NY*NZ / 2 );
+  for (g = 0; g < NX*NY*NZ; g++)
+    test_assert_int_equal( ecl_grid_get_active_index1( lazy , g ) , (g % 2) ? g / 2 : -1 );
+
+  ecl_grid_reset_actnum( lazy , NULL );
+  test_assert_int_equal( ecl_grid_get_active_size( lazy ) , NX*NY*NZ );
+  test_cells( grid , lazy );
+
+  free( actnum );
+  ecl_grid_free( lazy );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_grid_lazy");
+  ecl_grid_type * grid;
+  create_egrid( "LAZY.EGRID" );
+  grid = ecl_grid_alloc( "LAZY.EGRID" );
+
+  {
+    ecl_grid_type * lazy = ecl_grid_alloc_lazy( "LAZY.EGRID" );
+    test_topology( grid , lazy );
+    test_cells( grid , lazy );
+    test_assert_true( ecl_grid_compare( grid , lazy , true , false , true ));
+    ecl_grid_free( lazy );
+  }
+
+  {
+    ecl_grid_type * lazy = ecl_grid_alloc_lazy( "LAZY.EGRID" );
+    ecl_grid_type * copy;
+    test_search( grid , lazy );
+
+    copy = ecl_grid_alloc_copy( lazy );
+    test_assert_true( ecl_grid_compare( grid , copy , true , false , true ));
+    ecl_grid_free( copy );
+    ecl_grid_free( lazy );
+  }
+
+  test_cache( grid );
+  test_reset_actnum( grid );
+
+  {
+    ecl_grid_type * lazy;
+    ecl_grid_fwrite_GRID2( grid , "LAZY.GRID" , ECL_METRIC_UNITS );
+    lazy = ecl_grid_alloc_lazy( "LAZY.GRID" );
+    test_assert_true( ecl_grid_compare( grid , lazy , true , false , true ));
+    ecl_grid_free( lazy );
+  }
+
+  ecl_grid_free( grid );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,185 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_xy_index.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/ecl/ecl_grid.h>
+
+#define NX 15
+#define NY 11
+#define NZ 4
+
+
+/*
+  Creates a grid rotated 30 degrees in the xy plane, with perturbed
+  pillars and sloping layers.
+*/
+
+ecl_grid_type * alloc_grid( ) {
+  const double angle = M_PI / 6;
+  float * coord  = util_malloc( 6 * (NX + 1) * (NY + 1) * sizeof * coord );
+  float * zcorn  = util_malloc( 8 * NX * NY * NZ * sizeof * zcorn );
+  ecl_grid_type * grid;
+  int i,j,k,c;
+
+  for (j=0; j <= NY; j++) {
+    for (i=0; i <= NX; i++) {
+      float * pillar = &coord[6 * (j * (NX + 1) + i)];
+      double x = 10 * i + sin( 1.0 * j + i );
+      double y = 8 * j + cos( 0.5 * i + j );
+      pillar[0] = x * cos( angle ) - y * sin( angle );
+      pillar[1] = x * sin( angle ) + y * cos( angle );
+      pillar[2] = 0;
+      pillar[3] = pillar[0] + 0.5;
+      pillar[4] = pillar[1] - 0.3;
+      pillar[5] = 100;
+    }
+  }
+
+  for (k=0; k < NZ; k++)
+    for (j=0; j < NY; j++)
+      for (i=0; i < NX; i++)
+        for (c=0; c < 8; c++) {
+          int ci = i + (c % 2);
+          int cj = j + ((c % 4) / 2);
+          int ck = k + (c / 4);
+          zcorn[ ecl_grid_zcorn_index__( NX , NY , i , j , k , c ) ] = 10 * ck + 0.2 * ci + 0.1 * cj;
+        }
+
+  grid = ecl_grid_alloc_GRDECL_data( NX , NY , NZ , zcorn , coord , NULL , false , NULL );
+  free( zcorn );
+  free( coord );
+  return grid;
+}
+
+
+void test_ij( const ecl_grid_type * grid , int k ) {
+  double * x = util_calloc( NX * NY + 1 , sizeof * x );
+  double * y = util_calloc( NX * NY + 1 , sizeof * y );
+  int * i_list = util_calloc( NX * NY + 1 , sizeof * i_list );
+  int * j_list = util_calloc( NX * NY + 1 , sizeof * j_list );
+  int i,j;
+
+  for (j=0; j < NY; j++)
+    for (i=0; i < NX; i++) {
+      int column = i + j * NX;
+      double xc = 0, yc = 0 , z;
+      int di , dj;
+      for (dj = 0; dj < 2; dj++)
+        for (di = 0; di < 2; di++) {
+          double xp , yp;
+          ecl_grid_get_corner_xyz( grid , i + di , j + dj , k , &xp , &yp , &z );
+          xc += 0.25 * xp;
+          yc += 0.25 * yp;
+        }
+      x[column] = xc;
+      y[column] = yc;
+    }
+  x[NX*NY] = -1e6;
+  y[NX*NY] = -1e6;
+
+  ecl_grid_get_ij_from_xy_batch( grid , k , NX*NY + 1 , x , y , i_list , j_list );
+  for (j=0; j < NY; j++)
+    for (i=0; i < NX; i++) {
+      int column = i + j * NX;
+      int ig , jg;
+      test_assert_true( ecl_grid_get_ij_from_xy( grid , x[column] , y[column] , k , &ig , &jg ));
+      test_assert_int_equal( ig , i );
+      test_assert_int_equal( jg , j );
+      test_assert_int_equal( i_list[column] , i );
+      test_assert_int_equal( j_list[column] , j );
+    }
+
+  {
+    int ig , jg;
+    test_assert_false( ecl_grid_get_ij_from_xy( grid , x[NX*NY] , y[NX*NY] , k , &ig , &jg ));
+    test_assert_int_equal( i_list[NX*NY] , -1 );
+    test_assert_int_equal( j_list[NX*NY] , -1 );
+  }
+
+  free( j_list );
+  free( i_list );
+  free( y );
+  free( x );
+}
+
+
+void test_layer( const ecl_grid_type * grid , int k , bool lower_layer ) {
+  const int corner_offset = lower_layer ? 0 : 4;
+  double * x = util_calloc( NX * NY , sizeof * x );
+  double * y = util_calloc( NX * NY , sizeof * y );
+  int * global_index = util_calloc( NX * NY , sizeof * global_index );
+  int column;
+
+  for (column = 0; column < NX*NY; column++) {
+    int g = column + k * NX * NY;
+    int c;
+    x[column] = 0;
+    y[column] = 0;
+    for (c = 0; c < 4; c++) {
+      double xp , yp , zp;
+      ecl_grid_get_cell_corner_xyz1( grid , g , corner_offset + c , &xp , &yp , &zp );
+      x[column] += 0.25 * xp;
+      y[column] += 0.25 * yp;
+    }
+  }
+
+  ecl_grid_get_global_index_from_xy_batch( grid , k , lower_layer , NX*NY , x , y , global_index );
+  for (column = 0; column < NX*NY; column++) {
+    int g = column + k * NX * NY;
+    test_assert_int_equal( ecl_grid_get_global_index_from_xy( grid , k , lower_layer , x[column] , y[column] ) , g );
+    test_assert_int_equal( global_index[column] , g );
+  }
+
+  if (k == NZ - 1 && !lower_layer)
+    test_assert_int_equal( ecl_grid_get_global_index_from_xy_top( grid , x[7] , y[7] ) , 7 + k * NX * NY );
+
+  if (k == 0 && lower_layer)
+    test_assert_int_equal( ecl_grid_get_global_index_from_xy_bottom( grid , x[7] , y[7] ) , 7 );
+
+  test_assert_int_equal( ecl_grid_get_global_index_from_xy( grid , k , lower_layer , 1e6 , 1e6 ) , -1 );
+
+  free( global_index );
+  free( y );
+  free( x );
+}
+
+
+int main( int argc , char ** argv) {
+  ecl_grid_type * grid = alloc_grid( );
+  int k;
+
+  for (k = 0; k <= NZ; k++)
+    test_ij( grid , k );
+
+  for (k = 0; k < NZ; k++) {
+    test_layer( grid , k , true );
+    test_layer( grid , k , false );
+  }
+
+  ecl_grid_free_xy_index( grid );
+  test_ij( grid , 0 );
+  test_layer( grid , NZ - 1 , false );
+
+  ecl_grid_free( grid );
+  exit(0);
+}
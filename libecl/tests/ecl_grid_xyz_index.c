@@ -0,0 +1,199 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_grid_xyz_index.c' is part of ERT - Ensemble based
+   Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/rng.h>
+#include <ert/ecl/ecl_grid.h>
+
+
+int linear_find( const ecl_grid_type * grid , double x , double y , double z) {
+  int global_index;
+  for (global_index = 0; global_index < ecl_grid_get_global_size( grid ); global_index++)
+    if (ecl_grid_cell_contains_xyz1( grid , global_index , x , y , z))
+      return global_index;
+  return -1;
+}
+
+
+void test_centers( ecl_grid_type * grid ) {
+  int global_index;
+  for (global_index = 0; global_index < ecl_grid_get_global_size( grid ); global_index++) {
+    double x,y,z;
+    ecl_grid_get_xyz1( grid , global_index , &x , &y , &z );
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x , y , z , -1 ) , global_index );
+  }
+}
+
+
+void test_random( ecl_grid_type * grid , rng_type * rng , double xmin , double xmax , double ymin , double ymax , double zmin , double zmax) {
+  int i;
+  for (i = 0; i < 2000; i++) {
+    double x = xmin + rng_get_double( rng ) * (xmax - xmin);
+    double y = ymin + rng_get_double( rng ) * (ymax - ymin);
+    double z = zmin + rng_get_double( rng ) * (zmax - zmin);
+    int expected = linear_find( grid , x , y , z );
+
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x , y , z , -1 ) , expected );
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x , y , z , 0 ) , expected );
+  }
+}
+
+
+void test_batch( ecl_grid_type * grid , rng_type * rng , double xmin , double xmax , double ymin , double ymax , double zmin , double zmax) {
+  const int num_points = 5000;
+  double * x = util_calloc( num_points , sizeof * x );
+  double * y = util_calloc( num_points , sizeof * y );
+  double * z = util_calloc( num_points , sizeof * z );
+  int * start_index = util_calloc( num_points , sizeof * start_index );
+  int * global_index = util_calloc( num_points , sizeof * global_index );
+  int i;
+
+  for (i = 0; i < num_points; i++) {
+    x[i] = xmin + rng_get_double( rng ) * (xmax - xmin);
+    y[i] = ymin + rng_get_double( rng ) * (ymax - ymin);
+    z[i] = zmin + rng_get_double( rng ) * (zmax - zmin);
+    start_index[i] = i % ecl_grid_get_global_size( grid );
+  }
+
+  ecl_grid_get_global_index_from_xyz_batch( grid , num_points , x , y , z , NULL , global_index );
+  for (i = 0; i < num_points; i++)
+    test_assert_int_equal( global_index[i] , linear_find( grid , x[i] , y[i] , z[i] ));
+
+  ecl_grid_get_global_index_from_xyz_batch( grid , num_points , x , y , z , start_index , global_index );
+  for (i = 0; i < num_points; i++)
+    test_assert_int_equal( global_index[i] , ecl_grid_get_global_index_from_xyz( grid , x[i] , y[i] , z[i] , start_index[i] ));
+
+  free( x );
+  free( y );
+  free( z );
+  free( start_index );
+  free( global_index );
+}
+
+
+void test_rectangular( rng_type * rng ) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 20 , 15 , 6 , 1 , 2 , 3 , NULL );
+
+  test_centers( grid );
+  test_random( grid , rng , -1 , 21 , -1 , 31 , -1 , 19 );
+
+  /* Corner points on the outer boundary are found, as with the linear search. */
+  test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , 20 , 30 , 18 , -1 ) , ecl_grid_get_global_size( grid ) - 1);
+
+  ecl_grid_free_xyz_index( grid );
+  test_batch( grid , rng , -1 , 21 , -1 , 31 , -1 , 19 );
+  test_centers( grid );
+  ecl_grid_free( grid );
+}
+
+
+void test_rotated( rng_type * rng ) {
+  const double angle = 0.4;
+  double ivec[3] = { 10 * cos( angle ) , 10 * sin( angle ) , 0 };
+  double jvec[3] = { -20 * sin( angle ) , 20 * cos( angle ) , 0 };
+  double kvec[3] = { 0 , 0 , 5 };
+  ecl_grid_type * grid = ecl_grid_alloc_regular( 12 , 9 , 4 , ivec , jvec , kvec , NULL );
+
+  test_centers( grid );
+  test_random( grid , rng , -200 , 150 , -10 , 230 , -1 , 21 );
+  test_batch( grid , rng , -200 , 150 , -10 , 230 , -1 , 21 );
+  ecl_grid_free( grid );
+}
+
+
+void test_empty_xy( ) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( 1 , 1 , 10 , 1 , 1 , 1 , NULL );
+  test_centers( grid );
+  test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , 0.5 , 0.5 , 11 , -1 ) , -1 );
+  ecl_grid_free( grid );
+}
+
+
+/*
+  A 3x3x10 grid where the cells in layer 0 span the full thickness of
+  the grid, i.e. they overlap all the cells above. With a start_index
+  in the top layer the search around the start cell finds the top
+  layer cell, also after the spatial index has been built; without a
+  start_index the lowest global index is returned.
+*/
+
+void test_overlap( ) {
+  const int nx = 3;
+  const int ny = 3;
+  const int nz = 10;
+  float * coord = util_malloc( 6 * (nx + 1) * (ny + 1) * sizeof * coord );
+  float * zcorn = util_malloc( 8 * nx * ny * nz * sizeof * zcorn );
+  ecl_grid_type * grid;
+  int i,j,k,c;
+
+  for (j = 0; j <= ny; j++)
+    for (i = 0; i <= nx; i++) {
+      float * pillar = &coord[6 * (j * (nx + 1) + i)];
+      pillar[0] = i; pillar[1] = j; pillar[2] = 0;
+      pillar[3] = i; pillar[4] = j; pillar[5] = nz;
+    }
+
+  for (k = 0; k < nz; k++)
+    for (j = 0; j < ny; j++)
+      for (i = 0; i < nx; i++)
+        for (c = 0; c < 8; c++) {
+          float z;
+          if (k == 0)
+            z = (c < 4) ? 0 : nz;
+          else
+            z = (c < 4) ? k : k + 1;
+          zcorn[ ecl_grid_zcorn_index__( nx , ny , i , j , k , c ) ] = z;
+        }
+
+  grid = ecl_grid_alloc_GRDECL_data( nx , ny , nz , zcorn , coord , NULL , false , NULL );
+  {
+    const int bottom = ecl_grid_get_global_index3( grid , 1 , 1 , 0 );
+    const int top = ecl_grid_get_global_index3( grid , 1 , 1 , nz - 1 );
+    const int hint = ecl_grid_get_global_index3( grid , 2 , 1 , nz - 1 );
+    const double x = 1.5 , y = 1.5 , z = nz - 0.5;
+
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x , y , z , hint ) , top );
+    ecl_grid_init_xyz_index( grid );
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x , y , z , hint ) , top );
+    test_assert_int_equal( ecl_grid_get_global_index_from_xyz( grid , x , y , z , -1 ) , bottom );
+
+    ecl_grid_alloc_blocking_accumulators( grid );
+    test_assert_int_equal( ecl_grid_block_values_3d( grid , 1 , &x , &y , &z , &z ) , 1 );
+    test_assert_int_equal( ecl_grid_get_block_count3d( grid , 1 , 1 , 0 ) , 1 );
+    test_assert_int_equal( ecl_grid_get_block_count3d( grid , 1 , 1 , nz - 1 ) , 0 );
+  }
+  ecl_grid_free( grid );
+  free( zcorn );
+  free( coord );
+}
+
+
+int main( int argc , char ** argv) {
+  rng_type * rng = rng_alloc( MZRAN , INIT_DEFAULT );
+  test_rectangular( rng );
+  test_rotated( rng );
+  test_empty_xy( );
+  test_overlap( );
+  rng_free( rng );
+  exit(0);
+}
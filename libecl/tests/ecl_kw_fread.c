@@ -17,6 +17,8 @@
 */
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
 
 #include <ert/util/test_util.h>
 #include <ert/util/util.h>
@@ -75,8 +77,148 @@ void test_fread_alloc() {
 }
 
 
+void test_fmt_fread_alloc() {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_kw_fmt_fread" );
+  {
+    const int size = 50000;
+    ecl_kw_type * int_kw    = ecl_kw_alloc( "INT" , size , ECL_INT_TYPE );
+    ecl_kw_type * float_kw  = ecl_kw_alloc( "FLOAT" , size , ECL_FLOAT_TYPE );
+    ecl_kw_type * double_kw = ecl_kw_alloc( "DOUBLE" , 2503 , ECL_DOUBLE_TYPE );
+    ecl_kw_type * bool_kw   = ecl_kw_alloc( "BOOL" , 1001 , ECL_BOOL_TYPE );
+    ecl_kw_type * char_kw   = ecl_kw_alloc( "CHAR" , 257 , ECL_CHAR_TYPE );
+    int i;
+
+    for (i=0; i < size; i++) {
+      ecl_kw_iset_int( int_kw , i , (i % 2) ? i * 1000 : -i );
+      ecl_kw_iset_float( float_kw , i , (i - 2000) * 0.001 * (i % 7) );
+    }
+    for (i=0; i < ecl_kw_get_size( double_kw ); i++)
+      ecl_kw_iset_double( double_kw , i , (i % 2 ? -1 : 1) * 1.0 / (i + 1) * pow( 10 , (i % 41) - 20 ));
+    for (i=0; i < ecl_kw_get_size( bool_kw ); i++)
+      ecl_kw_iset_bool( bool_kw , i , (i % 3) == 0 );
+    for (i=0; i < ecl_kw_get_size( char_kw ); i++)
+      ecl_kw_iset_string8( char_kw , i , (i % 2) ? "A B" : "ABCDEFGH" );
+
+    {
+      fortio_type * fortio = fortio_open_writer("FMT" , true , true );
+      ecl_kw_fwrite( int_kw , fortio );
+      ecl_kw_fwrite( float_kw , fortio );
+      ecl_kw_fwrite( double_kw , fortio );
+      ecl_kw_fwrite( bool_kw , fortio );
+      ecl_kw_fwrite( char_kw , fortio );
+      fortio_fclose( fortio );
+    }
+    {
+      fortio_type * fortio = fortio_open_reader("FMT" , true , true );
+      ecl_kw_type * kw;
+
+      kw = ecl_kw_fread_alloc( fortio );
+      test_assert_true( ecl_kw_equal( kw , int_kw ));
+      ecl_kw_free( kw );
+
+      kw = ecl_kw_fread_alloc( fortio );
+      test_assert_true( ecl_kw_numeric_equal( kw , float_kw , 1e-6 , 1e-6 ));
+      ecl_kw_free( kw );
+
+      kw = ecl_kw_fread_alloc( fortio );
+      test_assert_true( ecl_kw_numeric_equal( kw , double_kw , 0 , 1e-13 ));
+      ecl_kw_free( kw );
+
+      kw = ecl_kw_fread_alloc( fortio );
+      test_assert_true( ecl_kw_equal( kw , bool_kw ));
+      ecl_kw_free( kw );
+
+      kw = ecl_kw_fread_alloc( fortio );
+      test_assert_true( ecl_kw_equal( kw , char_kw ));
+      ecl_kw_free( kw );
+
+      test_assert_true( fortio_read_at_eof( fortio ));
+      fortio_fclose( fortio );
+    }
+
+    ecl_kw_free( int_kw );
+    ecl_kw_free( float_kw );
+    ecl_kw_free( double_kw );
+    ecl_kw_free( bool_kw );
+    ecl_kw_free( char_kw );
+  }
+
+  /* Fortran formatted doubles: 'D' exponent, or no exponent character at all for three digit exponents. */
+  {
+    FILE * stream = util_fopen("FMT2" , "w");
+    fprintf(stream , " 'DOUBLE  '           6 'DOUB'\n");
+    fprintf(stream , "   0.12500000000000D+01  -0.50000000000000D-02   0.10000000000000+101\n");
+    fprintf(stream , "   0.25000000000000-100   0.00000000000000D+00  -7\n");
+    fprintf(stream , " 'INT     '           3 'INTE'\n");
+    fprintf(stream , "           1          -2           3\n");
+    fclose( stream );
+  }
+  {
+    fortio_type * fortio = fortio_open_reader("FMT2" , true , true );
+    ecl_kw_type * kw = ecl_kw_fread_alloc( fortio );
+
+    test_assert_double_equal( ecl_kw_iget_double( kw , 0 ) , 1.25 );
+    test_assert_double_equal( ecl_kw_iget_double( kw , 1 ) , -0.005 );
+    test_assert_double_equal( ecl_kw_iget_double( kw , 2 ) , 1e100 );
+    test_assert_double_equal( ecl_kw_iget_double( kw , 3 ) , 0.25e-100 );
+    test_assert_double_equal( ecl_kw_iget_double( kw , 4 ) , 0 );
+    test_assert_double_equal( ecl_kw_iget_double( kw , 5 ) , -7 );
+    ecl_kw_free( kw );
+
+    kw = ecl_kw_fread_alloc( fortio );
+    test_assert_int_equal( ecl_kw_iget_int( kw , 1 ) , -2 );
+    test_assert_int_equal( ecl_kw_iget_int( kw , 2 ) , 3 );
+    ecl_kw_free( kw );
+    fortio_fclose( fortio );
+  }
+
+  /*
+    Float values must be rounded directly to float, like strtof();
+    the first value rounds to the midpoint between two floats if it is
+    first rounded to double.
+  */
+  {
+    const int size = 2000;
+    char ** tokens = util_calloc( size , sizeof * tokens );
+    int i;
+
+    tokens[0] = util_alloc_string_copy( "0.10000000596046448E+01" );
+    for (i=1; i < size; i++)
+      tokens[i] = util_alloc_sprintf( "%.*E" , 1 + (i % 17) , (i % 2 ? -1 : 1) * (i * 0.7310585786300049) * pow( 10 , (i % 61) - 30 ));
+
+    {
+      FILE * stream = util_fopen("FMT3" , "w");
+      fprintf(stream , " 'FLOAT   '        %4d 'REAL'\n" , size);
+      for (i=0; i < size; i++)
+        fprintf(stream , " %s%s" , tokens[i] , (i % 4 == 3) ? "\n" : "");
+      fprintf(stream , "\n");
+      fclose( stream );
+    }
+    {
+      fortio_type * fortio = fortio_open_reader("FMT3" , true , true );
+      ecl_kw_type * kw = ecl_kw_fread_alloc( fortio );
+
+      test_assert_int_equal( ecl_kw_get_size( kw ) , size );
+      test_assert_true( ecl_kw_iget_float( kw , 0 ) == strtof( "1.0000000596046448" , NULL ));
+      test_assert_true( ecl_kw_iget_float( kw , 0 ) != (float) strtod( "1.0000000596046448" , NULL ));
+      for (i=0; i < size; i++)
+        test_assert_true( ecl_kw_iget_float( kw , i ) == strtof( tokens[i] , NULL ));
+
+      ecl_kw_free( kw );
+      fortio_fclose( fortio );
+    }
+
+    for (i=0; i < size; i++)
+      free( tokens[i] );
+    free( tokens );
+  }
+  test_work_area_free( work_area );
+}
+
+
 int main(int argc , char ** argv) {
   test_fread_alloc();
+  test_fmt_fread_alloc();
   exit(0);
 }
 
@@ -0,0 +1,189 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_kw_fwrite_fmt.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/fortio.h>
+
+/*
+  Reference implementation of the formatted output: one fprintf() call
+  for every element, with the mantissa and exponent found with log10()
+  and pow().
+*/
+
+static void fprintf_scientific(FILE * stream, const char * fmt , double x) {
+  double pow_x = ceil(log10(fabs(x)));
+  double arg_x   = x / pow(10.0 , pow_x);
+  if (x != 0.0) {
+    if (fabs(arg_x) == 1.0) {
+      arg_x *= 0.10;
+      pow_x += 1;
+    }
+  } else {
+    arg_x = 0.0;
+    pow_x = 0.0;
+  }
+  fprintf(stream , fmt , arg_x , (int) pow_x);
+}
+
+
+void reference_fwrite( const ecl_kw_type * ecl_kw , FILE * stream ) {
+  ecl_type_enum ecl_type = ecl_kw_get_type( ecl_kw );
+  int columns = (ecl_type == ECL_FLOAT_TYPE) ? 4 : (ecl_type == ECL_DOUBLE_TYPE) ? 3 : 6;
+  int size = ecl_kw_get_size( ecl_kw );
+  int i;
+
+  fprintf(stream , " '%-8s' %11d '%-4s'\n" , ecl_kw_get_header( ecl_kw ) , size , ecl_util_get_type_name( ecl_type ));
+  for (i = 0; i < size; i++) {
+    if (ecl_type == ECL_FLOAT_TYPE)
+      fprintf_scientific( stream , "  %11.8fE%+03d" , ecl_kw_iget_float( ecl_kw , i ));
+    else if (ecl_type == ECL_DOUBLE_TYPE)
+      fprintf_scientific( stream , "  %17.14fD%+03d" , ecl_kw_iget_double( ecl_kw , i ));
+    else
+      fprintf( stream , " %11d" , ecl_kw_iget_int( ecl_kw , i ));
+
+    if (((i % 1000) % columns == columns - 1) || (i % 1000 == 999) || (i == size - 1))
+      fprintf(stream , "\n");
+  }
+}
+
+
+static uint64_t random_bits( uint64_t * state ) {
+  *state = *state * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+  return *state;
+}
+
+
+static double random_double( uint64_t * state ) {
+  uint64_t bits = random_bits( state );
+  double value;
+  memcpy( &value , &bits , sizeof value );
+  return value;
+}
+
+
+static double random_normal_double( uint64_t * state ) {
+  double value = (random_bits( state ) >> 11) * (1.0 / 9007199254740992.0);
+  int exponent = (int) (random_bits( state ) % 80) - 40;
+  if (random_bits( state ) & 1)
+    value = -value;
+  return value * pow( 10 , exponent );
+}
+
+
+int fill_special( double * values ) {
+  int n = 0;
+  int k;
+  for (k = -320; k <= 320; k++) {
+    double p = pow( 10.0 , k );
+    values[n++] = p;
+    values[n++] = -p;
+    values[n++] = nextafter( p , 0 );
+    values[n++] = nextafter( p , INFINITY );
+    values[n++] = p * (1 - 1e-9);
+    values[n++] = p * (1 + 1e-9);
+    values[n++] = p * 0.999999999;
+    values[n++] = p * 0.99999999999999;
+    values[n++] = p * 0.5;
+  }
+  values[n++] = 0.0;
+  values[n++] = -0.0;
+  values[n++] = NAN;
+  values[n++] = INFINITY;
+  values[n++] = -INFINITY;
+  values[n++] = 5e-324;
+  values[n++] = 1.7976931348623157e308;
+  values[n++] = 3.4028234663852886e38;
+  values[n++] = 1.1754943508222875e-38;
+  values[n++] = 0.125;
+  values[n++] = 123456789.0;
+  values[n++] = -0.000123456789;
+  return n;
+}
+
+
+void test_kw( const ecl_kw_type * ecl_kw ) {
+  {
+    fortio_type * fortio = fortio_open_writer( "TEST.FUNRST" , true , true );
+    ecl_kw_fwrite( ecl_kw , fortio );
+    fortio_fclose( fortio );
+  }
+  {
+    FILE * stream = util_fopen( "REF.FUNRST" , "w");
+    reference_fwrite( ecl_kw , stream );
+    fclose( stream );
+  }
+  test_assert_true( util_files_equal( "TEST.FUNRST" , "REF.FUNRST" ));
+}
+
+
+void test_fwrite( ) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_kw_fwrite_fmt");
+  const int size = 200000;
+  uint64_t state = 1;
+  double * special = util_calloc( 10000 , sizeof * special );
+  int num_special = fill_special( special );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "DOUBLE" , size , ECL_DOUBLE_TYPE );
+  ecl_kw_type * float_kw  = ecl_kw_alloc( "FLOAT" , size , ECL_FLOAT_TYPE );
+  ecl_kw_type * int_kw    = ecl_kw_alloc( "INT" , 12345 , ECL_INT_TYPE );
+  int i;
+
+  for (i = 0; i < size; i++) {
+    double value;
+    if (i < num_special)
+      value = special[i];
+    else if (i % 3 == 0)
+      value = random_double( &state );
+    else
+      value = random_normal_double( &state );
+
+    ecl_kw_iset_double( double_kw , i , value );
+    ecl_kw_iset_float( float_kw , i , value );
+  }
+
+  for (i = 0; i < ecl_kw_get_size( int_kw ); i++)
+    ecl_kw_iset_int( int_kw , i , (int) random_bits( &state ) >> (i % 32) );
+  ecl_kw_iset_int( int_kw , 0 , 0 );
+  ecl_kw_iset_int( int_kw , 1 , -2147483647 - 1 );
+  ecl_kw_iset_int( int_kw , 2 , 2147483647 );
+
+  test_kw( double_kw );
+  test_kw( float_kw );
+  test_kw( int_kw );
+
+  ecl_kw_free( int_kw );
+  ecl_kw_free( float_kw );
+  ecl_kw_free( double_kw );
+  free( special );
+  test_work_area_free( work_area );
+}
+
+
+int main( int argc , char ** argv) {
+  test_fwrite();
+  exit(0);
+}
@@ -0,0 +1,140 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_kw_fwrite_threads.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+#include <ert/util/thread_pool.h>
+#include <ert/util/arg_pack.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/fortio.h>
+
+#define NUM_WRITERS 8
+
+
+void test_endian_flip_copy() {
+  const int elements = 37;
+  int element_size;
+
+  for (element_size = 2; element_size <= 8; element_size *= 2) {
+    unsigned char * src    = util_malloc( elements * element_size );
+    unsigned char * target = util_malloc( elements * element_size );
+    int i,j;
+
+    for (i = 0; i < elements * element_size; i++)
+      src[i] = (unsigned char) (i * 7 + 3);
+
+    util_endian_flip_vector_copy( target , src , element_size , elements );
+    for (i = 0; i < elements; i++)
+      for (j = 0; j < element_size; j++)
+        test_assert_int_equal( target[i * element_size + j] , src[(i + 1) * element_size - 1 - j]);
+
+    util_endian_flip_vector( target , element_size , elements );
+    test_assert_int_equal( memcmp( target , src , elements * element_size ) , 0 );
+
+    free( src );
+    free( target );
+  }
+}
+
+
+void * fwrite_kw__( void * arg ) {
+  arg_pack_type * arg_pack = arg_pack_safe_cast( arg );
+  const ecl_kw_type * ecl_kw = arg_pack_iget_const_ptr( arg_pack , 0 );
+  const char * filename = arg_pack_iget_const_ptr( arg_pack , 1 );
+  fortio_type * fortio = fortio_open_writer( filename , false , true );
+
+  ecl_kw_fwrite( ecl_kw , fortio );
+  fortio_fclose( fortio );
+  return NULL;
+}
+
+
+void test_fwrite_threads( const ecl_kw_type * ecl_kw ) {
+  ecl_kw_type * copy = ecl_kw_alloc_copy( ecl_kw );
+  thread_pool_type * tp = thread_pool_alloc( NUM_WRITERS , true );
+  arg_pack_type * arg_list[NUM_WRITERS];
+  char * filename_list[NUM_WRITERS];
+  int i;
+
+  for (i = 0; i < NUM_WRITERS; i++) {
+    filename_list[i] = util_alloc_sprintf( "%s.%d" , ecl_kw_get_header( ecl_kw ) , i );
+    arg_list[i] = arg_pack_alloc( );
+    arg_pack_append_const_ptr( arg_list[i] , ecl_kw );
+    arg_pack_append_const_ptr( arg_list[i] , filename_list[i] );
+    thread_pool_add_job( tp , fwrite_kw__ , arg_list[i] );
+  }
+  thread_pool_join( tp );
+  thread_pool_free( tp );
+
+  test_assert_true( ecl_kw_equal( ecl_kw , copy ));
+  for (i = 0; i < NUM_WRITERS; i++) {
+    fortio_type * fortio = fortio_open_reader( filename_list[i] , false , true );
+    ecl_kw_type * kw = ecl_kw_fread_alloc( fortio );
+
+    test_assert_true( ecl_kw_is_instance( kw ));
+    test_assert_true( ecl_kw_equal( ecl_kw , kw ));
+
+    ecl_kw_free( kw );
+    fortio_fclose( fortio );
+    arg_pack_free( arg_list[i] );
+    free( filename_list[i] );
+  }
+  ecl_kw_free( copy );
+}
+
+
+int main(int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_kw_fwrite_threads");
+  const int size = 2503;
+  ecl_kw_type * int_kw    = ecl_kw_alloc( "INT" , size , ECL_INT_TYPE );
+  ecl_kw_type * float_kw  = ecl_kw_alloc( "FLOAT" , size , ECL_FLOAT_TYPE );
+  ecl_kw_type * double_kw = ecl_kw_alloc( "DOUBLE" , size , ECL_DOUBLE_TYPE );
+  ecl_kw_type * char_kw   = ecl_kw_alloc( "CHAR" , 257 , ECL_CHAR_TYPE );
+  int i;
+
+  test_endian_flip_copy();
+
+  for (i = 0; i < size; i++) {
+    ecl_kw_iset_int( int_kw , i , i * 13 - 1000 );
+    ecl_kw_iset_float( float_kw , i , i * 0.25 );
+    ecl_kw_iset_double( double_kw , i , i * 1.0 / 3 );
+  }
+  for (i = 0; i < ecl_kw_get_size( char_kw ); i++) {
+    char * s = util_alloc_sprintf( "S%d" , i );
+    ecl_kw_iset_string8( char_kw , i , s );
+    free( s );
+  }
+
+  test_fwrite_threads( int_kw );
+  test_fwrite_threads( float_kw );
+  test_fwrite_threads( double_kw );
+  test_fwrite_threads( char_kw );
+
+  ecl_kw_free( int_kw );
+  ecl_kw_free( float_kw );
+  ecl_kw_free( double_kw );
+  ecl_kw_free( char_kw );
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,141 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_nnc_export_sort.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_kw_magic.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/fortio.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_nnc_export.h>
+
+#define NX 20
+#define NY 20
+#define NZ 10
+#define NUM_NNC 5000
+
+
+static int cmp_nnc( const void * nnc1 , const void * nnc2 ) {
+  return ecl_nnc_sort_cmp( nnc1 , nnc2 );
+}
+
+
+void test_sort( int max_index ) {
+  ecl_nnc_type * nnc_list = util_calloc( NUM_NNC , sizeof * nnc_list );
+  ecl_nnc_type * expected = util_calloc( NUM_NNC , sizeof * expected );
+  int i;
+
+  for (i = 0; i < NUM_NNC; i++) {
+    ecl_nnc_type * nnc = &nnc_list[i];
+    nnc->grid_nr1 = rand() % 3;
+    nnc->grid_nr2 = rand() % 3;
+    nnc->global_index1 = rand() % max_index;
+    nnc->global_index2 = rand() % max_index;
+    nnc->input_index = i;
+    nnc->trans = i;
+  }
+  for (i = 0; i < NUM_NNC; i++)
+    expected[i] = nnc_list[i];
+
+  qsort( expected , NUM_NNC , sizeof * expected , cmp_nnc );
+  ecl_nnc_sort( nnc_list , NUM_NNC );
+  for (i = 0; i < NUM_NNC; i++)
+    test_assert_int_equal( ecl_nnc_sort_cmp( &nnc_list[i] , &expected[i] ) , 0 );
+
+  free( expected );
+  free( nnc_list );
+}
+
+
+/*
+  Writes an EGRID file with NUM_NNC random self nnc, and an INIT file
+  with the corresponding TRANNNC keyword where the transmissibility of
+  nnc number i is i.
+*/
+
+void create_case( ) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+  ecl_kw_type * trannnc_kw = ecl_kw_alloc( TRANNNC_KW , NUM_NNC , ECL_FLOAT_TYPE );
+  int i;
+
+  for (i = 0; i < NUM_NNC; i++) {
+    ecl_grid_add_self_nnc( grid , rand() % (NX*NY*NZ) , rand() % (NX*NY*NZ) , i );
+    ecl_kw_iset_float( trannnc_kw , i , i );
+  }
+  ecl_grid_fwrite_EGRID2( grid , "NNC.EGRID" , ECL_METRIC_UNITS );
+  {
+    fortio_type * fortio = fortio_open_writer( "NNC.INIT" , false , true );
+    ecl_kw_fwrite( trannnc_kw , fortio );
+    fortio_fclose( fortio );
+  }
+  ecl_kw_free( trannnc_kw );
+  ecl_grid_free( grid );
+}
+
+
+void test_export( ) {
+  ecl_grid_type * grid = ecl_grid_alloc( "NNC.EGRID" );
+  ecl_file_type * init_file = ecl_file_open( "NNC.INIT" , 0 );
+  int num_nnc = ecl_nnc_export_get_size( grid );
+  ecl_nnc_type * nnc_data = util_calloc( num_nnc , sizeof * nnc_data );
+  int i;
+
+  test_assert_int_equal( num_nnc , NUM_NNC );
+  test_assert_int_equal( ecl_nnc_export( grid , init_file , nnc_data ) , NUM_NNC );
+  for (i = 0; i < num_nnc; i++) {
+    const ecl_nnc_type * nnc = &nnc_data[i];
+    const int * lgr_nr;
+    const int * global_index2;
+    const int * nnc_index;
+    int row_size = ecl_grid_get_cell_nnc_row( grid , nnc->global_index1 , &lgr_nr , &global_index2 , &nnc_index );
+    int j;
+
+    if (i > 0)
+      test_assert_true( ecl_nnc_sort_cmp( &nnc_data[i - 1] , nnc ) <= 0 );
+    test_assert_true( nnc->trans == nnc->input_index );
+
+    for (j = 0; j < row_size; j++)
+      if (nnc_index[j] == nnc->input_index)
+        break;
+    test_assert_true( j < row_size );
+    test_assert_int_equal( global_index2[j] , nnc->global_index2 );
+    test_assert_int_equal( lgr_nr[j] , 0 );
+  }
+
+  free( nnc_data );
+  ecl_file_close( init_file );
+  ecl_grid_free( grid );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_nnc_export_sort");
+
+  test_sort( 100 );
+  test_sort( 1 << 29 );
+  create_case( );
+  test_export( );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
@@ -0,0 +1,199 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_pack_file.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <ert/util/ert_api_config.h>
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+#include <ert/util/buffer.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_file.h>
+#include <ert/ecl/ecl_file_view.h>
+#include <ert/ecl/ecl_pack.h>
+#include <ert/ecl/ecl_util.h>
+#include <ert/ecl/fortio.h>
+
+#define NUM_BLOCKS 300
+#define KW_SIZE    1000
+
+
+/*
+  The same keywords are written to a plain unformatted file and to a
+  packed file; NUM_BLOCKS * 3 keywords is more than one batch in the
+  writer.
+*/
+
+void create_files( const char * filename , const char * packed_filename , int num_threads ) {
+  fortio_type * fortio = fortio_open_writer( filename , false , true );
+  ecl_pack_writer_type * writer = ecl_pack_writer_alloc( packed_filename , num_threads );
+  int block;
+
+  test_assert_not_NULL( writer );
+  for (block = 0; block < NUM_BLOCKS; block++) {
+    ecl_kw_type * seqnum = ecl_kw_alloc( "SEQNUM" , 1 , ECL_INT_TYPE );
+    ecl_kw_type * names = ecl_kw_alloc( "NAMES" , 3 , ECL_CHAR_TYPE );
+    ecl_kw_type * data = ecl_kw_alloc( "DATA" , KW_SIZE , ECL_FLOAT_TYPE );
+    int i;
+
+    ecl_kw_iset_int( seqnum , 0 , block );
+    ecl_kw_iset_string8( names , 0 , "A" );
+    ecl_kw_iset_string8( names , 1 , "BB" );
+    ecl_kw_iset_string8( names , 2 , "CCCCCCCC" );
+    for (i = 0; i < KW_SIZE; i++)
+      ecl_kw_iset_float( data , i , block * KW_SIZE + (i % 10) );
+
+    ecl_kw_fwrite( seqnum , fortio );
+    ecl_kw_fwrite( names , fortio );
+    ecl_kw_fwrite( data , fortio );
+
+    ecl_pack_writer_add_kw( writer , seqnum );
+    ecl_pack_writer_add_kw( writer , names );
+    ecl_pack_writer_add_kw( writer , data );
+
+    ecl_kw_free( seqnum );
+    ecl_kw_free( names );
+    ecl_kw_free( data );
+  }
+  fortio_fclose( fortio );
+  test_assert_true( ecl_pack_writer_close( writer ));
+}
+
+
+void test_equal( const char * filename , const char * packed_filename ) {
+  ecl_file_type * ecl_file = ecl_file_open( filename , 0 );
+  ecl_file_type * packed_file = ecl_file_open( packed_filename , ECL_FILE_CLOSE_STREAM );
+  int ikw;
+
+  test_assert_true( ecl_pack_is_packed_file( packed_filename ));
+  test_assert_false( ecl_pack_is_packed_file( filename ));
+  test_assert_not_NULL( packed_file );
+  test_assert_int_equal( ecl_file_get_size( ecl_file ) , ecl_file_get_size( packed_file ));
+  test_assert_int_equal( ecl_file_get_num_named_kw( packed_file , "DATA" ) , NUM_BLOCKS );
+  test_assert_true( util_file_size( packed_filename ) < util_file_size( filename ) / 2 );
+
+  /* Random access in reverse order. */
+  for (ikw = ecl_file_get_size( ecl_file ) - 1; ikw >= 0; ikw--)
+    test_assert_true( ecl_kw_equal( ecl_file_iget_kw( ecl_file , ikw ) , ecl_file_iget_kw( packed_file , ikw )));
+
+  ecl_file_close( packed_file );
+  ecl_file_close( ecl_file );
+}
+
+
+void test_views( const char * packed_filename ) {
+  ecl_file_type * packed_file = ecl_file_open( packed_filename , 0 );
+  ecl_file_view_type * view = ecl_file_alloc_global_blockview( packed_file , "SEQNUM" , 117 );
+
+  test_assert_int_equal( ecl_file_view_get_size( view ) , 3 );
+  test_assert_int_equal( ecl_kw_iget_int( ecl_file_view_iget_named_kw( view , "SEQNUM" , 0 ) , 0 ) , 117 );
+  test_assert_float_equal( ecl_kw_iget_float( ecl_file_view_iget_named_kw( view , "DATA" , 0 ) , 5 ) , 117 * KW_SIZE + 5 );
+  ecl_file_view_free( view );
+
+  test_assert_true( ecl_file_load_all( packed_file ));
+  test_assert_false( ecl_file_enable_prefetch( packed_file , 2 , NULL , 0 ));
+  ecl_file_close( packed_file );
+}
+
+
+void test_indexed_read( const char * packed_filename ) {
+  ecl_file_type * packed_file = ecl_file_open( packed_filename , 0 );
+  int_vector_type * index_map = int_vector_alloc( 0 , 0 );
+  {
+    float data[3];
+    int_vector_append( index_map , 999 );
+    int_vector_append( index_map , 3 );
+    int_vector_append( index_map , 0 );
+    ecl_file_indexed_read( packed_file , "DATA" , 10 , index_map , (char *) data );
+    test_assert_float_equal( data[0] , 10 * KW_SIZE + 9 );
+    test_assert_float_equal( data[1] , 10 * KW_SIZE + 3 );
+    test_assert_float_equal( data[2] , 10 * KW_SIZE );
+  }
+  {
+    char names[16];
+    int_vector_reset( index_map );
+    int_vector_append( index_map , 2 );
+    int_vector_append( index_map , 1 );
+    ecl_file_indexed_read( packed_file , "NAMES" , 4 , index_map , names );
+    test_assert_true( memcmp( names , "CCCCCCCCBB      " , 16 ) == 0 );
+  }
+  int_vector_free( index_map );
+  ecl_file_close( packed_file );
+}
+
+
+void test_invalid( const char * packed_filename ) {
+  test_assert_NULL( ecl_file_open( packed_filename , ECL_FILE_WRITABLE ));
+  {
+    /* A truncated file is rejected. */
+    buffer_type * buffer = buffer_fread_alloc( packed_filename );
+    FILE * stream = util_fopen( "TRUNC.UNRST.z" , "w" );
+    util_fwrite( buffer_get_data( buffer ) , 1 , buffer_get_size( buffer ) - 10 , stream , __func__ );
+    fclose( stream );
+    buffer_free( buffer );
+
+    test_assert_NULL( ecl_pack_open( "TRUNC.UNRST.z" ));
+    test_assert_NULL( ecl_file_open( "TRUNC.UNRST.z" , 0 ));
+  }
+}
+
+
+void test_file_type( const char * packed_filename ) {
+  bool fmt_file = true;
+  test_assert_true( ecl_util_packed_file( packed_filename ));
+  test_assert_false( ecl_util_packed_file( "TEST.UNRST" ));
+  test_assert_false( ecl_util_packed_file( ".z" ));
+  test_assert_int_equal( ecl_util_get_file_type( packed_filename , &fmt_file , NULL ) , ECL_UNIFIED_RESTART_FILE );
+  test_assert_false( fmt_file );
+  test_assert_int_equal( ecl_util_get_file_type( "TEST.X0010.z" , &fmt_file , NULL ) , ECL_RESTART_FILE );
+
+  fmt_file = true;
+  test_assert_true( ecl_util_fmt_file( packed_filename , &fmt_file ));
+  test_assert_false( fmt_file );
+  {
+    char * name = ecl_util_alloc_packed_filename( "TEST.UNRST" );
+    test_assert_string_equal( name , "TEST.UNRST.z" );
+    free( name );
+  }
+}
+
+
+int main( int argc , char ** argv) {
+#ifdef ERT_HAVE_ZLIB
+  test_work_area_type * work_area = test_work_area_alloc("ecl_pack_file");
+
+  create_files( "TEST.UNRST" , "PACKED.UNRST.z" , 1 );
+  test_equal( "TEST.UNRST" , "PACKED.UNRST.z" );
+
+  create_files( "TEST.UNRST" , "PACKED.UNRST.z" , 4 );
+  test_equal( "TEST.UNRST" , "PACKED.UNRST.z" );
+  test_views( "PACKED.UNRST.z" );
+  test_indexed_read( "PACKED.UNRST.z" );
+  test_invalid( "PACKED.UNRST.z" );
+  test_file_type( "PACKED.UNRST.z" );
+
+  test_work_area_free( work_area );
+#else
+  test_assert_NULL( ecl_pack_writer_alloc( "PACKED.UNRST.z" , 1 ));
+#endif
+  exit(0);
+}
@@ -0,0 +1,160 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_region_polygon.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+
+#include <ert/geometry/geo_polygon.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+
+/* The grid size, 41*31*5 = 6355, is not a multiple of the word size. */
+#define NX 41
+#define NY 31
+#define NZ 5
+#define SIZE (NX*NY*NZ)
+
+
+void test_region( const ecl_region_type * region , const bool * mask ) {
+  int g;
+  for (g = 0; g < SIZE; g++)
+    test_assert_bool_equal( ecl_region_contains_global( region , g ) , mask[g] );
+}
+
+
+/*
+  A star shaped polygon with many vertices; some of the vertices are
+  placed exactly at the y coordinate of the cell centers, and there is
+  a horizontal edge at a cell center.
+*/
+
+geo_polygon_type * alloc_star( int num_points ) {
+  geo_polygon_type * polygon = geo_polygon_alloc( "STAR" );
+  int i;
+  for (i = 0; i < num_points; i++) {
+    double angle = 2 * M_PI * i / num_points;
+    double r = (i % 2) ? 8 : 14;
+    double x = 20 + r * cos( angle );
+    double y = 15 + r * sin( angle );
+    if ((i % 7) == 0)
+      y = floor( y ) + 0.5;
+    geo_polygon_add_point( polygon , x , y );
+  }
+  geo_polygon_add_point( polygon , 30.0 , 15.5 );
+  geo_polygon_add_point( polygon , 33.0 , 15.5 );
+  return polygon;
+}
+
+
+void test_polygon( const ecl_grid_type * grid , const geo_polygon_type * polygon , bool * mask ) {
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  int g;
+
+  ecl_region_select_inside_polygon( region , polygon );
+  for (g = 0; g < SIZE; g++) {
+    double x,y,z;
+    int i,j,k;
+    ecl_grid_get_ijk1( grid , g , &i , &j , &k );
+    ecl_grid_get_xyz3( grid , i , j , 0 , &x , &y , &z );
+    mask[g] = geo_polygon_contains_point( polygon , x , y );
+  }
+  test_region( region , mask );
+  test_assert_int_equal( ecl_region_get_global_size( region ) , int_vector_size( ecl_region_get_global_list( region )));
+
+  /* The list must be rebuilt after a new selection. */
+  ecl_region_select_outside_polygon( region , polygon );
+  test_assert_int_equal( int_vector_size( ecl_region_get_global_list( region )) , SIZE );
+
+  ecl_region_deselect_inside_polygon( region , polygon );
+  for (g = 0; g < SIZE; g++)
+    mask[g] = !mask[g];
+  test_region( region , mask );
+
+  ecl_region_deselect_outside_polygon( region , polygon );
+  test_assert_int_equal( ecl_region_get_global_size( region ) , 0 );
+  ecl_region_free( region );
+}
+
+
+void test_cylinder( const ecl_grid_type * grid , bool * mask ) {
+  const double x0 = 17.25;
+  const double y0 = 12.75;
+  const double R  = 9;
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  int g;
+
+  ecl_region_select_in_cylinder( region , x0 , y0 , R );
+  for (g = 0; g < SIZE; g++) {
+    double x,y,z;
+    ecl_grid_get_xyz1( grid , g , &x , &y , &z );
+    mask[g] = ((x - x0)*(x - x0) + (y - y0)*(y - y0) < R*R);
+  }
+  test_region( region , mask );
+
+  ecl_region_deselect_in_zcylinder( region , x0 , y0 , R , 1.0 , 3.0 );
+  for (g = 0; g < SIZE; g++) {
+    double x,y,z;
+    ecl_grid_get_xyz1( grid , g , &x , &y , &z );
+    if ((z >= 1.0) && (z <= 3.0))
+      mask[g] = false;
+  }
+  test_region( region , mask );
+
+  ecl_region_deselect_all( region );
+  ecl_region_select_in_zcylinder( region , x0 , y0 , R , 1.0 , 3.0 );
+  for (g = 0; g < SIZE; g++) {
+    double x,y,z;
+    ecl_grid_get_xyz1( grid , g , &x , &y , &z );
+    mask[g] = ((z >= 1.0) && (z <= 3.0) && ((x - x0)*(x - x0) + (y - y0)*(y - y0) < R*R));
+  }
+  test_region( region , mask );
+  ecl_region_free( region );
+}
+
+
+int main( int argc , char ** argv) {
+  ecl_grid_type * grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , NULL );
+  bool * mask = util_calloc( SIZE , sizeof * mask );
+
+  {
+    geo_polygon_type * polygon = alloc_star( 500 );
+    test_polygon( grid , polygon , mask );
+    geo_polygon_free( polygon );
+  }
+
+  {
+    geo_polygon_type * polygon = geo_polygon_alloc( "EMPTY" );
+    ecl_region_type * region = ecl_region_alloc( grid , false );
+    ecl_region_select_inside_polygon( region , polygon );
+    test_assert_int_equal( ecl_region_get_global_size( region ) , 0 );
+    ecl_region_select_outside_polygon( region , polygon );
+    test_assert_int_equal( ecl_region_get_global_size( region ) , SIZE );
+    ecl_region_free( region );
+    geo_polygon_free( polygon );
+  }
+
+  test_cylinder( grid , mask );
+
+  free( mask );
+  ecl_grid_free( grid );
+  exit(0);
+}
@@ -0,0 +1,194 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_region_set_ops.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+
+/* The grid size, 7*5*3 = 105, is not a multiple of the word size. */
+#define NX 7
+#define NY 5
+#define NZ 3
+#define SIZE (NX*NY*NZ)
+
+
+/*
+  Checks the region against the reference selection in mask.
+*/
+
+void test_region( const ecl_grid_type * grid , ecl_region_type * region , const bool * mask ) {
+  const int_vector_type * global_list = ecl_region_get_global_list( region );
+  const int_vector_type * active_list = ecl_region_get_active_list( region );
+  const int_vector_type * global_active_list = ecl_region_get_global_active_list( region );
+  int num_global = 0;
+  int num_active = 0;
+  int g;
+
+  for (g = 0; g < SIZE; g++) {
+    test_assert_bool_equal( ecl_region_contains_global( region , g ) , mask[g] );
+    if (mask[g]) {
+      test_assert_int_equal( int_vector_iget( global_list , num_global ) , g );
+      num_global++;
+      if (ecl_grid_cell_active1( grid , g )) {
+        test_assert_int_equal( int_vector_iget( active_list , num_active ) , ecl_grid_get_active_index1( grid , g ));
+        test_assert_int_equal( int_vector_iget( global_active_list , num_active ) , g );
+        num_active++;
+      }
+    }
+  }
+  test_assert_int_equal( int_vector_size( global_list ) , num_global );
+  test_assert_int_equal( int_vector_size( active_list ) , num_active );
+  test_assert_int_equal( ecl_region_get_global_size( region ) , num_global );
+  test_assert_int_equal( ecl_region_get_active_size( region ) , num_active );
+}
+
+
+void select_pattern( ecl_region_type * region , bool * mask , int step ) {
+  int g;
+  for (g = 0; g < SIZE; g++) {
+    mask[g] = ((g % step) == 0);
+    if (mask[g])
+      ecl_region_select_global_index( region , g );
+  }
+}
+
+
+void test_set_ops( const ecl_grid_type * grid ) {
+  ecl_region_type * A = ecl_region_alloc( grid , false );
+  ecl_region_type * B = ecl_region_alloc( grid , false );
+  bool mask_A[SIZE] , mask_B[SIZE] , expected[SIZE];
+  int g;
+
+  select_pattern( A , mask_A , 2 );
+  select_pattern( B , mask_B , 3 );
+  test_region( grid , A , mask_A );
+  test_region( grid , B , mask_B );
+
+  {
+    ecl_region_type * C = ecl_region_alloc_copy( A );
+    ecl_region_intersection( C , B );
+    for (g = 0; g < SIZE; g++) expected[g] = mask_A[g] && mask_B[g];
+    test_region( grid , C , expected );
+    ecl_region_free( C );
+  }
+
+  {
+    ecl_region_type * C = ecl_region_alloc_copy( A );
+    ecl_region_union( C , B );
+    for (g = 0; g < SIZE; g++) expected[g] = mask_A[g] || mask_B[g];
+    test_region( grid , C , expected );
+    ecl_region_free( C );
+  }
+
+  {
+    ecl_region_type * C = ecl_region_alloc_copy( A );
+    ecl_region_subtract( C , B );
+    for (g = 0; g < SIZE; g++) expected[g] = mask_A[g] && !mask_B[g];
+    test_region( grid , C , expected );
+    ecl_region_free( C );
+  }
+
+  {
+    ecl_region_type * C = ecl_region_alloc_copy( A );
+    ecl_region_xor( C , B );
+    for (g = 0; g < SIZE; g++) expected[g] = mask_A[g] != mask_B[g];
+    test_region( grid , C , expected );
+
+    ecl_region_invert_selection( C );
+    for (g = 0; g < SIZE; g++) expected[g] = !expected[g];
+    test_region( grid , C , expected );
+    ecl_region_free( C );
+  }
+
+  {
+    ecl_region_type * C = ecl_region_alloc_copy( A );
+    test_assert_true( ecl_region_equal( A , C ));
+    ecl_region_union( C , A );
+    test_region( grid , C , mask_A );
+    ecl_region_deselect_global_index( C , 0 );
+    test_assert_false( ecl_region_equal( A , C ));
+    ecl_region_free( C );
+  }
+
+  ecl_region_free( B );
+  ecl_region_free( A );
+}
+
+
+void test_select( const ecl_grid_type * grid ) {
+  ecl_region_type * region = ecl_region_alloc( grid , true );
+  bool mask[SIZE];
+  int g;
+
+  for (g = 0; g < SIZE; g++) mask[g] = true;
+  test_region( grid , region , mask );
+
+  ecl_region_deselect_k1k2( region , 1 , 1 );
+  for (g = NX*NY; g < 2*NX*NY; g++) mask[g] = false;
+  test_region( grid , region , mask );
+
+  ecl_region_deselect_active_cells( region );
+  for (g = 0; g < SIZE; g++)
+    if (ecl_grid_cell_active1( grid , g ))
+      mask[g] = false;
+  test_region( grid , region , mask );
+
+  ecl_region_select_active_cells( region );
+  for (g = 0; g < SIZE; g++)
+    if (ecl_grid_cell_active1( grid , g ))
+      mask[g] = true;
+  test_region( grid , region , mask );
+
+  ecl_region_deselect_inactive_cells( region );
+  for (g = 0; g < SIZE; g++)
+    mask[g] = ecl_grid_cell_active1( grid , g );
+  test_region( grid , region , mask );
+
+  ecl_region_select_all( region );
+  for (g = 0; g < SIZE; g++) mask[g] = true;
+  test_region( grid , region , mask );
+
+  ecl_region_invert_selection( region );
+  for (g = 0; g < SIZE; g++) mask[g] = false;
+  test_region( grid , region , mask );
+
+  ecl_region_free( region );
+}
+
+
+int main(int argc , char ** argv) {
+  int * actnum = util_calloc( SIZE , sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+
+  for (g = 0; g < SIZE; g++)
+    actnum[g] = (g % 7) ? 1 : 0;
+  grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , actnum );
+
+  test_set_ops( grid );
+  test_select( grid );
+
+  ecl_grid_free( grid );
+  free( actnum );
+  exit(0);
+}
@@ -0,0 +1,184 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_region_stat.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/int_vector.h>
+
+#include <ert/ecl/ecl_kw.h>
+#include <ert/ecl/ecl_grid.h>
+#include <ert/ecl/ecl_region.h>
+#include <ert/ecl/ecl_region_stat.h>
+
+/* Large enough to be split in several chunks. */
+#define NX 80
+#define NY 60
+#define NZ 40
+#define NUM_REGIONS 12
+
+
+/*
+  Compares the region statistics with sums over the cells selected
+  with ecl_region_select_equal().
+*/
+
+void test_stat( const ecl_grid_type * grid , const ecl_kw_type * fipnum , const ecl_kw_type ** value_kw , int num_values , const ecl_kw_type * porv ) {
+  ecl_region_stat_type * stat = ecl_region_stat_alloc( grid , fipnum , num_values , value_kw , porv );
+  ecl_region_type * region = ecl_region_alloc( grid , false );
+  int region_value;
+
+  test_assert_true( ecl_region_stat_is_instance( stat ));
+  test_assert_int_equal( ecl_region_stat_get_num_values( stat ) , num_values );
+  test_assert_int_equal( ecl_region_stat_get_min_region( stat ) , 1 );
+  test_assert_int_equal( ecl_region_stat_get_max_region( stat ) , NUM_REGIONS );
+  test_assert_int_equal( ecl_region_stat_get_num_regions( stat ) , NUM_REGIONS );
+  test_assert_int_equal( ecl_region_stat_iget_region( stat , 0 ) , 1 );
+
+  for (region_value = 0; region_value <= NUM_REGIONS + 1; region_value++) {
+    const int_vector_type * global_list;
+    int value_nr;
+
+    ecl_region_deselect_all( region );
+    ecl_region_select_equal( region , fipnum , region_value );
+    global_list = ecl_region_get_global_active_list( region );
+    test_assert_int_equal( ecl_region_stat_get_count( stat , region_value ) , int_vector_size( global_list ));
+
+    for (value_nr = 0; value_nr < num_values; value_nr++) {
+      double sum = 0;
+      double weight = 0;
+      double min = 0;
+      double max = 0;
+      int index;
+
+      for (index = 0; index < int_vector_size( global_list ); index++) {
+        int global_index = int_vector_iget( global_list , index );
+        int active_index = ecl_grid_get_active_index1( grid , global_index );
+        double w = porv ? ecl_kw_iget_as_double( porv , global_index ) : 1;
+        double v = ecl_kw_iget_as_double( value_kw[value_nr] , active_index );
+
+        sum += w * v;
+        weight += w;
+        if (index == 0) {
+          min = v;
+          max = v;
+        } else {
+          min = util_double_min( min , v );
+          max = util_double_max( max , v );
+        }
+      }
+
+      test_assert_double_equal( ecl_region_stat_get_weight( stat , region_value ) , weight );
+      test_assert_double_equal( ecl_region_stat_iget_sum( stat , value_nr , region_value ) , sum );
+      test_assert_double_equal( ecl_region_stat_iget_mean( stat , value_nr , region_value ) , (weight > 0) ? sum / weight : 0 );
+      test_assert_true( ecl_region_stat_iget_min( stat , value_nr , region_value ) == min );
+      test_assert_true( ecl_region_stat_iget_max( stat , value_nr , region_value ) == max );
+    }
+  }
+
+  ecl_region_free( region );
+  ecl_region_stat_free( stat );
+}
+
+
+/*
+  Region values spanning the full int range are compacted to the
+  distinct values.
+*/
+
+void test_sparse( const ecl_grid_type * grid , const ecl_kw_type * value_kw ) {
+  const int active_size = ecl_grid_get_active_size( grid );
+  const int region_values[4] = { INT_MIN , -5 , 1 , INT_MAX };
+  ecl_kw_type * fipnum = ecl_kw_alloc( "FIPNUM" , active_size , ECL_INT_TYPE );
+  ecl_region_stat_type * stat;
+  int count[4] = { 0 , 0 , 0 , 0 };
+  double sum[4] = { 0 , 0 , 0 , 0 };
+  int a , i;
+
+  for (a = 0; a < active_size; a++) {
+    int r = (a * 7) % 4;
+    ecl_kw_iset_int( fipnum , a , region_values[r] );
+    count[r]++;
+    sum[r] += ecl_kw_iget_as_double( value_kw , a );
+  }
+
+  stat = ecl_region_stat_alloc( grid , fipnum , 1 , &value_kw , NULL );
+  test_assert_int_equal( ecl_region_stat_get_min_region( stat ) , INT_MIN );
+  test_assert_int_equal( ecl_region_stat_get_max_region( stat ) , INT_MAX );
+  test_assert_int_equal( ecl_region_stat_get_num_regions( stat ) , 4 );
+  for (i = 0; i < 4; i++) {
+    test_assert_int_equal( ecl_region_stat_iget_region( stat , i ) , region_values[i] );
+    test_assert_int_equal( ecl_region_stat_get_count( stat , region_values[i] ) , count[i] );
+    test_assert_double_equal( ecl_region_stat_iget_sum( stat , 0 , region_values[i] ) , sum[i] );
+  }
+  test_assert_int_equal( ecl_region_stat_get_count( stat , 0 ) , 0 );
+  test_assert_int_equal( ecl_region_stat_get_count( stat , INT_MAX - 1 ) , 0 );
+  test_assert_double_equal( ecl_region_stat_iget_sum( stat , 0 , 2 ) , 0 );
+
+  ecl_region_stat_free( stat );
+  ecl_kw_free( fipnum );
+}
+
+
+int main(int argc , char ** argv) {
+  const int size = NX*NY*NZ;
+  int * actnum = util_calloc( size , sizeof * actnum );
+  ecl_grid_type * grid;
+  int g;
+
+  for (g = 0; g < size; g++)
+    actnum[g] = (g % 9) ? 1 : 0;
+  grid = ecl_grid_alloc_rectangular( NX , NY , NZ , 1 , 1 , 1 , actnum );
+
+  {
+    const int active_size = ecl_grid_get_active_size( grid );
+    ecl_kw_type * fipnum = ecl_kw_alloc( "FIPNUM" , active_size , ECL_INT_TYPE );
+    ecl_kw_type * soil   = ecl_kw_alloc( "SOIL" , active_size , ECL_FLOAT_TYPE );
+    ecl_kw_type * depth  = ecl_kw_alloc( "DEPTH" , active_size , ECL_DOUBLE_TYPE );
+    ecl_kw_type * porv   = ecl_kw_alloc( "PORV" , size , ECL_FLOAT_TYPE );
+    int a;
+
+    for (a = 0; a < active_size; a++) {
+      int global_index = ecl_grid_get_global_index1A( grid , a );
+      ecl_kw_iset_int( fipnum , a , 1 + (global_index / 1000) % NUM_REGIONS );
+      ecl_kw_iset_float( soil , a , (a % 101) / 100.0 );
+      ecl_kw_iset_double( depth , a , ecl_grid_get_cdepth1( grid , global_index ));
+    }
+    for (g = 0; g < size; g++)
+      ecl_kw_iset_float( porv , g , 0.1 + (g % 7) * 0.05 );
+
+    {
+      const ecl_kw_type * value_kw[2] = { soil , depth };
+      test_stat( grid , fipnum , value_kw , 2 , porv );
+      test_stat( grid , fipnum , value_kw , 2 , NULL );
+      test_stat( grid , fipnum , NULL , 0 , porv );
+      test_sparse( grid , soil );
+    }
+
+    ecl_kw_free( porv );
+    ecl_kw_free( depth );
+    ecl_kw_free( soil );
+    ecl_kw_free( fipnum );
+  }
+
+  ecl_grid_free( grid );
+  free( actnum );
+  exit(0);
+}
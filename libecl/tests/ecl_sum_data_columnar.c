@@ -0,0 +1,194 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_data_columnar.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/double_vector.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_sum_data.h>
+#include <ert/ecl/ecl_sum_tstep.h>
+#include <ert/ecl/ecl_smspec.h>
+
+/*
+  The number of ministeps, 5*17 = 85, and the number of keys are not
+  multiples of the tile sizes used when the data is transposed.
+*/
+#define NUM_REPORT   5
+#define NUM_MINISTEP 17
+#define NUM_BPR      300
+
+
+double bpr_value( int tstep , int cell ) {
+  return 1000 * tstep + cell;
+}
+
+
+void write_summary( const char * name , time_t start_time ) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , false , true , ":" , start_time , true , 10 , 10 , 10 );
+  smspec_node_type ** nodes = util_calloc( NUM_BPR , sizeof * nodes );
+  int tstep_nr = 0;
+  int report_step, step, cell;
+
+  for (cell = 0; cell < NUM_BPR; cell++)
+    nodes[cell] = ecl_sum_add_var( ecl_sum , "BPR" , NULL , cell + 1 , "BARS" , 0.0 );
+
+  for (report_step = 0; report_step < NUM_REPORT; report_step++) {
+    for (step = 0; step < NUM_MINISTEP; step++) {
+      ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , report_step + 1 , tstep_nr * 3600.0 );
+      for (cell = 0; cell < NUM_BPR; cell++)
+        ecl_sum_tstep_set_from_node( tstep , nodes[cell] , bpr_value( tstep_nr , cell ));
+      tstep_nr++;
+    }
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+  free( nodes );
+}
+
+
+int bpr_index( const ecl_sum_type * ecl_sum , int cell ) {
+  char * key = util_alloc_sprintf( "BPR:%d" , cell + 1 );
+  int params_index = ecl_sum_get_general_var_params_index( ecl_sum , key );
+  free( key );
+  return params_index;
+}
+
+
+void test_sum( ecl_sum_type * ecl_sum ) {
+  int cell;
+  test_assert_int_equal( ecl_sum_get_data_length( ecl_sum ) , NUM_REPORT * NUM_MINISTEP );
+  for (cell = 0; cell < NUM_BPR; cell++) {
+    int params_index = bpr_index( ecl_sum , cell );
+    double_vector_type * data = ecl_sum_alloc_data_vector( ecl_sum , params_index , false );
+    double_vector_type * report_data = ecl_sum_alloc_data_vector( ecl_sum , params_index , true );
+    int tstep;
+
+    test_assert_int_equal( double_vector_size( data ) , NUM_REPORT * NUM_MINISTEP + 1 );
+    for (tstep = 0; tstep < NUM_REPORT * NUM_MINISTEP; tstep++) {
+      test_assert_double_equal( ecl_sum_iget( ecl_sum , tstep , params_index ) , bpr_value( tstep , cell ));
+      test_assert_double_equal( double_vector_iget( data , tstep + 1 ) , bpr_value( tstep , cell ));
+    }
+
+    test_assert_int_equal( double_vector_size( report_data ) , NUM_REPORT + 1 );
+    for (tstep = 1; tstep <= NUM_REPORT; tstep++)
+      test_assert_double_equal( double_vector_iget( report_data , tstep ) , bpr_value( tstep * NUM_MINISTEP - 1 , cell ));
+
+    double_vector_free( report_data );
+    double_vector_free( data );
+  }
+
+  {
+    int params_index = bpr_index( ecl_sum , 7 );
+    ecl_sum_scale_vector( ecl_sum , params_index , 2.0 );
+    test_assert_double_equal( ecl_sum_iget( ecl_sum , 11 , params_index ) , 2 * bpr_value( 11 , 7 ));
+    test_assert_double_equal( ecl_sum_iget( ecl_sum , 11 , params_index + 1 ) , bpr_value( 11 , 8 ));
+    ecl_sum_scale_vector( ecl_sum , params_index , 0.5 );
+  }
+}
+
+
+/*
+  Loads the data in row mode, and checks it against the data loaded
+  in columnar mode while switching between the modes.
+*/
+
+void test_switch_mode( const ecl_sum_type * ecl_sum ) {
+  ecl_smspec_type * smspec = (ecl_smspec_type *) ecl_sum_get_smspec( ecl_sum );
+  ecl_sum_data_type * data = ecl_sum_data_alloc( smspec );
+  stringlist_type * filelist = stringlist_alloc_new( );
+  int iter;
+
+  stringlist_append_copy( filelist , "CASE.UNSMRY" );
+  test_assert_true( ecl_sum_data_fread( data , filelist ));
+  test_assert_false( ecl_sum_data_is_columnar( data ));
+
+  for (iter = 0; iter < 3; iter++) {
+    int cell;
+    ecl_sum_data_set_columnar( data , (iter % 2) == 0 );
+    for (cell = 0; cell < NUM_BPR; cell += 13) {
+      int params_index = bpr_index( ecl_sum , cell );
+      double_vector_type * vector1 = ecl_sum_data_alloc_data_vector( data , params_index , false );
+      double_vector_type * vector2 = ecl_sum_alloc_data_vector( ecl_sum , params_index , false );
+      int tstep;
+
+      test_assert_true( double_vector_equal( vector1 , vector2 ));
+      for (tstep = 0; tstep < ecl_sum_data_get_length( data ); tstep++)
+        test_assert_double_equal( ecl_sum_data_iget( data , tstep , params_index ) , bpr_value( tstep , cell ));
+
+      double_vector_free( vector2 );
+      double_vector_free( vector1 );
+    }
+  }
+
+  stringlist_free( filelist );
+  ecl_sum_data_free( data );
+}
+
+
+/*
+  Tsteps added to a columnar instance without rebuilding the index
+  keep their own rows.
+*/
+
+void test_add_tstep( const ecl_sum_type * ecl_sum ) {
+  ecl_smspec_type * smspec = (ecl_smspec_type *) ecl_sum_get_smspec( ecl_sum );
+  ecl_sum_data_type * data = ecl_sum_data_alloc_writer( smspec );
+  int params_index = bpr_index( ecl_sum , 5 );
+  int tstep_nr;
+
+  ecl_sum_data_set_columnar( data , true );
+  for (tstep_nr = 0; tstep_nr < 150; tstep_nr++) {
+    ecl_sum_tstep_type * tstep = ecl_sum_data_add_new_tstep( data , 1 + tstep_nr / 50 , tstep_nr * 3600.0 );
+    ecl_sum_tstep_iset( tstep , params_index , tstep_nr );
+  }
+
+  {
+    double_vector_type * vector = ecl_sum_data_alloc_data_vector( data , params_index , false );
+    test_assert_int_equal( double_vector_size( vector ) , 151 );
+    for (tstep_nr = 0; tstep_nr < 150; tstep_nr++) {
+      test_assert_double_equal( double_vector_iget( vector , tstep_nr + 1 ) , tstep_nr );
+      test_assert_double_equal( ecl_sum_data_iget( data , tstep_nr , params_index ) , tstep_nr );
+    }
+    double_vector_free( vector );
+  }
+  ecl_sum_data_free( data );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_sum_data_columnar");
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+  ecl_sum_type * ecl_sum;
+
+  write_summary( "CASE" , start_time );
+  ecl_sum = ecl_sum_fread_alloc_case( "CASE" , ":" );
+  test_assert_true( ecl_sum_is_instance( ecl_sum ));
+
+  test_sum( ecl_sum );
+  test_switch_mode( ecl_sum );
+  test_add_tstep( ecl_sum );
+
+  ecl_sum_free( ecl_sum );
+  test_work_area_free( work_area );
+  exit(0);
+}
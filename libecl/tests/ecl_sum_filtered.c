@@ -0,0 +1,130 @@
+/*
+   Copyright (C) 2016  Statoil ASA, Norway.
+
+   The file 'ecl_sum_filtered.c' is part of ERT - Ensemble based Reservoir Tool.
+
+   ERT is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   ERT is distributed in the hope that it will be useful, but WITHOUT ANY
+   WARRANTY; without even the implied warranty of MERCHANTABILITY or
+   FITNESS FOR A PARTICULAR PURPOSE.
+
+   See the GNU General Public License at <http://www.gnu.org/licenses/gpl.html>
+   for more details.
+*/
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include <ert/util/test_util.h>
+#include <ert/util/util.h>
+#include <ert/util/stringlist.h>
+#include <ert/util/test_work_area.h>
+
+#include <ert/ecl/ecl_sum.h>
+#include <ert/ecl/ecl_smspec.h>
+
+#define NUM_REPORT   4
+#define NUM_MINISTEP 6
+#define NUM_BPR      40
+
+
+double bpr_value( int tstep , int cell ) {
+  return 1000 * tstep + cell;
+}
+
+
+double fopt_value( int tstep ) {
+  return 0.5 * tstep;
+}
+
+
+void write_summary( const char * name , time_t start_time , bool fmt , bool unified) {
+  ecl_sum_type * ecl_sum = ecl_sum_alloc_writer( name , fmt , unified , ":" , start_time , true , 10 , 10 , 10 );
+  smspec_node_type ** nodes = util_calloc( NUM_BPR , sizeof * nodes );
+  smspec_node_type * fopt = ecl_sum_add_var( ecl_sum , "FOPT" , NULL , 0 , "SM3" , 0.0 );
+  smspec_node_type * wwct = ecl_sum_add_var( ecl_sum , "WWCT" , "OP1" , 0 , "" , 0.0 );
+  int tstep_nr = 0;
+  int report_step, step, cell;
+
+  for (cell = 0; cell < NUM_BPR; cell++)
+    nodes[cell] = ecl_sum_add_var( ecl_sum , "BPR" , NULL , cell + 1 , "BARS" , 0.0 );
+
+  for (report_step = 0; report_step < NUM_REPORT; report_step++) {
+    for (step = 0; step < NUM_MINISTEP; step++) {
+      ecl_sum_tstep_type * tstep = ecl_sum_add_tstep( ecl_sum , report_step + 1 , tstep_nr * 86400.0 );
+      ecl_sum_tstep_set_from_node( tstep , fopt , fopt_value( tstep_nr ));
+      ecl_sum_tstep_set_from_node( tstep , wwct , 0.01 * tstep_nr );
+      for (cell = 0; cell < NUM_BPR; cell++)
+        ecl_sum_tstep_set_from_node( tstep , nodes[cell] , bpr_value( tstep_nr , cell ));
+      tstep_nr++;
+    }
+  }
+  ecl_sum_fwrite( ecl_sum );
+  ecl_sum_free( ecl_sum );
+  free( nodes );
+}
+
+
+void test_filtered( const char * case_name , time_t start_time ) {
+  ecl_sum_type * full = ecl_sum_fread_alloc_case( case_name , ":" );
+  stringlist_type * key_filter = stringlist_alloc_new( );
+  ecl_sum_type * filtered;
+
+  stringlist_append_copy( key_filter , "BPR:1?" );
+  stringlist_append_copy( key_filter , "BPR:2,1,1" );
+  stringlist_append_copy( key_filter , "FOPT" );
+  filtered = ecl_sum_fread_alloc_case_filtered( case_name , ":" , true , key_filter );
+
+  test_assert_true( ecl_sum_is_instance( filtered ));
+  test_assert_true( ecl_sum_has_key( filtered , "FOPT" ));
+  test_assert_true( ecl_sum_has_key( filtered , "BPR:17" ));
+  test_assert_true( ecl_sum_has_key( filtered , "BPR:2" ));
+  test_assert_false( ecl_sum_has_key( filtered , "BPR:1" ));
+  test_assert_false( ecl_sum_has_key( filtered , "WWCT:OP1" ));
+
+  /* FOPT, BPR:2 (matched with the i,j,k key) and BPR:10 - BPR:19 in addition to the time keys. */
+  test_assert_int_equal( ecl_smspec_get_params_size( ecl_sum_get_smspec( filtered )) ,
+                         ecl_smspec_get_params_size( ecl_sum_get_smspec( full )) - (NUM_BPR - 11) - 1 );
+
+  test_assert_int_equal( ecl_sum_get_data_length( filtered ) , NUM_REPORT * NUM_MINISTEP );
+  test_assert_int_equal( ecl_sum_get_last_report_step( filtered ) , NUM_REPORT );
+  test_assert_true( ecl_sum_get_start_time( filtered ) == start_time );
+  test_assert_true( ecl_sum_get_end_time( filtered ) == ecl_sum_get_end_time( full ));
+
+  {
+    int tstep;
+    for (tstep = 0; tstep < NUM_REPORT * NUM_MINISTEP; tstep++) {
+      test_assert_double_equal( ecl_sum_get_general_var( filtered , tstep , "FOPT" ) , fopt_value( tstep ));
+      test_assert_double_equal( ecl_sum_get_general_var( filtered , tstep , "BPR:13" ) , bpr_value( tstep , 12 ));
+      test_assert_double_equal( ecl_sum_get_general_var( filtered , tstep , "BPR:13" ) ,
+                                ecl_sum_get_general_var( full , tstep , "BPR:13" ));
+      test_assert_true( ecl_sum_iget_sim_time( filtered , tstep ) == ecl_sum_iget_sim_time( full , tstep ));
+      test_assert_double_equal( ecl_sum_iget_sim_days( filtered , tstep ) , ecl_sum_iget_sim_days( full , tstep ));
+    }
+  }
+
+  stringlist_free( key_filter );
+  ecl_sum_free( filtered );
+  ecl_sum_free( full );
+}
+
+
+int main( int argc , char ** argv) {
+  test_work_area_type * work_area = test_work_area_alloc("ecl_sum_filtered");
+  time_t start_time = util_make_date_utc( 1,1,2010 );
+
+  write_summary( "UNIFIED" , start_time , false , true );
+  test_filtered( "UNIFIED" , start_time );
+
+  write_summary( "MULTIPLE" , start_time , false , false );
+  test_filtered( "MULTIPLE" , start_time );
+
+  write_summary( "FORMATTED" , start_time , true , true );
+  test_filtered( "FORMATTED" , start_time );
+
+  test_work_area_free( work_area );
+  exit(0);
+}
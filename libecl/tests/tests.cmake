@@ -26,6 +26,44 @@ add_executable( ecl_kw_fread ecl_kw_fread.c )
 target_link_libraries( ecl_kw_fread ecl  )
 add_test( ecl_kw_fread ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_fread  )
 
+add_executable( ecl_kw_fwrite_fmt ecl_kw_fwrite_fmt.c )
+target_link_libraries( ecl_kw_fwrite_fmt ecl  )
+add_test( ecl_kw_fwrite_fmt ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_fwrite_fmt  )
+
+if (HAVE_PTHREAD)
+   add_executable( ecl_kw_fwrite_threads ecl_kw_fwrite_threads.c )
+   target_link_libraries( ecl_kw_fwrite_threads ecl  )
+   add_test( ecl_kw_fwrite_threads ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_fwrite_threads  )
+
+   add_executable( ecl_file_prefetch ecl_file_prefetch.c )
+   target_link_libraries( ecl_file_prefetch ecl  )
+   add_test( ecl_file_prefetch ${EXECUTABLE_OUTPUT_PATH}/ecl_file_prefetch  )
+
+   add_executable( ecl_file_thread_read ecl_file_thread_read.c )
+   target_link_libraries( ecl_file_thread_read ecl  )
+   add_test( ecl_file_thread_read ${EXECUTABLE_OUTPUT_PATH}/ecl_file_thread_read  )
+endif()
+
+add_executable( ecl_file_mmap ecl_file_mmap.c )
+target_link_libraries( ecl_file_mmap ecl  )
+add_test( ecl_file_mmap ${EXECUTABLE_OUTPUT_PATH}/ecl_file_mmap  )
+
+add_executable( ecl_file_index ecl_file_index.c )
+target_link_libraries( ecl_file_index ecl  )
+add_test( ecl_file_index ${EXECUTABLE_OUTPUT_PATH}/ecl_file_index  )
+
+add_executable( ecl_file_indexed_read ecl_file_indexed_read.c )
+target_link_libraries( ecl_file_indexed_read ecl  )
+add_test( ecl_file_indexed_read ${EXECUTABLE_OUTPUT_PATH}/ecl_file_indexed_read  )
+
+add_executable( ecl_file_kw_budget ecl_file_kw_budget.c )
+target_link_libraries( ecl_file_kw_budget ecl  )
+add_test( ecl_file_kw_budget ${EXECUTABLE_OUTPUT_PATH}/ecl_file_kw_budget  )
+
+add_executable( ecl_pack_file ecl_pack_file.c )
+target_link_libraries( ecl_pack_file ecl  )
+add_test( ecl_pack_file ${EXECUTABLE_OUTPUT_PATH}/ecl_pack_file  )
+
 add_executable( ecl_valid_basename ecl_valid_basename.c )
 target_link_libraries( ecl_valid_basename ecl  )
 add_test( ecl_valid_basename ${EXECUTABLE_OUTPUT_PATH}/ecl_valid_basename)
@@ -38,6 +76,14 @@ add_executable( ecl_sum_writer ecl_sum_writer.c )
 target_link_libraries( ecl_sum_writer ecl  )
 add_test( ecl_sum_writer ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_writer )
 
+add_executable( ecl_sum_data_columnar ecl_sum_data_columnar.c )
+target_link_libraries( ecl_sum_data_columnar ecl  )
+add_test( ecl_sum_data_columnar ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_data_columnar )
+
+add_executable( ecl_sum_filtered ecl_sum_filtered.c )
+target_link_libraries( ecl_sum_filtered ecl  )
+add_test( ecl_sum_filtered ${EXECUTABLE_OUTPUT_PATH}/ecl_sum_filtered )
+
 add_executable( ecl_grid_add_nnc ecl_grid_add_nnc.c )
 target_link_libraries( ecl_grid_add_nnc ecl  )
 add_test( ecl_grid_add_nnc ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_add_nnc )
@@ -62,6 +108,10 @@ add_executable( ecl_nnc_vector ecl_nnc_vector.c )
 target_link_libraries( ecl_nnc_vector ecl  )
 add_test(ecl_nnc_vector ${EXECUTABLE_OUTPUT_PATH}/ecl_nnc_vector )
 
+add_executable( ecl_nnc_export_sort ecl_nnc_export_sort.c )
+target_link_libraries( ecl_nnc_export_sort ecl  )
+add_test( ecl_nnc_export_sort ${EXECUTABLE_OUTPUT_PATH}/ecl_nnc_export_sort )
+
 add_executable( ecl_kw_grdecl ecl_kw_grdecl.c )
 target_link_libraries( ecl_kw_grdecl ecl  )
 add_test( ecl_kw_grdecl ${EXECUTABLE_OUTPUT_PATH}/ecl_kw_grdecl )
@@ -96,6 +146,46 @@ add_executable( ecl_grid_copy ecl_grid_copy.c )
 target_link_libraries( ecl_grid_copy ecl  )
 add_test( ecl_grid_copy ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_copy )
 
+add_executable( ecl_grid_corsnum ecl_grid_corsnum.c )
+target_link_libraries( ecl_grid_corsnum ecl  )
+add_test( ecl_grid_corsnum ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_corsnum )
+
+add_executable( ecl_grid_lazy ecl_grid_lazy.c )
+target_link_libraries( ecl_grid_lazy ecl  )
+add_test( ecl_grid_lazy ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_lazy )
+
+add_executable( ecl_grid_compact ecl_grid_compact.c )
+target_link_libraries( ecl_grid_compact ecl  )
+add_test( ecl_grid_compact ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_compact )
+
+add_executable( ecl_grid_geometry_data ecl_grid_geometry_data.c )
+target_link_libraries( ecl_grid_geometry_data ecl  )
+add_test( ecl_grid_geometry_data ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_geometry_data )
+
+add_executable( ecl_grid_cache ecl_grid_cache.c )
+target_link_libraries( ecl_grid_cache ecl  )
+add_test( ecl_grid_cache ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_cache )
+
+add_executable( ecl_grid_xy_index ecl_grid_xy_index.c )
+target_link_libraries( ecl_grid_xy_index ecl  )
+add_test( ecl_grid_xy_index ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_xy_index )
+
+add_executable( ecl_grid_block_stat ecl_grid_block_stat.c )
+target_link_libraries( ecl_grid_block_stat ecl  )
+add_test( ecl_grid_block_stat ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_block_stat )
+
+add_executable( ecl_region_set_ops ecl_region_set_ops.c )
+target_link_libraries( ecl_region_set_ops ecl  )
+add_test( ecl_region_set_ops ${EXECUTABLE_OUTPUT_PATH}/ecl_region_set_ops )
+
+add_executable( ecl_region_stat ecl_region_stat.c )
+target_link_libraries( ecl_region_stat ecl  )
+add_test( ecl_region_stat ${EXECUTABLE_OUTPUT_PATH}/ecl_region_stat )
+
+add_executable( ecl_region_polygon ecl_region_polygon.c )
+target_link_libraries( ecl_region_polygon ecl  )
+add_test( ecl_region_polygon ${EXECUTABLE_OUTPUT_PATH}/ecl_region_polygon )
+
 add_executable( ecl_get_num_cpu ecl_get_num_cpu_test.c )
 target_link_libraries( ecl_get_num_cpu ecl  )
 add_test( ecl_get_num_cpu ${EXECUTABLE_OUTPUT_PATH}/ecl_get_num_cpu 
@@ -117,3 +207,7 @@ target_link_libraries( ecl_rst_file ecl ert_util )
 add_test( ecl_rst_file ${EXECUTABLE_OUTPUT_PATH}/ecl_rst_file  )
 
 add_test( ecl_grid_cell_contains1 ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_cell_contains )
+
+add_executable( ecl_grid_xyz_index ecl_grid_xyz_index.c )
+target_link_libraries( ecl_grid_xyz_index ecl ert_util )
+add_test( ecl_grid_xyz_index ${EXECUTABLE_OUTPUT_PATH}/ecl_grid_xyz_index )
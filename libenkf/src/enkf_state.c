@@ -826,11 +826,26 @@ static forward_load_context_type * enkf_state_alloc_load_context( const enkf_sta
     const ecl_config_type * ecl_config = state->shared_info->ecl_config;
     const char * eclbase = enkf_state_get_eclbase( state );
 
-    load_context = forward_load_context_alloc( run_arg,
-                                               load_summary,
-                                               ecl_config ,
-                                               eclbase,
-                                               messages );
+    /*
+      Only the summary vectors which are used are loaded: the keys of
+      the SUMMARY nodes, and the (wildcard) keys of the summary key
+      matcher.
+    */
+    stringlist_type * summary_keys = ensemble_config_alloc_keylist_from_impl_type( state->ensemble_config , SUMMARY );
+    {
+      const summary_key_matcher_type * matcher = ensemble_config_get_summary_key_matcher(state->ensemble_config);
+      stringlist_type * matcher_keys = summary_key_matcher_get_keys( matcher );
+      stringlist_append_stringlist_copy( summary_keys , matcher_keys );
+      stringlist_free( matcher_keys );
+    }
+
+    load_context = forward_load_context_alloc_filtered( run_arg,
+                                                        load_summary,
+                                                        ecl_config ,
+                                                        eclbase,
+                                                        messages ,
+                                                        summary_keys );
+    stringlist_free( summary_keys );
     return load_context;
   }
 }
@@ -318,6 +318,7 @@ typedef enum {left_pad   = 0,
   char *  util_fread_alloc_string(FILE *);
   void    util_fskip_string(FILE *stream);
   void     util_endian_flip_vector(void * data , int element_size , int elements);
+  void     util_endian_flip_vector_copy(void * target , const void * src , int element_size , int elements);
   int      util_proc_mem_free(void);
 
 
@@ -502,6 +503,7 @@ void    util_abort_set_executable( const char * argv0 );
 
 #ifdef ERT_HAVE_ZLIB
   void     util_compress_buffer(const void * , int , void * , unsigned long * );
+  bool     util_uncompress_buffer(const void * zbuffer , unsigned long compressed_size , void * data , unsigned long data_size);
   int      util_fread_sizeof_compressed(FILE * stream);
   void     util_fread_compressed(void * , FILE * );
   void   * util_fread_alloc_compressed(FILE * );
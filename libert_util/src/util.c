@@ -140,7 +140,7 @@
 
 
 static uint16_t util_endian_convert16( uint16_t u ) {
-  return (( u >> 8U ) & 0xFFU) | (( u & 0xFFU) >> 8U);
+  return (( u >> 8U ) & 0xFFU) | (( u & 0xFFU) << 8U);
 }
 
 
@@ -179,21 +179,101 @@ static uint64_t util_endian_convert32_64( uint64_t u ) {
 
 
 
-void util_endian_flip_vector(void *data, int element_size , int elements) {
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+/*
+  SSE2 versions of the endian flip, operating on 16 bytes at a
+  time. SSE2 does not have a general byte shuffle, so the bytes are
+  first swapped within each 16 bit word with shift/or, and then the
+  16 bit words are reordered with the word shuffle instructions. The
+  load and store operations are unaligned, and the target may be
+  equal to the source.
+*/
+
+static __m128i util_endian_convert16_sse2( __m128i v ) {
+  return _mm_or_si128( _mm_slli_epi16( v , 8 ) , _mm_srli_epi16( v , 8 ));
+}
+
+static __m128i util_endian_convert32_sse2( __m128i v ) {
+  v = util_endian_convert16_sse2( v );
+  v = _mm_shufflelo_epi16( v , _MM_SHUFFLE( 2 , 3 , 0 , 1 ));
+  return _mm_shufflehi_epi16( v , _MM_SHUFFLE( 2 , 3 , 0 , 1 ));
+}
+
+static __m128i util_endian_convert64_sse2( __m128i v ) {
+  v = util_endian_convert16_sse2( v );
+  v = _mm_shufflelo_epi16( v , _MM_SHUFFLE( 0 , 1 , 2 , 3 ));
+  return _mm_shufflehi_epi16( v , _MM_SHUFFLE( 0 , 1 , 2 , 3 ));
+}
+
+
+static int util_endian_flip_vector_sse2( void * target , const void * src , int element_size , int elements) {
+  const int block_elements = 16 / element_size;
+  const int num_blocks     = elements / block_elements;
+  char       * target_ptr  = (char *) target;
+  const char * src_ptr     = (const char *) src;
   int i;
+
+  for (i = 0; i < num_blocks; i++) {
+    __m128i v = _mm_loadu_si128( (const __m128i *) &src_ptr[ 16 * i ] );
+    switch (element_size) {
+    case(2):
+      v = util_endian_convert16_sse2( v );
+      break;
+    case(4):
+      v = util_endian_convert32_sse2( v );
+      break;
+    default:
+      v = util_endian_convert64_sse2( v );
+      break;
+    }
+    _mm_storeu_si128( (__m128i *) &target_ptr[ 16 * i ] , v );
+  }
+  return num_blocks * block_elements;
+}
+#endif
+
+
+/*
+  Will endian flip the elements in the src vector and store the
+  result in target; src is not modified. The target and src storage
+  must either be identical, in which case the vector is flipped in
+  place, or not overlap at all.
+*/
+
+void util_endian_flip_vector_copy(void * target , const void * src , int element_size , int elements) {
+  int i = 0;
+
+  if (element_size == 1) {
+    if (target != src)
+      memcpy( target , src , elements );
+    return;
+  }
+
+  if (element_size != 2 && element_size != 4 && element_size != 8) {
+    fprintf(stderr,"%s: current element size: %d \n",__func__ , element_size);
+    util_abort("%s: can only endian flip 1/2/4/8 byte variables - aborting \n",__func__);
+  }
+
+#ifdef __SSE2__
+  i = util_endian_flip_vector_sse2( target , src , element_size , elements );
+#endif
+
   switch (element_size) {
-  case(1):
-    break;
   case(2):
     {
-      uint16_t *tmp16 = (uint16_t *) data;
+      uint16_t       *target16 = (uint16_t *) target;
+      const uint16_t *src16    = (const uint16_t *) src;
 
-      for (i = 0; i <elements; i++)
-        tmp16[i] = util_endian_convert16(tmp16[i]);
+      for (; i < elements; i++)
+        target16[i] = util_endian_convert16(src16[i]);
       break;
     }
   case(4):
     {
+      uint32_t       *target32 = (uint32_t *) target;
+      const uint32_t *src32    = (const uint32_t *) src;
 #ifdef ARCH64
       /*
         In the case of a 64 bit CPU the fastest way to swap 32 bit
@@ -202,40 +282,35 @@ void util_endian_flip_vector(void *data, int element_size , int elements) {
         of binary ECLIPSE files this case is quite common, and
         therefor worth supporting as a special case.
       */
-      uint64_t *tmp64 = (uint64_t *) data;
+      if ((i & 1) == 0) {
+        uint64_t       *target64 = (uint64_t *) target;
+        const uint64_t *src64    = (const uint64_t *) src;
 
-      for (i = 0; i <elements/2; i++)
-        tmp64[i] = util_endian_convert32_64(tmp64[i]);
-
-      if ( elements & 1 ) {
-        // Odd number of elements - flip the last element as an ordinary 32 bit swap.
-        uint32_t *tmp32 = (uint32_t *) data;
-        tmp32[ elements - 1] = util_endian_convert32( tmp32[elements - 1] );
+        for (; i + 1 < elements; i += 2)
+          target64[i/2] = util_endian_convert32_64(src64[i/2]);
       }
-      break;
-#else
-      uint32_t *tmp32 = (uint32_t *) data;
-
-      for (i = 0; i <elements; i++)
-        tmp32[i] = util_endian_convert32(tmp32[i]);
-
-      break;
 #endif
+      for (; i < elements; i++)
+        target32[i] = util_endian_convert32(src32[i]);
+      break;
     }
   case(8):
     {
-      uint64_t *tmp64 = (uint64_t *) data;
+      uint64_t       *target64 = (uint64_t *) target;
+      const uint64_t *src64    = (const uint64_t *) src;
 
-      for (i = 0; i <elements; i++)
-        tmp64[i] = util_endian_convert64(tmp64[i]);
+      for (; i < elements; i++)
+        target64[i] = util_endian_convert64(src64[i]);
       break;
     }
-  default:
-    fprintf(stderr,"%s: current element size: %d \n",__func__ , element_size);
-    util_abort("%s: can only endian flip 1/2/4/8 byte variables - aborting \n",__func__);
   }
 }
 
+
+void util_endian_flip_vector(void *data, int element_size , int elements) {
+  util_endian_flip_vector_copy( data , data , element_size , elements );
+}
+
 void util_endian_flip_vector_old(void *data, int element_size , int elements) {
   int i;
   switch (element_size) {
@@ -48,6 +48,24 @@ void util_compress_buffer(const void * data , int data_size , void * zbuffer , u
 
 
 
+/**
+  The inverse of util_compress_buffer(); will uncompress the
+  @compressed_size bytes in zbuffer into the buffer data, which must
+  have room for exactly @data_size bytes. Returns false if the
+  compressed data is corrupt, or does not expand to exactly
+  @data_size bytes.
+*/
+bool util_uncompress_buffer(const void * zbuffer , unsigned long compressed_size , void * data , unsigned long data_size) {
+  unsigned long uncompressed_size = data_size;
+  if (data_size == 0)
+    return (compressed_size == 0);
+
+  if (uncompress(data , &uncompressed_size , zbuffer , compressed_size) != Z_OK)
+    return false;
+
+  return (uncompressed_size == data_size);
+}
+
 /**
    This function allocates a new buffer which is a compressed version
    of the input buffer data. The input variable data_size, and the
@@ -196,6 +196,17 @@ class EclFile(BaseCClass):
               in cases where a high number of EclFile instances are
               open concurrently.
 
+           ecl.ECL_FILE_MMAP : The file is mapped into memory, and
+              the keywords are loaded from the mapped memory instead
+              of being read through the FILE * stream.
+
+           ecl.ECL_FILE_INDEX : The keyword index is loaded from, or
+              saved to, the sidecar file '<filename>.index' instead of
+              scanning through the complete file on every open.
+
+           ecl.ECL_FILE_THREAD_SAFE : Several threads can load
+              keywords from the same EclFile instance concurrently.
+
         When the file has been loaded the EclFile instance can be used
         to query for and get reference to the EclKW instances
         constituting the file, like e.g. SWAT from a restart file or
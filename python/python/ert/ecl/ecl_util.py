@@ -109,9 +109,15 @@ class EclFileFlagEnum(BaseCEnum):
     TYPE_NAME="ecl_file_flag_enum"
     ECL_FILE_CLOSE_STREAM = None
     ECL_FILE_WRITABLE = None
+    ECL_FILE_MMAP = None
+    ECL_FILE_INDEX = None
+    ECL_FILE_THREAD_SAFE = None
 
 EclFileFlagEnum.addEnum("ECL_FILE_CLOSE_STREAM" , 1 )
 EclFileFlagEnum.addEnum("ECL_FILE_WRITABLE" , 2 )
+EclFileFlagEnum.addEnum("ECL_FILE_MMAP" , 4 )
+EclFileFlagEnum.addEnum("ECL_FILE_INDEX" , 8 )
+EclFileFlagEnum.addEnum("ECL_FILE_THREAD_SAFE" , 16 )
 
 
 #-----------------------------------------------------------------